@@ -7,6 +7,7 @@
  */
 
 #include "flxBusI2C.h"
+#include "flxBusTrace.h"
 
 // Constructor
 
@@ -14,6 +15,8 @@ flxBusI2C::flxBusI2C(void)
 {
 
     _i2cPort = nullptr;
+    _maxTransfer = kI2CMaxTransferSize;
+    _busID = 0;
 }
 
 // Note - SoftwareWire is a subclass of TwoWire
@@ -25,6 +28,17 @@ void flxBusI2C::begin(TwoWire &wirePort)
 }
 
 int flxBusI2C::receiveResponse(uint8_t i2c_address, uint8_t *outputPointer, uint8_t length)
+{
+    flxBusTraceBegin();
+
+    int nData = readResponse(i2c_address, outputPointer, length);
+
+    flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, kBusTraceNoRegister, length,
+                   nData == length ? flxBusTraceOK : flxBusTraceError);
+    return nData;
+}
+
+int flxBusI2C::readResponse(uint8_t i2c_address, uint8_t *outputPointer, uint8_t length)
 {
     int nData;
 
@@ -38,13 +52,148 @@ int flxBusI2C::receiveResponse(uint8_t i2c_address, uint8_t *outputPointer, uint
 }
 bool flxBusI2C::readRegisterRegion(uint8_t i2c_address, uint8_t offset, uint8_t *outputPointer, uint8_t length)
 {
+    flxBusTraceBegin();
 
     _i2cPort->beginTransmission(i2c_address);
     _i2cPort->write(offset);
-    if (_i2cPort->endTransmission(false) != 0)
+    uint8_t status = _i2cPort->endTransmission(false);
+    if (status != 0)
+    {
+        flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, offset, length, flxBusTraceWireResult(status));
         return false;
+    }
 
-    return receiveResponse(i2c_address, outputPointer, length) == length;
+    bool result = readResponse(i2c_address, outputPointer, length) == length;
+
+    flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, offset, length, result ? flxBusTraceOK : flxBusTraceError);
+    return result;
+}
+
+bool flxBusI2C::readRegisterBurst(uint8_t i2c_address, uint8_t offset, uint8_t *outputPointer, size_t length)
+{
+    size_t nChunk;
+
+    while (length > 0)
+    {
+        nChunk = length > _maxTransfer ? _maxTransfer : length;
+
+        if (!readRegisterRegion(i2c_address, offset, outputPointer, (uint8_t)nChunk))
+            return false;
+
+        offset += nChunk;
+        outputPointer += nChunk;
+        length -= nChunk;
+    }
+    return true;
+}
+
+bool flxBusI2C::writeRegisterBurst(uint8_t i2c_address, uint8_t offset, uint8_t *inputPointer, size_t length)
+{
+    // the register offset is part of each transfer
+    size_t maxChunk = _maxTransfer - 1;
+    size_t nChunk;
+
+    if (maxChunk == 0 && length > 0)
+        return false;
+
+    while (length > 0)
+    {
+        nChunk = length > maxChunk ? maxChunk : length;
+
+        if (!writeRegisterRegion(i2c_address, offset, inputPointer, (uint8_t)nChunk))
+            return false;
+
+        offset += nChunk;
+        inputPointer += nChunk;
+        length -= nChunk;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Batched register access
+//
+// Runs of ops that access adjacent registers are moved in one transaction using a small
+// stack buffer. Ops that can't be combined are sent on their own.
+
+size_t flxBusI2C::adjacentOps(const flxI2CRegisterOp_t *ops, size_t nOps, size_t maxLength, size_t &length)
+{
+    size_t nRun = 1;
+
+    length = ops[0].length;
+
+    while (nRun < nOps && ops[nRun].offset == (uint8_t)(ops[nRun - 1].offset + ops[nRun - 1].length) &&
+           length + ops[nRun].length <= maxLength)
+    {
+        length += ops[nRun].length;
+        nRun++;
+    }
+    return nRun;
+}
+
+bool flxBusI2C::readRegisters(uint8_t i2c_address, const flxI2CRegisterOp_t *ops, size_t nOps)
+{
+    uint8_t buffer[kBatchBufferSize];
+    size_t nRun, length;
+
+    size_t maxLength = kBatchBufferSize < _maxTransfer ? kBatchBufferSize : _maxTransfer;
+
+    for (size_t i = 0; i < nOps; i += nRun)
+    {
+        nRun = adjacentOps(ops + i, nOps - i, maxLength, length);
+
+        // a single op is read directly into the callers buffer
+        if (nRun == 1)
+        {
+            if (!readRegisterBurst(i2c_address, ops[i].offset, ops[i].data, ops[i].length))
+                return false;
+            continue;
+        }
+
+        if (!readRegisterRegion(i2c_address, ops[i].offset, buffer, length))
+            return false;
+
+        uint8_t *pData = buffer;
+        for (size_t j = i; j < i + nRun; j++)
+        {
+            memcpy(ops[j].data, pData, ops[j].length);
+            pData += ops[j].length;
+        }
+    }
+    return true;
+}
+
+bool flxBusI2C::writeRegisters(uint8_t i2c_address, const flxI2CRegisterOp_t *ops, size_t nOps)
+{
+    uint8_t buffer[kBatchBufferSize];
+    size_t nRun, length;
+
+    // the register offset is part of the transfer
+    size_t maxLength = (kBatchBufferSize < _maxTransfer ? kBatchBufferSize : _maxTransfer) - 1;
+
+    for (size_t i = 0; i < nOps; i += nRun)
+    {
+        nRun = adjacentOps(ops + i, nOps - i, maxLength, length);
+
+        // a single op is written from the callers buffer - split if it's larger than a transfer
+        if (nRun == 1)
+        {
+            if (!writeRegisterBurst(i2c_address, ops[i].offset, ops[i].data, ops[i].length))
+                return false;
+            continue;
+        }
+
+        uint8_t *pData = buffer;
+        for (size_t j = i; j < i + nRun; j++)
+        {
+            memcpy(pData, ops[j].data, ops[j].length);
+            pData += ops[j].length;
+        }
+
+        if (!writeRegisterRegion(i2c_address, ops[i].offset, buffer, length))
+            return false;
+    }
+    return true;
 }
 
 uint8_t flxBusI2C::readRegister(uint8_t i2c_address, uint8_t offset)
@@ -66,6 +215,8 @@ bool flxBusI2C::readRegister(uint8_t i2c_address, uint8_t offset, uint8_t *outpu
 
     int nData = 0;
 
+    flxBusTraceBegin();
+
     _i2cPort->beginTransmission(i2c_address);
     _i2cPort->write(offset);
     _i2cPort->endTransmission();
@@ -80,6 +231,8 @@ bool flxBusI2C::readRegister(uint8_t i2c_address, uint8_t offset, uint8_t *outpu
     if (nData == 1) // Only update outputPointer if a single byte was returned
         *outputPointer = result;
 
+    flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, offset, 1, nData == 1 ? flxBusTraceOK : flxBusTraceError);
+
     return (nData == 1);
 }
 
@@ -106,6 +259,7 @@ bool flxBusI2C::readRegister16(uint8_t i2c_address, uint8_t offset, uint16_t *va
 }
 
 //////////////////////////////////////
+// Note: pings are not traced - a NACK is an expected response during device detection
 bool flxBusI2C::ping(uint8_t i2c_address)
 {
 
@@ -115,26 +269,38 @@ bool flxBusI2C::ping(uint8_t i2c_address)
 
 bool flxBusI2C::write(uint8_t i2c_address, uint8_t offset)
 {
+    flxBusTraceBegin();
 
     _i2cPort->beginTransmission(i2c_address);
     _i2cPort->write(offset);
-    return _i2cPort->endTransmission() == 0;
+    uint8_t status = _i2cPort->endTransmission();
+
+    flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, offset, 0, flxBusTraceWireResult(status));
+    return status == 0;
 }
 bool flxBusI2C::write(uint8_t i2c_address, uint8_t *pData, uint8_t length)
 {
+    flxBusTraceBegin();
 
     _i2cPort->beginTransmission(i2c_address);
     _i2cPort->write(pData, length);
-    return _i2cPort->endTransmission() == 0;
+    uint8_t status = _i2cPort->endTransmission();
+
+    flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, kBusTraceNoRegister, length, flxBusTraceWireResult(status));
+    return status == 0;
 }
 
 bool flxBusI2C::writeRegister(uint8_t i2c_address, uint8_t offset, uint8_t dataToWrite)
 {
+    flxBusTraceBegin();
 
     _i2cPort->beginTransmission(i2c_address);
     _i2cPort->write(offset);
     _i2cPort->write(dataToWrite);
-    return _i2cPort->endTransmission() == 0;
+    uint8_t status = _i2cPort->endTransmission();
+
+    flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, offset, 1, flxBusTraceWireResult(status));
+    return status == 0;
 }
 
 bool flxBusI2C::writeRegister16(uint8_t i2c_address, uint8_t offset, uint16_t dataToWrite)
@@ -154,6 +320,7 @@ bool flxBusI2C::writeRegister24(uint8_t i2c_address, uint8_t offset, uint32_t va
 }
 bool flxBusI2C::writeRegisterRegion(uint8_t i2c_address, uint8_t offset, uint8_t *inputPointer, uint8_t length)
 {
+    flxBusTraceBegin();
 
     _i2cPort->beginTransmission(i2c_address);
     _i2cPort->write(offset);
@@ -161,7 +328,10 @@ bool flxBusI2C::writeRegisterRegion(uint8_t i2c_address, uint8_t offset, uint8_t
     for (int i = 0; i < length; i++, inputPointer++) // send data bytes
         _i2cPort->write(*inputPointer);              // receive a byte as character
 
-    return _i2cPort->endTransmission() == 0;
+    uint8_t status = _i2cPort->endTransmission();
+
+    flxBusTraceEnd(flxBusTraceI2C, _busID, i2c_address, offset, length, flxBusTraceWireResult(status));
+    return status == 0;
 }
 
 //
@@ -21,6 +21,25 @@
 #include "Arduino.h"
 #include <Wire.h>
 
+// The max number of bytes in one Wire transfer is set by the size of the Wire buffer on the platform. Note: the
+// requestFrom() length is a uint8_t, so transfers are capped at 255 bytes.
+#if defined(I2C_BUFFER_LENGTH)
+#define kI2CMaxTransferSize (I2C_BUFFER_LENGTH > 255 ? 255 : I2C_BUFFER_LENGTH)
+#elif defined(WIRE_BUFFER_SIZE)
+#define kI2CMaxTransferSize (WIRE_BUFFER_SIZE > 255 ? 255 : WIRE_BUFFER_SIZE)
+#else
+#define kI2CMaxTransferSize 32
+#endif
+
+// Describes one register access in a batched read or write. Accesses to adjacent registers are
+// combined into a single bus transaction.
+typedef struct
+{
+    uint8_t offset;
+    uint8_t *data;
+    uint8_t length;
+} flxI2CRegisterOp_t;
+
 class flxBusI2C
 {
 
@@ -29,6 +48,12 @@ class flxBusI2C
 
     void begin(TwoWire &wirePort = Wire);
 
+    // use a wire port that has already been started
+    void setWirePort(TwoWire &wirePort)
+    {
+        _i2cPort = &wirePort;
+    }
+
     bool initialized()
     {
         return _i2cPort != nullptr;
@@ -44,6 +69,38 @@ class flxBusI2C
     // a chunk of memory into that array.
     bool readRegisterRegion(uint8_t i2c_address, uint8_t offset, uint8_t *outputPointer, uint8_t length);
 
+    // Reads a register region of any length, split into transfers that fit the Wire buffer. The device is
+    // expected to auto-increment the register address.
+    bool readRegisterBurst(uint8_t i2c_address, uint8_t offset, uint8_t *outputPointer, size_t length);
+
+    // The write version - each transfer carries the register offset and up to maxTransferSize() - 1 bytes
+    bool writeRegisterBurst(uint8_t i2c_address, uint8_t offset, uint8_t *inputPointer, size_t length);
+
+    // Batched reads and writes of a list of register ranges
+    bool readRegisters(uint8_t i2c_address, const flxI2CRegisterOp_t *ops, size_t nOps);
+    bool writeRegisters(uint8_t i2c_address, const flxI2CRegisterOp_t *ops, size_t nOps);
+
+    // The max bytes moved in one bus transfer
+    void setMaxTransferSize(uint8_t maxSize)
+    {
+        _maxTransfer = maxSize > 0 ? maxSize : 1;
+    }
+    uint8_t maxTransferSize(void)
+    {
+        return _maxTransfer;
+    }
+
+    // The bus identifier - 0 is the default (primary) bus. Additional buses are numbered by the
+    // framework when they are added to it.
+    void setBusID(uint8_t busID)
+    {
+        _busID = busID;
+    }
+    uint8_t busID(void)
+    {
+        return _busID;
+    }
+
     // readRegister reads one register
     uint8_t readRegister(uint8_t i2c_address, uint8_t offset);
     bool readRegister(uint8_t i2c_address, uint8_t offset, uint8_t *outputPointer);
@@ -73,5 +130,16 @@ class flxBusI2C
     bool writeRegisterRegion(uint8_t i2c_address, uint8_t offset, uint8_t *inputPointer, uint8_t length);
 
   private:
+    // read the response of a transaction - not traced
+    int readResponse(uint8_t i2c_address, uint8_t *outputPointer, uint8_t length);
+
+    // stack buffer used to combine batched register accesses
+    static constexpr uint8_t kBatchBufferSize = 32;
+
+    // number of ops, starting at ops[0], that access adjacent registers and fit in the batch buffer
+    size_t adjacentOps(const flxI2CRegisterOp_t *ops, size_t nOps, size_t maxLength, size_t &length);
+
     TwoWire *_i2cPort;
+    uint8_t _maxTransfer;
+    uint8_t _busID;
 };
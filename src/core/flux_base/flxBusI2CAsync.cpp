@@ -0,0 +1,278 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxBusI2CAsync.h"
+#include "flxCoreLog.h"
+
+#include <algorithm>
+
+// period of the service job in ms
+#define kI2CAsyncJobPeriod 1
+
+#if defined(ESP32)
+#define kI2CAsyncTaskStack 3072
+#define kI2CAsyncTaskPriority 2
+
+#define asyncLock() xSemaphoreTake(_hLock, portMAX_DELAY)
+#define asyncUnlock() xSemaphoreGive(_hLock)
+#else
+#define asyncLock()
+#define asyncUnlock()
+#endif
+
+//----------------------------------------------------------------------------------------------------
+flxBusI2CAsync::flxBusI2CAsync() : _i2cBus{nullptr}, _depth{0}, _nPending{0}
+{
+#if defined(ESP32)
+    _hWorker = nullptr;
+    _hCompleted = nullptr;
+    _hLock = nullptr;
+    _stopWorker = false;
+    _workerRunning = false;
+#endif
+}
+
+flxBusI2CAsync::~flxBusI2CAsync()
+{
+    end();
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxBusI2CAsync::begin(flxBusI2C &i2cBus, uint16_t depth)
+{
+    if (_i2cBus)
+        return true;
+
+    if (!i2cBus.initialized() || depth == 0)
+        return false;
+
+    _i2cBus = &i2cBus;
+    _depth = depth;
+
+#if defined(ESP32)
+    _hCompleted = xQueueCreate(depth, sizeof(flxI2CTransaction *));
+    _hLock = xSemaphoreCreateMutex();
+
+    _stopWorker = false;
+    _workerRunning = true;
+
+    if (!_hCompleted || !_hLock ||
+        xTaskCreate(workerTask, "flxI2CAsync", kI2CAsyncTaskStack, this, kI2CAsyncTaskPriority, &_hWorker) != pdPASS)
+    {
+        flxLogM_E(kMsgErrAllocErrorN, "I2C Async", "worker");
+        _hWorker = nullptr;
+        _workerRunning = false;
+        end();
+        return false;
+    }
+#endif
+
+    _job.setup("I2C Async", kI2CAsyncJobPeriod, this, &flxBusI2CAsync::jobHandlerCB);
+    flxAddJobToQueue(_job);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusI2CAsync::end(void)
+{
+    flxRemoveJobFromQueue(_job);
+
+#if defined(ESP32)
+    // The worker is stopped, not deleted - deleting it during a transaction would leave the Wire
+    // lock held. It finishes the transaction it's running and exits.
+    if (_hWorker)
+    {
+        _stopWorker = true;
+        xTaskNotifyGive(_hWorker);
+
+        while (_workerRunning)
+            vTaskDelay(1);
+    }
+    if (_hCompleted)
+        vQueueDelete(_hCompleted);
+    if (_hLock)
+        vSemaphoreDelete(_hLock);
+
+    _hWorker = nullptr;
+    _hCompleted = nullptr;
+    _hLock = nullptr;
+#endif
+    // transactions that haven't run fail
+    for (auto pTxn : _queue)
+        pTxn->status = flxI2CTxnError;
+
+    _queue.clear();
+    _nPending = 0;
+    _i2cBus = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxBusI2CAsync::submit(flxI2CTransaction &txn)
+{
+    if (!_i2cBus || txn.pending() || _nPending >= _depth)
+        return false;
+
+    asyncLock();
+    txn.status = flxI2CTxnPending;
+    _queue.push_back(&txn);
+    asyncUnlock();
+
+    _nPending++;
+
+#if defined(ESP32)
+    xTaskNotifyGive(_hWorker);
+#endif
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxBusI2CAsync::cancel(flxI2CTransaction &txn)
+{
+    bool bCanceled = false;
+
+    // once removed from the queue, the transaction isn't referenced again - the caller can reuse or free it
+    asyncLock();
+    auto itTxn = std::find(_queue.begin(), _queue.end(), &txn);
+    if (itTxn != _queue.end())
+    {
+        _queue.erase(itTxn);
+        txn.status = flxI2CTxnIdle;
+        bCanceled = true;
+    }
+    asyncUnlock();
+
+    if (bCanceled && _nPending > 0)
+        _nPending--;
+
+    return bCanceled;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Run a transaction using the blocking bus calls
+//
+bool flxBusI2CAsync::execute(flxI2CTransaction &txn)
+{
+    if (!_i2cBus)
+        return false;
+
+    if (txn.hasReg)
+    {
+        if (txn.rxData)
+            return _i2cBus->readRegisterBurst(txn.address, txn.reg, txn.rxData, txn.rxLength);
+
+        // register writes are limited to one transfer - the register and the data
+        if (txn.txLength + 1 > _i2cBus->maxTransferSize())
+            return false;
+
+        return _i2cBus->writeRegisterRegion(txn.address, txn.reg, (uint8_t *)txn.txData, txn.txLength);
+    }
+
+    if (txn.txData && txn.txLength > 0)
+    {
+        if (txn.txLength > _i2cBus->maxTransferSize() ||
+            !_i2cBus->write(txn.address, (uint8_t *)txn.txData, txn.txLength))
+            return false;
+    }
+    if (txn.rxData && txn.rxLength > 0)
+    {
+        if (txn.rxLength > _i2cBus->maxTransferSize())
+            return false;
+
+        return _i2cBus->receiveResponse(txn.address, txn.rxData, txn.rxLength) == (int)txn.rxLength;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Called in the framework loop when a transaction is finished
+void flxBusI2CAsync::complete(flxI2CTransaction *pTxn)
+{
+    if (_nPending > 0)
+        _nPending--;
+
+    if (pTxn->onComplete)
+        pTxn->onComplete(*pTxn);
+}
+
+#if defined(ESP32)
+//----------------------------------------------------------------------------------------------------
+// ESP32 - run transactions on a worker task, pass them back to the main loop on completion.
+//
+void flxBusI2CAsync::workerTask(void *pParam)
+{
+    ((flxBusI2CAsync *)pParam)->workerLoop();
+
+    // a task can't return
+    vTaskDelete(nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusI2CAsync::workerLoop(void)
+{
+    flxI2CTransaction *pTxn;
+
+    while (!_stopWorker)
+    {
+        // A transaction is taken off the queue while locked, so it can't be canceled once it has started
+        pTxn = nullptr;
+
+        asyncLock();
+        if (!_queue.empty())
+        {
+            pTxn = _queue.front();
+            _queue.pop_front();
+            pTxn->status = flxI2CTxnActive;
+        }
+        asyncUnlock();
+
+        // nothing to do - wait for submit() or end()
+        if (!pTxn)
+        {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+
+        pTxn->status = execute(*pTxn) ? flxI2CTxnDone : flxI2CTxnError;
+
+        xQueueSend(_hCompleted, &pTxn, portMAX_DELAY);
+    }
+
+    // end() waits for this - the object isn't used after it's cleared
+    _workerRunning = false;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusI2CAsync::jobHandlerCB(void)
+{
+    flxI2CTransaction *pTxn;
+
+    while (_hCompleted && xQueueReceive(_hCompleted, &pTxn, 0) == pdTRUE)
+        complete(pTxn);
+}
+#else
+//----------------------------------------------------------------------------------------------------
+// Run the next transaction - one per job dispatch so other jobs get time between bus operations
+//
+void flxBusI2CAsync::jobHandlerCB(void)
+{
+    if (_queue.empty())
+        return;
+
+    flxI2CTransaction *pTxn = _queue.front();
+    _queue.pop_front();
+
+    pTxn->status = flxI2CTxnActive;
+    pTxn->status = execute(*pTxn) ? flxI2CTxnDone : flxI2CTxnError;
+
+    complete(pTxn);
+}
+#endif
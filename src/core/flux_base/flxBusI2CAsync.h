@@ -0,0 +1,192 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxBusI2CAsync.h
+ *
+ * Queued, non-blocking I2C transactions on top of flxBusI2C.
+ *
+ * A driver fills in a transaction, submits it to the queue and then either polls the transaction
+ * status or provides a completion callback. Completion callbacks are always called from the
+ * framework loop (the job queue), never from a task or an interrupt.
+ *
+ * How the queue is serviced depends on the platform:
+ *
+ *    ESP32  - transactions run on a FreeRTOS worker task. The ESP32 Wire implementation locks
+ *             the bus for each transaction, so the worker and the main loop can share the port.
+ *             The worker takes transactions from the queue under a lock, so a transaction that
+ *             is canceled, or fails when the queue ends, is never touched by the worker again.
+ *
+ *    Others - transactions run from the job queue, one transaction per dispatch, so the other
+ *             jobs in the system are serviced between bus operations.
+ */
+
+#pragma once
+
+#include "flxBusI2C.h"
+#include "flxCoreJobs.h"
+
+#include <deque>
+#include <functional>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#endif
+
+typedef enum
+{
+    flxI2CTxnIdle = 0,
+    flxI2CTxnPending,
+    flxI2CTxnActive,
+    flxI2CTxnDone,
+    flxI2CTxnError
+} flxI2CTxnStatus_t;
+
+//----------------------------------------------------------------------------------------------------
+// flxI2CTransaction
+//
+// The transaction is owned by the caller and must stay valid until it completes.
+//
+class flxI2CTransaction
+{
+  public:
+    flxI2CTransaction()
+        : address{0}, reg{0}, hasReg{false}, txData{nullptr}, txLength{0}, rxData{nullptr}, rxLength{0},
+          status{flxI2CTxnIdle}
+    {
+    }
+
+    // read a register region
+    void setReadRegister(uint8_t i2cAddress, uint8_t offset, uint8_t *pData, size_t length)
+    {
+        set(i2cAddress, true, offset, nullptr, 0, pData, length);
+    }
+
+    // write a register region
+    void setWriteRegister(uint8_t i2cAddress, uint8_t offset, const uint8_t *pData, size_t length)
+    {
+        set(i2cAddress, true, offset, pData, length, nullptr, 0);
+    }
+
+    // raw write and/or read - if both are set, the write is sent first
+    void setTransfer(uint8_t i2cAddress, const uint8_t *pTxData, size_t txLen, uint8_t *pRxData, size_t rxLen)
+    {
+        set(i2cAddress, false, 0, pTxData, txLen, pRxData, rxLen);
+    }
+
+    // Completion callback - called from the framework loop
+    template <typename T> void setCallback(T *inst, void (T::*func)(flxI2CTransaction &))
+    {
+        onComplete = [=](flxI2CTransaction &txn) { (inst->*func)(txn); };
+    }
+
+    bool pending(void)
+    {
+        return status == flxI2CTxnPending || status == flxI2CTxnActive;
+    }
+
+    uint8_t address;
+    uint8_t reg;
+    bool hasReg;
+
+    const uint8_t *txData;
+    size_t txLength;
+
+    uint8_t *rxData;
+    size_t rxLength;
+
+    volatile flxI2CTxnStatus_t status;
+
+    std::function<void(flxI2CTransaction &)> onComplete;
+
+  private:
+    void set(uint8_t i2cAddress, bool bReg, uint8_t offset, const uint8_t *pTxData, size_t txLen, uint8_t *pRxData,
+             size_t rxLen)
+    {
+        address = i2cAddress;
+        hasReg = bReg;
+        reg = offset;
+        txData = pTxData;
+        txLength = txLen;
+        rxData = pRxData;
+        rxLength = rxLen;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------
+// flxBusI2CAsync
+//
+class flxBusI2CAsync
+{
+  public:
+    flxBusI2CAsync();
+    ~flxBusI2CAsync();
+
+    // depth is the max number of transactions that can be queued
+    bool begin(flxBusI2C &i2cBus, uint16_t depth = 16);
+
+    // Stop the queue - a transaction on the bus is finished first. Transactions that haven't run are
+    // set to flxI2CTxnError. No completion callbacks are called.
+    void end(void);
+
+    // Queue a transaction. Returns false if the queue is full or the transaction is already queued.
+    bool submit(flxI2CTransaction &txn);
+
+    flxI2CTxnStatus_t poll(flxI2CTransaction &txn)
+    {
+        return txn.status;
+    }
+
+    // remove a transaction that has not started
+    bool cancel(flxI2CTransaction &txn);
+
+    // number of transactions that have been submitted and not yet completed
+    size_t pending(void)
+    {
+        return _nPending;
+    }
+
+    // Execute a single transaction on the bus - blocking
+    bool execute(flxI2CTransaction &txn);
+
+  private:
+    void jobHandlerCB(void);
+    void complete(flxI2CTransaction *pTxn);
+
+    flxBusI2C *_i2cBus;
+    uint16_t _depth;
+
+    // transactions waiting to run
+    std::deque<flxI2CTransaction *> _queue;
+
+    // number of submitted transactions that have not been completed
+    size_t _nPending;
+
+    flxJob _job;
+
+#if defined(ESP32)
+    static void workerTask(void *pParam);
+    void workerLoop(void);
+
+    TaskHandle_t _hWorker;
+    QueueHandle_t _hCompleted;
+
+    // guards the transaction queue and status changes between the worker and the main loop
+    SemaphoreHandle_t _hLock;
+
+    // set by end() to stop the worker - the worker clears _workerRunning as it exits
+    volatile bool _stopWorker;
+    volatile bool _workerRunning;
+#endif
+};
@@ -9,6 +9,7 @@
 // SPI bus encapsulation
 
 #include "flxBusSPI.h"
+#include "flxBusTrace.h"
 #include "flxCoreLog.h"
 #include <Arduino.h>
 
@@ -44,7 +45,10 @@ bool flxBusSPI::begin(SPIClass &spiPort, SPISettings &spiSettings, bool bInit)
     return true;
 }
 
-bool flxBusSPI::writeRegisterByte(uint8_t cs, uint8_t offset, uint8_t data)
+//----------------------------------------------------------------------------------------------------------
+// Low level bus access
+
+bool flxBusSPI::beginTransfers(void)
 {
     // Bus?
     if (!_spiPort)
@@ -52,16 +56,96 @@ bool flxBusSPI::writeRegisterByte(uint8_t cs, uint8_t offset, uint8_t data)
 
     // Apply settings
     _spiPort->beginTransaction(_spiSettings);
+    return true;
+}
+
+void flxBusSPI::endTransfers(void)
+{
+    _spiPort->endTransaction();
+}
 
-    // Signal communication start
-    digitalWrite(cs, LOW);
+void flxBusSPI::selectDevice(uint8_t cs, bool bSelect)
+{
+    digitalWrite(cs, bSelect ? LOW : HIGH);
+}
+
+void flxBusSPI::transferBytes(uint8_t *buffer, size_t length)
+{
+    // Block transfer - the platform moves the bytes through the SPI hardware FIFO, rather than a call per byte
+    _spiPort->transfer(buffer, length);
+}
 
-    _spiPort->transfer(offset);
-    _spiPort->transfer(data);
+//----------------------------------------------------------------------------------------------------------
+// Register frames
+//
+// Short accesses are sent in a single block transfer, using a stack buffer.
+#define kSPIFrameBufferSize 32
 
-    // End communcation
-    digitalWrite(cs, HIGH);
-    _spiPort->endTransaction();
+void flxBusSPI::readFrame(uint8_t cs, uint8_t reg, uint8_t *data, size_t length)
+{
+    // Note: A leading "1" must be added to transfer with register to indicate a "read"
+    // Note to our future selves:
+    //   This works / is required on both the ISM330 and MMC5983,
+    //   but will cause badness with other SPI devices.
+    //   We may need to add an alternate method if we ever add another SPI device.
+    uint8_t buffer[kSPIFrameBufferSize] = {0};
+    buffer[0] = reg | kSPIReadFlag;
+
+    selectDevice(cs, true);
+
+    if (length < kSPIFrameBufferSize)
+    {
+        transferBytes(buffer, length + 1);
+        memcpy(data, buffer + 1, length);
+    }
+    else
+    {
+        transferBytes(buffer, 1);
+        memset(data, 0, length);
+        transferBytes(data, length);
+    }
+
+    selectDevice(cs, false);
+}
+
+void flxBusSPI::writeFrame(uint8_t cs, uint8_t reg, const uint8_t *data, size_t length)
+{
+    uint8_t buffer[kSPIFrameBufferSize];
+    size_t nBuffer = 0;
+
+    buffer[nBuffer++] = reg;
+
+    selectDevice(cs, true);
+
+    // The transfer overwrites the buffer - so the data is sent from a copy
+    for (size_t i = 0; i < length; i++)
+    {
+        buffer[nBuffer++] = data[i];
+        if (nBuffer == sizeof(buffer))
+        {
+            transferBytes(buffer, nBuffer);
+            nBuffer = 0;
+        }
+    }
+    if (nBuffer > 0)
+        transferBytes(buffer, nBuffer);
+
+    selectDevice(cs, false);
+}
+
+//----------------------------------------------------------------------------------------------------------
+bool flxBusSPI::writeRegisterByte(uint8_t cs, uint8_t offset, uint8_t data)
+{
+    flxBusTraceBegin();
+
+    if (!beginTransfers())
+        return false;
+
+    writeFrame(cs, offset, &data, 1);
+
+    endTransfers();
+
+    flxBusTraceEnd(flxBusTraceSPI, 0, cs, offset, 1, flxBusTraceOK);
 
     return true;
 }
@@ -69,51 +153,149 @@ bool flxBusSPI::writeRegisterByte(uint8_t cs, uint8_t offset, uint8_t data)
 // Return the number of bytes sent
 int flxBusSPI::writeRegisterRegion(uint8_t cs, uint8_t offset, const uint8_t *data, uint16_t length)
 {
+    flxBusTraceBegin();
 
-    if (!_spiPort)
+    if (!beginTransfers())
         return 0;
 
-    // Apply settings
-    _spiPort->beginTransaction(_spiSettings);
-
-    // Signal communication start
-    digitalWrite(cs, LOW);
-    _spiPort->transfer(offset);
+    writeFrame(cs, offset, data, length);
 
-    for (int i = 0; i < length; i++)
-        _spiPort->transfer(*data++);
+    endTransfers();
 
-    // End communication
-    digitalWrite(cs, HIGH);
-    _spiPort->endTransaction();
+    flxBusTraceEnd(flxBusTraceSPI, 0, cs, offset, length, flxBusTraceOK);
 
     return length;
 }
 
 int flxBusSPI::readRegisterRegion(uint8_t cs, uint8_t reg, uint8_t *data, uint16_t length)
 {
-    if (!_spiPort)
+    flxBusTraceBegin();
+
+    if (!beginTransfers())
         return 0;
 
-    // Apply settings
-    _spiPort->beginTransaction(_spiSettings);
+    readFrame(cs, reg, data, length);
 
-    // Signal communication start
-    digitalWrite(cs, LOW);
+    endTransfers();
 
-    // Note: A leading "1" must be added to transfer with register to indicate a "read"
-    // Note to our future selves:
-    //   This works / is required on both the ISM330 and MMC5983,
-    //   but will cause badness with other SPI devices.
-    //   We may need to add an alternate method if we ever add another SPI device.
-    _spiPort->transfer(reg | 0x80);
+    flxBusTraceEnd(flxBusTraceSPI, 0, cs, reg, length, flxBusTraceOK);
 
-    for (int i = 0; i < length; i++)
-        *data++ = _spiPort->transfer(0x00);
+    return length;
+}
 
-    // End transaction
-    digitalWrite(cs, HIGH);
-    _spiPort->endTransaction();
+//----------------------------------------------------------------------------------------------------------
+// Batched transfers
+//
+// Returns the number of ops, from the start of the list, that access consecutive registers in the same
+// direction. These are sent in one chip select frame.
 
-    return length;
+size_t flxBusSPI::adjacentOps(const flxSPIRegisterOp_t *ops, size_t nOps)
+{
+    size_t nRun = 1;
+
+    while (nRun < nOps && ops[nRun].write == ops[0].write &&
+           ops[nRun].offset == (uint8_t)(ops[nRun - 1].offset + ops[nRun - 1].length))
+        nRun++;
+
+    return nRun;
+}
+
+bool flxBusSPI::transferRegisters(uint8_t cs, const flxSPIRegisterOp_t *ops, size_t nOps)
+{
+    if (!ops || nOps == 0)
+        return true;
+
+    flxBusTraceBegin();
+
+    // One bus transaction for the batch
+    if (!beginTransfers())
+        return false;
+
+    size_t nRun;
+    size_t nBytes = 0;
+
+    for (size_t i = 0; i < nOps; i += nRun)
+    {
+        nRun = adjacentOps(ops + i, nOps - i);
+
+        // a single op is a register frame
+        if (nRun == 1)
+        {
+            if (ops[i].write)
+                writeFrame(cs, ops[i].offset, ops[i].data, ops[i].length);
+            else
+                readFrame(cs, ops[i].offset, ops[i].data, ops[i].length);
+
+            nBytes += ops[i].length;
+            continue;
+        }
+
+        // A run - the register address is sent once, then the data of each op is moved in the same frame
+        uint8_t command = ops[i].write ? ops[i].offset : ops[i].offset | kSPIReadFlag;
+
+        size_t length = 0;
+        for (size_t j = i; j < i + nRun; j++)
+            length += ops[j].length;
+
+        selectDevice(cs, true);
+
+        // Short run? Gather it into one block transfer
+        if (length < kSPIFrameBufferSize)
+        {
+            uint8_t buffer[kSPIFrameBufferSize] = {0};
+            buffer[0] = command;
+
+            uint8_t *pData = buffer + 1;
+            for (size_t j = i; j < i + nRun; j++)
+            {
+                if (ops[j].write)
+                    memcpy(pData, ops[j].data, ops[j].length);
+                pData += ops[j].length;
+            }
+
+            transferBytes(buffer, length + 1);
+
+            pData = buffer + 1;
+            for (size_t j = i; j < i + nRun; j++)
+            {
+                if (!ops[j].write)
+                    memcpy(ops[j].data, pData, ops[j].length);
+                pData += ops[j].length;
+            }
+
+            selectDevice(cs, false);
+            nBytes += length;
+            continue;
+        }
+
+        transferBytes(&command, 1);
+
+        for (size_t j = i; j < i + nRun; j++)
+        {
+            if (ops[j].write)
+            {
+                // send from a copy - the transfer overwrites the buffer
+                uint8_t buffer[kSPIFrameBufferSize];
+                for (size_t k = 0; k < ops[j].length; k += sizeof(buffer))
+                {
+                    size_t nChunk = ops[j].length - k < sizeof(buffer) ? ops[j].length - k : sizeof(buffer);
+                    memcpy(buffer, ops[j].data + k, nChunk);
+                    transferBytes(buffer, nChunk);
+                }
+            }
+            else
+            {
+                memset(ops[j].data, 0, ops[j].length);
+                transferBytes(ops[j].data, ops[j].length);
+            }
+            nBytes += ops[j].length;
+        }
+        selectDevice(cs, false);
+    }
+
+    endTransfers();
+
+    flxBusTraceEnd(flxBusTraceSPI, 0, cs, ops[0].offset, nBytes, flxBusTraceOK);
+
+    return true;
 }
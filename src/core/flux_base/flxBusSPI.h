@@ -12,6 +12,19 @@
 
 #include <SPI.h>
 
+// Register reads set the top bit of the register address
+#define kSPIReadFlag 0x80
+
+// Describes one register access in a batched transfer. Adjacent accesses to consecutive registers, in the same
+// direction, are combined into a single chip select frame.
+typedef struct
+{
+    uint8_t offset;
+    uint8_t *data;
+    uint16_t length;
+    bool write;
+} flxSPIRegisterOp_t;
+
 // Define our SPI Bus class
 
 class flxBusSPI
@@ -19,6 +32,9 @@ class flxBusSPI
 
   public:
     flxBusSPI(void);
+    virtual ~flxBusSPI()
+    {
+    }
 
     SPIClass *getSPIPort(void)
     {
@@ -40,7 +56,29 @@ class flxBusSPI
 
     int readRegisterRegion(uint8_t cs, uint8_t reg, uint8_t *data, uint16_t numBytes);
 
+    // Batched register reads and writes - run under one bus transaction
+    bool transferRegisters(uint8_t cs, const flxSPIRegisterOp_t *ops, size_t nOps);
+
+  protected:
+    // Low level bus access - overridden by a simulated bus.
+
+    // start/end a bus transaction - beginTransfers() returns false if the bus isn't available
+    virtual bool beginTransfers(void);
+    virtual void endTransfers(void);
+
+    // assert or release a chip select
+    virtual void selectDevice(uint8_t cs, bool bSelect);
+
+    // transfer a block of bytes - the buffer is sent and replaced with the bytes received
+    virtual void transferBytes(uint8_t *buffer, size_t length);
+
   private:
+    // One register access frame - called between beginTransfers() and endTransfers()
+    void readFrame(uint8_t cs, uint8_t reg, uint8_t *data, size_t length);
+    void writeFrame(uint8_t cs, uint8_t reg, const uint8_t *data, size_t length);
+
+    size_t adjacentOps(const flxSPIRegisterOp_t *ops, size_t nOps);
+
     SPIClass *_spiPort;
 
     // Settings are used for every transaction.
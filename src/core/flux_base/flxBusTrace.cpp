@@ -0,0 +1,213 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxBusTrace.h"
+
+#if defined(FLUX_SDK_BUS_TRACE)
+
+#include "flxCoreLog.h"
+
+const uint32_t kBusTraceHistLimits[kBusTraceHistBins - 1] = {100, 250, 500, 1000, 2500, 5000, 10000};
+
+static const char *kBusTraceBusNames[] = {"I2C", "SPI"};
+static const char *kBusTraceResultNames[] = {"ok", "NACK", "error"};
+
+#if defined(ESP32)
+#define busTraceLock() portENTER_CRITICAL(&_mux)
+#define busTraceUnlock() portEXIT_CRITICAL(&_mux)
+#else
+#define busTraceLock()
+#define busTraceUnlock()
+#endif
+
+//----------------------------------------------------------------------------------------------------
+flxBusTrace::flxBusTrace()
+{
+#if defined(ESP32)
+    _mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+    reset();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusTrace::reset(void)
+{
+    busTraceLock();
+
+    _ringNext = 0;
+    _ringCount = 0;
+    _nDevices = 0;
+    _nTransactions = 0;
+    _nNacks = 0;
+    _nErrors = 0;
+    _maxTime = 0;
+    _totalTime = 0;
+
+    busTraceUnlock();
+}
+
+//----------------------------------------------------------------------------------------------------
+// Find the stats for a device - adding an entry if needed. Returns nullptr if the table is full
+flxBusTraceDeviceStats_t *flxBusTrace::deviceStats(flxBusTraceKind_t bus, uint8_t busID, uint8_t address)
+{
+    for (size_t i = 0; i < _nDevices; i++)
+    {
+        if (_devices[i].bus == bus && _devices[i].busID == busID && _devices[i].address == address)
+            return &_devices[i];
+    }
+    if (_nDevices == kBusTraceMaxDevices)
+        return nullptr;
+
+    flxBusTraceDeviceStats_t *pStats = &_devices[_nDevices++];
+    memset(pStats, 0, sizeof(flxBusTraceDeviceStats_t));
+    pStats->bus = bus;
+    pStats->busID = busID;
+    pStats->address = address;
+
+    return pStats;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusTrace::record(flxBusTraceKind_t bus, uint8_t busID, uint8_t address, uint16_t reg, uint16_t length,
+                         uint32_t start, flxBusTraceResult_t result)
+{
+    uint32_t duration = micros() - start;
+
+    busTraceLock();
+
+    flxBusTraceRecord_t &theRecord = _ring[_ringNext];
+    theRecord.start = start;
+    theRecord.duration = duration;
+    theRecord.reg = reg;
+    theRecord.length = length;
+    theRecord.bus = bus;
+    theRecord.busID = busID;
+    theRecord.address = address;
+    theRecord.result = result;
+
+    _ringNext = (_ringNext + 1) % kBusTraceRingSize;
+    if (_ringCount < kBusTraceRingSize)
+        _ringCount++;
+
+    _nTransactions++;
+    _totalTime += duration;
+    if (duration > _maxTime)
+        _maxTime = duration;
+
+    if (result == flxBusTraceNACK)
+        _nNacks++;
+    else if (result == flxBusTraceError)
+        _nErrors++;
+
+    flxBusTraceDeviceStats_t *pStats = deviceStats(bus, busID, address);
+    if (pStats)
+    {
+        pStats->count++;
+        pStats->totalTime += duration;
+        if (duration > pStats->maxTime)
+            pStats->maxTime = duration;
+
+        if (result == flxBusTraceNACK)
+            pStats->nacks++;
+        else if (result == flxBusTraceError)
+            pStats->errors++;
+
+        int bin = 0;
+        while (bin < kBusTraceHistBins - 1 && duration >= kBusTraceHistLimits[bin])
+            bin++;
+        pStats->histogram[bin]++;
+    }
+
+    busTraceUnlock();
+}
+
+//----------------------------------------------------------------------------------------------------
+size_t flxBusTrace::getRecords(flxBusTraceRecord_t *pRecords, size_t nRecords)
+{
+    busTraceLock();
+
+    size_t nCopy = nRecords < _ringCount ? nRecords : _ringCount;
+
+    // start with the oldest record that fits
+    size_t iRecord = (_ringNext + kBusTraceRingSize - nCopy) % kBusTraceRingSize;
+
+    for (size_t i = 0; i < nCopy; i++)
+    {
+        pRecords[i] = _ring[iRecord];
+        iRecord = (iRecord + 1) % kBusTraceRingSize;
+    }
+
+    busTraceUnlock();
+
+    return nCopy;
+}
+
+//----------------------------------------------------------------------------------------------------
+size_t flxBusTrace::getDeviceStats(flxBusTraceDeviceStats_t *pStats, size_t nStats)
+{
+    busTraceLock();
+
+    size_t nCopy = nStats < _nDevices ? nStats : _nDevices;
+    memcpy(pStats, _devices, nCopy * sizeof(flxBusTraceDeviceStats_t));
+
+    busTraceUnlock();
+
+    return nCopy;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusTrace::dump(void)
+{
+    // copy out the data so the log output isn't done in a critical section. These are large, so
+    // allocate them
+    flxBusTraceRecord_t *pRecords = new flxBusTraceRecord_t[kBusTraceRingSize];
+    flxBusTraceDeviceStats_t *pStats = new flxBusTraceDeviceStats_t[kBusTraceMaxDevices];
+
+    size_t nRecords = getRecords(pRecords, kBusTraceRingSize);
+    size_t nStats = getDeviceStats(pStats, kBusTraceMaxDevices);
+
+    flxLog_N(F("\n\r\tBus Transactions: %u total, %u NACK, %u errors, %u us average, %u us max"), _nTransactions,
+             _nNacks, _nErrors, averageTime(), _maxTime);
+
+    flxLog_N(F("\n\r\tDevices (latency histogram bins in us: <100 <250 <500 <1k <2.5k <5k <10k >=10k):"));
+    for (size_t i = 0; i < nStats; i++)
+    {
+        flxBusTraceDeviceStats_t &theStats = pStats[i];
+
+        flxLog_N(F("\t\t%s%u 0x%02X  count: %u  NACK: %u  errors: %u  avg: %u us  max: %u us"),
+                 kBusTraceBusNames[theStats.bus], theStats.busID, theStats.address, theStats.count, theStats.nacks,
+                 theStats.errors, theStats.count == 0 ? 0 : theStats.totalTime / theStats.count, theStats.maxTime);
+
+        flxLog_N(F("\t\t    histogram: %u %u %u %u %u %u %u %u"), theStats.histogram[0], theStats.histogram[1],
+                 theStats.histogram[2], theStats.histogram[3], theStats.histogram[4], theStats.histogram[5],
+                 theStats.histogram[6], theStats.histogram[7]);
+    }
+
+    flxLog_N(F("\n\r\tLast %u transactions (start us, bus, address, register, length, duration us, result):"),
+             nRecords);
+    for (size_t i = 0; i < nRecords; i++)
+    {
+        flxBusTraceRecord_t &theRecord = pRecords[i];
+
+        if (theRecord.reg == kBusTraceNoRegister)
+            flxLog_N(F("\t\t%10u  %s%u  0x%02X    --  %4u  %6u  %s"), theRecord.start,
+                     kBusTraceBusNames[theRecord.bus], theRecord.busID, theRecord.address, theRecord.length,
+                     theRecord.duration, kBusTraceResultNames[theRecord.result]);
+        else
+            flxLog_N(F("\t\t%10u  %s%u  0x%02X  0x%02X  %4u  %6u  %s"), theRecord.start,
+                     kBusTraceBusNames[theRecord.bus], theRecord.busID, theRecord.address, theRecord.reg,
+                     theRecord.length, theRecord.duration, kBusTraceResultNames[theRecord.result]);
+    }
+
+    delete[] pRecords;
+    delete[] pStats;
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxBusTrace.h
+ *
+ * Optional tracing of I2C and SPI bus transactions.
+ *
+ * When FLUX_SDK_BUS_TRACE is defined, each transaction made through flxBusI2C and flxBusSPI is
+ * recorded - bus, address, register, length, duration and result. The last kBusTraceRingSize
+ * transactions are kept in a ring buffer and per-device latency histograms and error counters
+ * are maintained. A device is identified by the bus kind, the bus ID and its address, so the same
+ * address on two I2C buses is kept separately.
+ *
+ * Only traffic through the flxBusI2C and flxBusSPI methods is traced. Drivers that talk to the
+ * device through their own library (most of them) use the Wire or SPI port directly, and their
+ * transactions are not seen here.
+ *
+ * When FLUX_SDK_BUS_TRACE is not defined, the trace macros used by the bus classes are empty and
+ * the trace recorder is not built.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+typedef enum
+{
+    flxBusTraceI2C = 0,
+    flxBusTraceSPI
+} flxBusTraceKind_t;
+
+typedef enum
+{
+    flxBusTraceOK = 0,
+    flxBusTraceNACK,
+    flxBusTraceError
+} flxBusTraceResult_t;
+
+// register value used for transactions that don't address a register
+#define kBusTraceNoRegister 0xFFFF
+
+// Map the status returned by TwoWire::endTransmission() to a trace result. 2 and 3 are an
+// address or data NACK
+inline flxBusTraceResult_t flxBusTraceWireResult(uint8_t status)
+{
+    return status == 0 ? flxBusTraceOK : (status == 2 || status == 3 ? flxBusTraceNACK : flxBusTraceError);
+}
+
+#if defined(FLUX_SDK_BUS_TRACE)
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#endif
+
+// Size of the transaction ring and the number of devices stats are kept for
+#define kBusTraceRingSize 64
+#define kBusTraceMaxDevices 16
+
+// Latency histogram - the upper bound of each bin in microseconds. The last bin is open ended.
+#define kBusTraceHistBins 8
+extern const uint32_t kBusTraceHistLimits[kBusTraceHistBins - 1];
+
+typedef struct
+{
+    uint32_t start;    // micros() at the start of the transaction
+    uint32_t duration; // microseconds
+    uint16_t reg;      // register offset, or kBusTraceNoRegister
+    uint16_t length;   // bytes transferred
+    uint8_t bus;       // flxBusTraceKind_t
+    uint8_t busID;     // the I2C bus ID - 0 for SPI
+    uint8_t address;   // I2C address or SPI CS pin
+    uint8_t result;    // flxBusTraceResult_t
+} flxBusTraceRecord_t;
+
+typedef struct
+{
+    uint8_t bus;
+    uint8_t busID;
+    uint8_t address;
+    uint32_t count;
+    uint32_t nacks;
+    uint32_t errors;
+    uint32_t totalTime; // microseconds
+    uint32_t maxTime;   // microseconds
+    uint32_t histogram[kBusTraceHistBins];
+} flxBusTraceDeviceStats_t;
+
+//----------------------------------------------------------------------------------------------------
+// flxBusTrace
+//
+// Singleton that records bus transactions.
+//
+class flxBusTrace
+{
+  public:
+    static flxBusTrace &get(void)
+    {
+        static flxBusTrace instance;
+        return instance;
+    }
+
+    // Delete copy and assignment constructors - b/c this is singleton.
+    flxBusTrace(flxBusTrace const &) = delete;
+    void operator=(flxBusTrace const &) = delete;
+
+    void record(flxBusTraceKind_t bus, uint8_t busID, uint8_t address, uint16_t reg, uint16_t length,
+                uint32_t start, flxBusTraceResult_t result);
+
+    void reset(void);
+
+    // Totals over all devices
+    uint32_t transactions(void)
+    {
+        return _nTransactions;
+    }
+    uint32_t nacks(void)
+    {
+        return _nNacks;
+    }
+    uint32_t errors(void)
+    {
+        return _nErrors;
+    }
+    uint32_t maxTime(void)
+    {
+        return _maxTime;
+    }
+    uint32_t averageTime(void)
+    {
+        return _nTransactions == 0 ? 0 : (uint32_t)(_totalTime / _nTransactions);
+    }
+
+    // Copy out the ring - oldest record first. Returns the number of records copied.
+    size_t getRecords(flxBusTraceRecord_t *pRecords, size_t nRecords);
+
+    // Copy out the device stats. Returns the number of devices copied.
+    size_t getDeviceStats(flxBusTraceDeviceStats_t *pStats, size_t nStats);
+
+    // Output the trace ring and device stats to the log
+    void dump(void);
+
+  private:
+    flxBusTrace();
+
+    flxBusTraceDeviceStats_t *deviceStats(flxBusTraceKind_t bus, uint8_t busID, uint8_t address);
+
+    flxBusTraceRecord_t _ring[kBusTraceRingSize];
+    size_t _ringNext;
+    size_t _ringCount;
+
+    flxBusTraceDeviceStats_t _devices[kBusTraceMaxDevices];
+    size_t _nDevices;
+
+    uint32_t _nTransactions;
+    uint32_t _nNacks;
+    uint32_t _nErrors;
+    uint32_t _maxTime;
+    uint64_t _totalTime;
+
+#if defined(ESP32)
+    // the bus can be used from the async I2C worker task
+    portMUX_TYPE _mux;
+#endif
+};
+
+// Trace hooks used in the bus classes
+#define flxBusTraceBegin() uint32_t _busTraceStart = micros()
+#define flxBusTraceEnd(__bus__, __id__, __addr__, __reg__, __len__, __result__)                                      \
+    flxBusTrace::get().record(__bus__, __id__, __addr__, __reg__, __len__, _busTraceStart, __result__)
+
+#else
+
+#define flxBusTraceBegin()
+#define flxBusTraceEnd(__bus__, __id__, __addr__, __reg__, __len__, __result__)
+
+#endif
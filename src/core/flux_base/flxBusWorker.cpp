@@ -0,0 +1,155 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxBusWorker.h"
+#include "flxCoreLog.h"
+
+#include <algorithm>
+
+#if defined(ESP32)
+#define kBusWorkerTaskStack 4096
+#define kBusWorkerTaskPriority 2
+#endif
+
+//----------------------------------------------------------------------------------------------------
+flxBusWorker::flxBusWorker() : _busID{0}, _runTime{0}, _dispatched{false}
+{
+#if defined(ESP32)
+    _hWorker = nullptr;
+    _hDone = nullptr;
+#endif
+}
+
+flxBusWorker::~flxBusWorker()
+{
+    end();
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxBusWorker::begin(uint8_t busID)
+{
+    _busID = busID;
+
+#if defined(ESP32)
+    if (_hWorker)
+        return true;
+
+    char szName[16];
+    snprintf(szName, sizeof(szName), "flxBus%u", busID);
+
+    _hDone = xSemaphoreCreateBinary();
+
+    if (!_hDone ||
+        xTaskCreate(workerTask, szName, kBusWorkerTaskStack, this, kBusWorkerTaskPriority, &_hWorker) != pdPASS)
+    {
+        flxLogM_E(kMsgErrAllocErrorN, "Bus Worker", "task");
+        end();
+        return false;
+    }
+#endif
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusWorker::end(void)
+{
+    // don't pull the task out from under running operations
+    wait();
+
+#if defined(ESP32)
+    if (_hWorker)
+    {
+        vTaskDelete(_hWorker);
+        _hWorker = nullptr;
+    }
+    if (_hDone)
+    {
+        vSemaphoreDelete(_hDone);
+        _hDone = nullptr;
+    }
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusWorker::add(flxOperation *pOp)
+{
+    // the list can't change while the worker is running
+    if (pOp && !_dispatched && !contains(pOp))
+        _ops.push_back(pOp);
+}
+
+bool flxBusWorker::contains(flxOperation *pOp)
+{
+    return std::find(_ops.begin(), _ops.end(), pOp) != _ops.end();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusWorker::run(void)
+{
+    uint32_t ticks = micros();
+
+    for (auto pOp : _ops)
+        pOp->execute();
+
+    _runTime = micros() - ticks;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusWorker::dispatch(void)
+{
+    if (_dispatched || _ops.size() == 0)
+        return;
+
+    _dispatched = true;
+
+#if defined(ESP32)
+    if (_hWorker)
+    {
+        xTaskNotifyGive(_hWorker);
+        return;
+    }
+#endif
+    // no worker task - run inline
+    run();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusWorker::wait(void)
+{
+    if (!_dispatched)
+        return;
+
+#if defined(ESP32)
+    if (_hWorker)
+        xSemaphoreTake(_hDone, portMAX_DELAY);
+#endif
+    _dispatched = false;
+    _ops.clear();
+}
+
+#if defined(ESP32)
+//----------------------------------------------------------------------------------------------------
+// ESP32 - run the operations on the worker task, signal the waiting caller on completion.
+//
+void flxBusWorker::workerTask(void *pParam)
+{
+    flxBusWorker *pWorker = (flxBusWorker *)pParam;
+
+    for (;;)
+    {
+        if (ulTaskNotifyTake(pdTRUE, portMAX_DELAY) == 0)
+            continue;
+
+        pWorker->run();
+
+        xSemaphoreGive(pWorker->_hDone);
+    }
+}
+#endif
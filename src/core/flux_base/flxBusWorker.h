@@ -0,0 +1,92 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxBusWorker.h
+ *
+ * A worker context for an I2C bus. Operations - normally the devices on the bus - are added to
+ * the worker, which then runs their execute() methods when dispatched.
+ *
+ * Only execute() runs on the worker. The caller dispatches the workers, runs any remaining
+ * operations itself and then waits for the workers to complete. The output parameters of the
+ * devices are read after that, on the main loop - and most drivers read the bus in their parameter
+ * getters, with an execute() that does no bus I/O. A worker only takes bus time off the main loop
+ * for drivers that read the bus in execute() - for example the ISM330 FIFO drain, the AS7343 and
+ * AS7265x measurements and the BMV080 read.
+ *
+ * How the worker runs depends on the platform:
+ *
+ *    ESP32  - operations run on a FreeRTOS worker task, one task per bus.
+ *
+ *    Others - operations run inline when dispatched - the buses are serviced one after another.
+ */
+
+#pragma once
+
+#include "flxCore.h"
+
+#include <vector>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#endif
+
+//----------------------------------------------------------------------------------------------------
+// flxBusWorker
+//
+class flxBusWorker
+{
+  public:
+    flxBusWorker();
+    ~flxBusWorker();
+
+    bool begin(uint8_t busID);
+    void end(void);
+
+    uint8_t busID(void)
+    {
+        return _busID;
+    }
+
+    // Add an operation to run on the next dispatch
+    void add(flxOperation *pOp);
+    bool contains(flxOperation *pOp);
+
+    // Run the added operations - returns right away if the worker runs on a task
+    void dispatch(void);
+
+    // Wait for the dispatched operations to complete. The operation list is then cleared.
+    void wait(void);
+
+    // the time, in microseconds, the last dispatch took to run
+    uint32_t lastRunTime(void)
+    {
+        return _runTime;
+    }
+
+  private:
+    void run(void);
+
+    std::vector<flxOperation *> _ops;
+
+    uint8_t _busID;
+    uint32_t _runTime;
+    bool _dispatched;
+
+#if defined(ESP32)
+    static void workerTask(void *pParam);
+
+    TaskHandle_t _hWorker;
+    SemaphoreHandle_t _hDone;
+#endif
+};
@@ -13,6 +13,7 @@
 
 #include "flxCoreDevice.h"
 #include "flxFlux.h"
+#include "flxStorage.h"
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // Device factory things
@@ -21,6 +22,17 @@
 #define devAddrToKey(__addr__, __conf__) ((__addr__ * 10 + (uint16_t)__conf__))
 #define devKeyToAddr(__key__) (__key__ / 10)
 
+// Presence bitmap helpers - one bit per 7-bit I2C address
+#define kI2CPresenceBytes 16
+#define i2cPresenceSet(__map__, __addr__) (__map__[(__addr__) >> 3] |= (1 << ((__addr__) & 0x07)))
+#define i2cPresenceTest(__map__, __addr__) ((__map__[(__addr__) >> 3] & (1 << ((__addr__) & 0x07))) != 0)
+
+// Device cache storage - the block and key names, the record version and the max record size
+static const char *kDeviceCacheBlock = "Device Cache";
+static const char *kDeviceCacheKey = "devices";
+#define kDeviceCacheVersion 1
+#define kDeviceCacheSize 256
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Base Device class Impl
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -56,9 +68,13 @@ void flxDevice::addAddressToName()
         return;
 
     char szBuffer[64];
-    snprintf(szBuffer, sizeof(szBuffer),
-             getKind() == flxDeviceKindSPI || getKind() == flxDeviceKindGPIO ? "%s [p%d]" : "%s [x%x]", name(),
-             address());
+    if (getKind() == flxDeviceKindSPI || getKind() == flxDeviceKindGPIO)
+        snprintf(szBuffer, sizeof(szBuffer), "%s [p%d]", name(), address());
+    else if (busID() > 0)
+        // I2C device on an additional bus - include the bus ID
+        snprintf(szBuffer, sizeof(szBuffer), "%s [x%x:%d]", name(), address(), busID());
+    else
+        snprintf(szBuffer, sizeof(szBuffer), "%s [x%x]", name(), address());
 
     setName(szBuffer);
 }
@@ -68,17 +84,28 @@ void flxDevice::addAddressToName()
 ///////////////////////////////////////////////////////////////////////////////////////
 
 //-------------------------------------------------------------------------------
-bool flxDeviceFactory::addressInUse(uint8_t address)
+bool flxDeviceFactory::addressInUse(flxBusI2C &i2cDriver, uint8_t address)
 {
-    // loop over connected/created devices - if the address is a match, return true
+    // loop over connected/created devices - if the address on this bus is a match, return true
     for (auto device : flux.connectedDevices())
     {
-        if (device->address() == address)
+        if (device->address() == address && device->busID() == i2cDriver.busID() &&
+            device->getKind() == flxDeviceKindI2C)
             return true;
     }
     return false;
 }
 
+//-------------------------------------------------------------------------------
+// The cache key for a bus - each bus has it's own cache record
+static void deviceCacheKey(flxBusI2C &i2cDriver, char *szKey, size_t nKey)
+{
+    if (i2cDriver.busID() == 0)
+        strlcpy(szKey, kDeviceCacheKey, nKey);
+    else
+        snprintf(szKey, nKey, "%s%u", kDeviceCacheKey, i2cDriver.busID());
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 ///
 /// @brief dumps out the contents of the device table. Should be called before auto-load
@@ -143,12 +170,329 @@ bool flxDeviceFactory::registerDevice(flxDeviceBuilderI2C *deviceBuilder)
     return true;
 }
 
+///////////////////////////////////////////////////////////////////////////////////////
+// scanAddresses()
+//
+// Presence pass for auto-detection. Each address that has a registered I2C driver is pinged
+// once and the results are recorded in a bitmap. Only addresses that respond are probed with
+// the drivers isConnected() methods - which are often multi-step and include delays.
+//
+// Only addresses with a registered driver are pinged. This skips the reserved address ranges
+// and addresses nothing can be built for.
+//
+// If any driver at an address can't be pinged, the address is marked present, so that driver's
+// isConnected() is always called - the same as before the presence pass.
+//
+void flxDeviceFactory::scanAddresses(flxBusI2C &i2cDriver, uint8_t *present, uint8_t *noPing)
+{
+    uint8_t scanned[kI2CPresenceBytes] = {0};
+    uint8_t devAddr;
+
+    memset(present, 0, kI2CPresenceBytes);
+    memset(noPing, 0, kI2CPresenceBytes);
+
+    // addresses that can't be pinged
+    for (auto it : *_buildersByAddress)
+    {
+        if (it.second->getDeviceKind() == flxDeviceKindI2C && !it.second->pingable())
+            i2cPresenceSet(noPing, devKeyToAddr(it.first));
+    }
+
+    int nPresent = 0;
+    for (auto it : *_buildersByAddress)
+    {
+        if (it.second->getDeviceKind() != flxDeviceKindI2C)
+            continue;
+
+        devAddr = devKeyToAddr(it.first);
+
+        // already checked this address?
+        if (i2cPresenceTest(scanned, devAddr))
+            continue;
+
+        i2cPresenceSet(scanned, devAddr);
+
+        if (i2cPresenceTest(noPing, devAddr) || i2cDriver.ping(devAddr))
+        {
+            i2cPresenceSet(present, devAddr);
+            nPresent++;
+        }
+    }
+    flxLog_D(F("Device auto-detect: %d addresses to probe"), nPresent);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// Device cache
+//
+// The set of auto-detected devices is persisted, so the next startup can skip the driver
+// probes - the isConnected() calls - which are slow for a number of devices.
+//
+// The cache record is stored as a single byte array:
+//
+//      [version][# of registered drivers - 2 bytes][presence bitmap - 16 bytes]
+//      [address][confidence][name length][name] ... one entry per device
+//
+// The presence bitmap holds the pingable addresses that responded during the detection
+// scan. On startup, the cache is valid if the same drivers are registered, the presence
+// scan matches the cached bitmap and each cached device is found by its driver's
+// isConnected() method - so a different device at a cached address is detected.
+//
+// Addresses with a driver that can't be pinged aren't in the bitmap. At those addresses that
+// have no cached device, the drivers are probed - if a device is found, the cache is invalid.
+// The probes saved by the cache are the failed isConnected() calls at the pingable addresses.
+///////////////////////////////////////////////////////////////////////////////////////
+
+bool flxDeviceFactory::loadDeviceCache(flxBusI2C &i2cDriver, flxStorage *pCache, _DeviceCache_t &theCache)
+{
+    uint8_t record[kDeviceCacheSize];
+    size_t szRecord = 0;
+
+    theCache.clear();
+
+    if (!pCache->begin(true))
+        return false;
+
+    char szKey[16];
+    deviceCacheKey(i2cDriver, szKey, sizeof(szKey));
+
+    flxStorageBlock *stBlk = pCache->getBlock(kDeviceCacheBlock);
+    if (stBlk)
+    {
+        szRecord = stBlk->readBytes(szKey, record, sizeof(record));
+        pCache->endBlock(stBlk);
+    }
+    pCache->end();
+
+    uint16_t nBuilders = factory_count();
+    if (szRecord < 3 + kI2CPresenceBytes || record[0] != kDeviceCacheVersion ||
+        record[1] != (nBuilders & 0xFF) || record[2] != (nBuilders >> 8))
+        return false;
+
+    // compare the presence scan to the cached scan - for the addresses that can be pinged
+    uint8_t *cachedPresent = record + 3;
+    uint8_t present[kI2CPresenceBytes];
+    uint8_t noPing[kI2CPresenceBytes];
+
+    scanAddresses(i2cDriver, present, noPing);
+
+    for (int i = 0; i < kI2CPresenceBytes; i++)
+    {
+        if ((present[i] & ~noPing[i]) != cachedPresent[i])
+        {
+            flxLog_D(F("Device cache: bus has changed"));
+            return false;
+        }
+    }
+
+    // Now the device entries - find the builder for each
+    char szName[64];
+    uint16_t devKey;
+    size_t pos = 3 + kI2CPresenceBytes;
+    uint8_t cachedAddr[kI2CPresenceBytes] = {0};
+
+    while (pos + 3 <= szRecord)
+    {
+        uint8_t devAddr = record[pos];
+        uint8_t devConf = record[pos + 1];
+        uint8_t nName = record[pos + 2];
+        pos += 3;
+
+        if (nName >= sizeof(szName) || pos + nName > szRecord)
+            return false;
+
+        memcpy(szName, record + pos, nName);
+        szName[nName] = '\0';
+        pos += nName;
+
+        devKey = devAddrToKey(devAddr, devConf);
+        auto range = _buildersByAddress->equal_range(devKey);
+        auto it = range.first;
+        for (; it != range.second; it++)
+        {
+            if (strcmp(it->second->getDeviceName(), szName) == 0)
+                break;
+        }
+        if (it == range.second)
+        {
+            flxLog_D(F("Device cache: %s driver not found"), szName);
+            return false;
+        }
+
+        // Is the device still there? The presence scan only shows something answers at the address
+        if (!it->second->isConnected(i2cDriver, devAddr))
+        {
+            flxLog_D(F("Device cache: %s not connected"), szName);
+            return false;
+        }
+        theCache.push_back(*it);
+        i2cPresenceSet(cachedAddr, devAddr);
+    }
+
+    if (pos != szRecord)
+        return false;
+
+    // Addresses that can't be pinged, with no cached device - probe the drivers for a new device
+    for (auto it : *_buildersByAddress)
+    {
+        if (it.second->getDeviceKind() != flxDeviceKindI2C)
+            continue;
+
+        uint8_t devAddr = devKeyToAddr(it.first);
+        if (!i2cPresenceTest(noPing, devAddr) || i2cPresenceTest(cachedAddr, devAddr) ||
+            addressInUse(i2cDriver, devAddr))
+            continue;
+
+        if (it.second->isConnected(i2cDriver, devAddr))
+        {
+            flxLog_D(F("Device cache: new %s device"), it.second->getDeviceName());
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+void flxDeviceFactory::saveDeviceCache(flxBusI2C &i2cDriver, flxStorage *pCache, uint8_t *present, uint8_t *noPing,
+                                       _DeviceCache_t &theCache)
+{
+    uint8_t record[kDeviceCacheSize];
+    size_t szRecord;
+
+    uint16_t nBuilders = factory_count();
+    record[0] = kDeviceCacheVersion;
+    record[1] = nBuilders & 0xFF;
+    record[2] = nBuilders >> 8;
+
+    // The presence of pingable addresses
+    for (int i = 0; i < kI2CPresenceBytes; i++)
+        record[3 + i] = present[i] & ~noPing[i];
+
+    szRecord = 3 + kI2CPresenceBytes;
+
+    for (auto entry : theCache)
+    {
+        size_t nName = strlen(entry.second->getDeviceName());
+
+        if (szRecord + 3 + nName > sizeof(record))
+        {
+            flxLog_W(F("Device cache: too many devices to cache"));
+            return;
+        }
+        record[szRecord++] = devKeyToAddr(entry.first);
+        record[szRecord++] = entry.first % 10;
+        record[szRecord++] = nName;
+        memcpy(record + szRecord, entry.second->getDeviceName(), nName);
+        szRecord += nName;
+    }
+
+    if (!pCache->begin())
+        return;
+
+    char szKey[16];
+    deviceCacheKey(i2cDriver, szKey, sizeof(szKey));
+
+    flxStorageBlock *stBlk = pCache->beginBlock(kDeviceCacheBlock);
+    if (stBlk)
+    {
+        if (!stBlk->writeBytes(szKey, record, szRecord))
+            flxLog_W(F("Device cache: unable to save"));
+
+        pCache->endBlock(stBlk);
+    }
+    pCache->end();
+}
+
+//----------------------------------------------------------------------------------
+void flxDeviceFactory::clearDeviceCache(flxStorage *pCache, uint8_t nBuses)
+{
+    if (!pCache || !pCache->begin())
+        return;
+
+    // A record without a valid version is ignored
+    uint8_t record = 0;
+    char szKey[16];
+    flxBusI2C theBus;
+
+    flxStorageBlock *stBlk = pCache->beginBlock(kDeviceCacheBlock);
+    if (stBlk)
+    {
+        for (uint8_t i = 0; i < nBuses; i++)
+        {
+            theBus.setBusID(i);
+            deviceCacheKey(theBus, szKey, sizeof(szKey));
+            stBlk->writeBytes(szKey, &record, sizeof(record));
+        }
+        pCache->endBlock(stBlk);
+    }
+    pCache->end();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// buildDevice()
+//
+// Create and initialize the device for a builder at the given address. Returns nullptr on
+// failure.
+
+flxDevice *flxDeviceFactory::buildDevice(flxBusI2C &i2cDriver, flxDeviceBuilderI2C *deviceBuilder, uint8_t devAddr)
+{
+    flxDevice *pDevice = deviceBuilder->create();
+
+    if (!pDevice)
+    {
+        flxLogM_E(kMsgErrDeviceInit, deviceBuilder->getDeviceName(), "create");
+        return nullptr;
+    }
+
+    // setup the device object.
+    pDevice->setName(deviceBuilder->getDeviceName());
+    pDevice->setAddress(devAddr);
+    pDevice->setBusID(i2cDriver.busID());
+    pDevice->setAutoload();
+
+    // call device initialize...
+    if (!pDevice->initialize(i2cDriver))
+    {
+        // device failed to init - delete it ...
+        flxLogM_E(kMsgErrDeviceInit, deviceBuilder->getDeviceName(), "initialize");
+        deviceBuilder->destroy(pDevice);
+        return nullptr;
+    }
+    return pDevice;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////
+// buildCachedDevices()
+//
+// Build the devices of a validated cache. Returns the number of devices built. If a device
+// fails to build, the entries that did build are left in the cache list and -1 is returned.
+
+int flxDeviceFactory::buildCachedDevices(flxBusI2C &i2cDriver, _DeviceCache_t &theCache)
+{
+    auto it = theCache.begin();
+    while (it != theCache.end())
+    {
+        if (!buildDevice(i2cDriver, it->second, devKeyToAddr(it->first)))
+        {
+            theCache.erase(it, theCache.end());
+            return -1;
+        }
+        it++;
+    }
+    return theCache.size();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // buildConnectedDevices()
 //
 // Walks through the list of registered drivers and determines if the device is
 // connected to the system. If it is, a driver is created and added to our driver list.
 //
+// If a cache storage is provided, the cached device set is used if it's still valid.
+// Otherwise a full detection scan is run and the results are cached.
+//
+// With multiple buses, each bus is detected in turn - an address in use on one bus doesn't
+// block detection at that address on another bus.
+//
 // Once this is completed, the "registered builders" list is cleared. This frees up the list,
 // but the builder objects, which are globals (and small) remain.
 //
@@ -156,15 +500,83 @@ bool flxDeviceFactory::registerDevice(flxDeviceBuilderI2C *deviceBuilder)
 //    The count of devices connected and the driver was successfully created...
 ///////////////////////////////////////////////////////////////////////////////////////
 
-int flxDeviceFactory::buildDevices(flxBusI2C &i2cDriver)
+int flxDeviceFactory::buildDevices(flxBusI2C &i2cDriver, flxStorage *pCache)
+{
+    std::vector<flxBusI2C *> theBuses = {&i2cDriver};
+
+    return buildDevices(theBuses, pCache);
+}
+
+//----------------------------------------------------------------------------------
+int flxDeviceFactory::buildDevices(std::vector<flxBusI2C *> &theBuses, flxStorage *pCache)
 {
     if (!_buildersByAddress)
     {
         flxLogM_E(kMsgErrInvalidState, "Driver Map");
         return 0;
     }
-    // walk the list of registered drivers
+
+    // Only internal storage is used for the cache - external storage is a user-editable file
+    if (pCache && pCache->kind() != flxStorage::flxStorageKindInternal)
+        pCache = nullptr;
+
+    int nDevs = 0;
+    bool bFromCache;
+
+    _builtFromCache = theBuses.size() > 0;
+
+    for (auto pBus : theBuses)
+    {
+        if (!pBus || !pBus->initialized())
+            continue;
+
+        nDevs += buildBusDevices(*pBus, pCache, bFromCache);
+        _builtFromCache = _builtFromCache && bFromCache;
+    }
+
+    // done - no longer need the builders list/data
+    delete _buildersByAddress;
+    _buildersByAddress = nullptr;
+
+    // flxLog_I("DEBUG: BUILD - MAP DELETE >>>AFTER<<< -  Free Heap: %d", ESP.getFreeHeap());
+
+    return nDevs;
+}
+
+//----------------------------------------------------------------------------------
+// buildBusDevices()
+//
+// Detect and build the devices on one bus. Returns the number of devices built.
+
+int flxDeviceFactory::buildBusDevices(flxBusI2C &i2cDriver, flxStorage *pCache, bool &bFromCache)
+{
+    bFromCache = false;
+
+    // the devices built - used to update the cache
+    _DeviceCache_t theCache;
     int nDevs = 0;
+
+    if (pCache && loadDeviceCache(i2cDriver, pCache, theCache))
+    {
+        nDevs = buildCachedDevices(i2cDriver, theCache);
+        if (nDevs >= 0)
+        {
+            bFromCache = true;
+            return nDevs;
+        }
+        // a cached device failed to build - run a full scan. The devices that were built
+        // are skipped, since their address is in use.
+        nDevs = theCache.size();
+    }
+    else
+        theCache.clear();
+
+    // First, find what addresses respond on the bus
+    uint8_t present[kI2CPresenceBytes];
+    uint8_t noPing[kI2CPresenceBytes];
+    scanAddresses(i2cDriver, present, noPing);
+
+    // walk the list of registered drivers - within an address, these are sorted by confidence level
     uint8_t devAddr;
     flxDeviceBuilderI2C *deviceBuilder;
 
@@ -174,60 +586,39 @@ int flxDeviceFactory::buildDevices(flxBusI2C &i2cDriver)
         deviceBuilder = it->second;
         // Only autoload i2c devices
         if (deviceBuilder->getDeviceKind() != flxDeviceKindI2C)
+        {
+            it++;
             continue;
+        }
 
         // Get the devices I2C address;
         devAddr = devKeyToAddr(it->first);
 
-        // address in use? Jump ahead
-        if (addressInUse(devAddr))
+        // nothing at this address, or address in use? Jump ahead
+        if (!i2cPresenceTest(present, devAddr) || addressInUse(i2cDriver, devAddr))
         {
             // skip head to the next address block - follows the (address + ping) key in the map
             it = _buildersByAddress->upper_bound(devAddrToKey(devAddr, flxDevConfidencePing));
             continue;
         }
 
-        // Is this device at this address?
-        if (deviceBuilder->isConnected(i2cDriver, devAddr))
+        // Is this device at this address? If so, build a device driver
+        if (deviceBuilder->isConnected(i2cDriver, devAddr) && buildDevice(i2cDriver, deviceBuilder, devAddr))
         {
-            // yes connected - build a device driver
-            flxDevice *pDevice = deviceBuilder->create();
+            theCache.push_back(*it);
 
-            if (!pDevice)
-                flxLogM_E(kMsgErrDeviceInit, deviceBuilder->getDeviceName(), "create");
-            else
-            {
-                // setup the device object.
-                pDevice->setName(deviceBuilder->getDeviceName());
-                pDevice->setAddress(devAddr);
-                pDevice->setAutoload();
-
-                // call device initialize...
-                if (!pDevice->initialize(i2cDriver))
-                {
-                    // device failed to init - delete it ...
-                    flxLogM_E(kMsgErrDeviceInit, deviceBuilder->getDeviceName(), "initialize");
-                    deviceBuilder->destroy(pDevice);
-                }
-                else
-                {
-                    // the device is added - skip to next address block - just after (the address + PING) key
-                    it = _buildersByAddress->upper_bound(devAddrToKey(devAddr, flxDevConfidencePing));
-                    nDevs++;
-                    continue;
-                }
-            }
+            // the device is added - skip to next address block - just after (the address + PING) key
+            it = _buildersByAddress->upper_bound(devAddrToKey(devAddr, flxDevConfidencePing));
+            nDevs++;
+            continue;
         }
 
         // okay, device not connected, or failed to init - check the next device in the list
         it++;
     }
 
-    // done - no longer need the builders list/data
-    delete _buildersByAddress;
-    _buildersByAddress = nullptr;
-
-    // flxLog_I("DEBUG: BUILD - MAP DELETE >>>AFTER<<< -  Free Heap: %d", ESP.getFreeHeap());
+    if (pCache)
+        saveDeviceCache(i2cDriver, pCache, present, noPing, theCache);
 
     return nDevs;
 }
@@ -240,7 +631,7 @@ int flxDeviceFactory::buildDevices(flxBusI2C &i2cDriver)
 // If a new device is created by the user outside of this factory, but that
 // device was "auto loaded", we prune the autoload device.
 //
-// A device match = Device::type is the same and the address is the same.
+// A device match = Device::type is the same and the address and bus are the same.
 
 void flxDeviceFactory::pruneAutoload(flxDevice *theDevice, flxDeviceContainer &devList)
 {
@@ -255,7 +646,8 @@ void flxDeviceFactory::pruneAutoload(flxDevice *theDevice, flxDeviceContainer &d
         // only check auto loads
         if ((*itDevice)->autoload())
         {
-            if (theDevice->getType() == (*itDevice)->getType() && theDevice->address() == (*itDevice)->address())
+            if (theDevice->getType() == (*itDevice)->getType() && theDevice->address() == (*itDevice)->address() &&
+                theDevice->busID() == (*itDevice)->busID())
             {
                 // remove the device - returns updated iterator
                 flxDevice *pTmp = *itDevice;
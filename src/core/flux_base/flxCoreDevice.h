@@ -155,7 +155,7 @@ class flxDevice : public flxOperation
     void enable_all_parameters(void);
 
   public:
-    flxDevice() : _autoload{false}, _address{kSparkDeviceAddressNull}, _isInitalized{false}
+    flxDevice() : _autoload{false}, _address{kSparkDeviceAddressNull}, _busID{0}, _isInitalized{false}
     {
         flxRegister(disableAllParameters, "Disable All Parameters", "Disables all output parameters");
         flxRegister(enableAllParameters, "Enable All Parameters", "Enable all output parameters");
@@ -203,6 +203,17 @@ class flxDevice : public flxOperation
         return _address;
     }
 
+    // The bus the device is attached to - the flxBusI2C bus ID. 0 is the default bus.
+    void setBusID(uint8_t busID)
+    {
+        _busID = busID;
+    }
+
+    uint8_t busID(void)
+    {
+        return _busID;
+    }
+
     void addAddressToName();
 
     // device is initialized property
@@ -227,6 +238,7 @@ class flxDevice : public flxOperation
   private:
     bool _autoload;
     uint8_t _address;
+    uint8_t _busID;
     bool _isInitalized;
 };
 
@@ -273,6 +285,7 @@ using flxDeviceContainer = flxContainer<flxDevice>;
 // it's c++ - you have to do this
 class flxDeviceBuilderI2C;
 class flxIDeviceBuilderWr;
+class flxStorage;
 
 // Our factory class
 class flxDeviceFactory
@@ -295,7 +308,24 @@ class flxDeviceFactory
     };
 
     // Called to build a list of device objects for the devices connected to the system.
-    int buildDevices(flxBusI2C &);
+    //
+    // If a storage system is passed in, the detected device set is cached in it. On the next
+    // build, the cached set is validated with a presence scan and built without probing each
+    // driver. A full detection scan is run if the cache is missing or doesn't match the bus.
+    int buildDevices(flxBusI2C &, flxStorage *pCache = nullptr);
+
+    // Build the devices on a set of I2C buses. Each bus is detected independently - devices are
+    // tagged with the ID of the bus they are found on, and each bus has its own cache entry.
+    int buildDevices(std::vector<flxBusI2C *> &, flxStorage *pCache = nullptr);
+
+    // Discard the cached device set of the first nBuses buses - the next build runs a full detection scan
+    void clearDeviceCache(flxStorage *pCache, uint8_t nBuses = 1);
+
+    // Was the last build from the device cache? For a multi-bus build, true if all buses were.
+    bool builtFromCache(void)
+    {
+        return _builtFromCache;
+    }
 
     void pruneAutoload(flxDevice *, flxDeviceContainer &);
 
@@ -306,9 +336,24 @@ class flxDeviceFactory
     void dumpDeviceTable(void);
 
   private:
-    bool addressInUse(uint8_t);
+    bool addressInUse(flxBusI2C &, uint8_t);
+    void scanAddresses(flxBusI2C &, uint8_t *present, uint8_t *noPing);
+
+    // Device cache - an entry is the builder map key (address & confidence) and the builder
+    typedef std::vector<std::pair<uint16_t, flxDeviceBuilderI2C *>> _DeviceCache_t;
+
+    bool loadDeviceCache(flxBusI2C &, flxStorage *pCache, _DeviceCache_t &theCache);
+    void saveDeviceCache(flxBusI2C &, flxStorage *pCache, uint8_t *present, uint8_t *noPing,
+                         _DeviceCache_t &theCache);
+    int buildCachedDevices(flxBusI2C &, _DeviceCache_t &theCache);
+
+    // build the devices on one bus - the builder map is left in place
+    int buildBusDevices(flxBusI2C &, flxStorage *pCache, bool &bFromCache);
+
+    flxDevice *buildDevice(flxBusI2C &, flxDeviceBuilderI2C *deviceBuilder, uint8_t devAddr);
+
     // hide constructor - this is a singleton
-    flxDeviceFactory()
+    flxDeviceFactory() : _builtFromCache{false}
     {
         _buildersByAddress = new _BuilderMMap_t;
     };
@@ -318,6 +363,8 @@ class flxDeviceFactory
     typedef std::multimap<uint16_t, flxDeviceBuilderI2C *> _BuilderMMap_t;
 
     _BuilderMMap_t *_buildersByAddress;
+
+    bool _builtFromCache;
 };
 
 //----------------------------------------------------------------------------------
@@ -337,9 +384,10 @@ class flxDeviceBuilderI2C
     }
     virtual bool isConnected(flxBusI2C &i2cDriver, uint8_t address) = 0; // used to determine if a device is connected
     virtual flxDeviceConfidence_t connectedConfidence(void) = 0;         // 11/2023 update add
-    virtual const char *getDeviceName(void);                             // To report connected devices.
+    virtual const char *getDeviceName(void) = 0;                         // To report connected devices.
     virtual const uint8_t *getDefaultAddresses(void) = 0;
     virtual flxDeviceKind_t getDeviceKind(void) = 0;
+    virtual bool pingable(void) = 0; // can the device address be pinged during auto-detection
 };
 
 // Define a class template used to register a device, then use this template to
@@ -388,6 +436,11 @@ template <class DeviceType> class DeviceBuilder : public flxDeviceBuilderI2C
     {
         return DeviceType::kind();
     }
+
+    bool pingable(void)
+    {
+        return DeviceType::pingable();
+    }
 };
 
 // Macro to define the global builder object.
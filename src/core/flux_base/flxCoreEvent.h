@@ -26,7 +26,16 @@
 //
 class flxSignalBase
 {
-    // empty base class
+  public:
+    virtual ~flxSignalBase()
+    {
+    }
+
+    // Estimate of the heap used by the connected slots
+    virtual size_t heapSize(void) const
+    {
+        return 0;
+    }
 };
 
 template <typename TB, typename... ArgT> class flxSignal : public flxSignalBase
@@ -85,6 +94,17 @@ template <typename TB, typename... ArgT> class flxSignal : public flxSignalBase
         }
     }
 
+    // number of connected slots
+    size_t nSlots(void) const
+    {
+        return slots_.size();
+    }
+
+    size_t heapSize(void) const
+    {
+        return slots_.capacity() * sizeof(std::function<void(ArgT & ...Values)>);
+    }
+
     typedef TB value_type;
 
   private:
@@ -287,6 +307,24 @@ class _flxEventHub
             std::unique_ptr<_flxEventAliasWithValue<T>>(new _flxEventAliasWithValue<T>(alias, value)));
     }
 
+    //----------------------------------------------------------------------------------------------------
+    // Estimate of the heap used by the hub - the map nodes, the signal objects and their slots.
+    size_t heapSize(void)
+    {
+        // map nodes carry three pointers and a color on top of the value
+        const size_t kMapNodeOverhead = 4 * sizeof(void *);
+
+        size_t szHeap = 0;
+        for (auto &sig : _eventSignals)
+            szHeap += kMapNodeOverhead + sizeof(sig) + sizeof(flxSignal<void>) + sig.second->heapSize();
+
+        for (auto &alias : _eventAlias)
+            szHeap += kMapNodeOverhead + sizeof(alias) +
+                      alias.second.capacity() * sizeof(std::unique_ptr<_flxEventAlias>) +
+                      alias.second.size() * sizeof(_flxEventAlias);
+        return szHeap;
+    }
+
   private:
     //----------------------------------------------------------------------------------------------------
     // Alias work
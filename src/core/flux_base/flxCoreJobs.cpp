@@ -69,7 +69,7 @@ _flxJobQueue &flxJobQueue = _flxJobQueue::get();
 //------------------------------------------------------------------
 // overall job queue object
 //
-_flxJobQueue::_flxJobQueue() : _running{false}
+_flxJobQueue::_flxJobQueue() : _running{false}, _currentJob{nullptr}, _currentRemoved{false}
 {
 }
 
@@ -127,22 +127,40 @@ void _flxJobQueue::dispatchJobs(void)
     // are less than ticks.
 
     flxJob *theJob;
+    uint32_t tJob;
     uint32_t tNext;
 
     // our time cutoff
     uint32_t ticks = millis();
 
-    for (auto it = _jobQueue.begin(); it != _jobQueue.end(); /*nothing*/)
+    // Note: A handler can add or remove jobs (including itself), so the head of the queue is
+    // re-fetched each pass and the job is taken off the queue before its handler is called.
+    while (!_jobQueue.empty())
     {
+        auto it = _jobQueue.begin();
+
         // past what is available?
         if (it->first > ticks)
             break;
 
         theJob = it->second;
+        tJob = it->first;
+
+        // remove this item from the job queue head,
+        _jobQueue.erase(it);
 
         // call the job's handler. Doing this here, allows the target to modify job period if needed
+        _currentJob = theJob;
+        _currentRemoved = false;
+
         theJob->callHandler();
 
+        _currentJob = nullptr;
+
+        // did the handler remove this job?
+        if (_currentRemoved)
+            continue;
+
         // normally the base of the next period timeout is the current event timeout - this
         // keeps timed sequences on a predicable schedule - absorbing small delays
         // that occur during operation by the event delta.
@@ -152,18 +170,14 @@ void _flxJobQueue::dispatchJobs(void)
         // end is less than current ticks. If this is the case, fast forward the base by N * period()
         //
         // For a majority of jobs, the next event tick number is this event tick number + job period.
-        tNext = it->first + theJob->period();
+        tNext = tJob + theJob->period();
 
         // high-speed or timed out system (next is <= current ticks) - re-base the period to next valid time
         if (tNext <= ticks)
-            tNext = it->first + (((ticks - it->first) / theJob->period()) + 1) * theJob->period();
+            tNext = tJob + (((ticks - tJob) / theJob->period()) + 1) * theJob->period();
 
-        // remove this item from the job queue head,
-        // Note - erase returns the iterator to next item in container
-        it = _jobQueue.erase(it);
-
-        // add back if not a one shot job
-        if (!theJob->oneShot())
+        // add back if not a one shot job - and the handler didn't re-queue it
+        if (!theJob->oneShot() && findJob(*theJob) == _jobQueue.end())
             _jobQueue.insert(std::pair<uint32_t, flxJob *>(tNext, theJob));
     }
 }
@@ -200,6 +214,10 @@ void _flxJobQueue::addJob(flxJob &theJob)
 //
 void _flxJobQueue::removeJob(flxJob &theJob)
 {
+    // removing the job that is being dispatched? Make sure it isn't added back
+    if (&theJob == _currentJob)
+        _currentRemoved = true;
+
     auto itJob = findJob(theJob);
 
     // do we know of this job?
@@ -262,4 +280,68 @@ void flxUpdateJobInQueue(flxJob &theJob)
 void flxRemoveJobFromQueue(flxJob &theJob)
 {
     flxJobQueue.removeJob(theJob);
-}
\ No newline at end of file
+}
+//------------------------------------------------------------------
+// flxMeasurementCycle
+//------------------------------------------------------------------
+//
+void flxMeasurementCycle::start(void)
+{
+    if (_running || !_onTrigger)
+        return;
+
+    _running = true;
+
+    // kick off the first measurement now, then let the job queue drive the cycle
+    triggerCB();
+    flxAddJobToQueue(_jobTrigger);
+}
+//------------------------------------------------------------------
+void flxMeasurementCycle::stop(void)
+{
+    if (!_running)
+        return;
+
+    flxRemoveJobFromQueue(_jobTrigger);
+    flxRemoveJobFromQueue(_jobCollect);
+
+    _running = false;
+    _busy = false;
+}
+//------------------------------------------------------------------
+void flxMeasurementCycle::setPeriod(uint32_t in_period)
+{
+    if (in_period == 0 || in_period == _jobTrigger.period())
+        return;
+
+    _jobTrigger.setPeriod(in_period);
+
+    if (_running)
+        flxUpdateJobInQueue(_jobTrigger);
+}
+//------------------------------------------------------------------
+void flxMeasurementCycle::triggerCB(void)
+{
+    // previous conversion still running?
+    if (_busy)
+        return;
+
+    uint32_t waitTime = _onTrigger();
+
+    // trigger failed?
+    if (waitTime == 0)
+    {
+        _valid = false;
+        return;
+    }
+
+    _busy = true;
+    _jobCollect.setPeriod(waitTime);
+    flxUpdateJobInQueue(_jobCollect);
+}
+//------------------------------------------------------------------
+void flxMeasurementCycle::collectCB(void)
+{
+    _busy = false;
+    _valid = _onCollect();
+}
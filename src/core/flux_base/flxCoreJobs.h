@@ -142,6 +142,10 @@ class _flxJobQueue
 
     bool _running; // used to flag if the queue is running
 
+    // the job being dispatched, and if its handler removed it from the queue
+    flxJob *_currentJob;
+    bool _currentRemoved;
+
     // use a multi-map for the queue - since entries can have the same key (time value)
     std::multimap<uint32_t, flxJob *> _jobQueue;
 
@@ -156,4 +160,78 @@ void flxAddJobToQueue(flxJob &theJob);
 
 void flxUpdateJobInQueue(flxJob &theJob);
 
-void flxRemoveJobFromQueue(flxJob &theJob);
\ No newline at end of file
+void flxRemoveJobFromQueue(flxJob &theJob);
+//----------------------------------------------------------------------------------------------------
+// flxMeasurementCycle
+//
+// Many sensors follow a trigger -> wait -> collect pattern - start a conversion, wait for the device
+// to complete it and then read out the result. Rather than blocking the system with a delay() while
+// the device works, a measurement cycle splits this into two jobs:
+//
+//    - A periodic trigger job, that calls the objects trigger method. The trigger method starts the
+//      conversion and returns the time, in ms, the device needs to complete it. A return of 0 means
+//      the trigger failed and no collection is scheduled.
+//
+//    - A one-shot collect job, scheduled for when the conversion is complete. It calls the objects
+//      collect method, which reads the results into the objects cached values. The return value of
+//      collect marks the cached values as valid.
+//
+// If a conversion is still in progress when the trigger job fires, that trigger is skipped.
+//
+class flxMeasurementCycle
+{
+  public:
+    flxMeasurementCycle() : _busy{false}, _valid{false}, _running{false}
+    {
+    }
+
+    template <typename T>
+    void setup(const char *name, uint32_t in_period, T *inst, uint32_t (T::*trigger)(), bool (T::*collect)())
+    {
+        if (!inst || !trigger || !collect)
+            return;
+
+        _onTrigger = [=]() { return (inst->*trigger)(); };
+        _onCollect = [=]() { return (inst->*collect)(); };
+
+        _jobTrigger.setup(name, in_period, this, &flxMeasurementCycle::triggerCB);
+        _jobCollect.setup(name, in_period, this, &flxMeasurementCycle::collectCB, true);
+    }
+
+    // Start the cycle - the first measurement is triggered immediately
+    void start(void);
+    void stop(void);
+
+    void setPeriod(uint32_t in_period);
+
+    uint32_t period(void)
+    {
+        return _jobTrigger.period();
+    }
+
+    // Is a conversion in progress?
+    bool busy(void)
+    {
+        return _busy;
+    }
+
+    // Did the last collect succeed?
+    bool hasData(void)
+    {
+        return _valid;
+    }
+
+  private:
+    void triggerCB(void);
+    void collectCB(void);
+
+    std::function<uint32_t()> _onTrigger;
+    std::function<bool()> _onCollect;
+
+    flxJob _jobTrigger;
+    flxJob _jobCollect;
+
+    bool _busy;
+    bool _valid;
+    bool _running;
+};
@@ -39,10 +39,11 @@ const flxParamValueType_t kParamValueNone = 0;
 class flxParameter : public flxDescriptor
 {
     bool _isEnabled;
+    bool _isDirty; // enabled flag changed since it was saved
     flxParamValueType_t _valueType;
 
   public:
-    flxParameter() : _isEnabled{true}, _valueType{kParamValueNone}
+    flxParameter() : _isEnabled{true}, _isDirty{false}, _valueType{kParamValueNone}
     {
     }
 
@@ -62,9 +63,27 @@ class flxParameter : public flxDescriptor
 
     virtual void setEnabled(bool enabled)
     {
+        if (enabled != _isEnabled)
+            _isDirty = true;
+
         _isEnabled = enabled;
     };
+
+    bool isDirty(void)
+    {
+        return _isDirty;
+    }
+    void setIsDirty(bool bDirty = true)
+    {
+        _isDirty = bDirty;
+    }
     virtual flxDataType_t type(void) = 0;
+
+    // Estimate of the heap used by this parameter
+    virtual size_t heapSize(void)
+    {
+        return flxDescriptor::heapSize();
+    }
 };
 
 // We want to bin parameters as input and output for storing different
@@ -80,6 +99,13 @@ class flxParameterIn : public flxParameter
     {
         return std::string(name());
     }; // for consistancy
+
+    size_t heapSize(void)
+    {
+        flxDataLimit *pLimit = dataLimit();
+
+        return flxParameter::heapSize() + (pLimit ? pLimit->heapSize() : 0);
+    }
 };
 
 #define kParameterOutFlagArray 0x01
@@ -222,6 +248,21 @@ class _flxParameterContainer
         return _input_parameters;
     };
 
+    //---------------------------------------------------------------------------------
+    size_t parameterHeapSize(void)
+    {
+        size_t totalSize =
+            (_input_parameters.capacity() + _output_parameters.capacity()) * sizeof(flxParameter *);
+
+        for (auto param : _input_parameters)
+            totalSize += param->heapSize();
+
+        for (auto param : _output_parameters)
+            totalSize += param->heapSize();
+
+        return totalSize;
+    }
+
   private:
     flxParameterInList _input_parameters;
     flxParameterOutList _output_parameters;
@@ -1025,6 +1066,11 @@ class _flxParameterIn : public flxParameterIn, public _flxDataIn<T>
     {
         return _flxDataIn<T>::dataLimit();
     }
+
+    size_t heapSize(void)
+    {
+        return flxParameter::heapSize() + this->dataLimitHeapSize();
+    }
 };
 
 // Define by type
@@ -1337,13 +1383,18 @@ class flxOperation : public flxObject, public _flxParameterContainer
         if (!stBlk)
             return false;
 
-        //  need to stash our parameter enable flags.
-        flxParameterOutList outParams = getOutputParameters();
+        //  need to stash our parameter enable flags - for an incremental save, just the changed ones
+        flxParameterOutList &outParams = getOutputParameters();
 
         for (auto param : outParams)
         {
+            if (stBlk->incremental() && !param->isDirty())
+                continue;
+
             if (!stBlk->write(param->name(), param->enabled()))
                 flxLog_E(F("Error saving enabled flag for %s - parameter %s"), name(), param->name());
+            else
+                param->setIsDirty(false);
         }
 
         return flxObject::onSave(stBlk);
@@ -1355,17 +1406,25 @@ class flxOperation : public flxObject, public _flxParameterContainer
             return false;
 
         // se need to restore our parameter enable flags.
-        flxParameterOutList outParams = getOutputParameters();
+        flxParameterOutList &outParams = getOutputParameters();
 
         bool isEnabled;
         for (auto param : outParams)
         {
             if (stBlk->read(param->name(), isEnabled))
+            {
                 param->setEnabled(isEnabled);
+                param->setIsDirty(false);
+            }
         }
 
         return flxObject::onRestore(stBlk);
     }
+
+    virtual size_t heapSize(void)
+    {
+        return flxObject::heapSize() + parameterHeapSize();
+    }
 };
 
 using flxOperationContainer = flxContainer<flxOperation>;
@@ -64,6 +64,10 @@ class flxProperty : public flxDescriptor
     virtual bool hidden(void) = 0;
     virtual void setHidden(void) = 0;
     virtual bool secure(void) = 0;
+
+    // dirty - the value was set since the property was last saved or restored
+    virtual bool isDirty(void) = 0;
+    virtual void setIsDirty(bool bDirty = true) = 0;
     //---------------------------------------------------------------------------------
     virtual size_t size(void)
     {
@@ -76,6 +80,15 @@ class flxProperty : public flxDescriptor
         return 0; // number of bytes used to persist value
     };
 
+    //---------------------------------------------------------------------------------
+    // Estimate of the heap used by this property - allocated strings and data limits
+    virtual size_t heapSize(void)
+    {
+        flxDataLimit *pLimit = dataLimit();
+
+        return flxDescriptor::heapSize() + (pLimit ? pLimit->heapSize() : 0);
+    }
+
     // Expect subclasses will override this
     virtual std::string to_string()
     {
@@ -176,6 +189,8 @@ class _flxPropertyContainer
     // save/restore for properties in this container. Note, since we
     // expect this to be a "mix-in" class, we use a different interface
     // for the save/restore routines
+    //
+    // For an incremental save, only the properties set since they were last saved are written
 
     bool saveProperties(flxStorageBlock *stBlk)
     {
@@ -183,6 +198,9 @@ class _flxPropertyContainer
         bool status;
         for (auto property : _properties)
         {
+            if (stBlk->incremental() && !property->isDirty())
+                continue;
+
             status = property->save(stBlk);
             rc = rc && status;
         }
@@ -213,6 +231,17 @@ class _flxPropertyContainer
         return totalSize;
     };
 
+    //---------------------------------------------------------------------------------
+    size_t propertyHeapSize()
+    {
+        size_t totalSize = _properties.capacity() * sizeof(flxProperty *);
+
+        for (auto property : _properties)
+            totalSize += property->heapSize();
+
+        return totalSize;
+    };
+
     //---------------------------------------------------------------------------------
     // method to hide a property.
     void hideProperty(flxProperty &theProp)
@@ -274,6 +303,17 @@ class _flxPropertyBase : public flxProperty, public _flxDataIn<T>, public _flxDa
     {
         return ((_flags & kIsSecure) == kIsSecure);
     }
+    bool isDirty()
+    {
+        return ((_flags & kIsDirty) == kIsDirty);
+    }
+    void setIsDirty(bool bDirty = true)
+    {
+        if (bDirty)
+            _flags |= kIsDirty;
+        else
+            _flags &= ~kIsDirty;
+    }
     //---------------------------------------------------------------------------------
     flxDataType_t type()
     {
@@ -292,6 +332,12 @@ class _flxPropertyBase : public flxProperty, public _flxDataIn<T>, public _flxDa
         return size();
     }; // sometimes save size is different than size
 
+    //---------------------------------------------------------------------------------
+    virtual size_t heapSize(void)
+    {
+        return flxDescriptor::heapSize() + this->dataLimitHeapSize();
+    }
+
     //---------------------------------------------------------------------------------
     // Virtual functions to get and set the value - these are filled in
     // by the sub-class
@@ -313,6 +359,8 @@ class _flxPropertyBase : public flxProperty, public _flxDataIn<T>, public _flxDa
 
             if (!status)
                 flxLogM_E(kMsgErrSavingProperty, name());
+            else
+                setIsDirty(false);
         }
         return status;
     };
@@ -324,8 +372,12 @@ class _flxPropertyBase : public flxProperty, public _flxDataIn<T>, public _flxDa
 
         bool status = stBlk->read(name(), c);
 
+        // the value came from storage - so it's not dirty
         if (status)
+        {
             set(c);
+            setIsDirty(false);
+        }
 
         // If the value wasn't there, this is not a failure. So always return true
         return true;
@@ -391,6 +443,7 @@ class _flxPropertyBase : public flxProperty, public _flxDataIn<T>, public _flxDa
   private:
     static constexpr const uint8_t kIsHidden = 0x1;
     static constexpr const uint8_t kIsSecure = 0x2;
+    static constexpr const uint8_t kIsDirty = 0x4;
 
     uint8_t _flags;
 };
@@ -432,6 +485,17 @@ class _flxPropertyBaseString : public flxProperty, _flxDataInString, _flxDataOut
     {
         return ((_flags & kIsSecure) == kIsSecure);
     }
+    bool isDirty()
+    {
+        return ((_flags & kIsDirty) == kIsDirty);
+    }
+    void setIsDirty(bool bDirty = true)
+    {
+        if (bDirty)
+            _flags |= kIsDirty;
+        else
+            _flags &= ~kIsDirty;
+    }
 
     flxDataType_t type()
     {
@@ -480,7 +544,12 @@ class _flxPropertyBaseString : public flxProperty, _flxDataInString, _flxDataOut
         // If this is a secure string and storage is internal, the strings are stored
         // encrypted
         if (stBlk->kind() == flxStorage::flxStorageKindInternal && secure())
-            return stBlk->saveSecureString(name(), get().c_str());
+        {
+            status = stBlk->saveSecureString(name(), get().c_str());
+            if (status)
+                setIsDirty(false);
+            return status;
+        }
 
         // If we are saving to an external source, we don't save hidden values or secure values.
         // But, for secure props, we to write the key and a blank string (makes it easier to enter values)
@@ -494,6 +563,8 @@ class _flxPropertyBaseString : public flxProperty, _flxDataInString, _flxDataOut
             status = stBlk->writeString(name(), c.c_str());
             if (!status)
                 flxLogM_E(kMsgErrSavingProperty, name());
+            else
+                setIsDirty(false);
         }
         return status;
     }
@@ -528,6 +599,8 @@ class _flxPropertyBaseString : public flxProperty, _flxDataInString, _flxDataOut
 
             set(szBuffer);
         }
+        // the value came from storage - so it's not dirty
+        setIsDirty(false);
 
         return true;
     };
@@ -580,6 +653,7 @@ class _flxPropertyBaseString : public flxProperty, _flxDataInString, _flxDataOut
   private:
     static constexpr const uint8_t kIsHidden = 0x1;
     static constexpr const uint8_t kIsSecure = 0x2;
+    static constexpr const uint8_t kIsDirty = 0x4;
 
     uint8_t _flags;
 };
@@ -712,6 +786,7 @@ class _flxPropertyTypedRW : public _flxPropertyBase<T, HIDDEN, SECURE>
         }
 
         (my_object->*_setter)(value);
+        this->setIsDirty();
         my_object->setIsDirty();
     }
 
@@ -1332,6 +1407,7 @@ class flxPropertyRWString : public _flxPropertyBaseString<HIDDEN, SECURE>
         }
 
         (my_object->*_setter)(value);
+        this->setIsDirty();
         my_object->setIsDirty();
     }
 
@@ -1502,6 +1578,7 @@ class _flxPropertyTyped : public _flxPropertyBase<T, HIDDEN, SECURE>
     {
         data = value;
 
+        this->setIsDirty();
         if (my_object)
             my_object->setIsDirty();
     }
@@ -1728,6 +1805,8 @@ class flxPropertyString : public _flxPropertyBaseString<HIDDEN, SECURE>
     void set(std::string const &value)
     {
         data = value;
+
+        this->setIsDirty();
         if (my_object)
             my_object->setIsDirty();
     }
@@ -1783,6 +1862,12 @@ class flxPropertyString : public _flxPropertyBaseString<HIDDEN, SECURE>
         return *this;
     };
 
+    //---------------------------------------------------------------------------------
+    size_t heapSize(void)
+    {
+        return _flxPropertyBaseString<HIDDEN, SECURE>::heapSize() + flxStringHeapSize(data);
+    }
+
   private:
     std::string data; // storage for the property
 };
@@ -1816,6 +1901,9 @@ class flxObject : public flxPersist, public _flxPropertyContainer, public flxDes
     bool _hidden;
     bool _isDirty; // needs saving of props/data
 
+    // restore was deferred - the settings of this object haven't been read from storage yet
+    bool _restorePending;
+
     //---------------------------------------------------------------------------------
     static uint16_t getNextNameNumber(void)
     {
@@ -1826,7 +1914,7 @@ class flxObject : public flxPersist, public _flxPropertyContainer, public flxDes
     }
 
   public:
-    flxObject() : _hidden{false}, _parent(nullptr), _isDirty{false}
+    flxObject() : _hidden{false}, _parent(nullptr), _isDirty{false}, _restorePending{false}
     {
         // setup a default name for this device.
         char szBuffer[64];
@@ -1877,6 +1965,25 @@ class flxObject : public flxPersist, public _flxPropertyContainer, public flxDes
     {
         return _isDirty;
     }
+
+    // A pending object is skipped by restore - flxSettings restores it on demand
+    void setRestorePending(bool bPending = true)
+    {
+        _restorePending = bPending;
+    }
+
+    bool restorePending(void)
+    {
+        return _restorePending;
+    }
+
+    //---------------------------------------------------------------------------------
+    // Estimate of the heap used by this object - allocated strings and properties. Child objects
+    // are not included.
+    virtual size_t heapSize(void)
+    {
+        return flxDescriptor::heapSize() + propertyHeapSize();
+    }
     //---------------------------------------------------------------------------------
     virtual bool onSave(flxStorageBlock *stBlk)
     {
@@ -1889,13 +1996,18 @@ class flxObject : public flxPersist, public _flxPropertyContainer, public flxDes
         return status;
     }
     //---------------------------------------------------------------------------------
+    // For an incremental save, a clean object has nothing to write - so it's skipped.
     virtual bool save(flxStorage *pStorage)
     {
+        if (pStorage->incremental() && !isDirty())
+            return true;
 
         flxStorageBlock *stBlk = pStorage->beginBlock(name());
         if (!stBlk)
             return false;
 
+        stBlk->setIncremental(pStorage->incremental());
+
         bool status = onSave(stBlk);
 
         if (!status)
@@ -1922,6 +2034,9 @@ class flxObject : public flxPersist, public _flxPropertyContainer, public flxDes
     //---------------------------------------------------------------------------------
     virtual bool restore(flxStorage *pStorage)
     {
+        if (_restorePending)
+            return true;
+
         // Do we have this block in storage?
         flxStorageBlock *stBlk = pStorage->getBlock(name());
 
@@ -1990,6 +2105,12 @@ template <class T> class flxContainer : public T
         return (size_t)_vector.size();
     }
 
+    // Note - the heap size of the children is not included.
+    size_t heapSize(void)
+    {
+        return T::heapSize() + _vector.capacity() * sizeof(T *);
+    }
+
     void push_back(T *value)
     {
         // make sure the value isn't already in the list...
@@ -2146,7 +2267,8 @@ template <class T> class flxContainer : public T
         // save ourselves
         T::save(pStorage);
 
-        // Save the children
+        // Save the children. This walks the children on an incremental save too - a child with
+        // another parent doesn't mark this container as dirty, and a clean child returns at once.
         for (auto pObj : _vector)
             pObj->save(pStorage);
 
@@ -2156,6 +2278,10 @@ template <class T> class flxContainer : public T
     //---------------------------------------------------------------------------------
     virtual bool restore(flxStorage *pStorage)
     {
+        // a deferred container is restored with its children
+        if (T::restorePending())
+            return true;
+
         // restore our children
         for (auto pObj : _vector)
             pObj->restore(pStorage);
@@ -58,7 +58,7 @@ class flxDescriptor
         if (_nameAlloc)
         {
             if (_name != nullptr)
-                delete _name;
+                delete[] _name;
 
             _nameAlloc = false;
         }
@@ -136,7 +136,7 @@ class flxDescriptor
         if (_descAlloc)
         {
             if (_desc != nullptr)
-                delete _desc;
+                delete[] _desc;
 
             _descAlloc = false;
         }
@@ -201,7 +201,7 @@ class flxDescriptor
         if (_titleAlloc)
         {
             if (_title != nullptr)
-                delete _title;
+                delete[] _title;
 
             _titleAlloc = false;
         }
@@ -246,6 +246,17 @@ class flxDescriptor
         return _title;
     }
 
+    /**
+     * @brief Return the number of heap bytes used by the allocated (copied) name, description and title strings.
+     *
+     * @return size_t
+     */
+    size_t heapSize(void)
+    {
+        return (_nameAlloc && _name ? strlen(_name) + 1 : 0) + (_descAlloc && _desc ? strlen(_desc) + 1 : 0) +
+               (_titleAlloc && _title ? strlen(_title) + 1 : 0);
+    }
+
   protected:
     const char *_name;
     bool _nameAlloc;
@@ -1310,6 +1321,16 @@ typedef enum
     flxDataLimitTypeSet
 } flxDataLimit_t;
 
+//---------------------------------------------------------
+// Heap bytes used by a std::string - short strings live in the object (SSO) and use no heap
+
+inline size_t flxStringHeapSize(const std::string &str)
+{
+    static const size_t ssoCapacity = std::string().capacity();
+
+    return str.capacity() > ssoCapacity ? str.capacity() + 1 : 0;
+}
+
 class flxDataLimitDesc
 {
   public:
@@ -1344,6 +1365,17 @@ class flxDataLimit
         _dataLimits.clear();
     };
 
+    // Estimate of the heap used by the limit list
+    size_t heapSize(void)
+    {
+        size_t szHeap = _dataLimits.capacity() * sizeof(flxDataLimitDesc);
+
+        for (auto &item : _dataLimits)
+            szHeap += flxStringHeapSize(item.name);
+
+        return szHeap;
+    }
+
     // method to get the name of a limit based on value -
     // sub-classes specialize this
     virtual std::string getName(flxDataVariable &var)
@@ -1741,6 +1773,20 @@ template <typename T> class _flxDataIn : public flxDataIn
         return _dataLimit != nullptr ? _dataLimit->isValid(value) : true;
     }
 
+    // Heap used by the data limit - includes the limit object if it was allocated here
+    size_t dataLimitHeapSize(void)
+    {
+        if (!_dataLimit)
+            return 0;
+
+        size_t szHeap = _dataLimit->heapSize();
+
+        if (_limitIsAlloc)
+            szHeap += _dataLimitType == flxDataLimit::dataLimitSet ? sizeof(flxDataLimitSetType<T>)
+                                                                    : sizeof(flxDataLimitRange<T>);
+        return szHeap;
+    }
+
   private:
     flxDataLimitType<T> *_dataLimit;
     bool _limitIsAlloc;
@@ -93,6 +93,9 @@ template <typename T, typename B = flxDevice> class flxDeviceI2CType : public B
         if (!wirePort)
             return false;
 
+        // tag the device with the bus it's on
+        this->setBusID(i2cDriver.busID());
+
         // call the Wire version of the init methods -- this will
         // dispatch to the actual device onInitialize() method
 
@@ -166,6 +169,13 @@ template <typename T, typename B = flxDevice> class flxDeviceI2CType : public B
         return flxDeviceKindI2C;
     }
 
+    // Can the device be pinged (an empty write) during auto-detection? Devices that don't handle a ping
+    // hide this method and return false - their addresses are always probed with isConnected().
+    static bool pingable(void)
+    {
+        return true;
+    }
+
     flxDeviceKind_t getKind(void)
     {
         return kind();
@@ -280,6 +290,12 @@ template <typename T, typename B = flxDevice> class flxDeviceSPIType : public B
         return flxDeviceKindSPI;
     }
 
+    // Only I2C devices are pinged during auto-detection
+    static bool pingable(void)
+    {
+        return false;
+    }
+
     flxDeviceKind_t getKind(void)
     {
         return kind();
@@ -353,6 +369,12 @@ template <typename T> class flxDeviceGPIOType : public flxDevice
         return flxDeviceKindGPIO;
     }
 
+    // Only I2C devices are pinged during auto-detection
+    static bool pingable(void)
+    {
+        return false;
+    }
+
     flxDeviceKind_t getKind(void)
     {
         return kind();
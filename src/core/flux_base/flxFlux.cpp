@@ -17,6 +17,8 @@
 #include "flxSettings.h"
 #include "flxStorage.h"
 
+#include <algorithm>
+
 // for logging - define output driver on the stack
 
 static flxLoggingDrvDefault _logDriver;
@@ -90,9 +92,47 @@ bool flxFlux::start()
 
     flxBusI2C thei2cBus = i2cDriver();
 
-    // Build drivers for the registered devices connected to the system
+    // Build drivers for the registered devices connected to the system - on each I2C bus
     if (_deviceAutoload)
-        flxDeviceFactory::get().buildDevices(thei2cBus);
+    {
+        std::vector<flxBusI2C *> theBuses = {&thei2cBus};
+        theBuses.insert(theBuses.end(), _i2cBuses.begin(), _i2cBuses.end());
+
+        uint32_t ticks = millis();
+        int nDevs = flxDeviceFactory::get().buildDevices(theBuses, _deviceCache ? flxSettings.storage() : nullptr);
+
+        flxLog_I(F("Device detection: %d devices in %u ms (%s)"), nDevs, millis() - ticks,
+                 flxDeviceFactory::get().builtFromCache() ? "cached" : "full scan");
+
+        if (_i2cBuses.size() > 0)
+        {
+            for (auto pBus : theBuses)
+            {
+                int nBusDevs = 0;
+                for (auto device : Devices)
+                {
+                    if (device->getKind() == flxDeviceKindI2C && device->busID() == pBus->busID())
+                        nBusDevs++;
+                }
+                flxLog_I(F("    I2C bus %u: %d devices"), pBus->busID(), nBusDevs);
+            }
+        }
+    }
+
+    // Workers for the additional buses
+    if (_useBusWorkers)
+    {
+        for (auto pBus : _i2cBuses)
+        {
+            flxBusWorker *pWorker = new flxBusWorker;
+            if (!pWorker->begin(pBus->busID()))
+            {
+                delete pWorker;
+                break;
+            }
+            _busWorkers.push_back(pWorker);
+        }
+    }
 
     if (_theApplication)
         _theApplication->onDeviceLoad();
@@ -144,9 +184,94 @@ bool flxFlux::start()
     // // }
     setInitialized(true);
 
+    _startupTime = millis();
+    flxLog_I(F("Startup completed in %u ms"), _startupTime);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void flxFlux::rescanDevices(void)
+{
+    flxDeviceFactory::get().clearDeviceCache(flxSettings.storage(), i2cBusCount());
+}
+
+//------------------------------------------------------------------------------
+// Multiple I2C buses
+//------------------------------------------------------------------------------
+bool flxFlux::addI2CBus(flxBusI2C &theBus)
+{
+    if (&theBus == &_i2cDriver || std::find(_i2cBuses.begin(), _i2cBuses.end(), &theBus) != _i2cBuses.end())
+        return false;
+
+    if (!theBus.initialized())
+    {
+        flxLogM_E(kMsgErrInitialization, "I2C Bus", "not started");
+        return false;
+    }
+    // ID 0 is the default bus
+    theBus.setBusID(_i2cBuses.size() + 1);
+    _i2cBuses.push_back(&theBus);
+
     return true;
 }
 
+//------------------------------------------------------------------------------
+flxBusI2C *flxFlux::i2cBus(uint8_t busID)
+{
+    if (busID == 0)
+        return &i2cDriver();
+
+    return busID <= _i2cBuses.size() ? _i2cBuses[busID - 1] : nullptr;
+}
+
+//------------------------------------------------------------------------------
+// executeOperations()
+//
+// Devices on a bus with a worker are handed to that worker. The workers are dispatched, the
+// remaining operations are run here and then the workers are waited on. Only execute() is run on
+// a worker - the parameter values are read by the caller once this returns.
+//
+void flxFlux::executeOperations(flxOperationContainer &theOps)
+{
+    // an operation with a deferred restore gets its settings before it's first run
+    for (auto pOp : theOps)
+    {
+        if (pOp->restorePending())
+            flxSettings.restoreDeferred(pOp);
+    }
+
+    if (_busWorkers.size() > 0)
+    {
+        for (auto device : Devices)
+        {
+            if (device->getKind() == flxDeviceKindI2C && device->busID() > 0 &&
+                device->busID() <= _busWorkers.size() && theOps.contains(device))
+                _busWorkers[device->busID() - 1]->add(device);
+        }
+        for (auto pWorker : _busWorkers)
+            pWorker->dispatch();
+    }
+
+    for (auto pOp : theOps)
+    {
+        bool onWorker = false;
+        for (auto pWorker : _busWorkers)
+        {
+            if (pWorker->contains(pOp))
+            {
+                onWorker = true;
+                break;
+            }
+        }
+        if (!onWorker)
+            pOp->execute();
+    }
+
+    for (auto pWorker : _busWorkers)
+        pWorker->wait();
+}
+
 //------------------------------------------------------------------------------
 // loop()
 //
@@ -268,6 +393,10 @@ bool flxFlux::save(flxStorage *pStorage)
     // 11/2023 - originally used the name to find our start key, but names change
     //           switching to application class name - which doesn't change
 
+    // An incremental save is to storage that already has our ID block
+    if (pStorage->incremental())
+        return flxObjectContainer::save(pStorage);
+
     flxStorageBlock *stBlk = pStorage->beginBlock(appClassID());
     if (!stBlk)
         return false;
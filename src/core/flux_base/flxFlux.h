@@ -11,6 +11,7 @@
 #pragma once
 
 #include "flxCore.h"
+#include "flxBusWorker.h"
 #include "flxCoreDevice.h"
 #include "flxSerial.h"
 #include <memory>
@@ -194,6 +195,30 @@ class flxFlux : public flxObjectContainer
         return _i2cDriver;
     }
 
+    // Additional I2C buses - add before start(). The bus is given the next bus ID (1, 2, ...) and
+    // the devices on it are auto-detected at startup, independent of the other buses.
+    bool addI2CBus(flxBusI2C &theBus);
+
+    // The number of I2C buses - including the default bus
+    uint8_t i2cBusCount(void)
+    {
+        return _i2cBuses.size() + 1;
+    }
+
+    // Get a bus by ID - 0 is the default bus. nullptr if the bus doesn't exist
+    flxBusI2C *i2cBus(uint8_t busID);
+
+    // Service each additional I2C bus with its own worker - the execute() methods of the devices on
+    // the bus run on it. Parameter values are still read on the main loop. Set before start().
+    void setBusWorkers(bool bWorkers)
+    {
+        _useBusWorkers = bWorkers;
+    }
+
+    // Run the execute() method of a set of operations. Devices on a bus with a worker are run on
+    // that worker.
+    void executeOperations(flxOperationContainer &theOps);
+
     // Version Things
     void setVersion(uint32_t major, uint32_t minor, uint32_t point, const char *desc, uint32_t build)
     {
@@ -302,6 +327,21 @@ class flxFlux : public flxObjectContainer
         _loadSettings = bLoad;
     }
 
+    // Cache the auto-detected device set in the settings storage - speeds up startup
+    void setDeviceCache(bool bCache)
+    {
+        _deviceCache = bCache;
+    }
+
+    // Clear the cached device set - devices are fully re-detected on the next startup
+    void rescanDevices(void);
+
+    // Time, in ms since boot, start() completed. 0 if start hasn't completed
+    uint32_t startupTime(void)
+    {
+        return _startupTime;
+    }
+
     // more of a debug setting ...
     void dumpDeviceAutoLoadTable(void)
     {
@@ -313,6 +353,11 @@ class flxFlux : public flxObjectContainer
     flxBusI2C _i2cDriver;
     flxBusSPI _spiDriver;
 
+    // the additional I2C buses and their workers
+    std::vector<flxBusI2C *> _i2cBuses;
+    std::vector<flxBusWorker *> _busWorkers;
+    bool _useBusWorkers;
+
     uint32_t _v_major;
     uint32_t _v_minor;
     uint32_t _v_point;
@@ -332,12 +377,16 @@ class flxFlux : public flxObjectContainer
 
     bool _deviceAutoload;
     bool _loadSettings;
+    bool _deviceCache;
+
+    uint32_t _startupTime;
 
     // Note private constructor...
     flxFlux()
-        : _v_major{0}, _v_minor{0}, _v_point{0}, _v_build{0}, _v_desc{""}, _v_idprefix{"0000"},
+        : _useBusWorkers{false}, _v_major{0}, _v_minor{0}, _v_point{0}, _v_build{0}, _v_desc{""}, _v_idprefix{"0000"},
           _appClassID{kDefaultAppClassName}, _theApplication{nullptr}, _token{0}, _hasToken{false},
-          _verboseDevNames{false}, _deviceAutoload{true}, _loadSettings{true}
+          _verboseDevNames{false}, _deviceAutoload{true}, _loadSettings{true},
+          _deviceCache{true}, _startupTime{0}
     {
 
         // setup some default hierarchy things ...
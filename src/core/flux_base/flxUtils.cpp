@@ -158,7 +158,33 @@ bool flx_utils::id_hash_string_to_string(const char *instr, char *outstr, size_t
     uint32_t hash = id_hash_string(instr);
 
     // Now print this has into a string -- forms a unique tag
-    snprintf(outstr, len, "%X", hash);
+    return id_hash_to_string(hash, outstr, len);
+}
+//-------------------------------------------------------------------
+// Hash value to a string - upper case hex, the same as printf("%X"). This makes the key
+// for every value of a settings save or restore, so it doesn't use snprintf.
+bool flx_utils::id_hash_to_string(uint32_t hash, char *outstr, size_t len)
+{
+    static const char kHexDigits[] = "0123456789ABCDEF";
+
+    if (!outstr || !len)
+        return false;
+
+    // digits - least significant first
+    char digits[8];
+    uint8_t nDigits = 0;
+    do
+    {
+        digits[nDigits++] = kHexDigits[hash & 0x0F];
+        hash >>= 4;
+    } while (hash != 0);
+
+    // truncate to the buffer, like snprintf
+    size_t i = 0;
+    while (nDigits > 0 && i < len - 1)
+        outstr[i++] = digits[--nDigits];
+
+    outstr[i] = '\0';
 
     return true;
 }
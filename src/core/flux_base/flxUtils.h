@@ -27,6 +27,8 @@ uint32_t id_hash_string(const char *str);
 
 bool id_hash_string_to_string(const char *instr, char *outstr, size_t len);
 
+bool id_hash_to_string(uint32_t hash, char *outstr, size_t len);
+
 //-------------------------------------------------------------------
 std::string &to_string(std::string &data);
 const std::string &to_string(std::string const &data);
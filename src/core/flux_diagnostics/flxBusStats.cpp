@@ -0,0 +1,83 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxBusStats.h"
+
+#if defined(FLUX_SDK_BUS_TRACE)
+
+//----------------------------------------------------------------------------------------------------
+uint32_t flxBusStats::get_transactions(void)
+{
+    return flxBusTrace::get().transactions();
+}
+uint32_t flxBusStats::get_nacks(void)
+{
+    return flxBusTrace::get().nacks();
+}
+uint32_t flxBusStats::get_errors(void)
+{
+    return flxBusTrace::get().errors();
+}
+uint32_t flxBusStats::get_average_time(void)
+{
+    return flxBusTrace::get().averageTime();
+}
+uint32_t flxBusStats::get_max_time(void)
+{
+    return flxBusTrace::get().maxTime();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusStats::outputReport(void)
+{
+    flxBusTrace::get().dump();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxBusStats::reset(void)
+{
+    flxBusTrace::get().reset();
+}
+
+#else
+
+// Tracing isn't built - the parameters for these are not registered
+
+uint32_t flxBusStats::get_transactions(void)
+{
+    return 0;
+}
+uint32_t flxBusStats::get_nacks(void)
+{
+    return 0;
+}
+uint32_t flxBusStats::get_errors(void)
+{
+    return 0;
+}
+uint32_t flxBusStats::get_average_time(void)
+{
+    return 0;
+}
+uint32_t flxBusStats::get_max_time(void)
+{
+    return 0;
+}
+
+void flxBusStats::outputReport(void)
+{
+    flxLog_I(F("Bus tracing is not enabled. Build with FLUX_SDK_BUS_TRACE defined to enable it."));
+}
+
+void flxBusStats::reset(void)
+{
+}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Action to report the I2C/SPI bus transaction trace and statistics.
+//
+// The trace is only recorded if the framework is built with FLUX_SDK_BUS_TRACE defined. Otherwise
+// this action has no output parameters.
+//
+// Only transactions made through flxBusI2C and flxBusSPI are counted - drivers that use a device
+// library access the Wire or SPI port directly and don't show up here.
+
+#pragma once
+
+#include "flxBusTrace.h"
+#include "flxCore.h"
+#include "flxFlux.h"
+
+//----------------------------------------------------------------------------------------------------
+class flxBusStats : public flxActionType<flxBusStats>
+{
+
+  private:
+    uint32_t get_transactions(void);
+    uint32_t get_nacks(void);
+    uint32_t get_errors(void);
+    uint32_t get_average_time(void);
+    uint32_t get_max_time(void);
+
+  public:
+    flxBusStats()
+    {
+        // Set name and description
+        setName("Bus Statistics", "I2C and SPI bus transaction statistics");
+
+        flxRegister(busReport, "Bus Report", "Output the bus statistics and the most recent transactions");
+        busReport.prompt = false;
+
+        flxRegister(resetStats, "Reset Bus Statistics", "Clear the bus statistics and transaction trace");
+        resetStats.prompt = false;
+
+        // the output parameters are only live if tracing is enabled
+        if (flxBusTraceEnabled())
+        {
+            flxRegister(transactions, "Bus Transactions", "Number of bus transactions");
+            flxRegister(nacks, "Bus NACKs", "Number of I2C transactions not acknowledged");
+            flxRegister(errors, "Bus Errors", "Number of failed bus transactions");
+            flxRegister(averageTime, "Average Latency", "Average bus transaction time in microseconds");
+            flxRegister(maxTime, "Max Latency", "Longest bus transaction time in microseconds");
+        }
+
+        flux_add(this);
+    }
+
+    // Is bus tracing built into the framework
+    static bool flxBusTraceEnabled(void)
+    {
+#if defined(FLUX_SDK_BUS_TRACE)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // Dump the stats and trace ring to the log
+    void outputReport(void);
+
+    void reset(void);
+
+    // Our input parameters/functions
+    flxParameterInVoid<flxBusStats, &flxBusStats::outputReport> busReport;
+    flxParameterInVoid<flxBusStats, &flxBusStats::reset> resetStats;
+
+    // output parameters
+    flxParameterOutUInt32<flxBusStats, &flxBusStats::get_transactions> transactions;
+    flxParameterOutUInt32<flxBusStats, &flxBusStats::get_nacks> nacks;
+    flxParameterOutUInt32<flxBusStats, &flxBusStats::get_errors> errors;
+    flxParameterOutUInt32<flxBusStats, &flxBusStats::get_average_time> averageTime;
+    flxParameterOutUInt32<flxBusStats, &flxBusStats::get_max_time> maxTime;
+};
@@ -309,6 +309,19 @@ template <std::size_t BUFFER_SIZE> class flxFormatJSON : public flxOutputFormat
         return _maxSize;
     }
 
+    //-----------------------------------------------------------------
+    // The document pool grows to hold the largest observation - use the largest output size as
+    // the estimate of the pool size.
+    size_t heapSize(void)
+    {
+        size_t szHeap = flxOutputFormat::heapSize() + _jsonWriters.capacity() * sizeof(flxIWriterJSON *);
+
+        if (_spDoc)
+            szHeap += sizeof(JsonDocument) + _maxSize;
+
+        return szHeap;
+    }
+
   protected:
     //-----------------------------------------------------------------
     template <typename T>
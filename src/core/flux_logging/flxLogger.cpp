@@ -99,7 +99,8 @@ class _flxLoggerMetrics
 
 flxLogger::flxLogger()
     : _timestampType{TimeStampNone}, _outputDeviceID{false}, _outputLocalName{false}, _sampleNumberEnabled{false},
-      _currentSampleNumber{0}, _pMetrics{nullptr}, _sourceNameEnabled{false}, _eventSourceName{""}
+      _currentSampleNumber{0}, _pMetrics{nullptr}, _sourceNameEnabled{false}, _eventSourceName{""},
+      _firstObservation{true}
 {
     setName("Logger", "Data logging action");
 
@@ -320,14 +321,14 @@ void flxLogger::logObservationWithSource(const char *sourceName)
     if (_paramsToLog.size() > 0)
         logSection("General", _paramsToLog);
 
+    // call execute on the operations first - devices on an I2C bus with a worker run in
+    // parallel on that worker
+    flux.executeOperations(_opsToLog);
+
     // loop over ops to log - operations - each object is in a named section. Logs to all
     // formatters
     for (auto pObj : _opsToLog)
-    {
-        // call execute if the operation needs to run ...
-        pObj->execute();
         logSection(pObj->name(), pObj->getOutputParameters());
-    }
 
     // And end the observation for each formatter
     for (auto theFormatter : _Formatters)
@@ -343,6 +344,13 @@ void flxLogger::logObservationWithSource(const char *sourceName)
     if (_pMetrics)
         _pMetrics->captureMetric();
 
+    // Report the boot to first log time - used to track startup performance
+    if (_firstObservation)
+    {
+        _firstObservation = false;
+        flxLog_I(F("First observation logged %u ms after boot"), millis());
+    }
+
     // send an activity event
     flxSendEvent(flxEvent::kOnSystemActivityLow);
 
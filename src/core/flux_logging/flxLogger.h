@@ -203,6 +203,19 @@ class flxLogger : public flxActionType<flxLogger>
         va_add(a1, args...);
     }
 
+    // Include the output formatters and the logged item lists in the heap estimate
+    size_t heapSize(void)
+    {
+        size_t szHeap = flxOperation::heapSize() + _Formatters.capacity() * sizeof(flxOutputFormat *) +
+                        _opsToLog.heapSize() + _paramsToLog.capacity() * sizeof(flxParameterOut *) +
+                        _propsToLog.capacity() * sizeof(flxProperty *);
+
+        for (auto theFormatter : _Formatters)
+            szHeap += theFormatter->heapSize();
+
+        return szHeap;
+    }
+
     template <typename... Args> void add(flxOutputFormat &a1, Args &&...args)
     {
         va_add(a1, args...);
@@ -360,6 +373,8 @@ class flxLogger : public flxActionType<flxLogger>
     bool _sourceNameEnabled;
     std::string _eventSourceName;
 
+    bool _firstObservation;
+
     // Templates used to manage array logging based on type.
     //
     // Note - the array object is dynamically allocated.
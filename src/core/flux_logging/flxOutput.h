@@ -73,6 +73,12 @@ class flxOutputFormat
 
     virtual void reset(void) {};
 
+    // Estimate of the heap used by the formatter
+    virtual size_t heapSize(void)
+    {
+        return _Writers.capacity() * sizeof(flxWriter *);
+    }
+
     void add(flxWriter &newWriter)
     {
         add(&newWriter);
@@ -0,0 +1,227 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxMemory.h"
+#include "flxSettings.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#endif
+
+//----------------------------------------------------------------------------------------------------
+// Allocation tracking
+//----------------------------------------------------------------------------------------------------
+
+static flxAllocStats_t _allocStats = {0, 0, 0, 0, 0};
+
+// Allocations are made from several tasks on the ESP32 (the async bus workers, the network stack) - the
+// counters are updated in a critical section.
+#if defined(ESP32)
+static portMUX_TYPE _allocMux = portMUX_INITIALIZER_UNLOCKED;
+#define allocStatsLock() portENTER_CRITICAL(&_allocMux)
+#define allocStatsUnlock() portEXIT_CRITICAL(&_allocMux)
+#else
+#define allocStatsLock()
+#define allocStatsUnlock()
+#endif
+
+#ifdef FLUX_SDK_TRACK_ALLOCATIONS
+
+// Each block is prefixed with a header that holds the requested size. The header is padded to the
+// platforms maximum alignment so the returned pointer keeps malloc()'s alignment guarantees.
+
+typedef union
+{
+    size_t size;
+    std::max_align_t align;
+} flxAllocHeader_t;
+
+static void *flx_alloc(size_t size)
+{
+    flxAllocHeader_t *pHeader = (flxAllocHeader_t *)malloc(sizeof(flxAllocHeader_t) + size);
+
+    if (!pHeader)
+        return nullptr;
+
+    pHeader->size = size;
+
+    allocStatsLock();
+    _allocStats.nAllocs++;
+    _allocStats.bytesAllocated += size;
+    _allocStats.bytesInUse += size;
+    if (_allocStats.bytesInUse > _allocStats.peakInUse)
+        _allocStats.peakInUse = _allocStats.bytesInUse;
+    allocStatsUnlock();
+
+    return pHeader + 1;
+}
+
+static void flx_free(void *ptr)
+{
+    if (!ptr)
+        return;
+
+    flxAllocHeader_t *pHeader = (flxAllocHeader_t *)ptr - 1;
+
+    allocStatsLock();
+    _allocStats.nFrees++;
+    _allocStats.bytesInUse -= pHeader->size;
+    allocStatsUnlock();
+
+    free(pHeader);
+}
+
+void *operator new(size_t size)
+{
+    void *ptr = flx_alloc(size);
+    if (!ptr)
+        abort(); // exceptions are disabled on our targets
+
+    return ptr;
+}
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return flx_alloc(size);
+}
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return flx_alloc(size);
+}
+void operator delete(void *ptr) noexcept
+{
+    flx_free(ptr);
+}
+void operator delete[](void *ptr) noexcept
+{
+    flx_free(ptr);
+}
+void operator delete(void *ptr, size_t) noexcept
+{
+    flx_free(ptr);
+}
+void operator delete[](void *ptr, size_t) noexcept
+{
+    flx_free(ptr);
+}
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    flx_free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    flx_free(ptr);
+}
+
+bool flxAllocTrackingEnabled(void)
+{
+    return true;
+}
+#else
+bool flxAllocTrackingEnabled(void)
+{
+    return false;
+}
+#endif
+
+//----------------------------------------------------------------------------------------------------
+void flxGetAllocStats(flxAllocStats_t &stats)
+{
+    allocStatsLock();
+    stats = _allocStats;
+    allocStatsUnlock();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxResetAllocPeak(void)
+{
+    allocStatsLock();
+    _allocStats.peakInUse = _allocStats.bytesInUse;
+    allocStatsUnlock();
+}
+
+//----------------------------------------------------------------------------------------------------
+// flxMemoryUsage
+//----------------------------------------------------------------------------------------------------
+
+// Is the settings system an action of the framework, or standalone?
+static bool settingsIsAction(void)
+{
+    return std::find(flux.Actions.begin(), flux.Actions.end(), &flxSettings) != flux.Actions.end();
+}
+
+//----------------------------------------------------------------------------------------------------
+uint32_t flxMemoryUsage::objectHeapSize(void)
+{
+    size_t szHeap = flux.heapSize() + flux.Devices.heapSize() + flux.Actions.heapSize() + flxEventHub.heapSize();
+
+    for (auto device : flux.Devices)
+        szHeap += device->heapSize();
+
+    for (auto action : flux.Actions)
+        szHeap += action->heapSize();
+
+    if (!settingsIsAction())
+        szHeap += flxSettings.heapSize();
+
+    return szHeap;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxMemoryUsage::outputReport(void)
+{
+    flxLog_N(F("\n\r\tHeap: %u bytes free, %u bytes total"), flxPlatform::heap_free(), flxPlatform::heap_size());
+
+    if (flxAllocTrackingEnabled())
+    {
+        flxAllocStats_t stats;
+        flxGetAllocStats(stats);
+
+        flxLog_N(F("\tAllocations: %u allocs, %u frees, %u bytes in use, %u peak, %u total"), stats.nAllocs,
+                 stats.nFrees, stats.bytesInUse, stats.peakInUse, stats.bytesAllocated);
+    }
+
+    flxLog_N(F("\n\r\tEstimated object heap use (bytes):"));
+    flxLog_N(F("\t\t%-28s %6u"), flux.name(), (uint32_t)flux.heapSize());
+    flxLog_N(F("\t\t%-28s %6u"), "Event Hub", (uint32_t)flxEventHub.heapSize());
+
+    size_t szTotal = flux.Devices.heapSize();
+    flxLog_N(F("\n\r\tDevices:"));
+    for (auto device : flux.Devices)
+    {
+        flxLog_N(F("\t\t%-28s %6u"), device->name(), (uint32_t)device->heapSize());
+        szTotal += device->heapSize();
+    }
+    flxLog_N(F("\t\t%-28s %6u"), "(devices total)", (uint32_t)szTotal);
+
+    szTotal = flux.Actions.heapSize();
+    flxLog_N(F("\n\r\tActions:"));
+    for (auto action : flux.Actions)
+    {
+        flxLog_N(F("\t\t%-28s %6u"), action->name(), (uint32_t)action->heapSize());
+        szTotal += action->heapSize();
+    }
+    if (!settingsIsAction())
+    {
+        flxLog_N(F("\t\t%-28s %6u"), flxSettings.name(), (uint32_t)flxSettings.heapSize());
+        szTotal += flxSettings.heapSize();
+    }
+    flxLog_N(F("\t\t%-28s %6u"), "(actions total)", (uint32_t)szTotal);
+
+    flxLog_N(F("\n\r\tTotal estimated object heap: %u bytes\n\r"), objectHeapSize());
+}
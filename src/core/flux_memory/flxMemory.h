@@ -0,0 +1,114 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+// Action to report heap use - both platform totals and estimates for the framework objects
+
+#pragma once
+
+#include "flxCore.h"
+#include "flxFlux.h"
+#include "flxPlatform.h"
+
+//----------------------------------------------------------------------------------------------------
+// Allocation counters
+//
+// These are maintained by replacement global new/delete operators, which are only built if
+// FLUX_SDK_TRACK_ALLOCATIONS is defined. Otherwise the counters are always zero.
+
+typedef struct
+{
+    uint32_t nAllocs;        // number of allocations
+    uint32_t nFrees;         // number of frees
+    uint32_t bytesAllocated; // running total of bytes allocated
+    uint32_t bytesInUse;     // bytes currently allocated
+    uint32_t peakInUse;      // high water mark of bytesInUse
+} flxAllocStats_t;
+
+bool flxAllocTrackingEnabled(void);
+void flxGetAllocStats(flxAllocStats_t &stats);
+void flxResetAllocPeak(void);
+
+//----------------------------------------------------------------------------------------------------
+class flxMemoryUsage : public flxActionType<flxMemoryUsage>
+{
+
+  private:
+    uint32_t get_heap_free(void)
+    {
+        return flxPlatform::heap_free();
+    }
+    uint32_t get_heap_size(void)
+    {
+        return flxPlatform::heap_size();
+    }
+    uint32_t get_n_allocs(void)
+    {
+        flxAllocStats_t stats;
+        flxGetAllocStats(stats);
+        return stats.nAllocs;
+    }
+    uint32_t get_bytes_in_use(void)
+    {
+        flxAllocStats_t stats;
+        flxGetAllocStats(stats);
+        return stats.bytesInUse;
+    }
+    uint32_t get_peak_in_use(void)
+    {
+        flxAllocStats_t stats;
+        flxGetAllocStats(stats);
+        return stats.peakInUse;
+    }
+    uint32_t get_object_heap(void)
+    {
+        return objectHeapSize();
+    }
+
+  public:
+    flxMemoryUsage()
+    {
+        // Set name and description
+        setName("Memory Usage", "Heap use of the system and framework objects");
+
+        flxRegister(memoryReport, "Memory Report", "Output the estimated heap use of each system object");
+        memoryReport.prompt = false;
+
+        flxRegister(freeHeap, "Heap Free", "Free heap in bytes");
+        flxRegister(totalHeap, "Heap Size", "Total heap in bytes");
+        flxRegister(objectHeap, "Object Heap", "Estimated heap used by framework objects in bytes");
+
+        // the allocation counters are only live if tracking is enabled.
+        if (flxAllocTrackingEnabled())
+        {
+            flxRegister(allocCount, "Allocations", "Number of heap allocations");
+            flxRegister(bytesInUse, "Allocated Bytes", "Bytes currently allocated");
+            flxRegister(peakInUse, "Peak Allocated", "Peak bytes allocated");
+        }
+
+        flux_add(this);
+    }
+
+    // Estimated heap used by framework objects - the system, devices, actions and the event hub
+    uint32_t objectHeapSize(void);
+
+    // Dump the per-object estimates to the log
+    void outputReport(void);
+
+    // Our input parameters/functions
+    flxParameterInVoid<flxMemoryUsage, &flxMemoryUsage::outputReport> memoryReport;
+
+    // output parameters
+    flxParameterOutUInt32<flxMemoryUsage, &flxMemoryUsage::get_heap_free> freeHeap;
+    flxParameterOutUInt32<flxMemoryUsage, &flxMemoryUsage::get_heap_size> totalHeap;
+    flxParameterOutUInt32<flxMemoryUsage, &flxMemoryUsage::get_object_heap> objectHeap;
+    flxParameterOutUInt32<flxMemoryUsage, &flxMemoryUsage::get_n_allocs> allocCount;
+    flxParameterOutUInt32<flxMemoryUsage, &flxMemoryUsage::get_bytes_in_use> bytesInUse;
+    flxParameterOutUInt32<flxMemoryUsage, &flxMemoryUsage::get_peak_in_use> peakInUse;
+};
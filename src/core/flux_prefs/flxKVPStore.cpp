@@ -22,6 +22,18 @@
 #include "flxKVPStore.h"
 #include "flxKVPStoreEntry.h"
 
+#include <algorithm>
+
+//----------------------------------------------------------
+flxKVPStore::~flxKVPStore()
+{
+    for (auto thePage : _pages)
+        delete thePage;
+
+    for (auto pNSEntry : _namespaces)
+        delete pNSEntry;
+}
+
 flxKVPError_t flxKVPStore::checkNameSpaces(void)
 {
     // Is this item in the page?
@@ -161,9 +173,28 @@ flxKVPError_t flxKVPStore::initialize(void)
         }
         _pages.push_back(pPage);
     }
+    _pageCommit.assign(_pages.size(), 0);
 
-    // need to set the current page
+    // write out any pages that were initialized as they were loaded
+    flush();
+
+    // need to set the current page - the available page with the highest sequence, which was the
+    // target of the last compaction
     _currPage = (_pages.size() > 0 ? 0 : kNullPage);
+    _sequence = 0;
+
+    for (size_t i = 0; i < _pages.size(); i++)
+    {
+        if (_pages[i]->sequence() >= _sequence)
+        {
+            _sequence = _pages[i]->sequence();
+            if (_pages[i]->status() == flxKVPPageStatus::kPageAvailable)
+                _currPage = i;
+        }
+    }
+
+    if (_pages.size() > 1)
+        removeStaleEntries();
 
     // Now check name spaces. First, mark off the zero space -- because
     _nsState.set(0, true);
@@ -208,18 +239,184 @@ bool flxKVPStore::moveToFreePage(void)
     if (_pages.size() < 2)
         return false;
 
+    // the least worn available page
+    int16_t iPage = kNullPage;
     for (size_t i = 0; i < _pages.size(); i++)
     {
-        if (_pages[i]->status() == flxKVPPageStatus::kPageAvailable && (int)i != _currPage)
+        if (_pages[i]->status() == flxKVPPageStatus::kPageAvailable && (int)i != _currPage &&
+            (iPage == kNullPage || _pages[i]->eraseCount() < _pages[iPage]->eraseCount()))
+            iPage = i;
+    }
+
+    if (iPage == kNullPage)
+        return false;
+
+    flush();
+    _currPage = iPage;
+
+    return true;
+}
+
+//----------------------------------------------------------
+void flxKVPStore::flush(bool bSync /*=false*/)
+{
+    // in a transaction, changes are held until commit()
+    if (_inTransaction && !bSync)
+        return;
+
+    if (_storageDevice)
+    {
+        if (_inTransaction)
         {
-            commit();
-            _currPage = i;
-            return true;
+            _storageDevice->endTransaction();
+            _storageDevice->beginTransaction();
         }
+        else
+            _storageDevice->flush();
     }
 
-    return false;
+    for (auto thePage : _pages)
+        thePage->flushed();
 }
+
+//----------------------------------------------------------
+bool flxKVPStore::beginTransaction(void)
+{
+    if (_inTransaction)
+        return true;
+
+    if (!_storageDevice)
+        return false;
+
+    // start with the device flushed - so the pages count the erase cycle of the transaction
+    flush();
+
+    _inTransaction = _storageDevice->beginTransaction();
+
+    return _inTransaction;
+}
+
+//----------------------------------------------------------
+void flxKVPStore::commit(void)
+{
+    if (_inTransaction)
+    {
+        _inTransaction = false;
+        _storageDevice->endTransaction();
+    }
+    flush();
+
+    // nothing written in this commit? Then there's no wear to level - and the commit isn't counted
+    if (std::find(_pageCommit.begin(), _pageCommit.end(), _nCommits) == _pageCommit.end())
+        return;
+
+    levelWear();
+
+    _nCommits++;
+}
+
+//----------------------------------------------------------
+void flxKVPStore::selectPage(int16_t iPage)
+{
+    if (iPage != kNullPage)
+        _pageCommit[iPage] = _nCommits;
+
+    if (iPage == _writePage)
+        return;
+
+    flush();
+    _writePage = iPage;
+}
+//----------------------------------------------------------
+int16_t flxKVPStore::findPage(uint8_t iNS, const char *szKey)
+{
+    for (size_t i = 0; i < _pages.size(); i++)
+    {
+        if (_pages[i]->keyExists(iNS, szKey))
+            return i;
+    }
+    return kNullPage;
+}
+
+//----------------------------------------------------------
+flxKVPError_t flxKVPStore::setPageValue(int16_t iPage, uint8_t iNS, flxDataType_t dType, const char *szKey,
+                                        const void *value, size_t valueSize)
+{
+    selectPage(iPage);
+
+    // strings and byte arrays use the string entry type, with the given size
+    if (dType == flxTypeString)
+        return _pages[iPage]->setValueString(iNS, szKey, (const char *)value, valueSize);
+
+    return _pages[iPage]->setValue(iNS, dType, szKey, value, valueSize);
+}
+
+//----------------------------------------------------------
+// setMovedValue()
+//
+// Write a value to the current page. If the key is on another page, the new copy is written before the
+// old copy is deleted - if power is lost in between, removeStaleEntries() keeps the copy on the page with
+// the higher sequence. So the current page is given a higher sequence than the page the key is leaving.
+
+flxKVPError_t flxKVPStore::setMovedValue(int16_t iFrom, uint8_t iNS, flxDataType_t dType, const char *szKey,
+                                         const void *value, size_t valueSize)
+{
+    if (iFrom != kNullPage && iFrom != _currPage && _pages[_currPage]->sequence() <= _pages[iFrom]->sequence())
+    {
+        selectPage(_currPage);
+        flxKVPError_t retval = _pages[_currPage]->setSequence(++_sequence);
+        if (retval != kKVPErrorOK)
+            return retval;
+    }
+    return setPageValue(_currPage, iNS, dType, szKey, value, valueSize);
+}
+
+//----------------------------------------------------------
+// writeValue()
+//
+// If the key is on a page, the value is updated on that page. Otherwise, or if the update doesn't
+// fit, the value is written to the current page. If the current page is full, the next available
+// page is used, and if that fails, the current page is compacted.
+//
+// A value that moves to a new page is then deleted from the old page - there is one copy of a key.
+
+flxKVPError_t flxKVPStore::writeValue(uint8_t iNS, flxDataType_t dType, const char *szKey, const void *value,
+                                      size_t valueSize)
+{
+    if (_currPage == kNullPage || _pages.size() == 0)
+        return kKVPErrorPageFull;
+
+    int16_t iPage = findPage(iNS, szKey);
+
+    flxKVPError_t retval = kKVPErrorPageFull;
+
+    if (iPage != kNullPage)
+        retval = setPageValue(iPage, iNS, dType, szKey, value, valueSize);
+
+    if (retval != kKVPErrorPageFull)
+        return retval;
+
+    // the update didn't fit on its page, or this is a new key - if this is a new page for the key, check
+    // it's not full first
+    if (iPage != _currPage)
+        retval = setMovedValue(iPage, iNS, dType, szKey, value, valueSize);
+
+    if (retval == kKVPErrorPageFull && moveToFreePage())
+        retval = setMovedValue(iPage, iNS, dType, szKey, value, valueSize);
+
+    if (retval == kKVPErrorPageFull && compactPage(_currPage) == kKVPErrorOK)
+        retval = setMovedValue(iPage, iNS, dType, szKey, value, valueSize);
+
+    // the value has moved? Delete the old copy
+    if (retval == kKVPErrorOK && iPage != kNullPage && iPage != _currPage)
+    {
+        selectPage(iPage);
+        _pages[iPage]->deleteValue(iNS, szKey);
+    }
+
+    return retval;
+}
+
 //-----------------------------------------------------------
 // setValue
 flxKVPError_t flxKVPStore::setValue(uint8_t iNS, flxDataType_t dType, const char *szKey, const void *value,
@@ -229,58 +426,258 @@ flxKVPError_t flxKVPStore::setValue(uint8_t iNS, flxDataType_t dType, const char
     if (iNS < 1 || szKey == nullptr || strlen(szKey) < 2 || value == nullptr || valueSize == 0)
         return kKVPErrorBadParam;
 
-    if (_currPage == kNullPage || _pages.size() == 0)
-        return kKVPErrorPageFull;
+    // Typed string values are written with their length
+    if (dType == flxTypeString)
+        return setValueString(iNS, szKey, (const char *)value, strlen((const char *)value));
+
+    return writeValue(iNS, dType, szKey, value, valueSize);
+}
+
+//----------------------------------------------------------
+flxKVPError_t flxKVPStore::setValueString(uint8_t iNS, const char *szKey, const char *value, size_t valueSize)
+{
+    if (iNS < 1 || szKey == nullptr || strlen(szKey) < 2 || value == nullptr || valueSize == 0)
+        return kKVPErrorBadParam;
+
+    return writeValue(iNS, flxTypeString, szKey, value, valueSize);
+}
+
+//----------------------------------------------------------
+// Compaction
+//----------------------------------------------------------
+// compactPage()
+//
+// If there is an empty page, the live entries are copied to it. The copy is given the next sequence
+// number, the device is flushed and then the old page is erased. If this is interrupted, both pages
+// hold the entries and the older copies are removed at the next initialize().
+//
+// Without an empty page - which is the case for a single page store - the page is compacted in place.
+
+flxKVPError_t flxKVPStore::compactPage(int16_t iPage, bool bColdData /*=false*/)
+{
+    if (iPage == kNullPage || iPage >= (int16_t)_pages.size())
+        return kKVPErrorBadParam;
+
+    flxKVPStorePage *srcPage = _pages[iPage];
+
+    // an empty page to copy to?
+    int16_t iSpare = findSparePage(iPage, bColdData);
+
+    flxKVPError_t retval;
 
-    flxKVPError_t retval = _pages[_currPage]->setValue(iNS, dType, szKey, value, valueSize);
+    _nCompactions++;
 
-    // first attempt - multi tries here?
-    if (retval == kKVPErrorPageFull && _pages.size() > 1)
+    if (iSpare == kNullPage)
     {
-        if (moveToFreePage())
-            retval = _pages[_currPage]->setValue(iNS, dType, szKey, value, valueSize);
+        selectPage(iPage);
+        retval = srcPage->compact();
+        flush();
+        return retval;
     }
 
+    selectPage(iSpare);
+
+    flxKVPStorePage *spare = _pages[iSpare];
+    flxKVPStoreEntry theEntry;
+    uint32_t idxEntry = 0;
+
+    while (srcPage->nextEntry(idxEntry, theEntry) == kKVPErrorOK)
+    {
+        retval = spare->copyEntry(*srcPage, idxEntry, theEntry);
+        if (retval != kKVPErrorOK)
+            return retval;
+
+        idxEntry += theEntry.span == 0 ? 1 : theEntry.span;
+    }
+
+    // switch over - the copy is newer than any other page
+    retval = spare->setSequence(++_sequence);
+    if (retval != kKVPErrorOK)
+        return retval;
+
+    // the copy is written to flash before the old page is erased - in a transaction too
+    flush(true);
+    selectPage(iPage);
+
+    // Erase the old page - it's now the empty page
+    retval = srcPage->initPage(true);
+    flush();
+
+    if (_currPage == iPage)
+        _currPage = iSpare;
+
     return retval;
 }
 
 //----------------------------------------------------------
-flxKVPError_t flxKVPStore::setValueString(uint8_t iNS, const char *szKey, const char *value, size_t valueSize)
+int16_t flxKVPStore::findSparePage(int16_t iExclude, bool bMostWorn /*=false*/)
 {
-    if (iNS < 1 || szKey == nullptr || strlen(szKey) < 2 || value == nullptr || valueSize == 0)
-        return kKVPErrorBadParam;
+    int16_t iSpare = kNullPage;
 
-    if (_currPage == kNullPage || _pages.size() == 0 || _pages[_currPage]->status() != flxKVPPageStatus::kPageAvailable)
-        return kKVPErrorPageFull;
+    for (size_t i = 0; i < _pages.size(); i++)
+    {
+        if ((int16_t)i == iExclude || _pages[i]->status() != flxKVPPageStatus::kPageAvailable ||
+            _pages[i]->liveEntries() != 0)
+            continue;
+
+        if (iSpare == kNullPage || (bMostWorn ? _pages[i]->eraseCount() > _pages[iSpare]->eraseCount()
+                                              : _pages[i]->eraseCount() < _pages[iSpare]->eraseCount()))
+            iSpare = i;
+    }
+    return iSpare;
+}
+
+//----------------------------------------------------------
+// levelWear()
+//
+// Pages that hold frequently changed values are erased on most commits, while pages holding values that
+// don't change are not erased at all. To spread the erase cycles:
+//
+//  - Hot data: when the most worn page changed in this commit is wearLevelDelta cycles ahead of the least
+//    worn empty page, its entries are moved to that page. The worn page becomes an empty page.
+//  - Cold data: when the least worn page holds entries that haven't changed in the last wearLevelDelta
+//    commits, and the most worn empty page is wearLevelDelta cycles ahead of it, the entries are moved to
+//    the worn page - so the least worn page is used.
+//
+// At most one page is moved per call.
+
+void flxKVPStore::levelWear(void)
+{
+    if (_wearLevelDelta == 0 || _pages.size() < 2)
+        return;
+
+    int16_t iHot = kNullPage;
+    int16_t iCold = kNullPage;
+
+    for (size_t i = 0; i < _pages.size(); i++)
+    {
+        if (_pages[i]->liveEntries() == 0)
+            continue;
+
+        if (_pageCommit[i] == _nCommits)
+        {
+            if (iHot == kNullPage || _pages[i]->eraseCount() > _pages[iHot]->eraseCount())
+                iHot = i;
+        }
+        else if (_nCommits - _pageCommit[i] >= _wearLevelDelta &&
+                 (iCold == kNullPage || _pages[i]->eraseCount() < _pages[iCold]->eraseCount()))
+            iCold = i;
+    }
+
+    int16_t iSpare;
+
+    if (iHot != kNullPage)
+    {
+        iSpare = findSparePage(iHot);
+        if (iSpare != kNullPage && _pages[iHot]->eraseCount() >= _pages[iSpare]->eraseCount() + _wearLevelDelta)
+        {
+            if (compactPage(iHot) == kKVPErrorOK)
+                _nMigrations++;
+            return;
+        }
+    }
+
+    if (iCold == kNullPage)
+        return;
+
+    iSpare = findSparePage(iCold, true);
+    if (iSpare != kNullPage && _pages[iSpare]->eraseCount() >= _pages[iCold]->eraseCount() + _wearLevelDelta)
+    {
+        if (compactPage(iCold, true) == kKVPErrorOK)
+            _nMigrations++;
+    }
+}
+
+//----------------------------------------------------------
+void flxKVPStore::getWearStats(flxKVPWearStats_t &stats)
+{
+    stats.minEraseCount = 0;
+    stats.maxEraseCount = 0;
+    stats.totalEraseCount = 0;
+    stats.migrations = _nMigrations;
 
-    // TODO: Manage page availability
+    for (size_t i = 0; i < _pages.size(); i++)
+    {
+        uint32_t eraseCount = _pages[i]->eraseCount();
+
+        if (i == 0 || eraseCount < stats.minEraseCount)
+            stats.minEraseCount = eraseCount;
+        if (eraseCount > stats.maxEraseCount)
+            stats.maxEraseCount = eraseCount;
+        stats.totalEraseCount += eraseCount;
+    }
+}
 
-    flxKVPError_t retval = _pages[_currPage]->setValueString(iNS, szKey, value, valueSize);
+//----------------------------------------------------------
+flxKVPError_t flxKVPStore::compact(void)
+{
+    if (_pages.size() == 0 && initialize() != kKVPErrorOK)
+        return kKVPErrorConfig;
 
-    // first attempt - multi tries here?
-    if (retval == kKVPErrorPageFull && _pages.size() > 1)
+    // The pages to compact. A page compacted into an empty page leaves an empty page behind - so the
+    // set is taken first, and each page's entries are moved once.
+    std::vector<flxKVPStorePage *> toCompact;
+    for (auto thePage : _pages)
     {
-        if (moveToFreePage())
-            retval = _pages[_currPage]->setValueString(iNS, szKey, value, valueSize);
+        if (thePage->liveEntries() > 0)
+            toCompact.push_back(thePage);
     }
 
+    flxKVPError_t retval = kKVPErrorOK;
+
+    for (auto thePage : toCompact)
+    {
+        auto it = std::find(_pages.begin(), _pages.end(), thePage);
+
+        retval = compactPage(it - _pages.begin());
+        if (retval != kKVPErrorOK)
+            break;
+    }
     return retval;
 }
 
+//----------------------------------------------------------
+void flxKVPStore::removeStaleEntries(void)
+{
+    flxKVPStoreEntry theEntry;
+    uint32_t idxEntry;
+    bool bRemoved = false;
+
+    for (auto thePage : _pages)
+    {
+        idxEntry = 0;
+        while (thePage->nextEntry(idxEntry, theEntry) == kKVPErrorOK)
+        {
+            for (auto otherPage : _pages)
+            {
+                if (otherPage != thePage && otherPage->sequence() > thePage->sequence() &&
+                    otherPage->keyExists(theEntry.iNameSpace, theEntry.entryKey))
+                {
+                    thePage->deleteEntry(idxEntry);
+                    bRemoved = true;
+                    break;
+                }
+            }
+            idxEntry += theEntry.span == 0 ? 1 : theEntry.span;
+        }
+    }
+    if (bRemoved)
+        flush();
+}
+
 //----------------------------------------------------------
 flxKVPError_t flxKVPStore::getValue(uint8_t iNS, flxDataType_t dType, const char *szKey, void *value, size_t valueSize)
 {
     if (iNS < 1 || szKey == nullptr || strlen(szKey) < 2 || value == nullptr || valueSize == 0)
         return kKVPErrorBadParam;
 
-    // Serial.printf("getValue (1): NS: %u, %s\n\r", iNS , szKey);
+    // One indexed lookup per page - a page without the key returns no match
     for (auto thePage : _pages)
     {
-        // Serial.printf("keyExists: %d\n\r", (int)thePage->keyExists(iNS, szKey));
-        if (thePage->keyExists(iNS, szKey))
-            return thePage->readValue(iNS, dType, szKey, value, valueSize);
+        flxKVPError_t retval = thePage->readValue(iNS, dType, szKey, value, valueSize);
+        if (retval != kKVPErrorNoMatch)
+            return retval;
     }
-    // Serial.printf("getValue (2): %s\n\r", szKey);
     return kKVPErrorNoMatch;
 }
 //----------------------------------------------------------
@@ -289,13 +686,12 @@ flxKVPError_t flxKVPStore::deleteValue(uint8_t iNS, const char *szKey)
     if (iNS < 1 || szKey == nullptr || strlen(szKey) < 2)
         return kKVPErrorBadParam;
 
-    for (auto thePage : _pages)
-    {
-        if (thePage->keyExists(iNS, szKey))
-            return thePage->deleteValue(iNS, szKey);
-    }
+    int16_t iPage = findPage(iNS, szKey);
+    if (iPage == kNullPage)
+        return kKVPErrorNoMatch;
 
-    return kKVPErrorNoMatch;
+    selectPage(iPage);
+    return _pages[iPage]->deleteValue(iNS, szKey);
 }
 //----------------------------------------------------------
 bool flxKVPStore::keyExists(uint8_t iNS, const char *szKey)
@@ -312,11 +708,124 @@ bool flxKVPStore::keyExists(uint8_t iNS, const char *szKey)
 }
 
 //----------------------------------------------------------
+// Enumeration
+//----------------------------------------------------------
+bool flxKVPStore::nextNameSpace(size_t &iterator, uint8_t &iNS, const char *&szName)
+{
+    if (_pages.size() == 0 && initialize() != kKVPErrorOK)
+        return false;
+
+    if (iterator >= _namespaces.size())
+        return false;
+
+    iNS = _namespaces[iterator]->index;
+    szName = _namespaces[iterator]->name;
+    iterator++;
+
+    return true;
+}
+
+//----------------------------------------------------------
+const char *flxKVPStore::nameSpaceName(uint8_t iNS)
+{
+    for (auto pNSEntry : _namespaces)
+    {
+        if (pNSEntry->index == iNS)
+            return pNSEntry->name;
+    }
+    return nullptr;
+}
+
+//----------------------------------------------------------
+// The pages are walked in order, each entry read once. A key is on one page - a copy left on a second page
+// by an interrupted move or compaction is removed when the store is initialized.
+flxKVPError_t flxKVPStore::nextEntry(flxKVPStoreCursor &cursor, uint8_t iNS, flxKVPEntryInfo_t &info)
+{
+    if (_pages.size() == 0 && initialize() != kKVPErrorOK)
+        return kKVPErrorConfig;
+
+    flxKVPStoreEntry &theEntry = cursor._entry;
+
+    while (cursor._iPage < _pages.size())
+    {
+        flxKVPError_t retval = _pages[cursor._iPage]->nextEntry(cursor._iNext, theEntry);
+
+        if (retval == kKVPErrorIO)
+            return retval;
+
+        // end of the page - or a page that isn't in use
+        if (retval != kKVPErrorOK)
+        {
+            cursor._iPage++;
+            cursor._iNext = 0;
+            continue;
+        }
+
+        cursor._iEntry = cursor._iNext;
+        cursor._iNext += theEntry.span == 0 ? 1 : theEntry.span;
+
+        if (theEntry.iNameSpace == kKVPNameSpaceEntryNS || (iNS != kKVPAllNameSpaces && theEntry.iNameSpace != iNS))
+            continue;
+
+        info.iNameSpace = theEntry.iNameSpace;
+        theEntry.getKey(info.key, sizeof(info.key));
+        info.dataType = theEntry.dataType;
+
+        // the size of an integer type is in the low bits of the type
+        switch (theEntry.dataType)
+        {
+        case flxTypeString:
+            info.size = theEntry.dataLength.dataSize;
+            break;
+        case flxTypeBool:
+            info.size = sizeof(bool);
+            break;
+        case flxTypeFloat:
+            info.size = sizeof(float);
+            break;
+        case flxTypeDouble:
+            info.size = sizeof(double);
+            break;
+        default:
+            info.size = theEntry.dataType & 0x0F;
+            break;
+        }
+        return kKVPErrorOK;
+    }
+    return kKVPErrorNoMatch;
+}
+
+//----------------------------------------------------------
+flxKVPError_t flxKVPStore::readEntry(flxKVPStoreCursor &cursor, void *value, size_t valueSize)
+{
+    if (value == nullptr || valueSize == 0 || cursor._iPage >= _pages.size())
+        return kKVPErrorBadParam;
+
+    return _pages[cursor._iPage]->readEntryValue(cursor._iEntry, cursor._entry, value, valueSize);
+}
+
+//----------------------------------------------------------
+// Erase all pages. The namespaces were on the pages, so they're dropped too - getNameSpace() writes a new
+// record for a namespace used after the reset.
 void flxKVPStore::reset(void)
 {
     for (auto thePage : _pages)
     {
         // Reset the page - erase it and then re-init format
         thePage->initPage(true);
+        thePage->setSequence(0);
     }
+    flush();
+
+    for (auto pNSEntry : _namespaces)
+        delete pNSEntry;
+
+    _namespaces.clear();
+    _nsState.reset();
+    _nsState.set(0, true);
+
+    _sequence = 0;
+    _currPage = findSparePage(kNullPage);
+    if (_currPage == kNullPage && _pages.size() > 0)
+        _currPage = 0;
 }
\ No newline at end of file
@@ -29,14 +29,62 @@
 #include <bitset>
 #include <vector>
 
+//----------------------------------------------------------
+// Enumeration of the stored values
+
+// A value returned by flxKVPStore::nextEntry()
+typedef struct
+{
+    uint8_t iNameSpace;
+    char key[kKVPMaxKeyNameLength];
+    flxDataType_t dataType;
+    size_t size; // value size in bytes - for a string, the length without the null
+} flxKVPEntryInfo_t;
+
+class flxKVPStore;
+
+// The position of an enumeration. The values are returned in storage order, reading each page once.
+class flxKVPStoreCursor
+{
+  public:
+    flxKVPStoreCursor()
+    {
+        reset();
+    }
+
+    void reset(void)
+    {
+        _iPage = 0;
+        _iEntry = 0;
+        _iNext = 0;
+    }
+
+  private:
+    friend flxKVPStore;
+
+    uint16_t _iPage;
+    uint32_t _iEntry; // the entry last returned
+    uint32_t _iNext;  // where the search for the next entry starts
+    flxKVPStoreEntry _entry;
+};
+
 class flxKVPStore
 {
   public:
     static constexpr int16_t kNullPage = -1;
 
-    flxKVPStore() : _storageDevice{nullptr}, _currPage{kNullPage}
+    flxKVPStore()
+        : _storageDevice{nullptr}, _currPage{kNullPage}, _writePage{kNullPage}, _nCommits{1}, _inTransaction{false},
+          _sequence{0}, _nCompactions{0},
+          _nMigrations{0}, _wearLevelDelta{kKVPWearLevelDelta}
     {
     }
+    ~flxKVPStore();
+
+    // the store owns its pages and namespace entries
+    flxKVPStore(flxKVPStore const &) = delete;
+    void operator=(flxKVPStore const &) = delete;
+
     flxKVPError_t initialize(void);
 
     // get a storage handle/id - returns 0 on error
@@ -89,14 +137,63 @@ class flxKVPStore
 
     bool keyExists(uint8_t iNS, const char *szKey);
 
-    void commit(void)
+    //-----------------------------------------------------------------------
+    // Enumeration
+
+    // The namespaces - start with iterator at 0. Returns false after the last namespace.
+    bool nextNameSpace(size_t &iterator, uint8_t &iNS, const char *&szName);
+
+    // name of a namespace - nullptr if the index isn't in use
+    const char *nameSpaceName(uint8_t iNS);
+
+    // The values of a namespace, or of all namespaces (kKVPAllNameSpaces). Returns kKVPErrorNoMatch after the
+    // last value. The store shouldn't be changed during an enumeration.
+    flxKVPError_t nextEntry(flxKVPStoreCursor &cursor, uint8_t iNS, flxKVPEntryInfo_t &info);
+
+    // Read the value last returned by nextEntry() - strings are null terminated
+    flxKVPError_t readEntry(flxKVPStoreCursor &cursor, void *value, size_t valueSize);
+
+    // Transactions. After beginTransaction(), a device that buffers pages holds the changes in RAM, and each
+    // changed page is written to flash once - when commit() is called. Returns false if the device doesn't
+    // support transactions - changes are then written as they're made.
+    bool beginTransaction(void);
+    bool inTransaction(void)
+    {
+        return _inTransaction;
+    }
+
+    // Write changes to the storage device, ending a transaction - and then level page wear if needed. A commit
+    // with no changes doesn't write to the device.
+    void commit(void);
+
+    // erase cycles and time with interrupts disabled of the storage device
+    void getDeviceStats(flxKVPDeviceStats_t &stats)
     {
         if (_storageDevice)
-            _storageDevice->flush();
+            _storageDevice->getStats(stats);
+        else
+            memset(&stats, 0, sizeof(stats));
     }
 
     void reset(void);
 
+    // Reclaim space - compact all pages. This is also run on a page when a write doesn't fit.
+    flxKVPError_t compact(void);
+
+    // number of page compactions run
+    uint32_t compactions(void)
+    {
+        return _nCompactions;
+    }
+
+    // Wear leveling. Data is moved to another page when the erase counts of the pages differ by the given
+    // delta - 0 disables leveling.
+    void setWearLevelDelta(uint32_t delta)
+    {
+        _wearLevelDelta = delta;
+    }
+    void getWearStats(flxKVPWearStats_t &stats);
+
     void setStorageDevice(flxKVPStoreDevice *device)
     {
         _storageDevice = device;
@@ -106,12 +203,61 @@ class flxKVPStore
         setStorageDevice(&device);
     }
 
+    // RAM used by the page objects and their key indexes, namespace table and device buffers
+    size_t heapSize(void)
+    {
+        size_t size = _pages.capacity() * sizeof(flxKVPStorePage *) + _pages.size() * sizeof(flxKVPStorePage) +
+                      _namespaces.capacity() * sizeof(KVPNameSpaceEntry *) +
+                      _namespaces.size() * sizeof(KVPNameSpaceEntry) +
+                      (_storageDevice ? _storageDevice->bufferSize() : 0);
+
+        for (auto thePage : _pages)
+            size += thePage->heapSize();
+
+        return size;
+    }
+
   protected:
     flxKVPError_t getNameSpaceIndex(const char *szNS, uint8_t &outNSIndex);
 
   private:
     bool moveToFreePage(void);
 
+    // flush the device, and note the start of a new erase cycle for the pages. In a transaction, changes are
+    // held unless bSync is set.
+    void flush(bool bSync = false);
+
+    // switch the page being written - a device that buffers a page writes out the previous page. The page is
+    // noted as written in this commit.
+    void selectPage(int16_t iPage);
+
+    // an empty page - the least worn, or the most worn - kNullPage if there are none
+    int16_t findSparePage(int16_t iExclude, bool bMostWorn = false);
+
+    // compact a page - into an empty page if one is available, otherwise in place. Cold (unchanging) data is
+    // moved to the most worn empty page.
+    flxKVPError_t compactPage(int16_t iPage, bool bColdData = false);
+
+    // move hot or cold data to balance the erase counts of the pages
+    void levelWear(void);
+
+    // after an interrupted move or compaction, the same key can be on two pages - remove the older copy
+    void removeStaleEntries(void);
+
+    // the page holding a key - kNullPage if not found
+    int16_t findPage(uint8_t iNS, const char *szKey);
+
+    // write a value to a page - strings (and byte arrays) and typed values
+    flxKVPError_t setPageValue(int16_t iPage, uint8_t iNS, flxDataType_t dType, const char *szKey, const void *value,
+                               size_t valueSize);
+
+    // write a value to the current page - the page is made newer than the page the key is moving from
+    flxKVPError_t setMovedValue(int16_t iFrom, uint8_t iNS, flxDataType_t dType, const char *szKey,
+                                const void *value, size_t valueSize);
+
+    // set a value - update the page it's on, or write it to the current page, making room if needed
+    flxKVPError_t writeValue(uint8_t iNS, flxDataType_t dType, const char *szKey, const void *value, size_t valueSize);
+
     flxKVPError_t checkNameSpaces(void);
 
     // setValue
@@ -131,6 +277,21 @@ class flxKVPStore
 
     int16_t _currPage;
 
+    // the last page written, and the commit each page was last written in
+    int16_t _writePage;
+    std::vector<uint32_t> _pageCommit;
+    uint32_t _nCommits;
+
+    bool _inTransaction;
+
+    // the highest page sequence number
+    uint32_t _sequence;
+
+    uint32_t _nCompactions;
+    uint32_t _nMigrations;
+
+    uint32_t _wearLevelDelta;
+
     std::vector<flxKVPStorePage *> _pages;
     std::vector<KVPNameSpaceEntry *> _namespaces;
     std::bitset<256> _nsState;
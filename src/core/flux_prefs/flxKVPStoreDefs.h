@@ -54,5 +54,20 @@ enum flxKVPError_t : std::int8_t
 
 const uint8_t kKVPNameSpaceEntryNS = 0;
 
+// Enumerate the values of all namespaces - the namespace table isn't enumerated as values
+const uint8_t kKVPAllNameSpaces = kKVPNameSpaceEntryNS;
+
 // Maximum length of a key name
-const size_t kKVPMaxKeyNameLength = 16;
\ No newline at end of file
+const size_t kKVPMaxKeyNameLength = 16;
+
+// Wear leveling - the data on a page is moved when the page's erase count is this far from an empty page
+const uint32_t kKVPWearLevelDelta = 32;
+
+// Wear statistics for the pages of a store
+typedef struct
+{
+    uint32_t minEraseCount;   // erase cycles of the least worn page
+    uint32_t maxEraseCount;   // erase cycles of the most worn page
+    uint32_t totalEraseCount; // erase cycles of all pages
+    uint32_t migrations;      // pages moved to level wear
+} flxKVPWearStats_t;
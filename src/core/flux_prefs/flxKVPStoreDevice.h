@@ -23,6 +23,15 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+
+// Device statistics
+typedef struct
+{
+    uint32_t erases;           // sector erase/program cycles
+    uint32_t interruptsOff;    // total time interrupts were disabled to program flash - microseconds
+    uint32_t maxInterruptsOff; // the longest time interrupts were disabled - microseconds
+} flxKVPDeviceStats_t;
 
 // Define our device interface
 class flxKVPStoreDevice
@@ -41,4 +50,26 @@ class flxKVPStoreDevice
 
     virtual uint32_t storageSize() = 0;
     virtual uint32_t segmentSize() = 0;
+
+    // RAM used by the device to buffer page data
+    virtual size_t bufferSize(void)
+    {
+        return 0;
+    }
+
+    // Transactions - a device that buffers pages holds the changes made in a transaction, and writes each
+    // changed page once when the transaction ends. Returns false if the device doesn't support transactions.
+    virtual bool beginTransaction(void)
+    {
+        return false;
+    }
+    virtual void endTransaction(void)
+    {
+        flush();
+    }
+
+    virtual void getStats(flxKVPDeviceStats_t &stats)
+    {
+        memset(&stats, 0, sizeof(stats));
+    }
 };
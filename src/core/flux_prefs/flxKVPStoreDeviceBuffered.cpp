@@ -0,0 +1,244 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxKVPStoreDeviceBuffered.h"
+
+//----------------------------------------------------------
+flxKVPStoreDeviceBuffered::flxKVPStoreDeviceBuffered() : _nChanges{0}, _inTransaction{false}
+{
+    for (auto &theBuffer : _buffers)
+        theBuffer = {kNoSector, nullptr, 0};
+
+    resetStats();
+}
+
+flxKVPStoreDeviceBuffered::~flxKVPStoreDeviceBuffered()
+{
+    freeBuffers(0);
+}
+
+//----------------------------------------------------------
+flxKVPStoreDeviceBuffered::sectorBuffer_t *flxKVPStoreDeviceBuffered::findBuffer(uint32_t iSector)
+{
+    for (auto &theBuffer : _buffers)
+    {
+        if (theBuffer.sector == iSector && theBuffer.data != nullptr)
+            return &theBuffer;
+    }
+    return nullptr;
+}
+
+//----------------------------------------------------------
+// Outside of a transaction the first buffer is used - the sector in it is written out first. In a
+// transaction, a free buffer is used, or the buffer changed first is written out and reused.
+
+flxKVPStoreDeviceBuffered::sectorBuffer_t *flxKVPStoreDeviceBuffered::loadBuffer(uint32_t iSector)
+{
+    sectorBuffer_t *pBuffer = findBuffer(iSector);
+    if (pBuffer != nullptr)
+        return pBuffer;
+
+    const uint8_t *pFlash = sectorData(iSector);
+    if (pFlash == nullptr)
+        return nullptr;
+
+    pBuffer = &_buffers[0];
+
+    if (_inTransaction)
+    {
+        for (auto &theBuffer : _buffers)
+        {
+            if (theBuffer.sector == kNoSector)
+            {
+                pBuffer = &theBuffer;
+                break;
+            }
+            if (theBuffer.changed < pBuffer->changed)
+                pBuffer = &theBuffer;
+        }
+    }
+    writeBuffer(*pBuffer);
+
+    if (pBuffer->data == nullptr)
+    {
+        pBuffer->data = new uint8_t[segmentSize()];
+        if (pBuffer->data == nullptr)
+            return nullptr;
+    }
+
+    // the current contents of flash for this sector
+    memcpy(pBuffer->data, pFlash, segmentSize());
+    pBuffer->sector = iSector;
+    pBuffer->changed = 0;
+
+    return pBuffer;
+}
+
+//----------------------------------------------------------
+void flxKVPStoreDeviceBuffered::writeBuffer(sectorBuffer_t &theBuffer)
+{
+    if (theBuffer.changed == 0 || theBuffer.sector == kNoSector || theBuffer.data == nullptr)
+        return;
+
+    uint32_t usInterruptsOff = 0;
+
+    if (programSector(theBuffer.sector, theBuffer.data, usInterruptsOff))
+    {
+        _stats.erases++;
+        _stats.interruptsOff += usInterruptsOff;
+        if (usInterruptsOff > _stats.maxInterruptsOff)
+            _stats.maxInterruptsOff = usInterruptsOff;
+    }
+    theBuffer.changed = 0;
+}
+
+//----------------------------------------------------------
+// Write out the changed buffers - in the order they were changed
+void flxKVPStoreDeviceBuffered::writeBuffers(void)
+{
+    sectorBuffer_t *pNext;
+
+    do
+    {
+        pNext = nullptr;
+        for (auto &theBuffer : _buffers)
+        {
+            if (theBuffer.changed != 0 && (pNext == nullptr || theBuffer.changed < pNext->changed))
+                pNext = &theBuffer;
+        }
+        if (pNext != nullptr)
+            writeBuffer(*pNext);
+
+    } while (pNext != nullptr);
+
+    _nChanges = 0;
+}
+
+//----------------------------------------------------------
+void flxKVPStoreDeviceBuffered::freeBuffers(uint8_t nKeep)
+{
+    for (uint8_t i = nKeep; i < kMaxTransactionSectors; i++)
+    {
+        if (_buffers[i].data != nullptr)
+            delete[] _buffers[i].data;
+
+        _buffers[i] = {kNoSector, nullptr, 0};
+    }
+}
+
+//----------------------------------------------------------
+bool flxKVPStoreDeviceBuffered::write(uint32_t iPage, uint32_t address, const void *src, size_t len)
+{
+    if (!src || len == 0 || address + len > segmentSize())
+        return false;
+
+    sectorBuffer_t *pBuffer = loadBuffer(iPage);
+    if (pBuffer == nullptr)
+        return false;
+
+    memcpy(pBuffer->data + address, src, len);
+
+    if (pBuffer->changed == 0)
+        pBuffer->changed = ++_nChanges;
+
+    return true;
+}
+
+//----------------------------------------------------------
+bool flxKVPStoreDeviceBuffered::read(uint32_t iPage, uint32_t address, void *dest, size_t len)
+{
+    if (!dest || len == 0 || address + len > segmentSize())
+        return false;
+
+    // Only a buffered sector can differ from flash
+    sectorBuffer_t *pBuffer = findBuffer(iPage);
+    const uint8_t *pData = pBuffer != nullptr ? pBuffer->data : sectorData(iPage);
+
+    if (pData == nullptr)
+        return false;
+
+    memcpy(dest, pData + address, len);
+
+    return true;
+}
+
+//----------------------------------------------------------
+bool flxKVPStoreDeviceBuffered::erase(uint32_t iPage)
+{
+    sectorBuffer_t *pBuffer = loadBuffer(iPage);
+    if (pBuffer == nullptr)
+        return false;
+
+    memset(pBuffer->data, 0xFF, segmentSize());
+
+    if (pBuffer->changed == 0)
+        pBuffer->changed = ++_nChanges;
+
+    return true;
+}
+
+//----------------------------------------------------------
+// In a transaction, the changes are held until the transaction ends
+void flxKVPStoreDeviceBuffered::flush(void)
+{
+    if (!_inTransaction)
+        writeBuffers();
+}
+
+//----------------------------------------------------------
+void flxKVPStoreDeviceBuffered::close(void)
+{
+    _inTransaction = false;
+    writeBuffers();
+    freeBuffers(0);
+}
+
+//----------------------------------------------------------
+size_t flxKVPStoreDeviceBuffered::bufferSize(void)
+{
+    // buffers are allocated on first use
+    size_t size = 0;
+    for (auto &theBuffer : _buffers)
+    {
+        if (theBuffer.data != nullptr)
+            size += segmentSize();
+    }
+    return size;
+}
+
+//----------------------------------------------------------
+bool flxKVPStoreDeviceBuffered::beginTransaction(void)
+{
+    _inTransaction = true;
+    return true;
+}
+
+//----------------------------------------------------------
+// Write out the changed sectors - and release the buffers that are only used in a transaction
+void flxKVPStoreDeviceBuffered::endTransaction(void)
+{
+    _inTransaction = false;
+    writeBuffers();
+
+    // keep the first buffer - make sure it holds a sector
+    if (_buffers[0].data == nullptr)
+    {
+        for (uint8_t i = 1; i < kMaxTransactionSectors; i++)
+        {
+            if (_buffers[i].data != nullptr)
+            {
+                _buffers[0] = _buffers[i];
+                _buffers[i] = {kNoSector, nullptr, 0};
+                break;
+            }
+        }
+    }
+    freeBuffers(1);
+}
@@ -0,0 +1,100 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+//----------------------------------------------------------
+// A Key-Value-Pair Storage system
+//
+// flxKVPStoreDeviceBuffered - a device for flash that is written a sector at a time, and is read through a
+// memory mapping (the RP2 XIP flash).
+//
+// Sectors being changed are buffered in RAM. When a buffer is written out, the sector is erased and
+// programmed - which takes a sector erase time, with interrupts disabled on the RP2.
+//
+// Outside of a transaction, one sector is buffered - it's written out when the device is flushed, or
+// when a write moves to another sector. In a transaction, up to kMaxTransactionSectors sectors are
+// buffered, and each changed sector is written out once when the transaction ends, in the order the
+// sectors were first changed.
+//
+// Reads of a sector that isn't buffered come from the flash mapping, so they don't write out a buffer.
+//----------------------------------------------------------
+
+#pragma once
+
+#include "flxKVPStoreDevice.h"
+
+class flxKVPStoreDeviceBuffered : public flxKVPStoreDevice
+{
+  public:
+    // the most sectors held in RAM during a transaction
+    static constexpr uint8_t kMaxTransactionSectors = 4;
+
+    flxKVPStoreDeviceBuffered();
+    virtual ~flxKVPStoreDeviceBuffered();
+
+    bool write(uint32_t iPage, uint32_t address, const void *src, size_t len);
+    bool read(uint32_t iPage, uint32_t address, void *dest, size_t len);
+    bool erase(uint32_t iPage);
+
+    void flush(void);
+    void close(void);
+
+    size_t bufferSize(void);
+
+    bool beginTransaction(void);
+    void endTransaction(void);
+
+    bool inTransaction(void)
+    {
+        return _inTransaction;
+    }
+
+    void getStats(flxKVPDeviceStats_t &stats)
+    {
+        stats = _stats;
+    }
+    void resetStats(void)
+    {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+
+  protected:
+    // The flash contents of a sector - nullptr if the sector isn't valid
+    virtual const uint8_t *sectorData(uint32_t iSector) = 0;
+
+    // Erase and program a sector. usInterruptsOff is set to the time interrupts were disabled.
+    virtual bool programSector(uint32_t iSector, const uint8_t *data, uint32_t &usInterruptsOff) = 0;
+
+  private:
+    static constexpr uint32_t kNoSector = 0xFFFFFFFF;
+
+    typedef struct
+    {
+        uint32_t sector;
+        uint8_t *data;
+        uint32_t changed; // when the buffer was first changed - 0 if it's not changed
+    } sectorBuffer_t;
+
+    // the buffer holding a sector - nullptr if the sector isn't buffered
+    sectorBuffer_t *findBuffer(uint32_t iSector);
+
+    // buffer a sector for a change - writing out another buffer if needed
+    sectorBuffer_t *loadBuffer(uint32_t iSector);
+
+    void writeBuffer(sectorBuffer_t &theBuffer);
+    void writeBuffers(void);
+    void freeBuffers(uint8_t nKeep);
+
+    sectorBuffer_t _buffers[kMaxTransactionSectors];
+
+    uint32_t _nChanges;
+    bool _inTransaction;
+
+    flxKVPDeviceStats_t _stats;
+};
@@ -23,6 +23,8 @@
 #include "flxKVPStoreDefs.h"
 #include "flxUtils.h"
 
+#include <algorithm>
+
 //
 uint32_t flxKVPStorePage::flxKVPStorePageHeader::calculateCRC32() const
 {
@@ -39,7 +41,7 @@ uint32_t flxKVPStorePage::flxKVPStorePageHeader::calculateCRC32() const
 
 flxKVPStorePage::flxKVPStorePage()
     : _pageStatus{flxKVPPageStatus::kPageInvalid}, _pageSector{kNoSector}, _pageBaseAddress{0}, _pStorage{nullptr},
-      _entryState{0}, _lastEmptyEntry{0}
+      _entryState{0}, _lastEmptyEntry{0}, _sequence{0}, _eraseCount{0}, _bModified{false}
 {
 }
 
@@ -60,7 +62,8 @@ bool flxKVPStorePage::initialize(flxKVPStoreDevice *theDevice, uint32_t sectorNu
 
     _pageSector = sectorNumber;
 
-    _pageBaseAddress = kSectorSize * sectorNumber;
+    // device addresses are relative to the start of the page
+    _pageBaseAddress = 0;
 
     _lastEmptyEntry = 0;
 
@@ -85,10 +88,19 @@ flxKVPError_t flxKVPStorePage::updatePageStatus(flxKVPPageStatus newStatus, bool
     if (!_pStorage)
         return flxKVPError_t::kKVPErrorConfig;
 
+    // first change since the last flush - a new erase cycle for the sector
+    if (!_bModified)
+    {
+        _bModified = true;
+        _eraseCount++;
+    }
+
     flxKVPStorePageHeader theHeader;
     theHeader.status = _pageStatus;
     theHeader.number = _pageSector;
     theHeader.version = kKVPStoreVersion;
+    theHeader.sequence = _sequence;
+    theHeader.eraseCount = _eraseCount;
     theHeader.crc32 = theHeader.calculateCRC32();
 
     if (!_pStorage->write(_pageSector, _pageBaseAddress, &theHeader, sizeof(flxKVPStorePageHeader)))
@@ -103,7 +115,9 @@ flxKVPError_t flxKVPStorePage::updatePageStatus(flxKVPPageStatus newStatus, bool
 
 //---------------------------------------------
 /**
- * @brief Initialize the page AND write init values to flash
+ * @brief Initialize the page AND write init values to the storage device
+ *
+ * The device isn't flushed - the store does that, so a transaction writes the page once.
  *
  * @param bErase if true, erase the page - defaults to false
  * @return flxKVPError_t kKVPErrorOK if success
@@ -129,19 +143,14 @@ flxKVPError_t flxKVPStorePage::initPage(bool bErase /*=false*/)
 
     // Write out the entry state table.
     memset(_entryState, static_cast<uint8_t>(entryStateT::entryEmpty), sizeof(_entryState));
+    _index.clear();
 
-    bool bStatus = _pStorage->write(_pageSector, _pageBaseAddress + flxKVPStoreEntry::kEntrySize, _entryState,
-                                    sizeof(_entryState));
-
-    if (!bStatus)
+    if (!writeEntryStates())
     {
         _pageStatus = flxKVPPageStatus::kPageInvalid;
         return kKVPErrorIO;
     }
 
-    // commit our header changes
-    _pStorage->flush();
-
     return kKVPErrorOK;
 }
 //---------------------------------------------
@@ -186,13 +195,22 @@ flxKVPError_t flxKVPStorePage::loadPage(void)
 
     if (bNeedsInit)
     {
-        // if we are here, we need to init the page
+        // if we are here, we need to init the page - the erase count of a page without a valid header
+        // isn't known, it starts over
+        _sequence = 0;
+        _eraseCount = 0;
         if (initPage() != kKVPErrorOK)
             return kKVPErrorIO;
     }
     else
+    {
         _pageStatus = theHeader.status;
 
+        // pages written before sequence numbers were added have an erased sequence field
+        _sequence = theHeader.sequence == 0xFFFFFFFF ? 0 : theHeader.sequence;
+        _eraseCount = theHeader.eraseCount == 0xFFFFFFFF ? 0 : theHeader.eraseCount;
+    }
+
     // need to load in the entry status table.
     bStatus =
         _pStorage->read(_pageSector, _pageBaseAddress + flxKVPStoreEntry::kEntrySize, _entryState, sizeof(_entryState));
@@ -203,6 +221,18 @@ flxKVPError_t flxKVPStorePage::loadPage(void)
         // TODO: -- Should we erase the page at this point - OR rebuild the entry table -- don't like rebuild
     }
 
+    // Build the key index - one pass over the written entries
+    _index.clear();
+
+    flxKVPStoreEntry theEntry;
+    uint32_t idxEntry = 0;
+
+    while (nextEntry(idxEntry, theEntry) == kKVPErrorOK)
+    {
+        indexAdd(theEntry, idxEntry);
+        idxEntry += theEntry.span == 0 ? 1 : theEntry.span;
+    }
+
     return kKVPErrorOK;
 }
 
@@ -212,8 +242,9 @@ flxKVPError_t flxKVPStorePage::loadPage(void)
  *
  * This function searches for the next free entry in the flash page's index table.
  * It starts searching from the last empty entry and returns the index of the first
- * free entry it finds. If no free entry is found, it marks the page as full and
- * returns the value flxFPSEntry::kEntryInvalid.
+ * free entry it finds. If no free entry is found, returns the value flxFPSEntry::kEntryInvalid.
+ * The page is only marked as full if there are no free entries - a run for a large span
+ * can be made available by compacting the page.
  *
  * @return The index of the next free entry, or flxFPSEntry::kEntryInvalid if the page is full.
  */
@@ -221,6 +252,7 @@ uint32_t flxKVPStorePage::getNextFreeEntry(uint8_t span)
 {
     // blast through our index table and find a free entry that can support the span
     uint32_t idx = flxKVPStoreEntry::kEntryInvalid;
+    uint32_t nFree = 0;
 
     for (uint32_t nEmpty = 0, i = 0; i < kNEntriesPerPage; i++)
     {
@@ -233,13 +265,15 @@ uint32_t flxKVPStorePage::getNextFreeEntry(uint8_t span)
             //  Increment the empty count. If we have enough empty entries, return the index
             if (++nEmpty == span)
                 return idx;
+            nFree++;
         }
         else
             nEmpty = 0;
     }
 
-    // if we are here, we are full
-    updatePageStatus(flxKVPPageStatus::kPageFull);
+    // if we are here, we are full - or too fragmented for this span
+    if (nFree == 0)
+        updatePageStatus(flxKVPPageStatus::kPageFull);
 
     return flxKVPStoreEntry::kEntryInvalid;
 }
@@ -256,9 +290,12 @@ uint32_t flxKVPStorePage::getNextFreeEntry(uint8_t span)
  */
 flxKVPError_t flxKVPStorePage::writeEntry(const flxKVPStoreEntry &theEntry)
 {
-    if (!_pStorage || _pageStatus == flxKVPPageStatus::kPageFull)
+    if (!_pStorage)
         return kKVPErrorConfig;
 
+    if (_pageStatus == flxKVPPageStatus::kPageFull)
+        return kKVPErrorPageFull;
+
     uint32_t index = getNextFreeEntry();
 
     if (index == flxKVPStoreEntry::kEntryInvalid)
@@ -317,14 +354,18 @@ flxKVPError_t flxKVPStorePage::updateEntry(uint32_t index, const flxKVPStoreEntr
 
     uint32_t address = _pageBaseAddress + (index + kNBookKeepingEntries) * flxKVPStoreEntry::kEntrySize;
 
-    bool bStatus = _pStorage->write(_pageSector, address, &theEntry, sizeof(theEntry));
+    bool bStatus = writeData(address, &theEntry, sizeof(theEntry));
 
     // if success, update the status in the entry table
     if (bStatus)
     {
-        for (uint8_t i = 0; i < theEntry.span; i++)
-            setEntryState(index + i, entryStateT::entryWritten);
+        // mark the entry and its data records, then write the state table once
+        for (uint8_t i = 0; i < theEntry.span && index + i < kNEntriesPerPage; i++)
+            markEntryState(index + i, entryStateT::entryWritten);
+        bStatus = writeEntryStates();
         _lastEmptyEntry = index + theEntry.span;
+
+        indexAdd(theEntry, index);
     }
     // return status code based on bool from write.
     return bStatus ? kKVPErrorOK : kKVPErrorIO;
@@ -360,7 +401,39 @@ flxKVPError_t flxKVPStorePage::findEntry(uint8_t iNS, const char *szKey, flxKVPS
     if (entryIndex >= kNEntriesPerPage)
         return kKVPErrorInvalidIndex;
 
-    // TODO: Optimize the start point for this search
+    // A key lookup from the start of the page uses the index - only the entries with a matching hash
+    // are read from the device.
+    if (szKey != nullptr && entryIndex == 0)
+    {
+        uint32_t hash = keyHash(iNS, szKey);
+        auto it = std::lower_bound(_index.begin(), _index.end(), hash,
+                                   [](const flxKVPIndexRecord &rec, uint32_t value) { return rec.hash < value; });
+
+        for (; it != _index.end() && it->hash == hash; it++)
+        {
+            uint32_t i = it->index;
+
+            flxKVPError_t retval = readEntry(i, theEntry);
+            if (retval == kKVPErrorIO)
+                return kKVPErrorIO;
+            else if (retval != kKVPErrorOK)
+                continue;
+
+            if (theEntry.crc32 != theEntry.calculateCRC32())
+            {
+                // Delete this entry - it's corrupt. This changes the index, so search again
+                deleteEntry(i);
+                return findEntry(iNS, szKey, theEntry, entryIndex);
+            }
+
+            if (iNS == theEntry.iNameSpace && strncmp(szKey, theEntry.entryKey, flxKVPStoreEntry::kMaxKeyLength) == 0)
+            {
+                entryIndex = i;
+                return kKVPErrorOK;
+            }
+        }
+        return kKVPErrorNoMatch;
+    }
 
     uint32_t inc = 0;
 
@@ -431,12 +504,21 @@ flxKVPError_t flxKVPStorePage::deleteEntry(uint32_t index)
     // deal with the span of the entry
     uint32_t nErase = theEntry.span;
 
-    for (uint32_t i = 0; i < nErase; i++)
-        (void)setEntryState(index + i, entryStateT::entryEmpty);
+    for (uint32_t i = 0; i < nErase && index + i < kNEntriesPerPage; i++)
+        markEntryState(index + i, entryStateT::entryEmpty);
+
+    indexRemove(index);
+
+    if (!writeEntryStates())
+        return kKVPErrorIO;
 
     if (index < _lastEmptyEntry)
         _lastEmptyEntry = index;
 
+    // space is available again
+    if (_pageStatus == flxKVPPageStatus::kPageFull)
+        return updatePageStatus(flxKVPPageStatus::kPageAvailable);
+
     return kKVPErrorOK;
 }
 //--------------------------------------------------------------
@@ -476,21 +558,51 @@ flxKVPError_t flxKVPStorePage::setValueString(uint8_t iNS, const char *szKey, co
     // room on this page for the string?
     if (itExists == kKVPErrorOK)
     {
-        // no changes in type/value?
-        if (theEntry.dataLength.dataSize == valueSize)
+        // no changes in type/value? The data CRC is checked first, then the stored data
+        if (theEntry.dataLength.dataSize == valueSize &&
+            theEntry.dataLength.dataCRC32 ==
+                flxKVPStoreEntry::calculateCRC32(reinterpret_cast<const uint8_t *>(value), valueSize))
         {
             // If the value is the same, return kKVPErrorOK
-            uint32_t address = _pageBaseAddress + (idxEntry + kNBookKeepingEntries + 1) * flxKVPStoreEntry::kEntrySize;
-            if (memcmp(value, (char *)address, valueSize) == 0)
+            uint8_t record[flxKVPStoreEntry::kEntrySize];
+            size_t nCompared = 0;
+            for (uint32_t i = idxEntry + 1; nCompared < valueSize; i++)
+            {
+                size_t nRecord = std::min(valueSize - nCompared, (size_t)flxKVPStoreEntry::kEntrySize);
+                if (!readRecord(i, record) || memcmp(value + nCompared, record, nRecord) != 0)
+                    break;
+                nCompared += nRecord;
+            }
+            if (nCompared == valueSize)
                 return kKVPErrorOK;
         }
 
-        // if the current span length being used is less than needed, delete the entry. A new one is needed.
+        // if the current span length being used is less than needed, a new entry is needed. The old entry
+        // is only deleted once there's room for the new one - if the page is full, the value is written to
+        // another page and the old entry must still be on flash if power is lost before that's written.
+        //
+        // The space of the old entry can be used - the storage device buffers the page, so the delete and
+        // the new entry are programmed together.
         if (theEntry.span < newSpan)
         {
-            // We can't reuse and need to expand - delete and retreat
+            uint32_t idxNew = getNextFreeEntry(newSpan);
+            if (idxNew == flxKVPStoreEntry::kEntryInvalid)
+            {
+                for (uint32_t i = 0; i < theEntry.span; i++)
+                    markEntryState(idxEntry + i, entryStateT::entryEmpty);
+
+                idxNew = getNextFreeEntry(newSpan);
+
+                for (uint32_t i = 0; i < theEntry.span; i++)
+                    markEntryState(idxEntry + i, entryStateT::entryWritten);
+
+                if (idxNew == flxKVPStoreEntry::kEntryInvalid)
+                    return kKVPErrorPageFull;
+            }
+
             deleteEntry(idxEntry);
-            itExists = kKVPErrorGeneric; // force a new entry later in method
+            idxEntry = idxNew;
+            theEntry = flxKVPStoreEntry(iNS, flxTypeString, newSpan, szKey);
         }
         else if (theEntry.span > newSpan)
         {
@@ -527,7 +639,7 @@ flxKVPError_t flxKVPStorePage::setValueString(uint8_t iNS, const char *szKey, co
 
     // now write out the string data
     uint32_t address = _pageBaseAddress + (idxEntry + kNBookKeepingEntries + 1) * flxKVPStoreEntry::kEntrySize;
-    return _pStorage->write(_pageSector, address, uiValue, valueSize) ? kKVPErrorOK : kKVPErrorIO;
+    return writeData(address, uiValue, valueSize) ? kKVPErrorOK : kKVPErrorIO;
 }
 
 //--------------------------------------------------------------
@@ -605,7 +717,27 @@ flxKVPError_t flxKVPStorePage::readValue(uint8_t iNS, flxDataType_t dType, const
     if (dType != theEntry.dataType)
         return kKVPErrorBadType;
 
-    if (dType == flxTypeString)
+    return readEntryValue(idxEntry, theEntry, value, valueSize);
+}
+
+//---------------------------------------------
+/**
+ * @brief Reads the value of an entry - as returned by findEntry() or nextEntry().
+ *
+ * A string is null terminated, so the buffer must have room for the null. A typed value is copied from the
+ * entry.
+ *
+ * @param idxEntry The index of the entry
+ * @param theEntry The entry
+ * @param value Pointer to the buffer where the value will be stored.
+ * @param valueSize The size of the buffer.
+ * @return kKVPErrorOK on success, kKVPErrorBuffer if the buffer is too small, kKVPErrorIO on a device error
+ * or kKVPErrorCorrupt if the data is corrupt.
+ */
+flxKVPError_t flxKVPStorePage::readEntryValue(uint32_t idxEntry, const flxKVPStoreEntry &theEntry, void *value,
+                                              size_t valueSize)
+{
+    if (theEntry.dataType == flxTypeString)
     {
         //// Serial.printf("Sizes: %d, %d \n\r", valueSize, theEntry.dataLength.dataSize);
         if (valueSize < (size_t)theEntry.dataLength.dataSize + 1)
@@ -627,7 +759,7 @@ flxKVPError_t flxKVPStorePage::readValue(uint8_t iNS, flxDataType_t dType, const
             return kKVPErrorCorrupt;
     }
     else
-        memcpy(value, theEntry.data, valueSize);
+        memcpy(value, theEntry.data, std::min(valueSize, sizeof(theEntry.data)));
 
     return kKVPErrorOK;
 }
@@ -669,6 +801,225 @@ bool flxKVPStorePage::keyExists(uint8_t iNS, const char *szKey)
     // Serial.printf("Checking for key: %s\n\r", szKey);
     return findEntry(iNS, szKey, theEntry) == kKVPErrorOK;
 }
+//---------------------------------------------
+/**
+ * @brief Returns the next valid entry in the page, starting at the given index.
+ *
+ * Entries with a bad CRC are deleted and skipped.
+ *
+ * @param[in,out] entryIndex Input: the index to start at, returns the index of the entry found.
+ * @param theEntry The entry found.
+ * @return kKVPErrorOK if an entry is found, kKVPErrorNoMatch at the end of the page, or kKVPErrorIO on a read error.
+ */
+flxKVPError_t flxKVPStorePage::nextEntry(uint32_t &entryIndex, flxKVPStoreEntry &theEntry)
+{
+    if (!_pStorage || _pageStatus == flxKVPPageStatus::kPageUninitialized ||
+        _pageStatus == flxKVPPageStatus::kPageInvalid)
+        return kKVPErrorConfig;
+
+    uint32_t inc = 0;
+
+    for (uint32_t i = entryIndex; i < kNEntriesPerPage; i += inc)
+    {
+        inc = 1;
+
+        if (entryState(i) != entryStateT::entryWritten)
+            continue;
+
+        if (readEntry(i, theEntry) != kKVPErrorOK)
+            return kKVPErrorIO;
+
+        if (theEntry.crc32 != theEntry.calculateCRC32())
+        {
+            deleteEntry(i);
+            continue;
+        }
+        entryIndex = i;
+        return kKVPErrorOK;
+    }
+    return kKVPErrorNoMatch;
+}
+
+//---------------------------------------------
+/**
+ * @brief Sets the sequence number of the page and writes it to the page header.
+ *
+ * @param sequence The new sequence number
+ * @return kKVPErrorOK on success
+ */
+flxKVPError_t flxKVPStorePage::setSequence(uint32_t sequence)
+{
+    _sequence = sequence;
+    return updatePageStatus(_pageStatus, true);
+}
+
+//---------------------------------------------
+/**
+ * @brief Returns the number of written entries in the page - including string data records.
+ */
+uint32_t flxKVPStorePage::liveEntries(void)
+{
+    uint32_t nLive = 0;
+    for (uint32_t i = 0; i < kNEntriesPerPage; i++)
+    {
+        if (entryState(i) == entryStateT::entryWritten)
+            nLive++;
+    }
+    return nLive;
+}
+
+//---------------------------------------------
+/**
+ * @brief Compacts the page in place.
+ *
+ * Live entries are moved down to close the gaps left by deleted and resized entries, in order, so a
+ * record is never overwritten before it's moved. Corrupt entries are dropped. The entry state table and
+ * the page header are written once, when the move is complete.
+ *
+ * This isn't power-fail safe on a device that writes through to flash. On a device that buffers the page
+ * in RAM and programs it on flush (RP2), the compacted page is programmed in one operation.
+ *
+ * @return kKVPErrorOK on success, kKVPErrorIO on a device error
+ */
+flxKVPError_t flxKVPStorePage::compact(void)
+{
+    if (!_pStorage || _pageStatus == flxKVPPageStatus::kPageUninitialized ||
+        _pageStatus == flxKVPPageStatus::kPageInvalid)
+        return kKVPErrorConfig;
+
+    flxKVPStoreEntry theEntry;
+    uint8_t record[flxKVPStoreEntry::kEntrySize];
+    uint32_t iNext = 0;
+    uint32_t span;
+
+    for (uint32_t i = 0; i < kNEntriesPerPage; i += span)
+    {
+        span = 1;
+        if (entryState(i) != entryStateT::entryWritten)
+            continue;
+
+        if (readEntry(i, theEntry) != kKVPErrorOK)
+            return kKVPErrorIO;
+
+        span = theEntry.span == 0 ? 1 : std::min((uint32_t)theEntry.span, kNEntriesPerPage - i);
+
+        // drop corrupt entries
+        if (theEntry.crc32 != theEntry.calculateCRC32())
+        {
+            for (uint32_t n = 0; n < span; n++)
+                markEntryState(i + n, entryStateT::entryEmpty);
+            indexRemove(i);
+            continue;
+        }
+
+        if (i != iNext)
+        {
+            for (uint32_t n = 0; n < span; n++)
+            {
+                if (!readRecord(i + n, record) || !writeRecord(iNext + n, record))
+                    return kKVPErrorIO;
+                markEntryState(i + n, entryStateT::entryEmpty);
+                markEntryState(iNext + n, entryStateT::entryWritten);
+            }
+            indexMove(i, iNext);
+        }
+        iNext += span;
+    }
+
+    if (!writeEntryStates())
+        return kKVPErrorIO;
+
+    _lastEmptyEntry = iNext;
+
+    return updatePageStatus(iNext < kNEntriesPerPage ? flxKVPPageStatus::kPageAvailable
+                                                     : flxKVPPageStatus::kPageFull);
+}
+
+//---------------------------------------------
+/**
+ * @brief Copies an entry, and any data records, from another page.
+ *
+ * @param srcPage The page the entry is on
+ * @param index The index of the entry in the source page
+ * @param theEntry The entry - as read from the source page
+ * @return kKVPErrorOK on success, kKVPErrorPageFull if there's no room, kKVPErrorIO on a device error
+ */
+flxKVPError_t flxKVPStorePage::copyEntry(flxKVPStorePage &srcPage, uint32_t index, const flxKVPStoreEntry &theEntry)
+{
+    if (!_pStorage || !srcPage._pStorage)
+        return kKVPErrorConfig;
+
+    uint32_t span = theEntry.span == 0 ? 1 : theEntry.span;
+
+    uint32_t iDest = getNextFreeEntry(span);
+    if (iDest == flxKVPStoreEntry::kEntryInvalid)
+        return kKVPErrorPageFull;
+
+    uint8_t record[flxKVPStoreEntry::kEntrySize];
+
+    for (uint32_t n = 0; n < span; n++)
+    {
+        if (!srcPage.readRecord(index + n, record) || !writeRecord(iDest + n, record))
+            return kKVPErrorIO;
+        markEntryState(iDest + n, entryStateT::entryWritten);
+    }
+    _lastEmptyEntry = iDest + span;
+
+    indexAdd(theEntry, iDest);
+
+    return writeEntryStates() ? kKVPErrorOK : kKVPErrorIO;
+}
+
+//---------------------------------------------
+// Key index
+//---------------------------------------------
+// Hash of the namespace and key - the key is limited to the length stored in an entry
+uint32_t flxKVPStorePage::keyHash(uint8_t iNS, const char *szKey)
+{
+    uint32_t hash = 5381 * 33 + iNS;
+
+    for (uint16_t i = 0; i < flxKVPStoreEntry::kMaxKeyLength && szKey[i] != '\0'; i++)
+        hash = ((hash << 5) + hash) + szKey[i]; // hash * 33 + c
+
+    return hash;
+}
+
+//---------------------------------------------
+void flxKVPStorePage::indexAdd(const flxKVPStoreEntry &theEntry, uint32_t index)
+{
+    // an entry replaces what was at this index
+    indexRemove(index);
+
+    flxKVPIndexRecord record = {keyHash(theEntry.iNameSpace, theEntry.entryKey), (uint16_t)index};
+
+    auto it = std::upper_bound(_index.begin(), _index.end(), record.hash,
+                               [](uint32_t value, const flxKVPIndexRecord &rec) { return value < rec.hash; });
+    _index.insert(it, record);
+}
+
+//---------------------------------------------
+void flxKVPStorePage::indexRemove(uint32_t index)
+{
+    auto it = std::find_if(_index.begin(), _index.end(),
+                           [=](const flxKVPIndexRecord &rec) { return rec.index == index; });
+    if (it != _index.end())
+        _index.erase(it);
+}
+
+//---------------------------------------------
+// The hash doesn't change, so the table stays sorted
+void flxKVPStorePage::indexMove(uint32_t fromIndex, uint32_t toIndex)
+{
+    for (auto &rec : _index)
+    {
+        if (rec.index == fromIndex)
+        {
+            rec.index = toIndex;
+            break;
+        }
+    }
+}
+
 //---------------------------------------------
 /**
  * @brief Dumps the contents of the page to the Serial monitor.
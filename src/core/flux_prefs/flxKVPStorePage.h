@@ -29,6 +29,8 @@
 #include "flxKVPStoreDefs.h"
 #include "flxKVPStoreDevice.h"
 #include "flxKVPStoreEntry.h"
+
+#include <vector>
 // page state enum
 
 enum flxKVPPageStatus : uint32_t
@@ -114,6 +116,10 @@ class flxKVPStorePage
     // read value methods - leverage a template to get the type of the value
     flxKVPError_t readValue(uint8_t iNS, flxDataType_t dType, const char *szKey, void *value, size_t valueSize);
 
+    // read the value of an entry found on this page
+    flxKVPError_t readEntryValue(uint32_t idxEntry, const flxKVPStoreEntry &theEntry, void *value,
+                                 size_t valueSize);
+
     template <typename T> flxKVPError_t readValue(uint8_t iNS, const char *szKey, T &value)
     {
         return readValue(iNS, getTypeOf(value), szKey, &value, sizeof(value));
@@ -133,12 +139,82 @@ class flxKVPStorePage
         return _pageStatus;
     }
 
+    // Iterate over the written entries. Returns the first valid entry at or after entryIndex - the index
+    // is updated to the entry found. kKVPErrorNoMatch at the end of the page.
+    flxKVPError_t nextEntry(uint32_t &entryIndex, flxKVPStoreEntry &theEntry);
+
+    //-----------------------------------------------------------------------
+    // Compaction
+
+    // The page sequence number - set when the page receives compacted entries. If a key is on two pages,
+    // the page with the higher sequence holds the latest value.
+    uint32_t sequence(void)
+    {
+        return _sequence;
+    }
+    flxKVPError_t setSequence(uint32_t sequence);
+
+    //-----------------------------------------------------------------------
+    // Wear
+
+    // The erase/program cycles of the page's sector, kept in the page header. A cycle is counted the first
+    // time the page is modified after the storage device is flushed - a device that buffers a sector
+    // erases and programs it when the buffer is written out.
+    uint32_t eraseCount(void)
+    {
+        return _eraseCount;
+    }
+
+    // Called when the storage device has been flushed - the next change to the page is a new cycle
+    void flushed(void)
+    {
+        _bModified = false;
+    }
+
+    // number of written and empty entries
+    uint32_t liveEntries(void);
+    uint32_t freeEntries(void)
+    {
+        return kNEntriesPerPage - liveEntries();
+    }
+
+    // Move the live entries to the start of the page, closing the gaps left by deleted and resized
+    // entries. The entry state table is written once.
+    flxKVPError_t compact(void);
+
+    // Copy an entry, and any data records, from another page into this page
+    flxKVPError_t copyEntry(flxKVPStorePage &srcPage, uint32_t index, const flxKVPStoreEntry &theEntry);
+
     // Init the page - and optionally erase it
     flxKVPError_t initPage(bool bErase = false);
 
     void dumpPage(void);
 
+    // RAM used by the key index
+    size_t heapSize(void)
+    {
+        return _index.capacity() * sizeof(flxKVPIndexRecord);
+    }
+
   private:
+    //---------------------------------------------------------------
+    // Key index - a sorted table of (namespace + key hash, entry index) for the written entries of the
+    // page. Built when the page is loaded, and kept up to date as entries are written, moved and deleted,
+    // so a key lookup reads only the matching entry from the device.
+    struct flxKVPIndexRecord
+    {
+        uint32_t hash;
+        uint16_t index;
+    };
+
+    static uint32_t keyHash(uint8_t iNS, const char *szKey);
+
+    void indexAdd(const flxKVPStoreEntry &theEntry, uint32_t index);
+    void indexRemove(uint32_t index);
+    void indexMove(uint32_t fromIndex, uint32_t toIndex);
+
+    std::vector<flxKVPIndexRecord> _index;
+
     // Methods for our entry state table
 
     enum class entryStateT : uint8_t
@@ -161,23 +237,57 @@ class flxKVPStorePage
     }
 
     //---------------------------------------------------------------
-    entryStateT setEntryState(uint32_t entry, entryStateT eState)
+    // Set the state of an entry in the state table - RAM only
+    void markEntryState(uint32_t entry, entryStateT eState)
     {
-        if (entry >= kNEntriesPerPage)
-            return entryStateT::entryError;
-
         size_t idx = entry / 16;
         size_t offset = (entry % 16) * 2;
 
         _entryState[idx] = (_entryState[idx] & ~(0x3 << offset)) | (static_cast<uint32_t>(eState) << offset);
+    }
+
+    // All writes to the page, except the header, go through here - the first write after a flush counts an
+    // erase cycle
+    bool writeData(uint32_t address, const void *src, size_t len)
+    {
+        if (!_pStorage)
+            return false;
 
-        bool bStatus = false;
-        if (_pStorage)
-            bStatus = _pStorage->write(_pageSector, _pageBaseAddress + flxKVPStoreEntry::kEntrySize, _entryState,
-                                       sizeof(_entryState));
+        if (!_bModified && updatePageStatus(_pageStatus, true) != kKVPErrorOK)
+            return false;
+
+        return _pStorage->write(_pageSector, address, src, len);
+    }
+
+    bool writeEntryStates(void)
+    {
+        return writeData(_pageBaseAddress + flxKVPStoreEntry::kEntrySize, _entryState, sizeof(_entryState));
+    }
+
+    //---------------------------------------------------------------
+    entryStateT setEntryState(uint32_t entry, entryStateT eState)
+    {
+        if (entry >= kNEntriesPerPage)
+            return entryStateT::entryError;
+
+        markEntryState(entry, eState);
 
         // If we are unable to write the entry state, we return an error
-        return bStatus ? eState : entryStateT::entryError;
+        return writeEntryStates() ? eState : entryStateT::entryError;
+    }
+
+    // raw access to an entry record - used to move entries and their data records
+    uint32_t entryAddress(uint32_t index)
+    {
+        return _pageBaseAddress + (index + kNBookKeepingEntries) * flxKVPStoreEntry::kEntrySize;
+    }
+    bool readRecord(uint32_t index, void *dest)
+    {
+        return _pStorage->read(_pageSector, entryAddress(index), dest, flxKVPStoreEntry::kEntrySize);
+    }
+    bool writeRecord(uint32_t index, const void *src)
+    {
+        return writeData(entryAddress(index), src, flxKVPStoreEntry::kEntrySize);
     }
 
     uint32_t getNextFreeEntry(uint8_t span = 1);
@@ -193,15 +303,19 @@ class flxKVPStorePage
          * @brief Default constructor.
          * Initializes the status to kPageInvalid and fills the fill array with 0xff.
          */
-        flxKVPStorePageHeader() : status{flxKVPPageStatus::kPageInvalid}
+        flxKVPStorePageHeader() : status{flxKVPPageStatus::kPageInvalid}, sequence{0xFFFFFFFF}, eraseCount{0xFFFFFFFF}
         {
+            memset(reserved, 0xff, sizeof(reserved));
             memset(fill, 0xff, sizeof(fill) / sizeof(fill[0]));
         };
 
         flxKVPPageStatus status; /**< The status of the flash page. */
         uint32_t number;         /**< The number of the flash page. */
         uint8_t version;         /**< The version of the flash page. */
-        uint8_t fill[19];        /**< An array used for padding. */
+        uint8_t reserved[3];     /**< Alignment padding. */
+        uint32_t sequence;       /**< The compaction sequence number of the page - 0xFFFFFFFF if not set */
+        uint32_t eraseCount;     /**< Erase/program cycles of the page sector - 0xFFFFFFFF if not set */
+        uint8_t fill[8];         /**< An array used for padding. */
         uint32_t crc32;          /**< The CRC32 checksum of the flash page. */
 
         /**
@@ -223,4 +337,9 @@ class flxKVPStorePage
     uint32_t _entryState[8]; // 32 bits
 
     uint32_t _lastEmptyEntry;
+
+    uint32_t _sequence;
+
+    uint32_t _eraseCount;
+    bool _bModified;
 };
\ No newline at end of file
@@ -10,6 +10,8 @@
 
 #include "flxSettings.h"
 
+#include <algorithm>
+
 // Global object - for quick access to Settings system
 flxSettingsSave &flxSettings = flxSettingsSave::get();
 //------------------------------------------------------------
@@ -21,6 +23,7 @@ flxSettingsSave &flxSettings = flxSettingsSave::get();
 void flxSettingsSave::setStorage(flxStorage *pStorage)
 {
     _primaryStorage = pStorage;
+    _primaryInSync = false;
 }
 
 void flxSettingsSave::setFallback(flxStorage *pStorage)
@@ -56,6 +59,9 @@ bool flxSettingsSave::saveObjectToStorage(flxObject *pObject, flxStorage *pStora
     if (!pStorage)
         return false;
 
+    // Deferred objects are restored first - otherwise their defaults are saved over their settings
+    restoreDeferred();
+
     // Start storage transaction
     if (!pStorage->begin())
         return false;
@@ -88,10 +94,24 @@ bool flxSettingsSave::save(flxObject *pObject, bool primary_only)
     if (!_primaryStorage)
         return false;
 
+    // An incremental save of the system writes just the changed settings. This needs storage that keeps
+    // values between saves (internal), and that holds the settings of a full save.
+    bool bSystem = pObject == &flux;
+
+    _primaryStorage->setIncremental(bSystem && incrementalSave() && _primaryInSync &&
+                                    _primaryStorage->kind() == flxStorage::flxStorageKindInternal);
+
     bool status = saveObjectToStorage(pObject, _primaryStorage);
 
+    _primaryStorage->setIncremental(false);
+
     if (!status)
+    {
         flxLog_E(F("Unable to save %s to %s"), pObject->name(), _primaryStorage->name());
+        _primaryInSync = false;
+    }
+    else if (bSystem)
+        _primaryInSync = true;
 
     // Save to secondary ?
     if (!primary_only && fallbackSave() && _fallbackStorage != nullptr)
@@ -119,6 +139,10 @@ bool flxSettingsSave::restoreObjectFromStorage(flxObject *pObject, flxStorage *p
 
     pStorage->end();
 
+    // restored values are not dirty, but they might not be in the primary storage
+    if (pStorage != _primaryStorage)
+        _primaryInSync = false;
+
     return status;
 }
 
@@ -143,8 +167,19 @@ bool flxSettingsSave::restore(flxObject *pObject)
     if (!_primaryStorage)
         return false;
 
+    // A restore of the system skips the deferred objects. An object restored directly isn't deferred.
+    bool bSystem = pObject == &flux;
+
+    if (bSystem)
+        markDeferred(true);
+    else
+        pObject->setRestorePending(false);
+
     bool status = restoreObjectFromStorage(pObject, _primaryStorage);
 
+    if (bSystem)
+        _deferredStorage = _primaryStorage;
+
     char *strSource = nullptr;
     if (!status)
     {
@@ -163,6 +198,11 @@ bool flxSettingsSave::restore(flxObject *pObject)
                 //  We restored from fallback, now save to main storage -- TODO - should this be a setting
                 flxLog_D(F("Saving settings to %s"), _primaryStorage->name());
                 strSource = (char *)_fallbackStorage->name();
+
+                // the save restores the deferred objects - from the fallback
+                if (bSystem)
+                    _deferredStorage = _fallbackStorage;
+
                 // save the new settings - to primary storage only
                 save(pObject, true);
             }
@@ -176,13 +216,102 @@ bool flxSettingsSave::restore(flxObject *pObject)
     else
         flxLog_N(F("unable to restore settings, using defaults"));
 
+    if (bSystem)
+    {
+        // nothing to restore the deferred objects from?
+        if (!status)
+            markDeferred(false);
+        else
+        {
+            for (auto pDeferred : _deferred)
+            {
+                if (pDeferred->restorePending())
+                {
+                    flxAddJobToQueue(_jobDeferred);
+                    break;
+                }
+            }
+        }
+    }
+
     return status;
 }
 
+//----------------------------------------------------------------------------------
+// Deferred restore
+//----------------------------------------------------------------------------------
+void flxSettingsSave::setDeferredRestore(flxObject *pObject, bool bDefer)
+{
+    if (!pObject || pObject == &flux)
+        return;
+
+    auto it = std::find(_deferred.begin(), _deferred.end(), pObject);
+
+    if (bDefer && it == _deferred.end())
+        _deferred.push_back(pObject);
+
+    else if (!bDefer && it != _deferred.end())
+    {
+        // a pending object is restored now
+        restoreDeferred(pObject);
+        _deferred.erase(it);
+    }
+}
+
+//----------------------------------------------------------------------------------
+void flxSettingsSave::markDeferred(bool bPending)
+{
+    for (auto pDeferred : _deferred)
+        pDeferred->setRestorePending(bPending);
+
+    if (!bPending)
+        flxRemoveJobFromQueue(_jobDeferred);
+}
+
+//----------------------------------------------------------------------------------
+bool flxSettingsSave::restoreDeferred(flxObject *pObject)
+{
+    if (!pObject || !pObject->restorePending())
+        return true;
+
+    pObject->setRestorePending(false);
+
+    return restoreObjectFromStorage(pObject, _deferredStorage);
+}
+
+//----------------------------------------------------------------------------------
+void flxSettingsSave::restoreDeferred(void)
+{
+    for (auto pDeferred : _deferred)
+        restoreDeferred(pDeferred);
+
+    flxRemoveJobFromQueue(_jobDeferred);
+}
+
+//----------------------------------------------------------------------------------
+void flxSettingsSave::restoreDeferred_CB(void)
+{
+    for (auto pDeferred : _deferred)
+    {
+        if (pDeferred->restorePending())
+        {
+            restoreDeferred(pDeferred);
+            return;
+        }
+    }
+    // all restored
+    flxRemoveJobFromQueue(_jobDeferred);
+}
+
 //----------------------------------------------------------------------------------
 
 void flxSettingsSave::reset(void)
 {
+    _primaryInSync = false;
+
+    // the settings are gone - deferred objects keep their current values
+    markDeferred(false);
+
     if (_primaryStorage)
         _primaryStorage->resetStorage();
 
@@ -198,6 +327,9 @@ void flxSettingsSave::restore_fallback(void)
     if (!_fallbackStorage)
         return;
 
+    // all objects are restored from the fallback
+    markDeferred(false);
+
     if (!restoreObjectFromStorage(&flux, _fallbackStorage))
         flxLog_E(F("Unable to restore settings from %s"), _fallbackStorage->name());
     else
@@ -216,6 +348,9 @@ void flxSettingsSave::save_fallback(void)
     if (!_fallbackStorage)
         return;
 
+    // the save clears the dirty flags - so the next save to the primary storage is a full save
+    _primaryInSync = false;
+
     if (!saveObjectToStorage(&flux, _fallbackStorage))
         flxLog_E(F("Unable to save settings to %s"), _fallbackStorage->name());
 }
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "flxCore.h"
+#include "flxCoreJobs.h"
 #include "flxFlux.h"
 #include "flxStorage.h"
 
@@ -34,6 +35,12 @@ class flxSettingsSave : public flxActionType<flxSettingsSave>
     void restore_fallback(void);
     void save_fallback(void);
 
+    // set or clear the pending flag of the deferred objects
+    void markDeferred(bool bPending);
+
+    // job that restores the deferred objects after startup - one object each time it runs
+    void restoreDeferred_CB(void);
+
     void set_fallbackSize(uint32_t sz)
     {
         if (_fallbackStorage)
@@ -93,11 +100,48 @@ class flxSettingsSave : public flxActionType<flxSettingsSave>
     bool restore(flxObject *pObject);
     void reset(void);
 
+    //------------------------------------------------------------
+    // Deferred restore
+    //
+    // A restore of the system skips the objects registered here - for example a connector or device
+    // that isn't used in every session. A deferred object is restored from the storage the system was
+    // restored from when it's first used - when it's accessed by the framework (an operation is run, its
+    // settings are edited, the settings are saved), or when restoreDeferred() is called for it - for
+    // example when the object is initialized or enabled. A background job restores the rest after
+    // startup.
+    void setDeferredRestore(flxObject *pObject, bool bDefer = true);
+    void setDeferredRestore(flxObject &theObject, bool bDefer = true)
+    {
+        setDeferredRestore(&theObject, bDefer);
+    }
+
+    // restore a deferred object now, if its restore is pending
+    bool restoreDeferred(flxObject *pObject);
+    bool restoreDeferred(flxObject &theObject)
+    {
+        return restoreDeferred(&theObject);
+    }
+
+    // restore all pending objects
+    void restoreDeferred(void);
+
     bool isAvailable()
     {
         return _primaryStorage != nullptr;
     }
 
+    flxStorage *storage(void)
+    {
+        return _primaryStorage;
+    }
+
+    // include the storage systems in our heap estimate
+    size_t heapSize(void)
+    {
+        return flxOperation::heapSize() + (_primaryStorage ? _primaryStorage->heapSize() : 0) +
+               (_fallbackStorage ? _fallbackStorage->heapSize() : 0);
+    }
+
     //------------------------------------------------------------------------------
 
     // save/restore methods for objects
@@ -111,6 +155,10 @@ class flxSettingsSave : public flxActionType<flxSettingsSave>
     flxPropertyBool<flxSettingsSave> fallbackSave = {false};
     flxPropertyBool<flxSettingsSave> fallbackRestore = {true};
 
+    // Save only the settings that changed since the last save. Only settings changed through their
+    // properties are saved - objects that persist other state save themselves.
+    flxPropertyBool<flxSettingsSave> incrementalSave = {false};
+
     flxPropertyRWUInt32<flxSettingsSave, &flxSettingsSave::get_fallBackSize, &flxSettingsSave::set_fallbackSize>
         fallbackBuffer;
 
@@ -123,7 +171,8 @@ class flxSettingsSave : public flxActionType<flxSettingsSave>
     flxParameterInVoid<flxSettingsSave, &flxSettingsSave::save_fallback> saveFallback;
 
   private:
-    flxSettingsSave() : _primaryStorage{nullptr}, _fallbackStorage{nullptr}
+    flxSettingsSave()
+        : _primaryStorage{nullptr}, _fallbackStorage{nullptr}, _primaryInSync{false}, _deferredStorage{nullptr}
     {
 
         // Set name and description
@@ -134,6 +183,7 @@ class flxSettingsSave : public flxActionType<flxSettingsSave>
 
         flxRegister(fallbackRestore, "Fallback Restore", "If unable to restore settings, use the fallback source");
         flxRegister(fallbackSave, "Fallback Save", "Save settings also saves to the fallback storage");
+        flxRegister(incrementalSave, "Incremental Save", "Only save the settings that changed since the last save");
 
         flxRegister(fallbackBuffer, "%s Buffer Size", "The size in bytes used for the internal I/O buffer");
 
@@ -143,9 +193,24 @@ class flxSettingsSave : public flxActionType<flxSettingsSave>
 
         flxRegister(saveFallback, "Save to Fallback", "Save system settings to the fallback storage");
         flxRegister(restoreFallback, "Restore from Fallback", "Restore system settings from the fallback storage");
+
+        _jobDeferred.setup("Deferred Restore", kDeferredRestorePeriod, this, &flxSettingsSave::restoreDeferred_CB);
     }
 
     flxStorage *_primaryStorage;
     flxStorage *_fallbackStorage;
+
+    // Does the primary storage hold all the system settings? Set by a full save of the system, which
+    // allows incremental saves after it.
+    bool _primaryInSync;
+
+    // how often the background job restores a deferred object - in ms
+    static constexpr uint32_t kDeferredRestorePeriod = 50;
+
+    // objects restored on demand, and the storage the system was restored from
+    std::vector<flxObject *> _deferred;
+    flxStorage *_deferredStorage;
+
+    flxJob _jobDeferred;
 };
 extern flxSettingsSave &flxSettings;
\ No newline at end of file
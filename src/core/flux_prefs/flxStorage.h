@@ -68,6 +68,10 @@ class flxStorage : public flxDescriptor
 {
 
   public:
+    flxStorage() : _incremental{false}
+    {
+    }
+
     typedef enum
     {
         flxStorageKindInternal,
@@ -98,6 +102,27 @@ class flxStorage : public flxDescriptor
     {
         return 0;
     }
+
+    // RAM held by the storage system between transactions
+    virtual size_t heapSize(void)
+    {
+        return flxDescriptor::heapSize();
+    }
+
+    // An incremental save only writes the objects and properties that changed since they were last
+    // saved. The values already in storage are kept - so this is only used with storage that
+    // holds its values between saves.
+    void setIncremental(bool bIncremental)
+    {
+        _incremental = bIncremental;
+    }
+    bool incremental(void)
+    {
+        return _incremental;
+    }
+
+  private:
+    bool _incremental;
 };
 
 //------------------------------------------------------------------------------
@@ -108,6 +133,10 @@ class flxStorageBlock
 {
 
   public:
+    flxStorageBlock() : _incremental{false}
+    {
+    }
+
     virtual bool writeBool(const char *tag, bool data) = 0;
     virtual bool writeInt8(const char *tag, int8_t data) = 0;
     virtual bool writeInt16(const char *tag, int16_t data) = 0;
@@ -221,4 +250,17 @@ class flxStorageBlock
 
     bool saveSecureString(const char *tag, const char *data);
     bool restoreSecureString(const char *tag, char *data, size_t len);
+
+    // Set when the block is written by an incremental save
+    void setIncremental(bool bIncremental)
+    {
+        _incremental = bIncremental;
+    }
+    bool incremental(void)
+    {
+        return _incremental;
+    }
+
+  private:
+    bool _incremental;
 };
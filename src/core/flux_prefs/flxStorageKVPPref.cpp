@@ -21,6 +21,10 @@
 #include "flxCoreLog.h"
 #include "flxUtils.h"
 
+#ifdef CONFIG_FLUX_PREFS_BINARY
+#include "flxStorageBinaryPref.h"
+#endif
+
 #define kHashTagSize 16
 
 #define kMinTagLen 3
@@ -30,7 +34,8 @@
 // handy helper
 static bool tag_is_valid(const char *tag)
 {
-    if (!tag || strlen(tag) < kMinTagLen)
+    // only the minimum length is checked - not the whole tag
+    if (!tag || strnlen(tag, kMinTagLen) < kMinTagLen)
     {
         flxLog_E("Preference  Storage - invalid tag length - minimum is %d: %s\n\r", kMinTagLen, !tag ? "NULL" : tag);
         return false;
@@ -535,3 +540,214 @@ void flxStorageKVPPref::resetStorage()
     // nvs_flash_erase();
     // nvs_flash_init();
 }
+
+//------------------------------------------------------------------------------
+// Bulk export and import
+//------------------------------------------------------------------------------
+
+template <typename T> static T valueOf(const uint8_t *data)
+{
+    T value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Write the value last returned by the enumeration to a block. The store doesn't separate strings and byte
+// arrays - a value with a null in it is written as bytes.
+static bool exportValue(flxKVPStore &theStore, flxKVPStoreCursor &cursor, const flxKVPEntryInfo_t &info,
+                        flxStorageBlock *stBlk, std::vector<uint8_t> &buffer)
+{
+    if (info.dataType == flxTypeString)
+    {
+        buffer.resize(info.size + 1);
+        if (theStore.readEntry(cursor, buffer.data(), buffer.size()) != kKVPErrorOK)
+            return false;
+
+        if (memchr(buffer.data(), '\0', info.size) != nullptr)
+            return stBlk->writeBytes(info.key, buffer.data(), info.size);
+
+        return stBlk->writeString(info.key, (const char *)buffer.data());
+    }
+
+    uint8_t data[sizeof(double)];
+    if (theStore.readEntry(cursor, data, sizeof(data)) != kKVPErrorOK)
+        return false;
+
+    switch (info.dataType)
+    {
+    case flxTypeBool:
+        return stBlk->writeBool(info.key, valueOf<bool>(data));
+    case flxTypeInt8:
+        return stBlk->writeInt8(info.key, valueOf<int8_t>(data));
+    case flxTypeInt16:
+        return stBlk->writeInt16(info.key, valueOf<int16_t>(data));
+    case flxTypeInt32:
+        return stBlk->writeInt32(info.key, valueOf<int32_t>(data));
+    case flxTypeUInt8:
+        return stBlk->writeUInt8(info.key, valueOf<uint8_t>(data));
+    case flxTypeUInt16:
+        return stBlk->writeUInt16(info.key, valueOf<uint16_t>(data));
+    case flxTypeUInt32:
+        return stBlk->writeUInt32(info.key, valueOf<uint32_t>(data));
+    case flxTypeFloat:
+        return stBlk->writeFloat(info.key, valueOf<float>(data));
+    case flxTypeDouble:
+        return stBlk->writeDouble(info.key, valueOf<double>(data));
+    default:
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool flxStorageKVPPref::exportTo(flxStorage *pStorage)
+{
+    if (!pStorage || pStorage == this || !pStorage->begin())
+        return false;
+
+    flxKVPStoreCursor cursor;
+    flxKVPEntryInfo_t info;
+    std::vector<uint8_t> buffer;
+
+    flxStorageBlock *stBlk = nullptr;
+    uint8_t iBlockNS = kKVPAllNameSpaces;
+    uint32_t nValues = 0;
+    uint32_t nErrors = 0;
+
+    flxKVPError_t retval;
+
+    while ((retval = _prefs.nextEntry(cursor, kKVPAllNameSpaces, info)) == kKVPErrorOK)
+    {
+        // the values of a namespace are usually together - a block is started when the namespace changes
+        if (!stBlk || info.iNameSpace != iBlockNS)
+        {
+            if (stBlk)
+                pStorage->endBlock(stBlk);
+
+            const char *szNS = _prefs.nameSpaceName(info.iNameSpace);
+
+            stBlk = szNS ? pStorage->beginBlock(szNS) : nullptr;
+            iBlockNS = info.iNameSpace;
+        }
+
+        if (stBlk && exportValue(_prefs, cursor, info, stBlk, buffer))
+            nValues++;
+        else
+            nErrors++;
+    }
+    if (stBlk)
+        pStorage->endBlock(stBlk);
+
+    pStorage->end();
+
+    if (retval != kKVPErrorNoMatch || nErrors > 0)
+    {
+        flxLog_E(F("Settings export to %s - %u values not exported"), pStorage->name(), nErrors);
+        return false;
+    }
+    flxLog_D(F("Settings export to %s - %u values"), pStorage->name(), nValues);
+
+    return true;
+}
+
+#ifdef CONFIG_FLUX_PREFS_BINARY
+//------------------------------------------------------------------------------
+template <typename T>
+static flxKVPError_t importValue(flxKVPStore &theStore, uint8_t iNS,
+                                 const flxStorageBinaryPref::binaryEntry_t &theEntry)
+{
+    if (theEntry.length != sizeof(T))
+        return kKVPErrorBadParam;
+
+    T value = valueOf<T>(theEntry.data);
+
+    return theStore.setValue(iNS, theEntry.tag, value);
+}
+
+//------------------------------------------------------------------------------
+bool flxStorageKVPPref::importFrom(flxStorageBinaryPref *pSnapshot)
+{
+    if (!pSnapshot || !pSnapshot->begin(true))
+        return false;
+
+    // each changed page is written once, at the end
+    _prefs.beginTransaction();
+
+    flxStorageBinaryPref::binaryEntry_t theEntry;
+    uint16_t iBlock = 0;
+    uint16_t iValue = 0;
+
+    const char *szBlock = nullptr;
+    uint8_t iNS = 0;
+    uint32_t nValues = 0;
+    uint32_t nErrors = 0;
+
+    for (; pSnapshot->nextValue(iBlock, iValue, theEntry); iValue++)
+    {
+        // a block is a namespace
+        if (theEntry.block != szBlock)
+        {
+            szBlock = theEntry.block;
+            iNS = _prefs.getNameSpace(szBlock);
+        }
+
+        flxKVPError_t retval = kKVPErrorNamespace;
+
+        if (iNS != 0)
+        {
+            switch (theEntry.type)
+            {
+            case flxStorageBinaryPref::kTypeBool:
+                retval = importValue<bool>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeInt8:
+                retval = importValue<int8_t>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeInt16:
+                retval = importValue<int16_t>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeInt32:
+                retval = importValue<int32_t>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeUInt8:
+                retval = importValue<uint8_t>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeUInt16:
+                retval = importValue<uint16_t>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeUInt32:
+                retval = importValue<uint32_t>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeFloat:
+                retval = importValue<float>(_prefs, iNS, theEntry);
+                break;
+            case flxStorageBinaryPref::kTypeDouble:
+                retval = importValue<double>(_prefs, iNS, theEntry);
+                break;
+            default:
+                // strings and byte arrays - the store doesn't hold empty values, so they're skipped, as
+                // they are when written to a block
+                retval = theEntry.length == 0
+                             ? kKVPErrorOK
+                             : _prefs.setValue(iNS, theEntry.tag, (const void *)theEntry.data, theEntry.length);
+                break;
+            }
+        }
+        if (retval == kKVPErrorOK)
+            nValues++;
+        else
+            nErrors++;
+    }
+
+    _prefs.commit();
+    pSnapshot->end();
+
+    if (nErrors > 0)
+    {
+        flxLog_E(F("Settings import from %s - %u values not imported"), pSnapshot->name(), nErrors);
+        return false;
+    }
+    flxLog_D(F("Settings import from %s - %u values"), pSnapshot->name(), nValues);
+
+    return true;
+}
+#endif
@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include "flux_config.h"
+
 #include "flxKVPStoreDevice.h"
 #include "flxKVPStorePrefs.h"
 #include "flxStorage.h"
@@ -32,6 +34,7 @@
 // Use tags to ID an item and move to use data types. Model after the
 // ESP32 preference library
 class flxStorageKVPPref;
+class flxStorageBinaryPref;
 
 class flxStorageKVPBlock : public flxStorageBlock
 {
@@ -106,16 +109,22 @@ class flxStorageKVPPref : public flxStorage
         return flxStorage::flxStorageKindInternal;
     }
 
-    // add begin, end stubs - the Esp32 prefs system doesn't required transaction brackets
+    // begin and end bracket a save or restore - a save is a KVP store transaction, so each flash page it
+    // changes is written once, at end()
     bool begin(bool readonly = false)
     {
         _readOnly = readonly;
+
+        if (!_readOnly)
+            _prefs.beginTransaction();
+
         return true;
     }
     void end(void)
     {
-        // commit any changes
-        _prefs.commit();
+        // commit any changes - a restore doesn't change the store, so nothing is written
+        if (!_readOnly)
+            _prefs.commit();
         _readOnly = false;
     }
 
@@ -127,11 +136,29 @@ class flxStorageKVPPref : public flxStorage
 
     void resetStorage();
 
+    // Bulk copy of the stored values, in one pass over the store - for backup and provisioning. The copy
+    // holds the namespaces and keys of the store (hashed tags), so it's imported back into a KVP store and
+    // isn't read as settings by another storage.
+    //
+    // Export - each namespace is a block in the destination storage
+    bool exportTo(flxStorage *pStorage);
+
+#ifdef CONFIG_FLUX_PREFS_BINARY
+    // Import a snapshot made by exportTo() - the values are added to the store in one transaction. This
+    // needs the flux_prefs_binary module.
+    bool importFrom(flxStorageBinaryPref *pSnapshot);
+#endif
+
     void setStorageDevice(flxKVPStoreDevice *pDevice)
     {
         _prefs.setStorageDevice(pDevice);
     }
 
+    size_t heapSize(void)
+    {
+        return flxStorage::heapSize() + _prefs.heapSize();
+    }
+
   private:
     // The block used to interface with the system
     flxStorageKVPBlock _theBlock;
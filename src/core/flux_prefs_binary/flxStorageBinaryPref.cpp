@@ -0,0 +1,855 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxStorageBinaryPref.h"
+#include "flxCoreLog.h"
+#include "flxUtils.h"
+
+#include <string.h>
+
+// Sizes in the snapshot file
+#define kSnapshotHeaderSize 16
+#define kSnapshotDirEntrySize 8
+#define kSnapshotRecordSize 5
+#define kSnapshotCRCSize 4
+
+// The file is read and written in chunks of this size
+#define kSnapshotChunkSize 128
+
+//-----------------------------------------------------------------------------------
+// Little endian values in the file
+
+static uint16_t get16(const uint8_t *pData)
+{
+    return (uint16_t)pData[0] | (uint16_t)pData[1] << 8;
+}
+
+static uint32_t get32(const uint8_t *pData)
+{
+    return (uint32_t)get16(pData) | (uint32_t)get16(pData + 2) << 16;
+}
+
+static void put16(uint8_t *pData, uint16_t value)
+{
+    pData[0] = value & 0xFF;
+    pData[1] = value >> 8;
+}
+
+static void put32(uint8_t *pData, uint32_t value)
+{
+    put16(pData, value & 0xFFFF);
+    put16(pData + 2, value >> 16);
+}
+
+//-----------------------------------------------------------------------------------
+// Read a file in chunks - keeping a CRC of the bytes read
+
+class flxBinaryFileReader
+{
+  public:
+    flxBinaryFileReader(flxFSFile &theFile) : _file{theFile}, _count{0}, _next{0}, _crc{0}
+    {
+    }
+
+    bool read(void *data, size_t len)
+    {
+        uint8_t *pData = (uint8_t *)data;
+
+        while (len > 0)
+        {
+            if (_next == _count)
+            {
+                _count = _file.read(_buffer, sizeof(_buffer));
+                _next = 0;
+                if (_count == 0)
+                    return false;
+            }
+            size_t nBytes = _count - _next < len ? _count - _next : len;
+
+            memcpy(pData, _buffer + _next, nBytes);
+            _crc = flx_utils::calc_crc32(_crc, pData, nBytes);
+
+            _next += nBytes;
+            pData += nBytes;
+            len -= nBytes;
+        }
+        return true;
+    }
+
+    uint32_t crc(void)
+    {
+        return _crc;
+    }
+
+  private:
+    flxFSFile &_file;
+    uint8_t _buffer[kSnapshotChunkSize];
+    size_t _count;
+    size_t _next;
+    uint32_t _crc;
+};
+
+//-----------------------------------------------------------------------------------
+// Write a file in chunks - keeping a CRC of the bytes written. Write errors are reported by flush()
+
+class flxBinaryFileWriter
+{
+  public:
+    flxBinaryFileWriter(flxFSFile &theFile) : _file{theFile}, _count{0}, _crc{0}, _error{false}
+    {
+    }
+
+    void write(const void *data, size_t len)
+    {
+        const uint8_t *pData = (const uint8_t *)data;
+
+        _crc = flx_utils::calc_crc32(_crc, pData, len);
+
+        while (len > 0)
+        {
+            size_t nBytes = sizeof(_buffer) - _count < len ? sizeof(_buffer) - _count : len;
+
+            memcpy(_buffer + _count, pData, nBytes);
+            _count += nBytes;
+            pData += nBytes;
+            len -= nBytes;
+
+            if (_count == sizeof(_buffer))
+                flush();
+        }
+    }
+
+    bool flush(void)
+    {
+        if (_count > 0 && _file.write(_buffer, _count) != _count)
+            _error = true;
+
+        _count = 0;
+        return !_error;
+    }
+
+    uint32_t crc(void)
+    {
+        return _crc;
+    }
+
+  private:
+    flxFSFile &_file;
+    uint8_t _buffer[kSnapshotChunkSize];
+    size_t _count;
+    uint32_t _crc;
+    bool _error;
+};
+
+//-----------------------------------------------------------------------------------
+// flxStorageBinaryBlock
+//-----------------------------------------------------------------------------------
+
+bool flxStorageBinaryBlock::write(const char *tag, uint8_t type, const void *data, size_t len)
+{
+    if (!tag || _readOnly || !_snapshot)
+        return false;
+
+    return _snapshot->setValue(_iBlock, _iNext, tag, type, data, len);
+}
+
+//------------------------------------------------------------------------------
+bool flxStorageBinaryBlock::read(const char *tag, uint8_t type, void *data, size_t len)
+{
+    if (!tag || !_snapshot)
+        return false;
+
+    const flxStorageBinaryPref::binaryValue_t *pValue = _snapshot->getValue(_iBlock, _iNext, tag);
+
+    if (!pValue || pValue->type != type || pValue->length != len)
+        return false;
+
+    memcpy(data, _snapshot->valueData(pValue), len);
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Numeric values are stored in the byte order of the target - the supported targets are little endian
+bool flxStorageBinaryBlock::writeBool(const char *tag, bool data)
+{
+    uint8_t value = data ? 1 : 0;
+    return write(tag, flxStorageBinaryPref::kTypeBool, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::writeInt8(const char *tag, int8_t data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeInt8, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeInt16(const char *tag, int16_t data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeInt16, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeInt32(const char *tag, int32_t data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeInt32, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeUInt8(const char *tag, uint8_t data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeUInt8, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeUInt16(const char *tag, uint16_t data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeUInt16, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeUInt32(const char *tag, uint32_t data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeUInt32, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeFloat(const char *tag, float data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeFloat, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeDouble(const char *tag, double data)
+{
+    return write(tag, flxStorageBinaryPref::kTypeDouble, &data, sizeof(data));
+}
+
+bool flxStorageBinaryBlock::writeString(const char *tag, const char *data)
+{
+    if (!data)
+        return false;
+
+    return write(tag, flxStorageBinaryPref::kTypeString, data, strlen(data));
+}
+
+bool flxStorageBinaryBlock::writeBytes(const char *tag, const uint8_t *data, size_t len)
+{
+    if (!data && len > 0)
+        return false;
+
+    return write(tag, flxStorageBinaryPref::kTypeBytes, data, len);
+}
+
+//------------------------------------------------------------------------------
+bool flxStorageBinaryBlock::readBool(const char *tag, bool &value)
+{
+    uint8_t data;
+    if (!read(tag, flxStorageBinaryPref::kTypeBool, &data, sizeof(data)))
+        return false;
+
+    value = data != 0;
+    return true;
+}
+
+bool flxStorageBinaryBlock::readInt8(const char *tag, int8_t &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeInt8, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::readInt16(const char *tag, int16_t &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeInt16, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::readInt32(const char *tag, int32_t &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeInt32, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::readUInt8(const char *tag, uint8_t &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeUInt8, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::readUInt16(const char *tag, uint16_t &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeUInt16, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::readUInt32(const char *tag, uint32_t &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeUInt32, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::readFloat(const char *tag, float &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeFloat, &value, sizeof(value));
+}
+
+bool flxStorageBinaryBlock::readDouble(const char *tag, double &value)
+{
+    return read(tag, flxStorageBinaryPref::kTypeDouble, &value, sizeof(value));
+}
+
+//------------------------------------------------------------------------------
+// The string is null terminated - so len must include room for the null.
+size_t flxStorageBinaryBlock::readString(const char *tag, char *data, size_t len)
+{
+    if (!tag || !data || !_snapshot)
+        return 0;
+
+    const flxStorageBinaryPref::binaryValue_t *pValue = _snapshot->getValue(_iBlock, _iNext, tag);
+
+    if (!pValue || pValue->type != flxStorageBinaryPref::kTypeString || pValue->length >= len)
+        return 0;
+
+    memcpy(data, _snapshot->valueData(pValue), pValue->length);
+    data[pValue->length] = '\0';
+
+    return pValue->length;
+}
+
+//------------------------------------------------------------------------------
+size_t flxStorageBinaryBlock::getStringLength(const char *tag)
+{
+    if (!tag || !_snapshot)
+        return 0;
+
+    const flxStorageBinaryPref::binaryValue_t *pValue = _snapshot->getValue(_iBlock, _iNext, tag);
+
+    return pValue && pValue->type == flxStorageBinaryPref::kTypeString ? pValue->length : 0;
+}
+
+//------------------------------------------------------------------------------
+// A string can be read as bytes - a storage that doesn't separate the two (KVP) exports byte arrays
+// without a null as strings.
+static bool isBytes(uint8_t type)
+{
+    return type == flxStorageBinaryPref::kTypeBytes || type == flxStorageBinaryPref::kTypeString;
+}
+
+size_t flxStorageBinaryBlock::readBytes(const char *tag, uint8_t *data, size_t len)
+{
+    if (!tag || !data || !_snapshot)
+        return 0;
+
+    const flxStorageBinaryPref::binaryValue_t *pValue = _snapshot->getValue(_iBlock, _iNext, tag);
+
+    // room in buffer?
+    if (!pValue || !isBytes(pValue->type) || pValue->length > len)
+        return 0;
+
+    memcpy(data, _snapshot->valueData(pValue), pValue->length);
+
+    return pValue->length;
+}
+
+//------------------------------------------------------------------------------
+size_t flxStorageBinaryBlock::getBytesLength(const char *tag)
+{
+    if (!tag || !_snapshot)
+        return 0;
+
+    const flxStorageBinaryPref::binaryValue_t *pValue = _snapshot->getValue(_iBlock, _iNext, tag);
+
+    return pValue && isBytes(pValue->type) ? pValue->length : 0;
+}
+
+//------------------------------------------------------------------------------
+bool flxStorageBinaryBlock::valueExists(const char *tag)
+{
+    if (!tag || !_snapshot)
+        return false;
+
+    return _snapshot->getValue(_iBlock, _iNext, tag) != nullptr;
+}
+
+//------------------------------------------------------------------------------
+// flxStorageBinaryPref
+//------------------------------------------------------------------------------
+
+void flxStorageBinaryPref::clear(void)
+{
+    // swap with empty vectors to release the memory
+    std::vector<char>().swap(_strings);
+    std::vector<uint8_t>().swap(_data);
+    std::vector<binaryBlock_t>().swap(_blocks);
+
+    _iNextBlock = 0;
+    _modified = false;
+}
+
+//------------------------------------------------------------------------------
+// Tags are stored once in the string table. A tag is only looked up here when a value or block is
+// added - finding a value compares the tag with the string table entry of each value.
+
+bool flxStorageBinaryPref::findString(const char *tag, uint16_t &offset, bool bAdd)
+{
+    size_t size = _strings.size();
+
+    for (size_t i = 0; i < size; i += strlen(_strings.data() + i) + 1)
+    {
+        if (strcmp(_strings.data() + i, tag) == 0)
+        {
+            offset = i;
+            return true;
+        }
+    }
+    if (!bAdd)
+        return false;
+
+    // offsets are 16 bits
+    size_t len = strlen(tag) + 1;
+    if (size + len > 0xFFFF)
+    {
+        flxLogM_E(kMsgErrSizeExceeded, "Binary settings string table");
+        return false;
+    }
+    _strings.insert(_strings.end(), tag, tag + len);
+    offset = size;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Values are usually read in the order they were written, so the search starts after the last
+// value found.
+int flxStorageBinaryPref::findValue(uint16_t iBlock, const char *tag, uint16_t &iNext)
+{
+    if (iBlock >= _blocks.size())
+        return -1;
+
+    std::vector<binaryValue_t> &values = _blocks[iBlock].values;
+    size_t nValues = values.size();
+
+    for (size_t i = 0, iValue = iNext; i < nValues; i++, iValue++)
+    {
+        if (iValue >= nValues)
+            iValue = 0;
+
+        if (strcmp(string(values[iValue].tag), tag) == 0)
+        {
+            iNext = iValue + 1;
+            return iValue;
+        }
+    }
+    return -1;
+}
+
+//------------------------------------------------------------------------------
+const flxStorageBinaryPref::binaryValue_t *flxStorageBinaryPref::getValue(uint16_t iBlock, uint16_t &iNext,
+                                                                          const char *tag)
+{
+    int iValue = findValue(iBlock, tag, iNext);
+
+    return iValue < 0 ? nullptr : &_blocks[iBlock].values[iValue];
+}
+
+//------------------------------------------------------------------------------
+// A value of the same type and size is updated in place - otherwise the data is added to the end of
+// the data in RAM, and the old data is dropped when the snapshot is written out.
+
+bool flxStorageBinaryPref::setValue(uint16_t iBlock, uint16_t &iNext, const char *tag, uint8_t type,
+                                    const void *data, size_t len)
+{
+    if (iBlock >= _blocks.size() || len > 0xFFFF)
+        return false;
+
+    std::vector<binaryValue_t> &values = _blocks[iBlock].values;
+
+    int iValue = findValue(iBlock, tag, iNext);
+    if (iValue >= 0)
+    {
+        binaryValue_t &theValue = values[iValue];
+
+        if (theValue.type == type && theValue.length == len)
+        {
+            // unchanged values don't cause a write of the snapshot
+            if (len > 0 && memcmp(_data.data() + theValue.offset, data, len) != 0)
+            {
+                memcpy(_data.data() + theValue.offset, data, len);
+                _modified = true;
+            }
+            return true;
+        }
+    }
+    else
+    {
+        if (values.size() >= 0xFFFF)
+            return false;
+
+        uint16_t offTag;
+        if (!findString(tag, offTag, true))
+            return false;
+
+        values.push_back({offTag, 0, 0, 0});
+        iValue = values.size() - 1;
+        iNext = iValue + 1;
+    }
+
+    binaryValue_t &theValue = values[iValue];
+
+    theValue.type = type;
+    theValue.length = len;
+    theValue.offset = _data.size();
+
+    if (len > 0)
+        _data.insert(_data.end(), (const uint8_t *)data, (const uint8_t *)data + len);
+
+    _modified = true;
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Load the snapshot in one pass through the file, checking the CRC and the structure of the file.
+// The values section is kept as read - the values point at their data in the records.
+
+bool flxStorageBinaryPref::load(const char *szFile)
+{
+    flxFSFile theFile = _fileSystem->open(szFile, flxIFileSystem::kFileRead);
+    if (!theFile)
+    {
+        flxLogM_W(kMsgErrFileOpen, "Binary Settings", szFile);
+        return false;
+    }
+
+    flxBinaryFileReader theReader(theFile);
+
+    uint8_t header[kSnapshotHeaderSize] = {0};
+
+    bool status = theReader.read(header, sizeof(header)) && get32(header) == kSnapshotMagic &&
+                  get16(header + 4) == kSnapshotVersion;
+
+    uint16_t nBlocks = get16(header + 6);
+    uint32_t stringsSize = get32(header + 8);
+    uint32_t valuesSize = get32(header + 12);
+
+    // the sections must fill the file
+    status = status && stringsSize <= 0xFFFF &&
+             theFile.size() == kSnapshotHeaderSize + stringsSize + nBlocks * kSnapshotDirEntrySize + valuesSize +
+                                   kSnapshotCRCSize;
+
+    std::vector<uint8_t> directory;
+
+    if (status)
+    {
+        _strings.resize(stringsSize);
+        directory.resize(nBlocks * kSnapshotDirEntrySize);
+        _data.resize(valuesSize);
+
+        status = theReader.read(_strings.data(), stringsSize) &&
+                 theReader.read(directory.data(), directory.size()) && theReader.read(_data.data(), valuesSize);
+    }
+    if (status)
+    {
+        uint32_t crc = theReader.crc();
+        uint8_t fileCRC[kSnapshotCRCSize];
+
+        status = theReader.read(fileCRC, sizeof(fileCRC)) && get32(fileCRC) == crc;
+    }
+    theFile.close();
+
+    // every tag must be terminated
+    status = status && (stringsSize == 0 || _strings[stringsSize - 1] == '\0');
+
+    // build the blocks - the records of each block follow the records of the previous block
+    uint32_t position = 0;
+
+    if (status)
+        _blocks.resize(nBlocks);
+
+    for (uint16_t iBlock = 0; status && iBlock < nBlocks; iBlock++)
+    {
+        const uint8_t *pEntry = directory.data() + iBlock * kSnapshotDirEntrySize;
+
+        binaryBlock_t &theBlock = _blocks[iBlock];
+        theBlock.tag = get16(pEntry);
+        uint16_t nValues = get16(pEntry + 2);
+
+        status = theBlock.tag < stringsSize && get32(pEntry + 4) == position;
+
+        if (status)
+            theBlock.values.resize(nValues);
+
+        for (uint16_t iValue = 0; status && iValue < nValues; iValue++)
+        {
+            if (position + kSnapshotRecordSize > valuesSize)
+            {
+                status = false;
+                break;
+            }
+            const uint8_t *pRecord = _data.data() + position;
+
+            binaryValue_t &theValue = theBlock.values[iValue];
+            theValue.type = pRecord[0];
+            theValue.tag = get16(pRecord + 1);
+            theValue.length = get16(pRecord + 3);
+            theValue.offset = position + kSnapshotRecordSize;
+
+            position = theValue.offset + theValue.length;
+
+            status = theValue.type >= kTypeBool && theValue.type <= kTypeBytes && theValue.tag < stringsSize &&
+                     position <= valuesSize;
+        }
+    }
+    status = status && position == valuesSize;
+
+    if (!status)
+    {
+        flxLogM_E(kMsgErrValueError, "Binary Settings", szFile);
+        clear();
+    }
+
+    return status;
+}
+
+//------------------------------------------------------------------------------
+// Write the snapshot to a temporary file, then replace the snapshot file with it. The records are
+// written from the values - data dropped by updates isn't written.
+//
+// The temporary file is only deleted while the snapshot file is still in place. Once the snapshot
+// file is removed, the temporary file is the only copy of the settings - if the rename fails it's
+// kept, and begin() loads it.
+
+bool flxStorageBinaryPref::save(void)
+{
+    uint32_t valuesSize = 0;
+
+    for (auto &theBlock : _blocks)
+    {
+        for (auto &theValue : theBlock.values)
+            valuesSize += kSnapshotRecordSize + theValue.length;
+    }
+
+    std::string tmpName = _filename + ".tmp";
+
+    flxFSFile theFile = _fileSystem->open(tmpName.c_str(), flxIFileSystem::kFileWrite, true);
+    if (!theFile)
+    {
+        flxLogM_E(kMsgErrFileOpen, "Binary Settings", tmpName.c_str());
+        return false;
+    }
+
+    flxBinaryFileWriter theWriter(theFile);
+
+    uint8_t buffer[kSnapshotHeaderSize];
+
+    put32(buffer, kSnapshotMagic);
+    put16(buffer + 4, kSnapshotVersion);
+    put16(buffer + 6, _blocks.size());
+    put32(buffer + 8, _strings.size());
+    put32(buffer + 12, valuesSize);
+    theWriter.write(buffer, kSnapshotHeaderSize);
+
+    theWriter.write(_strings.data(), _strings.size());
+
+    uint32_t position = 0;
+
+    for (auto &theBlock : _blocks)
+    {
+        put16(buffer, theBlock.tag);
+        put16(buffer + 2, theBlock.values.size());
+        put32(buffer + 4, position);
+        theWriter.write(buffer, kSnapshotDirEntrySize);
+
+        for (auto &theValue : theBlock.values)
+            position += kSnapshotRecordSize + theValue.length;
+    }
+
+    for (auto &theBlock : _blocks)
+    {
+        for (auto &theValue : theBlock.values)
+        {
+            buffer[0] = theValue.type;
+            put16(buffer + 1, theValue.tag);
+            put16(buffer + 3, theValue.length);
+            theWriter.write(buffer, kSnapshotRecordSize);
+            theWriter.write(_data.data() + theValue.offset, theValue.length);
+        }
+    }
+
+    put32(buffer, theWriter.crc());
+    theWriter.write(buffer, kSnapshotCRCSize);
+
+    bool status = theWriter.flush();
+    theFile.close();
+
+    if (status && _fileSystem->exists(_filename.c_str()))
+        status = _fileSystem->remove(_filename.c_str());
+
+    if (!status)
+    {
+        flxLog_E(F("Error writing binary settings file"));
+        _fileSystem->remove(tmpName.c_str());
+        return false;
+    }
+
+    if (!_fileSystem->rename(tmpName.c_str(), _filename.c_str()))
+    {
+        flxLog_E(F("Error renaming binary settings file - the settings are in %s"), tmpName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// The existing snapshot is loaded in both modes - a save can write a subset of the settings (an
+// incremental save, or a save of one object), and the other values are kept.
+//
+// If the snapshot file is missing or isn't valid, the temporary file of a save that was interrupted
+// after it was written is loaded. The next save then writes the snapshot file.
+
+bool flxStorageBinaryPref::begin(bool readonly)
+{
+    if (!_fileSystem || _filename.length() == 0 || !_fileSystem->enabled())
+    {
+        flxLogM_E(kMsgErrResourceNotAvail, "Binary File Settings:");
+        return false;
+    }
+
+    clear();
+    _readOnly = readonly;
+
+    if (_fileSystem->exists(_filename.c_str()) && load(_filename.c_str()))
+        return true;
+
+    std::string tmpName = _filename + ".tmp";
+
+    if (_fileSystem->exists(tmpName.c_str()) && load(tmpName.c_str()))
+    {
+        flxLog_W(F("Binary settings loaded from %s"), tmpName.c_str());
+        _modified = true;
+    }
+
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void flxStorageBinaryPref::end(void)
+{
+    if (!_readOnly && _modified && _fileSystem && _filename.length() > 0)
+        save();
+
+    clear();
+}
+
+//------------------------------------------------------------------------------
+// Blocks are usually used in the order they were written, so the search starts after the last
+// block found.
+
+flxStorageBinaryBlock *flxStorageBinaryPref::getBlock(const char *tag)
+{
+    if (!tag)
+        return nullptr;
+
+    size_t nBlocks = _blocks.size();
+    uint16_t iBlock = _iNextBlock;
+
+    for (size_t i = 0; i < nBlocks; i++, iBlock++)
+    {
+        if (iBlock >= nBlocks)
+            iBlock = 0;
+
+        if (strcmp(string(_blocks[iBlock].tag), tag) == 0)
+        {
+            _iNextBlock = iBlock + 1;
+
+            _theBlock._iBlock = iBlock;
+            _theBlock._iNext = 0;
+            _theBlock.setReadOnly(_readOnly);
+
+            return &_theBlock;
+        }
+    }
+    return nullptr;
+}
+
+//------------------------------------------------------------------------------
+// A block that isn't in the snapshot is added - unless the storage is read only
+flxStorageBinaryBlock *flxStorageBinaryPref::beginBlock(const char *tag)
+{
+    flxStorageBinaryBlock *pBlock = getBlock(tag);
+
+    if (pBlock || !tag || _readOnly || _blocks.size() >= 0xFFFF)
+        return pBlock;
+
+    uint16_t offTag;
+    if (!findString(tag, offTag, true))
+        return nullptr;
+
+    _blocks.push_back({offTag, {}});
+    _modified = true;
+
+    return getBlock(tag);
+}
+
+//------------------------------------------------------------------------------
+void flxStorageBinaryPref::endBlock(flxStorageBlock *)
+{
+}
+
+//------------------------------------------------------------------------------
+bool flxStorageBinaryPref::nextValue(uint16_t &iBlock, uint16_t &iValue, binaryEntry_t &theEntry)
+{
+    for (; iBlock < _blocks.size(); iBlock++, iValue = 0)
+    {
+        binaryBlock_t &theBlock = _blocks[iBlock];
+
+        if (iValue < theBlock.values.size())
+        {
+            binaryValue_t &theValue = theBlock.values[iValue];
+
+            theEntry.block = string(theBlock.tag);
+            theEntry.tag = string(theValue.tag);
+            theEntry.type = theValue.type;
+            theEntry.data = valueData(&theValue);
+            theEntry.length = theValue.length;
+
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+void flxStorageBinaryPref::resetStorage()
+{
+    clear();
+
+    if (!_fileSystem || _filename.length() == 0)
+        return;
+
+    std::string tmpName = _filename + ".tmp";
+
+    if (_fileSystem->exists(_filename.c_str()))
+        _fileSystem->remove(_filename.c_str());
+
+    if (_fileSystem->exists(tmpName.c_str()))
+        _fileSystem->remove(tmpName.c_str());
+}
+
+//------------------------------------------------------------------------------
+void flxStorageBinaryPref::checkName()
+{
+    if (_filename.length() == 0 || !_fileSystem)
+        return;
+
+    // make a better name that includes the destination
+    char szBuffer[128];
+    snprintf(szBuffer, sizeof(szBuffer), "%s on the %s", _filename.c_str(), _fileSystem->name());
+    setName(szBuffer);
+}
+
+void flxStorageBinaryPref::setFileSystem(flxIFileSystem *theFilesystem)
+{
+    _fileSystem = theFilesystem;
+    checkName();
+}
+
+void flxStorageBinaryPref::setFilename(std::string &filename)
+{
+    _filename = filename;
+    checkName();
+}
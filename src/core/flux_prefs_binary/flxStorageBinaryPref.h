@@ -0,0 +1,252 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * flxStorageBinaryPref.h
+ *
+ * Settings storage in a binary snapshot file - a fast restore and backup of the system settings.
+ *
+ * The snapshot holds all values, including hidden and secure values (an internal storage kind).
+ * Values are stored in binary, with no parsing or tag hashing on restore. The JSON file storage is
+ * used for settings that are edited by hand - with the snapshot as the primary storage and a JSON
+ * file as the fallback, flxSettings restores the snapshot, and a "restore from fallback" moves an
+ * edited JSON file into the snapshot.
+ *
+ * File format - all values are little endian:
+ *
+ *    header       - magic (uint32_t), version (uint16_t), number of blocks (uint16_t),
+ *                   string table size (uint32_t), values size (uint32_t)
+ *    string table - the block and value tags. Each tag is stored once, null terminated, and is
+ *                   referenced by its offset in the table.
+ *    directory    - for each block: tag (uint16_t), number of values (uint16_t), offset of the
+ *                   block's values in the values section (uint32_t)
+ *    values       - the value records of each block. A record is type (uint8_t), tag (uint16_t),
+ *                   data length (uint16_t) and the data. Strings are stored without the null.
+ *    CRC          - CRC32 of everything before it (uint32_t)
+ *
+ * The directory gives the location of each block for random access, and the records are in block
+ * order, so the file can also be read in one sequential pass - which is how this storage reads it.
+ *
+ * The snapshot is loaded into RAM by begin(), and is released by end() - after writing it out if a
+ * value changed. A new snapshot is written to a temporary file and renamed, so an interrupted write
+ * leaves the previous snapshot in place. If the snapshot file is missing or fails its CRC, a valid
+ * temporary file - left by a save that didn't finish the rename - is loaded instead.
+ */
+
+#pragma once
+
+#include "flxFS.h"
+#include "flxStorage.h"
+
+#include <string>
+#include <vector>
+
+class flxStorageBinaryPref;
+
+//------------------------------------------------------------------------------
+class flxStorageBinaryBlock : public flxStorageBlock
+{
+  public:
+    flxStorageBinaryBlock() : _snapshot{nullptr}, _iBlock{0}, _iNext{0}, _readOnly{false}
+    {
+    }
+
+    bool writeBool(const char *tag, bool data);
+    bool writeInt8(const char *tag, int8_t data);
+    bool writeInt16(const char *tag, int16_t data);
+    bool writeInt32(const char *tag, int32_t data);
+    bool writeUInt8(const char *tag, uint8_t data);
+    bool writeUInt16(const char *tag, uint16_t data);
+    bool writeUInt32(const char *tag, uint32_t data);
+    bool writeFloat(const char *tag, float data);
+    bool writeDouble(const char *tag, double data);
+    bool writeString(const char *tag, const char *data);
+    bool writeBytes(const char *tag, const uint8_t *data, size_t len);
+
+    bool readBool(const char *tag, bool &value);
+    bool readInt8(const char *tag, int8_t &value);
+    bool readInt16(const char *tag, int16_t &value);
+    bool readInt32(const char *tag, int32_t &value);
+    bool readUInt8(const char *tag, uint8_t &value);
+    bool readUInt16(const char *tag, uint16_t &value);
+    bool readUInt32(const char *tag, uint32_t &value);
+    bool readFloat(const char *tag, float &value);
+    bool readDouble(const char *tag, double &value);
+    size_t readString(const char *tag, char *data, size_t len);
+    size_t readBytes(const char *tag, uint8_t *data, size_t len);
+
+    size_t getStringLength(const char *tag);
+    size_t getBytesLength(const char *tag);
+
+    bool valueExists(const char *tag);
+
+    flxStorage::flxStorageKind_t kind(void)
+    {
+        return flxStorage::flxStorageKindInternal;
+    }
+
+    void setReadOnly(bool readonly)
+    {
+        _readOnly = readonly;
+    }
+
+  private:
+    friend flxStorageBinaryPref;
+
+    bool write(const char *tag, uint8_t type, const void *data, size_t len);
+    bool read(const char *tag, uint8_t type, void *data, size_t len);
+
+    flxStorageBinaryPref *_snapshot;
+
+    // the block in the snapshot, and the next value to check when finding a value - values are
+    // usually read in the order they were written
+    uint16_t _iBlock;
+    uint16_t _iNext;
+
+    bool _readOnly;
+};
+
+//------------------------------------------------------------------------------
+// flxStorageBinaryPref
+//
+// Settings storage in a binary snapshot file
+class flxStorageBinaryPref : public flxStorage
+{
+  public:
+    flxStorageBinaryPref() : _fileSystem{nullptr}, _filename{""}, _iNextBlock{0}, _readOnly{false}, _modified{false}
+    {
+        setName("Binary File", "Device setting storage using a binary snapshot file");
+        _theBlock._snapshot = this;
+    }
+
+    flxStorageKind_t kind(void)
+    {
+        return flxStorage::flxStorageKindInternal;
+    }
+
+    bool begin(bool readonly = false);
+    void end(void);
+
+    // public methods to manage a block
+    flxStorageBinaryBlock *beginBlock(const char *tag);
+    flxStorageBinaryBlock *getBlock(const char *tag);
+    void endBlock(flxStorageBlock *);
+
+    void resetStorage();
+
+    void setFileSystem(flxIFileSystem *);
+    void setFilename(std::string &name);
+    void setFilename(const char *name)
+    {
+        std::string strName = name;
+        setFilename(strName);
+    }
+
+    size_t heapSize(void)
+    {
+        return flxStorage::heapSize() + _filename.capacity();
+    }
+
+    static constexpr uint32_t kSnapshotMagic = 0x53584C46; // "FLXS"
+    static constexpr uint16_t kSnapshotVersion = 1;
+
+    // value types in the snapshot
+    typedef enum
+    {
+        kTypeBool = 1,
+        kTypeInt8,
+        kTypeInt16,
+        kTypeInt32,
+        kTypeUInt8,
+        kTypeUInt16,
+        kTypeUInt32,
+        kTypeFloat,
+        kTypeDouble,
+        kTypeString,
+        kTypeBytes
+    } binaryType_t;
+
+    // A value in the snapshot - returned by nextValue()
+    typedef struct
+    {
+        const char *block;
+        const char *tag;
+        uint8_t type; // binaryType_t
+        const uint8_t *data;
+        size_t length;
+    } binaryEntry_t;
+
+    // Enumerate the values - between begin() and end(). Returns the first value at or after the position
+    // (block, value), and updates the position to it. Returns false after the last value.
+    bool nextValue(uint16_t &iBlock, uint16_t &iValue, binaryEntry_t &theEntry);
+
+  private:
+    friend flxStorageBinaryBlock;
+
+    void checkName();
+
+    typedef struct
+    {
+        uint16_t tag;    // offset in the string table
+        uint8_t type;    // binaryType_t
+        uint16_t length; // data length
+        uint32_t offset; // offset of the data in _data
+    } binaryValue_t;
+
+    typedef struct
+    {
+        uint16_t tag;
+        std::vector<binaryValue_t> values;
+    } binaryBlock_t;
+
+    // Load a snapshot file - false if the file isn't a valid snapshot
+    bool load(const char *szFile);
+
+    // write out the snapshot file
+    bool save(void);
+
+    void clear(void);
+
+    // offset of a tag in the string table - it's added if needed and bAdd is true
+    bool findString(const char *tag, uint16_t &offset, bool bAdd);
+
+    const char *string(uint16_t offset)
+    {
+        return _strings.data() + offset;
+    }
+
+    // find a value in a block - starting at iNext. Returns the index of the value, or -1
+    int findValue(uint16_t iBlock, const char *tag, uint16_t &iNext);
+
+    bool setValue(uint16_t iBlock, uint16_t &iNext, const char *tag, uint8_t type, const void *data, size_t len);
+    const binaryValue_t *getValue(uint16_t iBlock, uint16_t &iNext, const char *tag);
+
+    const uint8_t *valueData(const binaryValue_t *pValue)
+    {
+        return _data.data() + pValue->offset;
+    }
+
+    // The block used to interface with the system
+    flxStorageBinaryBlock _theBlock;
+
+    flxIFileSystem *_fileSystem;
+    std::string _filename;
+
+    // the snapshot - in RAM between begin() and end()
+    std::vector<char> _strings;
+    std::vector<uint8_t> _data;
+    std::vector<binaryBlock_t> _blocks;
+
+    // the next block to check when finding a block
+    uint16_t _iNextBlock;
+
+    bool _readOnly;
+    bool _modified;
+};
@@ -0,0 +1,126 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ * flxJSONFileStream.h
+ *
+ * Stream JSON between a file and a document. ArduinoJson reads from and writes to the reader/writer
+ * below as it parses or serializes, so the file is never held in memory. The file is read and
+ * written in chunks of kJSONFileChunkSize bytes.
+ */
+
+#pragma once
+
+#include "flxFS.h"
+
+#include <string.h>
+
+#define kJSONFileChunkSize 128
+
+//-----------------------------------------------------------------------------------
+// Reads the file in chunks - the ArduinoJson reader interface
+class flxJSONFileReader
+{
+  public:
+    flxJSONFileReader(flxFSFile &theFile) : _file{theFile}, _next{0}, _end{0}
+    {
+    }
+
+    int read(void)
+    {
+        if (_next == _end && !fill())
+            return -1;
+
+        return _buffer[_next++];
+    }
+
+    size_t readBytes(char *buffer, size_t length)
+    {
+        size_t nRead = 0;
+
+        while (nRead < length)
+        {
+            if (_next == _end && !fill())
+                break;
+
+            size_t nCopy = _end - _next < length - nRead ? _end - _next : length - nRead;
+            memcpy(buffer + nRead, _buffer + _next, nCopy);
+
+            _next += nCopy;
+            nRead += nCopy;
+        }
+        return nRead;
+    }
+
+  private:
+    bool fill(void)
+    {
+        _next = 0;
+        _end = _file.read(_buffer, sizeof(_buffer));
+
+        return _end > 0;
+    }
+
+    flxFSFile &_file;
+    uint8_t _buffer[kJSONFileChunkSize];
+    size_t _next;
+    size_t _end;
+};
+
+//-----------------------------------------------------------------------------------
+// Buffers the serializer output and writes it to the file in chunks - the ArduinoJson writer
+// interface. A failed write is kept and reported by flush().
+class flxJSONFileWriter
+{
+  public:
+    flxJSONFileWriter(flxFSFile &theFile) : _file{theFile}, _count{0}, _error{false}
+    {
+    }
+
+    size_t write(uint8_t c)
+    {
+        return write(&c, 1);
+    }
+
+    size_t write(const uint8_t *buffer, size_t length)
+    {
+        size_t nWritten = 0;
+
+        while (nWritten < length)
+        {
+            if (_count == sizeof(_buffer) && !flush())
+                break;
+
+            size_t nCopy = sizeof(_buffer) - _count < length - nWritten ? sizeof(_buffer) - _count : length - nWritten;
+            memcpy(_buffer + _count, buffer + nWritten, nCopy);
+
+            _count += nCopy;
+            nWritten += nCopy;
+        }
+        return nWritten;
+    }
+
+    // write out the buffered data - returns false if a write to the file failed
+    bool flush(void)
+    {
+        if (_count > 0 && !_error && _file.write(_buffer, _count) != _count)
+            _error = true;
+
+        _count = 0;
+
+        return !_error;
+    }
+
+  private:
+    flxFSFile &_file;
+    uint8_t _buffer[kJSONFileChunkSize];
+    size_t _count;
+    bool _error;
+};
@@ -14,6 +14,7 @@
 
 #include "flxStorageJSONPref.h"
 #include "flxCoreLog.h"
+#include "flxJSONFileStream.h"
 #include "flxUtils.h"
 
 #define kJsonDocumentSize 3600
@@ -409,7 +410,10 @@ void flxStorageJSONPref::resetStorage()
 //-----------------------------------------------------------------------------------
 // File version
 //-----------------------------------------------------------------------------------
+//
+// The JSON is streamed between the file and the document - see flxJSONFileStream.h
 
+//-----------------------------------------------------------------------------------
 bool flxStorageJSONPrefFile::begin(bool readonly)
 {
 
@@ -432,24 +436,15 @@ bool flxStorageJSONPrefFile::begin(bool readonly)
 
         if (theFile)
         {
-            size_t nBytes = theFile.size();
-
-            if (nBytes > 0)
+            if (theFile.size() > 0)
             {
-                char *pBuffer = new char[nBytes];
-
-                if (pBuffer)
-                {
-                    size_t nRead = theFile.read((uint8_t *)pBuffer, nBytes);
-
-                    if (nRead == nBytes)
-                    {
-                        if (deserializeJson(*_spDocument, (const char *)pBuffer, nBytes) == DeserializationError::Ok)
-                            status = true;
-                    }
-                }
+                flxJSONFileReader theReader(theFile);
 
-                delete pBuffer;
+                DeserializationError err = deserializeJson(*_spDocument, theReader);
+                if (!err)
+                    status = true;
+                else if (err.code() == DeserializationError::NoMemory)
+                    flxLogM_E(kMsgErrSizeExceeded, "Preferences JSON Read");
             }
             else
                 flxLog_D(F("JSON Settings Begin - Empty file"));
@@ -467,28 +462,25 @@ bool flxStorageJSONPrefFile::begin(bool readonly)
 
 void flxStorageJSONPrefFile::end(void)
 {
-    if (!_readOnly)
+    if (!_readOnly && _spDocument && _fileSystem && _filename.length() > 0)
     {
+        // Serialize the document straight to the file
+        flxFSFile theFile = _fileSystem->open(_filename.c_str(), flxIFileSystem::kFileWrite, true);
 
-        // Create a json string and write to the filesystem
-        std::string value;
-        if (!serializeJsonPretty(*_spDocument, value))
-        {
-            flxLogM_E(kMsgErrCreateFailure, "JSON Settings", "JSON string");
-        }
-        else if (_fileSystem && _filename.length() > 0)
+        if (theFile)
         {
-            flxFSFile theFile = _fileSystem->open(_filename.c_str(), flxIFileSystem::kFileWrite, true);
+            flxJSONFileWriter theWriter(theFile);
 
-            if (theFile)
-            {
-                if (theFile.write((uint8_t *)value.c_str(), value.length()) == 0)
-                    flxLog_E(F("Error writing JSON settings file"));
-                theFile.close();
-            }
-            else
-                flxLogM_E(kMsgErrFileOpen, "JSON Settings", _filename.c_str());
+            size_t nBytes =
+                _compact ? serializeJson(*_spDocument, theWriter) : serializeJsonPretty(*_spDocument, theWriter);
+
+            if (nBytes == 0 || !theWriter.flush())
+                flxLog_E(F("Error writing JSON settings file"));
+
+            theFile.close();
         }
+        else
+            flxLogM_E(kMsgErrFileOpen, "JSON Settings", _filename.c_str());
     }
     // call super to clear out everything
     flxStorageJSONPref::end();
@@ -547,7 +539,12 @@ bool flxStorageJSONPrefSerial::begin(bool readonly)
 void flxStorageJSONPrefSerial::end(void)
 {
     if (!_readOnly && _spDocument)
-        serializeJsonPretty(*_spDocument, Serial);
+    {
+        if (_compact)
+            serializeJson(*_spDocument, Serial);
+        else
+            serializeJsonPretty(*_spDocument, Serial);
+    }
 
     // call super to clear out everything
     flxStorageJSONPref::end();
@@ -97,7 +97,8 @@ class flxStorageJSONPref : public flxStorage
 {
 
   public:
-    flxStorageJSONPref() : _spDocument{nullptr}, _readOnly{false}, _jsonDocSize{kDefaultJsonDocumentSize}
+    flxStorageJSONPref()
+        : _spDocument{nullptr}, _readOnly{false}, _jsonDocSize{kDefaultJsonDocumentSize}, _compact{false}
     {
     }
     flxStorageJSONPref(size_t buffer_size) : flxStorageJSONPref()
@@ -133,6 +134,16 @@ class flxStorageJSONPref : public flxStorage
         return _jsonDocSize;
     }
 
+    // Compact output has no whitespace - the default is pretty printed output
+    void setCompact(bool bCompact)
+    {
+        _compact = bCompact;
+    }
+    bool compact(void)
+    {
+        return _compact;
+    }
+
   protected:
     // The block used to interface with the system
     flxStorageJSONBlock _theBlock;
@@ -146,6 +157,8 @@ class flxStorageJSONPref : public flxStorage
     bool _readOnly;
 
     size_t _jsonDocSize;
+
+    bool _compact;
 };
 
 //------------------------------------------------------------------
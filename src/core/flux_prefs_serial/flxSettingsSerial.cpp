@@ -11,6 +11,7 @@
 #include "flxSettingsSerial.h"
 #include "flxFlux.h"
 #include "flxSerialField.h"
+#include "flxSettings.h"
 #include "flxUtils.h"
 #include <ctype.h>
 #include <time.h>
@@ -456,6 +457,9 @@ bool flxSettingsSerial::drawPage(flxActionContainer *pCurrent)
 //
 void flxSettingsSerial::drawPageHeader(flxObject *pCurrent, const char *szItem)
 {
+    // show the stored settings of an object with a deferred restore
+    if (pCurrent && pCurrent->restorePending())
+        flxSettings.restoreDeferred(pCurrent);
 
     char szBuffer[kOutputBufferSize];
     char szOutput[kOutputBufferSize];
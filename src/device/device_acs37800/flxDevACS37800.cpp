@@ -20,6 +20,7 @@
 #include "Arduino.h"
 
 #include "flxDevACS37800.h"
+#include "flxSettings.h"
 
 #define kACS37800AddressDefault 0x60
 
@@ -72,6 +73,26 @@ flxDevACS37800::flxDevACS37800()
     flxRegister(senseResistance, "Sense resistance", "Define the voltage sense resistance (Ohms)");
     flxRegister(dividerResistance, "Divider resistance", "Define the voltage divider resistance (Ohms)");
     flxRegister(currentRange, "Current range", "Define the sensor current range (Amps)");
+
+    // Energy metering
+    flxRegister(energyActive, "Energy (Active)", "Active energy (Wh)");
+    flxRegister(energyReactive, "Energy (Reactive)", "Reactive energy (VARh)");
+    flxRegister(powerPeak, "Power (Peak)", "Peak active power since the last observation (Watts)");
+    flxRegister(powerMin, "Power (Minimum)", "Minimum active power since the last observation (Watts)");
+    flxRegister(powerAverage, "Power (Average)", "Average active power since the last observation (Watts)");
+    flxRegister(powerSamples, "Power Samples", "Number of power samples since the last observation");
+
+    flxRegister(energyMetering, "Energy metering", "Sample power in the background and accumulate energy");
+    flxRegister(sampleInterval, "Sample interval", "The power sample interval (ms)");
+    flxRegister(energySaveInterval, "Energy save interval",
+                "How often the energy counters are saved (minutes). 0 = with the system settings only");
+    flxRegister(resetEnergy, "Reset energy", "Reset the energy counters to zero");
+
+    // hidden
+    flxRegister(_extEnergyActive, "EnergyActive");
+    flxRegister(_extEnergyReactive, "EnergyReactive");
+
+    _sampleJob.setup(kACS37800DeviceName, _sampleInterval, this, &flxDevACS37800::sampleJobCB);
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -101,7 +122,121 @@ bool flxDevACS37800::isConnected(flxBusI2C &i2cDriver, uint8_t address)
 //
 bool flxDevACS37800::onInitialize(TwoWire &wirePort)
 {
-    return ACS37800::begin(address(), wirePort);
+    if (!ACS37800::begin(address(), wirePort))
+        return false;
+
+    _lastEnergySave = millis();
+
+    if (_energyMetering)
+        flxAddJobToQueue(_sampleJob);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Energy metering
+//----------------------------------------------------------------------------------------------------------
+
+// Job callback - sample the active and reactive power, and integrate energy using the trapezoidal rule
+void flxDevACS37800::sampleJobCB(void)
+{
+    float active, reactive;
+
+    if (ACS37800::readPowerActiveReactive(&active, &reactive) != 0)
+    {
+        // Can't bridge the gap - start again at the next sample
+        _hasLastSample = false;
+        return;
+    }
+
+    uint32_t now = millis();
+
+    if (_hasLastSample)
+    {
+        double hours = (now - _lastSampleTime) / 3600000.;
+
+        _energyActive += (active + _lastActive) / 2. * hours;
+        _energyReactive += (reactive + _lastReactive) / 2. * hours;
+        energyChanged();
+    }
+    _hasLastSample = true;
+    _lastSampleTime = now;
+    _lastActive = active;
+    _lastReactive = reactive;
+
+    // window statistics
+    if (_windowCount == 0 || active > _windowPeak)
+        _windowPeak = active;
+    if (_windowCount == 0 || active < _windowMin)
+        _windowMin = active;
+    _windowSum += active;
+    _windowCount++;
+
+    // Time to checkpoint the energy counters?
+    if (_energySaveInterval > 0 && now - _lastEnergySave >= _energySaveInterval * 60000UL)
+    {
+        _lastEnergySave = now;
+        if (!flxSettings.save(this))
+            flxLog_W(F("%s: unable to save the energy counters"), name());
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------
+// The energy counters change outside of their property set() methods - mark them dirty, so an incremental
+// save of the system writes them
+void flxDevACS37800::energyChanged(void)
+{
+    _extEnergyActive.setIsDirty();
+    _extEnergyReactive.setIsDirty();
+    this->setIsDirty();
+}
+
+//----------------------------------------------------------------------------------------------------------
+void flxDevACS37800::resetWindow(void)
+{
+    _windowPeak = 0.;
+    _windowMin = 0.;
+    _windowSum = 0.;
+    _windowCount = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------
+bool flxDevACS37800::execute(void)
+{
+    if (!_energyMetering)
+        return true;
+
+    // No samples in this window? Report the last sample
+    if (_windowCount == 0)
+    {
+        _outPeak = _outMin = _outAvg = _lastActive;
+        _outCount = 0;
+        return true;
+    }
+
+    _outPeak = _windowPeak;
+    _outMin = _windowMin;
+    _outAvg = (float)(_windowSum / _windowCount);
+    _outCount = _windowCount;
+
+    resetWindow();
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------
+void flxDevACS37800::reset_energy()
+{
+    _energyActive = 0.;
+    _energyReactive = 0.;
+    energyChanged();
+
+    // Persist the reset - if the counters are being saved
+    if (_energySaveInterval > 0)
+    {
+        _lastEnergySave = millis();
+        flxSettings.save(this);
+    }
 }
 
 // GETTER methods for output params
@@ -249,6 +384,31 @@ bool flxDevACS37800::read_pos_power_factor()
     return _thePosPF;
 }
 
+double flxDevACS37800::read_energy_active()
+{
+    return _energyActive;
+}
+double flxDevACS37800::read_energy_reactive()
+{
+    return _energyReactive;
+}
+float flxDevACS37800::read_window_power_peak()
+{
+    return _outPeak;
+}
+float flxDevACS37800::read_window_power_min()
+{
+    return _outMin;
+}
+float flxDevACS37800::read_window_power_avg()
+{
+    return _outAvg;
+}
+uint32_t flxDevACS37800::read_window_samples()
+{
+    return _outCount;
+}
+
 // methods used to get values for our RW properties
 
 uint32_t flxDevACS37800::get_number_of_samples()
@@ -305,3 +465,65 @@ void flxDevACS37800::set_current_range(float range)
     if (isInitialized())
         ACS37800::setCurrentRange(range);
 }
+bool flxDevACS37800::get_energy_metering()
+{
+    return _energyMetering;
+}
+void flxDevACS37800::set_energy_metering(bool enable)
+{
+    _energyMetering = enable;
+
+    energyActive.setEnabled(enable);
+    energyReactive.setEnabled(enable);
+    powerPeak.setEnabled(enable);
+    powerMin.setEnabled(enable);
+    powerAverage.setEnabled(enable);
+    powerSamples.setEnabled(enable);
+
+    if (!isInitialized())
+        return;
+
+    _hasLastSample = false;
+    resetWindow();
+
+    if (enable)
+        flxAddJobToQueue(_sampleJob);
+    else
+        flxRemoveJobFromQueue(_sampleJob);
+}
+uint16_t flxDevACS37800::get_sample_interval()
+{
+    return _sampleInterval;
+}
+void flxDevACS37800::set_sample_interval(uint16_t interval)
+{
+    _sampleInterval = interval < kACS37800SampleIntervalMin ? kACS37800SampleIntervalMin : interval;
+    _sampleJob.setPeriod(_sampleInterval);
+
+    if (isInitialized() && _energyMetering)
+        flxUpdateJobInQueue(_sampleJob);
+}
+uint16_t flxDevACS37800::get_energy_save_interval()
+{
+    return _energySaveInterval;
+}
+void flxDevACS37800::set_energy_save_interval(uint16_t interval)
+{
+    _energySaveInterval = interval;
+}
+double flxDevACS37800::get_ext_energy_active()
+{
+    return _energyActive;
+}
+void flxDevACS37800::set_ext_energy_active(double energy)
+{
+    _energyActive = energy;
+}
+double flxDevACS37800::get_ext_energy_reactive()
+{
+    return _energyReactive;
+}
+void flxDevACS37800::set_ext_energy_reactive(double energy)
+{
+    _energyReactive = energy;
+}
@@ -23,10 +23,22 @@
 #include "Arduino.h"
 
 #include "SparkFun_ACS37800_Arduino_Library.h"
+#include "flxCoreJobs.h"
 #include "flxDevice.h"
 
 // What is the name used to ID this device?
 #define kACS37800DeviceName "ACS37800"
+
+// Energy metering
+//
+// A job samples the active and reactive power at the sample interval and integrates energy between
+// samples. The energy counters are persisted to settings at the save interval.
+#define kACS37800SampleIntervalDefault 100
+#define kACS37800SampleIntervalMin 10
+#define kACS37800SampleIntervalMax 10000
+
+#define kACS37800EnergySaveDefault 15 // minutes
+#define kACS37800EnergySaveMax 1440
 //----------------------------------------------------------------------------------------------------------
 // Define our class - note we are sub-classing from the Qwiic Library
 class flxDevACS37800 : public flxDeviceI2CType<flxDevACS37800>, public ACS37800
@@ -62,6 +74,9 @@ class flxDevACS37800 : public flxDeviceI2CType<flxDevACS37800>, public ACS37800
     // Called when a managed property is updated
     void onPropertyUpdate(const char *);
 
+    // Called before the output parameters are read - snapshots and resets the window statistics
+    bool execute(void);
+
   private:
     // methods used to get values for our output parameters
     float read_volts();
@@ -75,6 +90,12 @@ class flxDevACS37800 : public flxDeviceI2CType<flxDevACS37800>, public ACS37800
     float read_power_factor();
     bool read_pos_angle();
     bool read_pos_power_factor();
+    double read_energy_active();
+    double read_energy_reactive();
+    float read_window_power_peak();
+    float read_window_power_min();
+    float read_window_power_avg();
+    uint32_t read_window_samples();
 
     // methods used to get values for our RW properties
     uint32_t get_number_of_samples();
@@ -87,6 +108,26 @@ class flxDevACS37800 : public flxDeviceI2CType<flxDevACS37800>, public ACS37800
     float get_divider_resistance();
     void set_current_range(float);
     float get_current_range();
+    bool get_energy_metering();
+    void set_energy_metering(bool);
+    uint16_t get_sample_interval();
+    void set_sample_interval(uint16_t);
+    uint16_t get_energy_save_interval();
+    void set_energy_save_interval(uint16_t);
+
+    // hidden - persisted energy counters
+    double get_ext_energy_active();
+    void set_ext_energy_active(double);
+    double get_ext_energy_reactive();
+    void set_ext_energy_reactive(double);
+
+    // methods for our input parameters
+    void reset_energy();
+
+    // energy metering job
+    void sampleJobCB(void);
+    void energyChanged(void);
+    void resetWindow(void);
 
     // Flags to prevent readInstantaneous being called multiple times
     bool _volts = false;
@@ -125,6 +166,35 @@ class flxDevACS37800 : public flxDeviceI2CType<flxDevACS37800>, public ACS37800
     float _dividerResistance = ACS37800_DEFAULT_DIVIDER_RES;
     float _currentRange = ACS37800_DEFAULT_CURRENT_RANGE;
 
+    // Energy metering
+    bool _energyMetering = true;
+    uint16_t _sampleInterval = kACS37800SampleIntervalDefault;
+    uint16_t _energySaveInterval = kACS37800EnergySaveDefault;
+
+    double _energyActive = 0.;   // Wh
+    double _energyReactive = 0.; // VARh
+
+    // the previous sample - for the trapezoidal rule
+    bool _hasLastSample = false;
+    uint32_t _lastSampleTime = 0;
+    float _lastActive = 0.;
+    float _lastReactive = 0.;
+
+    uint32_t _lastEnergySave = 0;
+
+    // active power statistics for the current window (between observations), and the last window
+    float _windowPeak = 0.;
+    float _windowMin = 0.;
+    double _windowSum = 0.;
+    uint32_t _windowCount = 0;
+
+    float _outPeak = 0.;
+    float _outMin = 0.;
+    float _outAvg = 0.;
+    uint32_t _outCount = 0;
+
+    flxJob _sampleJob;
+
   public:
     // Define our output parameters - specify the get functions to call.
     flxParameterOutFloat<flxDevACS37800, &flxDevACS37800::read_volts> volts;
@@ -139,6 +209,17 @@ class flxDevACS37800 : public flxDeviceI2CType<flxDevACS37800>, public ACS37800
     flxParameterOutBool<flxDevACS37800, &flxDevACS37800::read_pos_angle> positiveAngle;
     flxParameterOutBool<flxDevACS37800, &flxDevACS37800::read_pos_power_factor> positivePowerFactor;
 
+    // Energy metering outputs
+    flxParameterOutDouble<flxDevACS37800, &flxDevACS37800::read_energy_active> energyActive;
+    flxParameterOutDouble<flxDevACS37800, &flxDevACS37800::read_energy_reactive> energyReactive;
+    flxParameterOutFloat<flxDevACS37800, &flxDevACS37800::read_window_power_peak> powerPeak;
+    flxParameterOutFloat<flxDevACS37800, &flxDevACS37800::read_window_power_min> powerMin;
+    flxParameterOutFloat<flxDevACS37800, &flxDevACS37800::read_window_power_avg> powerAverage;
+    flxParameterOutUInt32<flxDevACS37800, &flxDevACS37800::read_window_samples> powerSamples;
+
+    // Input parameters
+    flxParameterInVoid<flxDevACS37800, &flxDevACS37800::reset_energy> resetEnergy;
+
     // Define our read-write properties
     flxPropertyRWUInt32<flxDevACS37800, &flxDevACS37800::get_number_of_samples, &flxDevACS37800::set_number_of_samples>
         numberOfSamples = {0, 0, 1023};
@@ -154,4 +235,22 @@ class flxDevACS37800 : public flxDeviceI2CType<flxDevACS37800>, public ACS37800
 
     flxPropertyRWFloat<flxDevACS37800, &flxDevACS37800::get_current_range, &flxDevACS37800::set_current_range>
         currentRange;
+
+    flxPropertyRWBool<flxDevACS37800, &flxDevACS37800::get_energy_metering, &flxDevACS37800::set_energy_metering>
+        energyMetering = {true};
+
+    flxPropertyRWUInt16<flxDevACS37800, &flxDevACS37800::get_sample_interval, &flxDevACS37800::set_sample_interval>
+        sampleInterval = {kACS37800SampleIntervalDefault, kACS37800SampleIntervalMin, kACS37800SampleIntervalMax};
+
+    flxPropertyRWUInt16<flxDevACS37800, &flxDevACS37800::get_energy_save_interval,
+                        &flxDevACS37800::set_energy_save_interval>
+        energySaveInterval = {kACS37800EnergySaveDefault, 0, kACS37800EnergySaveMax};
+
+    // Energy counters - hidden properties, so they persist between startup/shutdown of the system
+    flxPropertyRWHiddenDouble<flxDevACS37800, &flxDevACS37800::get_ext_energy_active,
+                              &flxDevACS37800::set_ext_energy_active>
+        _extEnergyActive;
+    flxPropertyRWHiddenDouble<flxDevACS37800, &flxDevACS37800::get_ext_energy_reactive,
+                              &flxDevACS37800::set_ext_energy_reactive>
+        _extEnergyReactive;
 };
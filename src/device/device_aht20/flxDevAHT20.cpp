@@ -26,7 +26,7 @@ uint8_t flxDevAHT20::defaultDeviceAddress[] = {AHT20_DEFAULT_ADDRESS, kSparkDevi
 // Register this class with the system - this enables the *auto load* of this device
 flxRegisterDevice(flxDevAHT20);
 
-flxDevAHT20::flxDevAHT20()
+flxDevAHT20::flxDevAHT20() : _sampleInterval{kAHT20DefaultSampleInterval}, _temperatureC{0}, _humidity{0}
 {
 
     spSetupDeviceIdent(getDeviceName());
@@ -35,16 +35,96 @@ flxDevAHT20::flxDevAHT20()
     // Register output params
     flxRegister(temperatureC, "Temperature (C)", "The temperature in degrees C");
     flxRegister(humidity, "Humidity (%RH)", "The relative humidity in %");
+
+    flxRegister(sampleInterval, "Sample Interval (ms)", "The time between sensor measurements in milliseconds");
+
+    // Measurements run in the background - trigger, then collect the results once the conversion is
+    // done. This removes the ~80 ms blocking wait the AHT20 library performs for each read.
+    _measureCycle.setup(getDeviceName(), _sampleInterval, this, &flxDevAHT20::triggerMeasurement,
+                        &flxDevAHT20::collectMeasurement);
 }
 
-// Function to encapsulate the ops needed to get values from the sensor.
+// Return the cached values from the last measurement
 float flxDevAHT20::read_temperature_c()
 {
-    return AHT20::getTemperature();
+    return _temperatureC;
 }
 float flxDevAHT20::read_humidity()
 {
-    return AHT20::getHumidity();
+    return _humidity;
+}
+
+//----------------------------------------------------------------------------------------------------------
+uint32_t flxDevAHT20::get_sample_interval(void)
+{
+    return _sampleInterval;
+}
+
+void flxDevAHT20::set_sample_interval(uint32_t interval)
+{
+    _sampleInterval = interval;
+    _measureCycle.setPeriod(interval);
+}
+
+//----------------------------------------------------------------------------------------------------------
+// CRC8 - polynomial 0x31, init 0xFF
+//
+uint8_t flxDevAHT20::computeCRC(uint8_t *pData, uint8_t length)
+{
+    uint8_t crc = 0xFF; // Init with 0xFF
+    for (uint8_t x = 0; x < length; x++)
+    {
+        crc ^= pData[x]; // XOR-in the next input byte
+
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            if ((crc & 0x80) != 0)
+                crc = (uint8_t)((crc << 1) ^ 0x31);
+            else
+                crc <<= 1;
+        }
+    }
+    return crc;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Start a conversion. Returns the time needed to complete the conversion - 0 on error
+//
+uint32_t flxDevAHT20::triggerMeasurement(void)
+{
+    uint8_t command[3] = {0xAC, 0x33, 0x00};
+
+    if (!_i2cBus.write(address(), command, sizeof(command)))
+        return 0;
+
+    // datasheet - wait 80 ms for the measurement to complete
+    return 80;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Read the results of the conversion into the cached values
+//
+bool flxDevAHT20::collectMeasurement(void)
+{
+    uint8_t results[7];
+
+    if (_i2cBus.receiveResponse(address(), results, sizeof(results)) != sizeof(results))
+        return false;
+
+    // still busy? Skip this measurement
+    if ((results[0] & 0x80) != 0)
+        return false;
+
+    if (computeCRC(results, 6) != results[6])
+        return false;
+
+    uint32_t rawHumidity = ((uint32_t)results[1] << 12) | ((uint32_t)results[2] << 4) | (results[3] >> 4);
+    uint32_t rawTemperature = ((uint32_t)(results[3] & 0x0F) << 16) | ((uint32_t)results[4] << 8) | results[5];
+
+    _humidity = ((float)rawHumidity / 1048576.) * 100.;
+    _temperatureC = ((float)rawTemperature / 1048576.) * 200. - 50.;
+
+    return true;
 }
 
 // Static method used to determine if this device is connected
@@ -70,19 +150,7 @@ bool flxDevAHT20::isConnected(flxBusI2C &i2cDriver, uint8_t address)
     }
 
     // Check CRC
-    uint8_t crc = 0xFF; // Init with 0xFF
-    for (uint8_t x = 0; x < 6; x++)
-    {
-        crc ^= results[x]; // XOR-in the next input byte
-
-        for (uint8_t i = 0; i < 8; i++)
-        {
-            if ((crc & 0x80) != 0)
-                crc = (uint8_t)((crc << 1) ^ 0x31);
-            else
-                crc <<= 1;
-        }
-    }
+    uint8_t crc = computeCRC(results, 6);
     if (crc == results[6])
         return true;
 
@@ -104,7 +172,15 @@ bool flxDevAHT20::onInitialize(TwoWire &wirePort)
     bool result = AHT20::begin(wirePort);
 
     if (!result)
+    {
         flxLog_E("AHT20 - begin failed");
+        return false;
+    }
+
+    _i2cBus.setWirePort(wirePort);
+
+    // start the background measurements
+    _measureCycle.start();
 
-    return result;
+    return true;
 }
@@ -21,10 +21,14 @@
 
 #include "Arduino.h"
 #include "SparkFun_Qwiic_Humidity_AHT20.h"
+#include "flxCoreJobs.h"
 #include "flxDevice.h"
 
 #define kAHT20DeviceName "AHT20"
 
+// Default time between measurements - ms
+#define kAHT20DefaultSampleInterval 2000
+
 // Define our class
 class flxDevAHT20 : public flxDeviceI2CType<flxDevAHT20>, public AHT20
 {
@@ -57,7 +61,28 @@ class flxDevAHT20 : public flxDeviceI2CType<flxDevAHT20>, public AHT20
     float read_temperature_c();
     float read_humidity();
 
+    uint32_t get_sample_interval(void);
+    void set_sample_interval(uint32_t);
+
+    // measurement cycle methods
+    uint32_t triggerMeasurement(void);
+    bool collectMeasurement(void);
+
+    static uint8_t computeCRC(uint8_t *pData, uint8_t length);
+
+    flxBusI2C _i2cBus;
+    flxMeasurementCycle _measureCycle;
+
+    uint32_t _sampleInterval;
+
+    // cached values from the last measurement
+    float _temperatureC;
+    float _humidity;
+
   public:
+    flxPropertyRWUInt32<flxDevAHT20, &flxDevAHT20::get_sample_interval, &flxDevAHT20::set_sample_interval>
+        sampleInterval = {kAHT20DefaultSampleInterval, 250, 60000};
+
     // Define our output parameters - specify the get functions to call.
     flxParameterOutFloat<flxDevAHT20, &flxDevAHT20::read_temperature_c> temperatureC;
     flxParameterOutFloat<flxDevAHT20, &flxDevAHT20::read_humidity> humidity;
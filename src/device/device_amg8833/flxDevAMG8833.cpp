@@ -21,6 +21,10 @@
 
 #include "flxDevAMG8833.h"
 
+// The pixel temperature registers - 64 pixels, two bytes each, low byte first
+#define kAMG8833PixelRegister 0x80
+#define kAMG8833NumPixels 64
+
 uint8_t flxDevAMG8833::defaultDeviceAddress[] = {0x69, 0x68, kSparkDeviceAddressNull};
 
 // Register this class with the system - this enables the *auto load* of this device
@@ -84,6 +88,8 @@ bool flxDevAMG8833::onInitialize(TwoWire &wirePort)
     // device construction
     GridEYE::begin(address(), wirePort); // Returns void
 
+    _i2cBus.setWirePort(wirePort);
+
     if (_frameRate10FPS)
         GridEYE::setFramerate10FPS();
     else
@@ -124,12 +130,28 @@ float flxDevAMG8833::read_device_temperature_C()
 
 bool flxDevAMG8833::read_pixel_temperatures(flxDataArrayFloat *temps)
 {
-    static float theTemps[64] = {-99.0};
+    static float theTemps[kAMG8833NumPixels] = {-99.0};
 
+    // Read all the pixel registers in as few transactions as the Wire buffer allows, rather than
+    // a transaction per pixel.
+    uint8_t pixelData[kAMG8833NumPixels * 2];
+
+    if (!_i2cBus.readRegisterBurst(address(), kAMG8833PixelRegister, pixelData, sizeof(pixelData)))
+        return false;
+
+    int16_t value;
     int i = 0;
     for (int y = 0; y < 8; y++)
-        for (int x = 0; x < 64; x += 8)
-            theTemps[i++] = GridEYE::getPixelTemperature(x + y);
+    {
+        for (int x = 0; x < kAMG8833NumPixels; x += 8)
+        {
+            // 12-bit, two's complement value - 0.25C per LSB
+            value = (int16_t)((uint16_t)pixelData[(x + y) * 2] | (uint16_t)pixelData[(x + y) * 2 + 1] << 8);
+            value = (int16_t)(value << 4) >> 4;
+
+            theTemps[i++] = value * 0.25;
+        }
+    }
 
     temps->set(theTemps, 8, 8, true); // don't copy
 
@@ -59,6 +59,9 @@ class flxDevAMG8833 : public flxDeviceI2CType<flxDevAMG8833>, public GridEYE
 
     bool _frameRate10FPS = true; // Default to 10 FPS
 
+    // Used for block reads of the pixel registers
+    flxBusI2C _i2cBus;
+
     uint8_t get_frame_rate();
     void set_frame_rate(uint8_t);
 
@@ -29,7 +29,9 @@ flxRegisterDevice(flxDevAS7331);
 //----------------------------------------------------------------------------------------------------------
 /// @brief Constructor
 ///
-flxDevAS7331::flxDevAS7331() : _gain{GAIN_256}, _convTime{TIME_64MS}, _valid_data{false}, _in_setup{false}
+flxDevAS7331::flxDevAS7331()
+    : _gain{GAIN_256}, _convTime{TIME_64MS}, _sampleInterval{kAS7331DefaultSampleInterval}, _valid_data{false},
+      _in_setup{false}
 {
 
     setName(getDeviceName(), "AS7331 UV Spectral Sensor");
@@ -37,12 +39,17 @@ flxDevAS7331::flxDevAS7331() : _gain{GAIN_256}, _convTime{TIME_64MS}, _valid_dat
     // Properties
     flxRegister(sensorGain, "Gain", "Sensor gain setting");
     flxRegister(conversionTime, "Conversion Time", "Integration/conversion time");
+    flxRegister(sampleInterval, "Sample Interval (ms)", "The time between sensor measurements in milliseconds");
 
     // Data parameters
     flxRegister(uvaValue, "UVA", "UVA irradiance (uW/cm2)");
     flxRegister(uvbValue, "UVB", "UVB irradiance (uW/cm2)");
     flxRegister(uvcValue, "UVC", "UVC irradiance (uW/cm2)");
     flxRegister(temperatureC, "Temperature", "Sensor temperature (C)");
+
+    // Measurements run in the background, so reading values doesn't block for the conversion time
+    _measureCycle.setup(getDeviceName(), _sampleInterval, this, &flxDevAS7331::triggerMeasurement,
+                        &flxDevAS7331::collectMeasurement);
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -102,13 +109,15 @@ bool flxDevAS7331::onInitialize(TwoWire &wirePort)
 
     _in_setup = false;
 
-    // Use command (one-shot) mode — take a measurement each time execute() is called
+    // Use command (one-shot) mode — each measurement is started by the measurement cycle
     if (!SfeAS7331ArdI2C::prepareMeasurement(MEAS_MODE_CMD))
     {
         flxLog_D(F("%s : Failed to prepare measurement."), name());
         return false;
     }
 
+    _measureCycle.start();
+
     return true;
 }
 
@@ -158,27 +167,51 @@ void flxDevAS7331::set_conv_time(uint16_t value)
         flxLog_W(F("%s : Failed to set conversion time."), name());
 }
 
+//---------------------------------------------------------------------------
+// Sample interval property - getter/setter
+//---------------------------------------------------------------------------
+
+uint32_t flxDevAS7331::get_sample_interval(void)
+{
+    return _sampleInterval;
+}
+
+void flxDevAS7331::set_sample_interval(uint32_t interval)
+{
+    _sampleInterval = interval;
+    _measureCycle.setPeriod(interval);
+}
+
 //---------------------------------------------------------------------------
 ///
-/// @brief Called right before data parameters are read — triggers a one-shot measurement
+/// @brief Starts a one-shot measurement
 ///
-bool flxDevAS7331::execute(void)
+/// @return The time needed to complete the conversion in ms, 0 on error
+///
+uint32_t flxDevAS7331::triggerMeasurement(void)
 {
-    // Start a one-shot measurement
     if (SfeAS7331ArdI2C::setStartState(true) != 0)
     {
-        flxLog_E(F("%s : Failed to start measurement."), name());
-        _valid_data = false;
-        return false;
+        flxLog_D(F("%s : Failed to start measurement."), name());
+        return 0;
     }
 
-    // Wait for conversion to complete — conversion time + margin
-    delay(2 + SfeAS7331ArdI2C::getConversionTimeMillis());
+    // conversion time + margin
+    return 2 + SfeAS7331ArdI2C::getConversionTimeMillis();
+}
 
+//---------------------------------------------------------------------------
+///
+/// @brief Reads the results of a completed measurement - the values are cached by the library
+///
+/// @return true on success
+///
+bool flxDevAS7331::collectMeasurement(void)
+{
     // Read all UV channels + temperature
     if (SfeAS7331ArdI2C::readAllUV() != 0)
     {
-        flxLog_E(F("%s : Failed to read UV data."), name());
+        flxLog_D(F("%s : Failed to read UV data."), name());
         _valid_data = false;
         return false;
     }
@@ -188,3 +221,13 @@ bool flxDevAS7331::execute(void)
     _valid_data = true;
     return true;
 }
+
+//---------------------------------------------------------------------------
+///
+/// @brief Called right before data parameters are read. The measurement runs in the background,
+///        so this just reports if the cached values are valid.
+///
+bool flxDevAS7331::execute(void)
+{
+    return _valid_data;
+}
@@ -18,10 +18,15 @@
 #pragma once
 #include "SparkFun_AS7331.h"
 #include "flxCore.h"
+#include "flxCoreJobs.h"
 #include "flxDevice.h"
 
 #define kAS7331DeviceName "AS7331"
 
+// Default time between measurements - ms. If the conversion time is longer than the interval, the
+// measurement runs at the conversion rate.
+#define kAS7331DefaultSampleInterval 1000
+
 // Define our class
 class flxDevAS7331 : public flxDeviceI2CType<flxDevAS7331>, public SfeAS7331ArdI2C
 {
@@ -64,7 +69,17 @@ class flxDevAS7331 : public flxDeviceI2CType<flxDevAS7331>, public SfeAS7331ArdI
     void set_conv_time(uint16_t);
     uint16_t _convTime;
 
-    // UV channel accessors — values cached by execute()
+    uint32_t get_sample_interval(void);
+    void set_sample_interval(uint32_t);
+    uint32_t _sampleInterval;
+
+    // measurement cycle methods
+    uint32_t triggerMeasurement(void);
+    bool collectMeasurement(void);
+
+    flxMeasurementCycle _measureCycle;
+
+    // UV channel accessors — values cached by the last measurement
     float get_uva_value(void)
     {
         return _valid_data ? getUVA() : 0.0f;
@@ -123,6 +138,9 @@ class flxDevAS7331 : public flxDeviceI2CType<flxDevAS7331>, public SfeAS7331ArdI
          {"8192ms", TIME_8192MS},
          {"16384ms", TIME_16384MS}}};
 
+    flxPropertyRWUInt32<flxDevAS7331, &flxDevAS7331::get_sample_interval, &flxDevAS7331::set_sample_interval>
+        sampleInterval = {kAS7331DefaultSampleInterval, 10, 60000};
+
     // Data parameters — UV irradiance in uW/cm²
     flxParameterOutFloat<flxDevAS7331, &flxDevAS7331::get_uva_value> uvaValue;
     flxParameterOutFloat<flxDevAS7331, &flxDevAS7331::get_uvb_value> uvbValue;
@@ -21,6 +21,8 @@
 
 #include "flxDevButton.h"
 
+#include <map>
+
 // The Qwiic Button can be configured to have any I2C address (via I2C methods)
 // The four jumper links on the back of the board allow it to be given 16 addresses: 0x6F - 0x60
 // To avoid collisions with other sensors (MCP9600, VCNL4040, SCD30) we'll limit the supported addresses here to: 0x6F -
@@ -30,6 +32,12 @@ uint8_t flxDevButton::defaultDeviceAddress[] = {
 
 #define kButtonUpdateIntervalMS 170
 
+// When the INT pin is used, the job only checks the interrupt count - no bus traffic - so it runs faster
+#define kButtonInterruptIntervalMS 20
+
+// Size of the click queue on the device
+#define kButtonClickQueueSize 15
+
 //----------------------------------------------------------------------------------------------------------
 // Register this class with the system, enabling this driver during system
 // initialization and device discovery.
@@ -54,6 +62,7 @@ flxDevButton::flxDevButton()
 
     // Register parameters
     flxRegister(buttonState, "Button State", "The current state of the button");
+    flxRegister(pressTime, "Press Time (ms)", "System time of the last button press");
 
     // setup our job -
     _theJob.setup(name(), kButtonUpdateIntervalMS, this, &flxDevButton::checkButton);
@@ -99,6 +108,9 @@ bool flxDevButton::onInitialize(TwoWire &wirePort)
 
     rc &= QwiicButton::LEDoff(); // Make sure the LED is off
 
+    if (rc && _bInterruptEnabled && _intrPin > 0)
+        setupInterrupt();
+
     return rc;
 }
 
@@ -111,6 +123,11 @@ bool flxDevButton::read_button_state()
         return _toggle_state;
 }
 
+uint32_t flxDevButton::read_press_time()
+{
+    return _pressTime;
+}
+
 // methods for the read-write properties
 uint8_t flxDevButton::get_press_mode()
 {
@@ -133,10 +150,27 @@ void flxDevButton::set_led_brightness(uint8_t brightness)
 // Loop
 
 void flxDevButton::checkButton(void)
+{
+    if (_intrIsSetup)
+    {
+        checkInterrupt();
+        return;
+    }
+
+    // Polling - read the current button state
+    updateState(QwiicButton::isPressed(), millis());
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Update the button state, send events and set the LED
+void flxDevButton::updateState(bool pressed, uint32_t eventTime)
 {
     // process events
-    _last_button_state = _this_button_state;       // Store the last button state
-    _this_button_state = QwiicButton::isPressed(); // Read the current button state
+    _last_button_state = _this_button_state; // Store the last button state
+    _this_button_state = pressed;            // The current button state
+
+    if (!_last_button_state && _this_button_state)
+        _pressTime = eventTime;
 
     if (_pressMode)
     {
@@ -168,3 +202,219 @@ void flxDevButton::checkButton(void)
         }
     }
 }
+
+//----------------------------------------------------------------------------------------------------------
+// Interrupt Things
+// ----------------------------------------------------------------------------------------------------------
+//
+// our ISR static vars for state
+volatile uint32_t flxDevButton::_intrCount = 0;
+volatile uint32_t flxDevButton::_intrTimes[kButtonIntrTimes] = {0};
+
+// the number of buttons using each INT pin
+static std::map<uint16_t, uint8_t> _intrPinUsers;
+
+//-------------------------------------------------------------
+// ISR Callback for the INT pin - count the interrupt and timestamp it
+void flxDevButton::button_isr_cb(void)
+{
+    flxDevButton::_intrTimes[flxDevButton::_intrCount % kButtonIntrTimes] = millis();
+    flxDevButton::_intrCount++;
+}
+
+//-------------------------------------------------------------
+void flxDevButton::attachIntrPin(uint16_t pin)
+{
+    if (_intrPinUsers[pin]++ > 0)
+        return;
+
+    // The INT output is active low, open drain
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(pin, button_isr_cb, FALLING);
+}
+
+//-------------------------------------------------------------
+void flxDevButton::detachIntrPin(uint16_t pin)
+{
+    auto itPin = _intrPinUsers.find(pin);
+    if (itPin == _intrPinUsers.end())
+        return;
+
+    // other buttons still use the pin?
+    if (--itPin->second > 0)
+        return;
+
+    _intrPinUsers.erase(itPin);
+    detachInterrupt(pin);
+}
+
+//-------------------------------------------------------------
+// Called from the job when the INT pin is used. The device is only read if an interrupt occurred.
+void flxDevButton::checkInterrupt(void)
+{
+    uint32_t intrCount = _intrCount;
+    if (intrCount == _lastIntrCount)
+        return;
+
+    // The time of the first edge since the last check - or the oldest edge kept, if there were more
+    uint32_t iFirst = intrCount - _lastIntrCount > kButtonIntrTimes ? intrCount - kButtonIntrTimes : _lastIntrCount;
+    uint32_t intrTime = _intrTimes[iFirst % kButtonIntrTimes];
+    _lastIntrCount = intrCount;
+
+    // Buttons can share an INT pin - so this button might not be the source
+    bool pressed = QwiicButton::isPressed();
+    bool clicked = QwiicButton::hasBeenClicked();
+
+    // Each click in the device queue is a press and release - some could have happened between our checks
+    uint8_t nClicks = 0;
+    if (clicked)
+    {
+        while (nClicks < kButtonClickQueueSize && !QwiicButton::isClickedQueueEmpty())
+        {
+            QwiicButton::popClickedQueue();
+            nClicks++;
+        }
+        if (nClicks == 0)
+            nClicks = 1;
+    }
+
+    QwiicButton::clearEventBits(); // releases the INT pin
+
+    for (uint8_t i = 0; i < nClicks; i++)
+    {
+        if (!_this_button_state)
+            updateState(true, intrTime);
+        updateState(false, intrTime);
+    }
+
+    if (pressed != _this_button_state)
+        updateState(pressed, intrTime);
+}
+
+//-------------------------------------------------------------
+void flxDevButton::shutdownInterrupt(void)
+{
+    if (!_intrIsSetup)
+        return;
+
+    detachIntrPin(_intrPin);
+    _intrIsSetup = false;
+
+    if (isInitialized())
+        QwiicButton::resetInterruptConfig();
+
+    // back to polling
+    _theJob.setPeriod(kButtonUpdateIntervalMS);
+    flxUpdateJobInQueue(_theJob);
+}
+
+//-------------------------------------------------------------
+void flxDevButton::setupInterrupt(void)
+{
+    // Already setup = lets  disable?
+    if (_intrIsSetup)
+        shutdownInterrupt();
+
+    // Everything set? The device is configured when it's initialized
+    if (!_bInterruptEnabled || _intrPin == 0 || !isInitialized())
+        return;
+
+    // interrupt on press and click (release) events
+    if (QwiicButton::enablePressedInterrupt() != 0 || QwiicButton::enableClickedInterrupt() != 0)
+    {
+        flxLog_E(F("%s: unable to enable the device interrupt - using polling"), name());
+        return;
+    }
+    QwiicButton::clearEventBits();
+
+    attachIntrPin(_intrPin);
+    _lastIntrCount = _intrCount;
+    _intrIsSetup = true;
+
+    _theJob.setPeriod(kButtonInterruptIntervalMS);
+    flxUpdateJobInQueue(_theJob);
+
+    flxLog_I(F("%s: Interrupt events enabled on pin (%u)"), name(), _intrPin);
+}
+
+//-----------------------------------------
+void flxDevButton::setAvailableInterruptPins(const uint16_t *inPins, size_t len)
+{
+    if (!inPins || (len == 0))
+    {
+        flxLog_D(F("Button Interrupt Pin list is null or empty"));
+        return;
+    }
+
+    flxDataLimitSetUInt16 *dataLimit = new flxDataLimitSetUInt16;
+    size_t nItems = 0;
+    char szBuffer[8];
+
+    // We set the provided pins as limits on the pin property. Let's set that up
+    for (int i = 0; i < len; i++)
+    {
+        if (inPins[i] == 0)
+        {
+            flxLog_D(F("Button Interrupt Pin list contains a zero pin - ignoring"));
+            continue; // skip zero pins
+        }
+        snprintf(szBuffer, sizeof(szBuffer), "%u", inPins[i]);
+        dataLimit->addItem((const char *)szBuffer, inPins[i]);
+        nItems++;
+        // first pin is our winner
+        if (nItems == 1 && _intrPin == 0)
+            _intrPin = inPins[i]; // set the first pin as the default
+    }
+
+    if (nItems == 0)
+    {
+        flxLog_D(F("Button Interrupt Pin list contains no valid pins - ignoring"));
+        delete dataLimit; // clean up
+        return;           // no valid pins
+    }
+    interruptPin.setDataLimit(dataLimit);
+
+    // Okay, our pin is setup. Make sure the properties are registered.
+    if (this->containsProperty(&interruptEvents) == false)
+    {
+        flxRegister(interruptEvents, "Interrupt Events", "Use the button INT pin to detect button events");
+        flxRegister(interruptPin, "Interrupt Pin", "Pin connected to the button INT output");
+    }
+
+    setupInterrupt();
+}
+
+//-----------------------------------------
+// Methods for read-write properties - interrupt events
+void flxDevButton::set_interrupt_events(bool enable)
+{
+    // no change?
+    if (_bInterruptEnabled == enable)
+        return;
+
+    _bInterruptEnabled = enable;
+
+    if (_bInterruptEnabled)
+        setupInterrupt();
+    else
+        shutdownInterrupt();
+}
+
+//-----------------------------------------
+bool flxDevButton::get_interrupt_events(void)
+{
+    return _bInterruptEnabled;
+}
+
+//-----------------------------------------
+void flxDevButton::set_interrupt_pin(uint16_t pin)
+{
+    if (pin == _intrPin)
+        return;
+
+    shutdownInterrupt();
+
+    _intrPin = pin;
+
+    setupInterrupt();
+}
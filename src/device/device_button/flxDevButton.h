@@ -27,6 +27,9 @@
 
 // What is the name used to ID this device?
 #define kButtonDeviceName "BUTTON"
+
+// The number of INT edge times kept by the ISR
+#define kButtonIntrTimes 8
 //----------------------------------------------------------------------------------------------------------
 // Define our class - note we are sub-classing from the Qwiic Library
 class flxDevButton : public flxDeviceI2CType<flxDevButton>, public QwiicButton
@@ -36,6 +39,7 @@ class flxDevButton : public flxDeviceI2CType<flxDevButton>, public QwiicButton
     flxDevButton();
     ~flxDevButton()
     {
+        shutdownInterrupt();
         flxRemoveJobFromQueue(_theJob);
     }
 
@@ -68,18 +72,54 @@ class flxDevButton : public flxDeviceI2CType<flxDevButton>, public QwiicButton
   private:
     // methods used to get values for our output parameters
     bool read_button_state();
+    uint32_t read_press_time();
     void checkButton(void);
+    void checkInterrupt(void);
+    void updateState(bool pressed, uint32_t eventTime);
 
     // methods for our read-write properties
     uint8_t get_press_mode();
     void set_press_mode(uint8_t);
     uint8_t get_led_brightness();
     void set_led_brightness(uint8_t);
+
+    // property methods - enable/disable the INT pin events
+    void set_interrupt_events(bool enable);
+    bool get_interrupt_events(void);
+
+    void set_interrupt_pin(uint16_t pin);
+    uint16_t get_interrupt_pin(void)
+    {
+        return _intrPin;
+    }
+
+    static void button_isr_cb(void);
+
+    // Buttons can share an INT pin - the pin is attached for the first button using it, and detached
+    // when the last button stops using it
+    static void attachIntrPin(uint16_t pin);
+    static void detachIntrPin(uint16_t pin);
+
+    void shutdownInterrupt(void);
+    void setupInterrupt(void);
+
     bool _pressMode = true;
     bool _last_button_state = false;
     bool _this_button_state = false;
     bool _toggle_state = false;
     uint8_t _ledBrightness = 128;
+    uint32_t _pressTime = 0;
+
+    // INT pin event detection. The INT output is open drain, so buttons can share a pin - the ISR counts
+    // interrupts and records the time of each edge, and each button checks its event bits when the count
+    // changes. Events use the time of the first edge the button hasn't seen - the press edge.
+    bool _bInterruptEnabled = false;
+    uint16_t _intrPin = 0;
+    bool _intrIsSetup = false;
+    uint32_t _lastIntrCount = 0;
+
+    static volatile uint32_t _intrCount;
+    static volatile uint32_t _intrTimes[kButtonIntrTimes];
 
     flxJob _theJob;
 
@@ -89,6 +129,17 @@ class flxDevButton : public flxDeviceI2CType<flxDevButton>, public QwiicButton
     flxPropertyRWUInt8<flxDevButton, &flxDevButton::get_led_brightness, &flxDevButton::set_led_brightness>
         ledBrightness;
 
+    // Interrupt events - this isn't shown unless a list of available pins is provided
+    flxPropertyRWBool<flxDevButton, &flxDevButton::get_interrupt_events, &flxDevButton::set_interrupt_events>
+        interruptEvents;
+    flxPropertyRWUInt16<flxDevButton, &flxDevButton::get_interrupt_pin, &flxDevButton::set_interrupt_pin>
+        interruptPin;
+
     // Define our output parameters - specify the get functions to call.
     flxParameterOutBool<flxDevButton, &flxDevButton::read_button_state> buttonState;
+    flxParameterOutUInt32<flxDevButton, &flxDevButton::read_press_time> pressTime;
+
+    //-----------------------------------------------------
+    // methods to set the pins available for the button INT output
+    void setAvailableInterruptPins(const uint16_t *pins, size_t len);
 };
@@ -30,7 +30,7 @@ flxRegisterDevice(flxDevENS160);
 //----------------------------------------------------------------------------------------------------------
 /// @brief Constructor
 ///
-flxDevENS160::flxDevENS160() : _opMode{SFE_ENS160_STANDARD}, _tempCComp{nullptr}, _rhComp{nullptr}
+flxDevENS160::flxDevENS160() : _opMode{SFE_ENS160_STANDARD}, _tempCComp{nullptr}, _rhComp{nullptr}, _resetPending{false}
 {
 
     setName(getDeviceName(), "ScioSense ENS160 Indoor Air Quality Sensor");
@@ -102,13 +102,25 @@ bool flxDevENS160::onInitialize(TwoWire &wirePort)
 
     SparkFun_ENS160::setOperatingMode(SFE_ENS160_RESET);
 
-    delay(100); //
-
-    SparkFun_ENS160::setOperatingMode(operatingMode());
+    // The device needs 100 ms to reset - rather than blocking startup, set the operating
+    // mode from a one-shot job once the reset is complete.
+    _resetPending = true;
+    _resetJob.setup(name(), 100, this, &flxDevENS160::resetCompleteCB, true);
+    flxAddJobToQueue(_resetJob);
 
     return true;
 }
 
+//----------------------------------------------------------------------------------------------------------
+///
+/// @brief Called after the device reset completes - sets the cached operating mode
+///
+void flxDevENS160::resetCompleteCB(void)
+{
+    _resetPending = false;
+    SparkFun_ENS160::setOperatingMode(_opMode);
+}
+
 //---------------------------------------------------------------------------
 // props
 //---------------------------------------------------------------------------
@@ -137,10 +149,11 @@ uint8_t flxDevENS160::get_operating_mode(void)
 ///
 void flxDevENS160::set_operating_mode(uint8_t newMode)
 {
-    if (isInitialized())
+    _opMode = newMode;
+
+    // if a reset is in progress, the mode is set once it completes
+    if (isInitialized() && !_resetPending)
         SparkFun_ENS160::setOperatingMode(newMode);
-    else
-        _opMode = newMode;
 }
 
 //---------------------------------------------------------------------------
@@ -71,6 +71,9 @@ class flxDevENS160 : public flxDeviceI2CType<flxDevENS160>, public SparkFun_ENS1
 
     void updateParams(void);
 
+    // called once the device reset has completed
+    void resetCompleteCB(void);
+
     // Property methods
 
     // operating mode.
@@ -100,6 +103,10 @@ class flxDevENS160 : public flxDeviceI2CType<flxDevENS160>, public SparkFun_ENS1
 
     flxJob _theJob;
 
+    // one-shot job used to wait for the device reset to complete
+    flxJob _resetJob;
+    bool _resetPending;
+
   public:
     // properties
     // Operating mode prop
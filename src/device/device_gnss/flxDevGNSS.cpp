@@ -45,8 +45,11 @@ flxRegisterDevice(flxDevGNSS);
 // Object constructor. Performs initialization of device values, including device identifiers (name, I2C address),
 // and managed properties.
 
-flxDevGNSS::flxDevGNSS() : _bPPSLoggingEnabled{false}, _ppsPin{0}, _ppsLoggingIsSetup{false}
+flxDevGNSS::flxDevGNSS()
+    : _solutionCount{0}, _stringCount{0}, _bPPSLoggingEnabled{false}, _ppsPin{0}, _ppsLoggingIsSetup{false}
 {
+    memset(&_solution, 0, sizeof(_solution));
+    memset(_szStrings, 0, sizeof(_szStrings));
 
     // Setup unique identifiers for this device and basic device object systems
     setName(getDeviceName());
@@ -183,13 +186,13 @@ bool flxDevGNSS::onInitialize(TwoWire &wirePort)
     bool result = SFE_UBLOX_GNSS::begin(wirePort);
     if (result)
     {
-        SFE_UBLOX_GNSS::setI2COutput(COM_TYPE_UBX); // Set the I2C port to output UBX only (turn off NMEA noise)
-        SFE_UBLOX_GNSS::setAutoPVT(true);           // Enable PVT at the navigation rate
+        _pvtDevice = this;
+        configure_output();
 
-        // Save the port and message settings to flash and BBR
-        SFE_UBLOX_GNSS::saveConfigSelective(VAL_CFG_SUBSEC_IOPORT | VAL_CFG_SUBSEC_MSGCONF);
-        delay(1100);
-        SFE_UBLOX_GNSS::getPVT(); // Ensure we get fresh data
+        // Ensure we get fresh data - give the module a navigation cycle first. This is done from a
+        // one-shot job rather than blocking startup.
+        _startupJob.setup("GNSS Startup", 1100, this, &flxDevGNSS::startup_pvt, true);
+        flxAddJobToQueue(_startupJob);
 
         // Enable our update job
         flxAddJobToQueue(_theJob);
@@ -197,183 +200,223 @@ bool flxDevGNSS::onInitialize(TwoWire &wirePort)
     return result;
 }
 
+//----------------------------------------------------------------------------------------------------------
+// Set the module output - UBX only with auto PVT - and save the settings
+void flxDevGNSS::configure_output(void)
+{
+    SFE_UBLOX_GNSS::setI2COutput(COM_TYPE_UBX);   // Set the I2C port to output UBX only (turn off NMEA noise)
+    SFE_UBLOX_GNSS::setAutoPVTcallbackPtr(pvt_cb); // Enable PVT at the navigation rate - delivered to pvt_cb
+
+    // Save the port and message settings to flash and BBR
+    SFE_UBLOX_GNSS::saveConfigSelective(VAL_CFG_SUBSEC_IOPORT | VAL_CFG_SUBSEC_MSGCONF);
+}
+
+//----------------------------------------------------------------------------------------------------------
+void flxDevGNSS::startup_pvt(void)
+{
+    SFE_UBLOX_GNSS::getPVT();
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Auto PVT callback - called from checkCallbacks() in the update job, once per navigation epoch
+
+flxDevGNSS *flxDevGNSS::_pvtDevice = nullptr;
+
+void flxDevGNSS::pvt_cb(UBX_NAV_PVT_data_t *pvtData)
+{
+    if (!_pvtDevice || !pvtData)
+        return;
+
+    flxGNSSSolution_t &theSoln = _pvtDevice->_solution;
+
+    theSoln.iTOW = pvtData->iTOW;
+    theSoln.year = pvtData->year;
+    theSoln.month = pvtData->month;
+    theSoln.day = pvtData->day;
+    theSoln.hour = pvtData->hour;
+    theSoln.min = pvtData->min;
+    theSoln.sec = pvtData->sec;
+    theSoln.fixType = pvtData->fixType;
+    theSoln.carrSoln = pvtData->flags.bits.carrSoln;
+    theSoln.numSV = pvtData->numSV;
+    theSoln.lon = pvtData->lon;
+    theSoln.lat = pvtData->lat;
+    theSoln.height = pvtData->height;
+    theSoln.hMSL = pvtData->hMSL;
+    theSoln.hAcc = pvtData->hAcc;
+    theSoln.vAcc = pvtData->vAcc;
+    theSoln.gSpeed = pvtData->gSpeed;
+    theSoln.headMot = pvtData->headMot;
+    theSoln.pDOP = pvtData->pDOP;
+
+    _pvtDevice->_solutionCount++;
+}
+
 // GETTER methods for output params
 uint32_t flxDevGNSS::read_year()
 {
-    return SFE_UBLOX_GNSS::getYear();
+    return _solution.year;
 }
 uint32_t flxDevGNSS::read_month()
 {
-    return SFE_UBLOX_GNSS::getMonth();
+    return _solution.month;
 }
 uint32_t flxDevGNSS::read_day()
 {
-    return SFE_UBLOX_GNSS::getDay();
+    return _solution.day;
 }
 uint32_t flxDevGNSS::read_hour()
 {
-    return SFE_UBLOX_GNSS::getHour();
+    return _solution.hour;
 }
 uint32_t flxDevGNSS::read_min()
 {
-    return SFE_UBLOX_GNSS::getMinute();
+    return _solution.min;
 }
 uint32_t flxDevGNSS::read_sec()
 {
-    return SFE_UBLOX_GNSS::getSecond();
+    return _solution.sec;
 }
 double flxDevGNSS::read_latitude()
 {
-    return (((double)SFE_UBLOX_GNSS::getLatitude()) / 10000000);
+    return (((double)_solution.lat) / 10000000);
 }
 double flxDevGNSS::read_longitude()
 {
-    return (((double)SFE_UBLOX_GNSS::getLongitude()) / 10000000);
+    return (((double)_solution.lon) / 10000000);
 }
 double flxDevGNSS::read_altitude()
 {
-    return (((double)SFE_UBLOX_GNSS::getAltitude()) / 1000);
+    return (((double)_solution.height) / 1000);
 }
 double flxDevGNSS::read_altitude_msl()
 {
-    return (((double)SFE_UBLOX_GNSS::getAltitudeMSL()) / 1000);
+    return (((double)_solution.hMSL) / 1000);
 }
 uint32_t flxDevGNSS::read_siv()
 {
-    return SFE_UBLOX_GNSS::getSIV();
+    return _solution.numSV;
 }
 uint32_t flxDevGNSS::read_fix()
 {
-    return SFE_UBLOX_GNSS::getFixType();
+    return _solution.fixType;
 }
 uint32_t flxDevGNSS::read_carrier_soln()
 {
-    return SFE_UBLOX_GNSS::getCarrierSolutionType();
+    return _solution.carrSoln;
 }
 float flxDevGNSS::read_ground_speed()
 {
-    return (((float)SFE_UBLOX_GNSS::getGroundSpeed()) / 1000);
+    return (((float)_solution.gSpeed) / 1000);
 }
 float flxDevGNSS::read_heading()
 {
-    return (((float)SFE_UBLOX_GNSS::getHeading()) / 100000);
+    return (((float)_solution.headMot) / 100000);
 }
 float flxDevGNSS::read_horiz_acc()
 {
-    return (((float)SFE_UBLOX_GNSS::getHorizontalAccEst()) / 1000);
+    return (((float)_solution.hAcc) / 1000);
 }
 float flxDevGNSS::read_vert_acc()
 {
-    return (((float)SFE_UBLOX_GNSS::getVerticalAccEst()) / 1000);
+    return (((float)_solution.vAcc) / 1000);
 }
 float flxDevGNSS::read_pdop()
 {
-    return (((float)SFE_UBLOX_GNSS::getPDOP()) / 100);
+    return (((float)_solution.pDOP) / 100);
 }
 uint32_t flxDevGNSS::read_tow()
 {
-    return SFE_UBLOX_GNSS::getTimeOfWeek();
+    return _solution.iTOW;
 }
 
-std::string flxDevGNSS::read_iso8601()
+//----------------------------------------------------------------------------------------------------------
+// Format a date/time string from the current solution. Each string is only formatted once per solution.
+const char *flxDevGNSS::format_string(flxGNSSString_t which)
 {
-    uint y = SFE_UBLOX_GNSS::getYear();
-    uint M = SFE_UBLOX_GNSS::getMonth();
-    uint d = SFE_UBLOX_GNSS::getDay();
-    uint h = SFE_UBLOX_GNSS::getHour();
-    uint m = SFE_UBLOX_GNSS::getMinute();
-    uint s = SFE_UBLOX_GNSS::getSecond();
+    char *szBuffer = _szStrings[which];
+
+    // already formatted for this solution?
+    if (_stringCount[which] == _solutionCount && szBuffer[0] != '\0')
+        return szBuffer;
 
-    char szBuffer[32] = {'\0'};
-    snprintf(szBuffer, sizeof(szBuffer), "%04d-%02d-%02dT%02d:%02d:%02dZ", y, M, d, h, m, s);
+    const flxGNSSSolution_t &theSoln = _solution;
+    size_t szBuf = sizeof(_szStrings[which]);
 
-    std::string theString = szBuffer;
+    switch (which)
+    {
+    case kGNSSStrISO8601:
+        snprintf(szBuffer, szBuf, "%04u-%02u-%02uT%02u:%02u:%02uZ", theSoln.year, theSoln.month, theSoln.day,
+                 theSoln.hour, theSoln.min, theSoln.sec);
+        break;
+    case kGNSSStrYYYYMMDD:
+        snprintf(szBuffer, szBuf, "%04u/%02u/%02u", theSoln.year, theSoln.month, theSoln.day);
+        break;
+    case kGNSSStrYYYYDDMM:
+        snprintf(szBuffer, szBuf, "%04u/%02u/%02u", theSoln.year, theSoln.day, theSoln.month);
+        break;
+    case kGNSSStrDDMMYYYY:
+        snprintf(szBuffer, szBuf, "%02u/%02u/%04u", theSoln.day, theSoln.month, theSoln.year);
+        break;
+    case kGNSSStrHHMMSS:
+        snprintf(szBuffer, szBuf, "%02u:%02u:%02u", theSoln.hour, theSoln.min, theSoln.sec);
+        break;
+    default:
+        szBuffer[0] = '\0';
+        break;
+    }
+    _stringCount[which] = _solutionCount;
 
-    return theString;
+    return szBuffer;
 }
 
-std::string flxDevGNSS::read_yyyy_mm_dd()
+std::string flxDevGNSS::read_iso8601()
 {
-    uint y = SFE_UBLOX_GNSS::getYear();
-    uint M = SFE_UBLOX_GNSS::getMonth();
-    uint d = SFE_UBLOX_GNSS::getDay();
-
-    char szBuffer[24] = {'\0'};
-    snprintf(szBuffer, sizeof(szBuffer), "%04d/%02d/%02d", y, M, d);
-
-    std::string theString = szBuffer;
+    return format_string(kGNSSStrISO8601);
+}
 
-    return theString;
+std::string flxDevGNSS::read_yyyy_mm_dd()
+{
+    return format_string(kGNSSStrYYYYMMDD);
 }
 
 std::string flxDevGNSS::read_yyyy_dd_mm()
 {
-    uint y = SFE_UBLOX_GNSS::getYear();
-    uint M = SFE_UBLOX_GNSS::getMonth();
-    uint d = SFE_UBLOX_GNSS::getDay();
-
-    char szBuffer[24] = {'\0'};
-    snprintf(szBuffer, sizeof(szBuffer), "%04d/%02d/%02d", y, d, M);
-
-    std::string theString = szBuffer;
-
-    return theString;
+    return format_string(kGNSSStrYYYYDDMM);
 }
 
 std::string flxDevGNSS::read_dd_mm_yyyy()
 {
-    uint y = SFE_UBLOX_GNSS::getYear();
-    uint M = SFE_UBLOX_GNSS::getMonth();
-    uint d = SFE_UBLOX_GNSS::getDay();
-
-    char szBuffer[24] = {'\0'};
-    snprintf(szBuffer, sizeof(szBuffer), "%02d/%02d/%04d", d, M, y);
-
-    std::string theString = szBuffer;
-
-    return theString;
+    return format_string(kGNSSStrDDMMYYYY);
 }
 
 std::string flxDevGNSS::read_hh_mm_ss()
 {
-    uint h = SFE_UBLOX_GNSS::getHour();
-    uint m = SFE_UBLOX_GNSS::getMinute();
-    uint s = SFE_UBLOX_GNSS::getSecond();
-
-    char szBuffer[24] = {'\0'};
-    snprintf(szBuffer, sizeof(szBuffer), "%02d:%02d:%02d", h, m, s);
-
-    std::string theString = szBuffer;
-
-    return theString;
+    return format_string(kGNSSStrHHMMSS);
 }
 
 std::string flxDevGNSS::read_fix_string()
 {
-    uint fix = SFE_UBLOX_GNSS::getFixType();
+    uint fix = _solution.fixType;
 
     const char *types[] = {"none", "dead_reckoning", "2D", "3D", "GNSS_+_dead_reckoning", "time_only", "unknown"};
 
     if (fix > 5)
         fix = 6;
 
-    std::string theString = types[fix];
-
-    return theString;
+    return types[fix];
 }
 
 std::string flxDevGNSS::read_carrier_soln_string()
 {
-    uint carrSoln = SFE_UBLOX_GNSS::getCarrierSolutionType();
+    uint carrSoln = _solution.carrSoln;
 
     const char *types[] = {"none", "floating", "fixed", "unknown"};
 
     if (carrSoln > 2)
         carrSoln = 3;
 
-    std::string theString = types[carrSoln];
-
-    return theString;
+    return types[carrSoln];
 }
 
 // method for location
@@ -404,10 +447,20 @@ void flxDevGNSS::set_measurement_rate(uint32_t rate)
 void flxDevGNSS::factory_default()
 {
     SFE_UBLOX_GNSS::factoryDefault();
-    delay(5000);
-    SFE_UBLOX_GNSS::setI2COutput(COM_TYPE_UBX);
-    SFE_UBLOX_GNSS::setAutoPVT(true);
-    SFE_UBLOX_GNSS::saveConfigSelective(VAL_CFG_SUBSEC_IOPORT | VAL_CFG_SUBSEC_MSGCONF);
+
+    // The module takes ~5 seconds to restart. Stop polling it and restore the output configuration
+    // from a one-shot job once it's back.
+    flxRemoveJobFromQueue(_theJob);
+
+    _factoryDefaultJob.setup("GNSS Factory Default", 5000, this, &flxDevGNSS::factory_default_complete, true);
+    flxAddJobToQueue(_factoryDefaultJob);
+}
+
+void flxDevGNSS::factory_default_complete(void)
+{
+    configure_output();
+
+    flxAddJobToQueue(_theJob);
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -415,7 +468,9 @@ void flxDevGNSS::factory_default()
 
 void flxDevGNSS::jobHandlerCB(void)
 {
+    // Read any data from the module, then deliver new PVT solutions to our callback
     SFE_UBLOX_GNSS::checkUblox();
+    SFE_UBLOX_GNSS::checkCallbacks();
 
     // PPS Event triggered?
     if (_ppsLoggingIsSetup && _pps_triggered)
@@ -33,6 +33,31 @@ flxDefineEventID(kOnGNSSPPSEvent);
 
 // What is the name used to ID this device?
 #define kGNSSDeviceName "GNSS"
+
+// The navigation solution values used by the driver - copied from each auto PVT message
+typedef struct
+{
+    uint32_t iTOW; // time of week - ms
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+    uint8_t fixType;
+    uint8_t carrSoln;
+    uint8_t numSV;
+    int32_t lon;     // deg * 1e-7
+    int32_t lat;     // deg * 1e-7
+    int32_t height;  // mm
+    int32_t hMSL;    // mm
+    uint32_t hAcc;   // mm
+    uint32_t vAcc;   // mm
+    int32_t gSpeed;  // mm/s
+    int32_t headMot; // deg * 1e-5
+    uint16_t pDOP;   // * 0.01
+} flxGNSSSolution_t;
+
 //----------------------------------------------------------------------------------------------------------
 // Define our class - note we are sub-classing from the Qwiic Library
 class flxDevGNSS : public flxDeviceI2CType<flxDevGNSS>, public flxIClock, public SFE_UBLOX_GNSS
@@ -123,6 +148,38 @@ class flxDevGNSS : public flxDeviceI2CType<flxDevGNSS>, public flxIClock, public
     void jobHandlerCB(void);
     flxJob _theJob;
 
+    // Auto PVT callback - the latest navigation solution is cached and the output parameters are
+    // read from the cache, so each navigation epoch is parsed once.
+    static void pvt_cb(UBX_NAV_PVT_data_t *pvtData);
+    static flxDevGNSS *_pvtDevice;
+
+    flxGNSSSolution_t _solution;
+    uint32_t _solutionCount;
+
+    // String outputs are formatted into these buffers once per solution
+    typedef enum
+    {
+        kGNSSStrISO8601 = 0,
+        kGNSSStrYYYYMMDD,
+        kGNSSStrYYYYDDMM,
+        kGNSSStrDDMMYYYY,
+        kGNSSStrHHMMSS,
+        kGNSSStrCount
+    } flxGNSSString_t;
+
+    const char *format_string(flxGNSSString_t which);
+
+    char _szStrings[kGNSSStrCount][24];
+    uint32_t _stringCount[kGNSSStrCount];
+
+    // Module output configuration, and the one-shot jobs used to wait on the module after startup
+    // and after a factory reset
+    void configure_output(void);
+    void startup_pvt(void);
+    void factory_default_complete(void);
+    flxJob _startupJob;
+    flxJob _factoryDefaultJob;
+
     bool get_location(flxDataArrayFloat *);
 
     bool _bPPSLoggingEnabled; // flag to indicate if PPS logging is enabled
@@ -24,6 +24,30 @@
 #define kISM330AddressDefault 0x6B
 #define kISM330AddressAlt 0x6A
 
+// FIFO registers
+#define kISM330RegFIFOCtrl1 0x07 // WTM[7:0]
+#define kISM330RegFIFOCtrl2 0x08 // WTM[8] in bit 0
+#define kISM330RegFIFOCtrl3 0x09 // BDR_GY[7:4], BDR_XL[3:0]
+#define kISM330RegFIFOCtrl4 0x0A // DEC_TS_BATCH[7:6], FIFO_MODE[2:0]
+#define kISM330RegCtrl10C 0x19   // TIMESTAMP_EN - bit 5
+#define kISM330RegFIFOStatus1 0x3A
+#define kISM330RegFIFODataOutTag 0x78
+
+#define kISM330FIFOModeBypass 0x00
+#define kISM330FIFOModeContinuous 0x06
+#define kISM330FIFODecTSBatch1 0x40 // timestamp batched with every sample
+#define kISM330TimestampEnable 0x20
+
+#define kISM330FIFOStatusOverrun 0x40
+
+// FIFO word tags
+#define kISM330TagGyro 0x01
+#define kISM330TagAccel 0x02
+#define kISM330TagTimestamp 0x04
+
+// The device timestamp has a 25 us resolution
+#define kISM330TimestampTickUS 25
+
 // Define our class static variables - allocs storage for them
 
 uint8_t flxDevISM330::defaultDeviceAddress[] = {kISM330AddressDefault, kISM330AddressAlt, kSparkDeviceAddressNull};
@@ -58,6 +82,17 @@ flxDevISM330Base::flxDevISM330Base()
     flxRegister(gyroZ, "Gyro Z (milli-dps)", "Gyro Z (milli-dps)", kParamValueGyroZ);
     flxRegister(temperature, "Temperature (C)", "The ambient temperature in degrees C");
 
+    flxRegister(streamTimestamp, "Stream Timestamp (us)", "Device timestamp of each streamed sample (us)");
+    streamTimestamp.setPrecision(0);
+    flxRegister(streamAccelX, "Stream Accel X (milli-g)", "Streamed accelerometer X samples (milli-g)");
+    flxRegister(streamAccelY, "Stream Accel Y (milli-g)", "Streamed accelerometer Y samples (milli-g)");
+    flxRegister(streamAccelZ, "Stream Accel Z (milli-g)", "Streamed accelerometer Z samples (milli-g)");
+    flxRegister(streamGyroX, "Stream Gyro X (milli-dps)", "Streamed gyro X samples (milli-dps)");
+    flxRegister(streamGyroY, "Stream Gyro Y (milli-dps)", "Streamed gyro Y samples (milli-dps)");
+    flxRegister(streamGyroZ, "Stream Gyro Z (milli-dps)", "Streamed gyro Z samples (milli-dps)");
+    flxRegister(streamDropped, "Stream Dropped", "Samples dropped because the stream buffer was full");
+    flxRegister(fifoOverruns, "FIFO Overruns", "Number of times the device FIFO overflowed");
+
     // Register properties
     flxRegister(accelDataRate, "Accel Data Rate (Hz)", "Accelerometer Data Rate (Hz)");
     flxRegister(accelFullScale, "Accel Full Scale (g)", "Accelerometer Full Scale (g)");
@@ -67,6 +102,13 @@ flxDevISM330Base::flxDevISM330Base()
     flxRegister(gyroFilterLP1, "Gyro Filter LP1", "Gyro Filter LP1");
     flxRegister(accelSlopeFilter, "Accel Slope Filter", "Accelerometer Slope Filter");
     flxRegister(gyroLP1Bandwidth, "Gyro LP1 Filter Bandwidth", "Gyro LP1 Filter Bandwidth");
+    flxRegister(fifoStreaming, "FIFO Streaming", "Output all samples batched in the device FIFO");
+    flxRegister(fifoWatermark, "FIFO Watermark", "FIFO fill level (words) used to pace FIFO reads");
+
+    // streaming is off by default - the instantaneous values are output
+    set_fifo_streaming(false);
+
+    _fifoJob.setup(kISM330DeviceName, 100, this, &flxDevISM330Base::fifoJobCB);
 }
 
 // Base version of on Initialize
@@ -98,6 +140,8 @@ bool flxDevISM330Base::onInitialize(void)
         result &= setAccelSlopeFilter(_accel_slope_filter);
         result &= setGyroFilterLP1(_gyro_filter_lp1);
         result &= setGyroLP1Bandwidth(_gyro_lp1_bandwidth);
+        if (_fifo_streaming)
+            result &= configureFIFO(true);
         if (!result)
             flxLog_E("ISM330 onInitialize: device configuration failed");
     }
@@ -204,7 +248,11 @@ void flxDevISM330Base::set_accel_data_rate(uint8_t rate)
 {
     _accel_data_rate = rate;
     if (isInitialized())
+    {
         setAccelDataRate(rate);
+        if (_fifo_streaming)
+            configureFIFO(true);
+    }
 }
 uint8_t flxDevISM330Base::get_accel_full_scale()
 {
@@ -214,7 +262,11 @@ void flxDevISM330Base::set_accel_full_scale(uint8_t scale)
 {
     _accel_full_scale = scale;
     if (isInitialized())
+    {
         setAccelFullScale(scale);
+        if (_fifo_streaming)
+            configureFIFO(true);
+    }
 }
 uint8_t flxDevISM330Base::get_gyro_data_rate()
 {
@@ -224,7 +276,11 @@ void flxDevISM330Base::set_gyro_data_rate(uint8_t rate)
 {
     _gyro_data_rate = rate;
     if (isInitialized())
+    {
         setGyroDataRate(rate);
+        if (_fifo_streaming)
+            configureFIFO(true);
+    }
 }
 uint8_t flxDevISM330Base::get_gyro_full_scale()
 {
@@ -234,7 +290,11 @@ void flxDevISM330Base::set_gyro_full_scale(uint8_t scale)
 {
     _gyro_full_scale = scale;
     if (isInitialized())
+    {
         setGyroFullScale(scale);
+        if (_fifo_streaming)
+            configureFIFO(true);
+    }
 }
 uint8_t flxDevISM330Base::get_accel_filter_lp2()
 {
@@ -276,6 +336,372 @@ void flxDevISM330Base::set_gyro_lp1_bandwidth(uint8_t bw)
     if (isInitialized())
         setGyroLP1Bandwidth(bw);
 }
+bool flxDevISM330Base::get_fifo_streaming()
+{
+    return _fifo_streaming;
+}
+void flxDevISM330Base::set_fifo_streaming(bool enable)
+{
+    _fifo_streaming = enable;
+
+    // Output either the streamed arrays or the instantaneous values
+    accelX.setEnabled(!enable);
+    accelY.setEnabled(!enable);
+    accelZ.setEnabled(!enable);
+    gyroX.setEnabled(!enable);
+    gyroY.setEnabled(!enable);
+    gyroZ.setEnabled(!enable);
+
+    streamTimestamp.setEnabled(enable);
+    streamAccelX.setEnabled(enable);
+    streamAccelY.setEnabled(enable);
+    streamAccelZ.setEnabled(enable);
+    streamGyroX.setEnabled(enable);
+    streamGyroY.setEnabled(enable);
+    streamGyroZ.setEnabled(enable);
+    streamDropped.setEnabled(enable);
+    fifoOverruns.setEnabled(enable);
+
+    if (isInitialized())
+        configureFIFO(enable);
+}
+uint16_t flxDevISM330Base::get_fifo_watermark()
+{
+    return _fifo_watermark;
+}
+void flxDevISM330Base::set_fifo_watermark(uint16_t watermark)
+{
+    _fifo_watermark = watermark > kISM330FIFOWatermarkMax ? kISM330FIFOWatermarkMax : watermark;
+    if (isInitialized() && _fifo_streaming)
+        configureFIFO(true);
+}
+
+//----------------------------------------------------------------------------------------------------------
+// FIFO Streaming
+//----------------------------------------------------------------------------------------------------------
+//
+// When streaming, the accelerometer and gyro are batched into the device FIFO at their output data rates,
+// along with the device timestamp. A job drains the FIFO with burst reads - paced by the watermark - into
+// a sample buffer. At each observation the buffer is handed to the array output parameters.
+//
+// FIFO words are read directly from the FIFO data registers, which works for both the I2C and SPI
+// versions of the driver. The data address wraps from the last data register back to the tag register,
+// so a single read returns a run of words.
+
+// ODR/BDR register value to Hz - the BDR and ODR settings use the same encoding
+static const float kISM330RateHz[] = {0, 12.5, 26, 52, 104, 208, 416, 833, 1666, 3332, 6667, 1.6};
+
+static float ism330RateHz(uint8_t rate)
+{
+    return rate < sizeof(kISM330RateHz) / sizeof(float) ? kISM330RateHz[rate] : 0;
+}
+
+// LSB to milli-g
+static float ism330AccelScale(uint8_t fullScale)
+{
+    switch (fullScale)
+    {
+    case ISM_2g:
+        return 0.061;
+    case ISM_8g:
+        return 0.244;
+    case ISM_16g:
+        return 0.488;
+    case ISM_4g:
+    default:
+        return 0.122;
+    }
+}
+
+// LSB to milli-dps
+static float ism330GyroScale(uint8_t fullScale)
+{
+    switch (fullScale)
+    {
+    case ISM_125dps:
+        return 4.375;
+    case ISM_250dps:
+        return 8.75;
+    case ISM_1000dps:
+        return 35.;
+    case ISM_2000dps:
+        return 70.;
+    case ISM_4000dps:
+        return 140.;
+    case ISM_500dps:
+    default:
+        return 17.5;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Read the FIFO about twice per watermark fill period
+//
+uint32_t flxDevISM330Base::fifoDrainPeriod(void)
+{
+    float accelHz = ism330RateHz(_accel_data_rate);
+    float gyroHz = ism330RateHz(_gyro_data_rate);
+
+    // words per second - each sample has a timestamp word at the fastest rate
+    float wordsPerSec = accelHz + gyroHz + (accelHz > gyroHz ? accelHz : gyroHz);
+
+    if (wordsPerSec <= 0)
+        return 1000;
+
+    uint32_t period = (uint32_t)((_fifo_watermark * 1000.) / wordsPerSec / 2);
+
+    return period < 5 ? 5 : (period > 1000 ? 1000 : period);
+}
+
+//----------------------------------------------------------------------------------------------------------
+void flxDevISM330Base::clearStream(ism330_stream_t &stream)
+{
+    stream.timestamp.clear();
+    stream.accelX.clear();
+    stream.accelY.clear();
+    stream.accelZ.clear();
+    stream.gyroX.clear();
+    stream.gyroY.clear();
+    stream.gyroZ.clear();
+}
+
+//----------------------------------------------------------------------------------------------------------
+bool flxDevISM330Base::configureFIFO(bool enable)
+{
+    uint8_t value;
+
+    flxRemoveJobFromQueue(_fifoJob);
+
+    // Stop the FIFO - this also clears its contents
+    value = kISM330FIFOModeBypass;
+    if (writeRegisterRegion(kISM330RegFIFOCtrl4, &value, 1) != 0)
+        return false;
+
+    clearStream(_streamIn);
+    _sampleHasAccel = false;
+    _sampleHasGyro = false;
+
+    if (!enable)
+    {
+        value = 0;
+        writeRegisterRegion(kISM330RegFIFOCtrl3, &value, 1);
+
+        // release the sample buffers
+        _streamIn = ism330_stream_t();
+        _streamOut = ism330_stream_t();
+
+        // the device counter may wrap more than once before streaming restarts
+        _timestampStarted = false;
+        return true;
+    }
+
+    _accelScale = ism330AccelScale(_accel_full_scale);
+    _gyroScale = ism330GyroScale(_gyro_full_scale);
+
+    // enable the device timestamp
+    if (readRegisterRegion(kISM330RegCtrl10C, &value, 1) != 0)
+        return false;
+    value |= kISM330TimestampEnable;
+    if (writeRegisterRegion(kISM330RegCtrl10C, &value, 1) != 0)
+        return false;
+
+    uint8_t fifoCtrl[4];
+    fifoCtrl[0] = _fifo_watermark & 0xFF;
+    fifoCtrl[1] = (_fifo_watermark >> 8) & 0x01;
+
+    // batch at the output data rate of each sensor
+    fifoCtrl[2] = ((_gyro_data_rate & 0x0F) << 4) | (_accel_data_rate & 0x0F);
+    fifoCtrl[3] = kISM330FIFODecTSBatch1 | kISM330FIFOModeContinuous;
+
+    if (writeRegisterRegion(kISM330RegFIFOCtrl1, fifoCtrl, sizeof(fifoCtrl)) != 0)
+    {
+        flxLog_E(F("%s: Unable to configure the FIFO"), name());
+        return false;
+    }
+
+    _fifoJob.setPeriod(fifoDrainPeriod());
+    flxAddJobToQueue(_fifoJob);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------
+void flxDevISM330Base::fifoJobCB(void)
+{
+    drainFIFO();
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Read everything in the FIFO
+//
+bool flxDevISM330Base::drainFIFO(void)
+{
+    uint8_t status[2];
+
+    if (readRegisterRegion(kISM330RegFIFOStatus1, status, sizeof(status)) != 0)
+        return false;
+
+    if (status[1] & kISM330FIFOStatusOverrun)
+        _fifoOverruns++;
+
+    uint16_t nWords = status[0] | ((status[1] & 0x03) << 8);
+
+    uint8_t buffer[kISM330FIFOReadWords * kISM330FIFOWordSize];
+
+    while (nWords > 0)
+    {
+        uint16_t nRead = nWords > kISM330FIFOReadWords ? kISM330FIFOReadWords : nWords;
+
+        if (readRegisterRegion(kISM330RegFIFODataOutTag, buffer, nRead * kISM330FIFOWordSize) != 0)
+            return false;
+
+        for (int i = 0; i < nRead; i++)
+            decodeFIFOWord(buffer + i * kISM330FIFOWordSize);
+
+        nWords -= nRead;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Add the current sample to the stream buffer
+//
+void flxDevISM330Base::pushStreamSample(void)
+{
+    if (!_sampleHasAccel && !_sampleHasGyro)
+        return;
+
+    if (_streamIn.timestamp.size() >= kISM330StreamMaxSamples)
+        _streamDropped++;
+    else
+    {
+        _streamIn.timestamp.push_back(_sampleTimestamp);
+        _streamIn.accelX.push_back(_sampleHasAccel ? _sampleAccel[0] : 0);
+        _streamIn.accelY.push_back(_sampleHasAccel ? _sampleAccel[1] : 0);
+        _streamIn.accelZ.push_back(_sampleHasAccel ? _sampleAccel[2] : 0);
+        _streamIn.gyroX.push_back(_sampleHasGyro ? _sampleGyro[0] : 0);
+        _streamIn.gyroY.push_back(_sampleHasGyro ? _sampleGyro[1] : 0);
+        _streamIn.gyroZ.push_back(_sampleHasGyro ? _sampleGyro[2] : 0);
+    }
+    _sampleHasAccel = false;
+    _sampleHasGyro = false;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// A FIFO word is a tag byte followed by 6 data bytes. A timestamp word starts a new sample; the accel and
+// gyro words that follow it make up the sample.
+//
+void flxDevISM330Base::decodeFIFOWord(const uint8_t *word)
+{
+    const uint8_t *data = word + 1;
+
+    switch (word[0] >> 3)
+    {
+    case kISM330TagTimestamp: {
+        pushStreamSample();
+
+        uint32_t ticks =
+            (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+
+        // the tick difference is wrap safe - timestamps are at least one per sample, far more often than the wrap
+        if (!_timestampStarted)
+        {
+            _timestampTicks = ticks;
+            _timestampStarted = true;
+        }
+        else
+            _timestampTicks += (uint32_t)(ticks - _lastTimestampTicks);
+
+        _lastTimestampTicks = ticks;
+        _sampleTimestamp = (double)(_timestampTicks * kISM330TimestampTickUS);
+        break;
+    }
+
+    case kISM330TagAccel:
+        if (_sampleHasAccel)
+            pushStreamSample();
+        for (int i = 0; i < 3; i++)
+            _sampleAccel[i] = (int16_t)(data[i * 2] | (data[i * 2 + 1] << 8)) * _accelScale;
+        _sampleHasAccel = true;
+        break;
+
+    case kISM330TagGyro:
+        if (_sampleHasGyro)
+            pushStreamSample();
+        for (int i = 0; i < 3; i++)
+            _sampleGyro[i] = (int16_t)(data[i * 2] | (data[i * 2 + 1] << 8)) * _gyroScale;
+        _sampleHasGyro = true;
+        break;
+
+    default: // other tags are not batched
+        break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------
+bool flxDevISM330Base::execute(void)
+{
+    if (!_fifo_streaming || !isInitialized())
+        return true;
+
+    // pick up anything that arrived since the last job run, then hand the samples to the outputs
+    drainFIFO();
+
+    std::swap(_streamIn, _streamOut);
+    clearStream(_streamIn);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------
+bool flxDevISM330Base::read_stream_timestamp(flxDataArrayDouble *theArray)
+{
+    if (_streamOut.timestamp.size() == 0)
+        return false;
+
+    theArray->set(_streamOut.timestamp.data(), _streamOut.timestamp.size(), true); // don't copy
+    return true;
+}
+bool flxDevISM330Base::readStreamArray(std::vector<float> &values, flxDataArrayFloat *theArray)
+{
+    if (values.size() == 0)
+        return false;
+
+    theArray->set(values.data(), values.size(), true); // don't copy
+    return true;
+}
+bool flxDevISM330Base::read_stream_accel_x(flxDataArrayFloat *theArray)
+{
+    return readStreamArray(_streamOut.accelX, theArray);
+}
+bool flxDevISM330Base::read_stream_accel_y(flxDataArrayFloat *theArray)
+{
+    return readStreamArray(_streamOut.accelY, theArray);
+}
+bool flxDevISM330Base::read_stream_accel_z(flxDataArrayFloat *theArray)
+{
+    return readStreamArray(_streamOut.accelZ, theArray);
+}
+bool flxDevISM330Base::read_stream_gyro_x(flxDataArrayFloat *theArray)
+{
+    return readStreamArray(_streamOut.gyroX, theArray);
+}
+bool flxDevISM330Base::read_stream_gyro_y(flxDataArrayFloat *theArray)
+{
+    return readStreamArray(_streamOut.gyroY, theArray);
+}
+bool flxDevISM330Base::read_stream_gyro_z(flxDataArrayFloat *theArray)
+{
+    return readStreamArray(_streamOut.gyroZ, theArray);
+}
+uint32_t flxDevISM330Base::read_stream_dropped()
+{
+    return _streamDropped;
+}
+uint32_t flxDevISM330Base::read_fifo_overruns()
+{
+    return _fifoOverruns;
+}
 
 //----------------------------------------------------------------------------------------------------------
 // I2C Version of the driver
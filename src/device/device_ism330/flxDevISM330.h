@@ -23,11 +23,34 @@
 #include "Arduino.h"
 
 #include "SparkFun_ISM330DHCX.h"
+#include "flxCoreJobs.h"
 #include "flxDevice.h"
 
+#include <vector>
+
 // What is the name used to ID this device?
 #define kISM330DeviceName "ISM330"
 
+// FIFO streaming
+//
+// The max number of samples buffered between observations. If more samples arrive before the
+// next observation, they are dropped and counted (Stream Dropped). The FIFO is drained by a job,
+// but the samples are only output when the device is observed - so capture is lossless only while
+// the data rate times the observation (log) interval is under this limit. At 833 Hz that's an
+// interval under about 1.2 seconds, at 1666 Hz about 0.6 seconds. For longer intervals, lower the
+// data rate or define a larger limit - each sample uses 32 bytes of RAM.
+#ifndef kISM330StreamMaxSamples
+#define kISM330StreamMaxSamples 1024
+#endif
+
+// Number of FIFO words read per bus transaction - each word is a tag byte and 6 data bytes
+#define kISM330FIFOReadWords 32
+#define kISM330FIFOWordSize 7
+
+// The FIFO watermark is 9 bits
+#define kISM330FIFOWatermarkMax 511
+#define kISM330FIFOWatermarkDefault 64
+
 //----------------------------------------------------------------------------------------------------------
 // Define a base framework device class. Then subclass from this for I2C and SPI version
 // of the device driver
@@ -38,6 +61,10 @@ class flxDevISM330Base : public flxDevice, public QwDevISM330DHCX
   public:
     flxDevISM330Base();
 
+    // Called before the output parameters are read. When streaming, this drains the FIFO and
+    // snapshots the samples collected since the last observation for the array outputs.
+    bool execute(void);
+
   private:
     // methods used to get values for our output parameters
     float read_accel_x();
@@ -65,6 +92,31 @@ class flxDevISM330Base : public flxDevice, public QwDevISM330DHCX
     void set_accel_slope_filter(uint8_t);
     uint8_t get_gyro_lp1_bandwidth();
     void set_gyro_lp1_bandwidth(uint8_t);
+    bool get_fifo_streaming();
+    void set_fifo_streaming(bool);
+    uint16_t get_fifo_watermark();
+    void set_fifo_watermark(uint16_t);
+
+    // FIFO streaming support
+    bool configureFIFO(bool enable);
+    bool drainFIFO(void);
+    void decodeFIFOWord(const uint8_t *word);
+    void pushStreamSample(void);
+    uint32_t fifoDrainPeriod(void);
+    void fifoJobCB(void);
+
+    // stream outputs
+    bool read_stream_timestamp(flxDataArrayDouble *);
+    bool read_stream_accel_x(flxDataArrayFloat *);
+    bool read_stream_accel_y(flxDataArrayFloat *);
+    bool read_stream_accel_z(flxDataArrayFloat *);
+    bool read_stream_gyro_x(flxDataArrayFloat *);
+    bool read_stream_gyro_y(flxDataArrayFloat *);
+    bool read_stream_gyro_z(flxDataArrayFloat *);
+    uint32_t read_stream_dropped();
+    uint32_t read_fifo_overruns();
+
+    bool readStreamArray(std::vector<float> &values, flxDataArrayFloat *theArray);
 
     // Flags to prevent getAccel being called multiple times
     bool _accelX = false;
@@ -88,6 +140,49 @@ class flxDevISM330Base : public flxDevice, public QwDevISM330DHCX
     uint8_t _accel_slope_filter = ISM_LP_ODR_DIV_100;
     uint8_t _gyro_lp1_bandwidth = ISM_MEDIUM;
 
+    bool _fifo_streaming = false;
+    uint16_t _fifo_watermark = kISM330FIFOWatermarkDefault;
+
+    // A set of samples - struct of arrays, so they map directly to the array output parameters
+    typedef struct
+    {
+        std::vector<double> timestamp;
+        std::vector<float> accelX;
+        std::vector<float> accelY;
+        std::vector<float> accelZ;
+        std::vector<float> gyroX;
+        std::vector<float> gyroY;
+        std::vector<float> gyroZ;
+    } ism330_stream_t;
+
+    void clearStream(ism330_stream_t &stream);
+
+    // samples being collected from the FIFO, and the set being output for the current observation
+    ism330_stream_t _streamIn;
+    ism330_stream_t _streamOut;
+
+    // The sample being assembled from FIFO words
+    double _sampleTimestamp = 0;
+
+    // The device timestamp is a 32 bit count of 25 us ticks - it's extended to 64 bits so the stream
+    // timestamps don't wrap
+    uint64_t _timestampTicks = 0;
+    uint32_t _lastTimestampTicks = 0;
+    bool _timestampStarted = false;
+    float _sampleAccel[3] = {0};
+    float _sampleGyro[3] = {0};
+    bool _sampleHasAccel = false;
+    bool _sampleHasGyro = false;
+
+    // LSB to output unit scale factors, set when the FIFO is configured
+    float _accelScale = 0;
+    float _gyroScale = 0;
+
+    uint32_t _streamDropped = 0;
+    uint32_t _fifoOverruns = 0;
+
+    flxJob _fifoJob;
+
   public:
     // Define our output parameters - specify the get functions to call.
     flxParameterOutFloat<flxDevISM330Base, &flxDevISM330Base::read_accel_x> accelX;
@@ -98,6 +193,17 @@ class flxDevISM330Base : public flxDevice, public QwDevISM330DHCX
     flxParameterOutFloat<flxDevISM330Base, &flxDevISM330Base::read_gyro_z> gyroZ;
     flxParameterOutFloat<flxDevISM330Base, &flxDevISM330Base::read_temperature> temperature;
 
+    // Streaming outputs - all the samples collected from the FIFO since the last observation
+    flxParameterOutArrayDouble<flxDevISM330Base, &flxDevISM330Base::read_stream_timestamp> streamTimestamp;
+    flxParameterOutArrayFloat<flxDevISM330Base, &flxDevISM330Base::read_stream_accel_x> streamAccelX;
+    flxParameterOutArrayFloat<flxDevISM330Base, &flxDevISM330Base::read_stream_accel_y> streamAccelY;
+    flxParameterOutArrayFloat<flxDevISM330Base, &flxDevISM330Base::read_stream_accel_z> streamAccelZ;
+    flxParameterOutArrayFloat<flxDevISM330Base, &flxDevISM330Base::read_stream_gyro_x> streamGyroX;
+    flxParameterOutArrayFloat<flxDevISM330Base, &flxDevISM330Base::read_stream_gyro_y> streamGyroY;
+    flxParameterOutArrayFloat<flxDevISM330Base, &flxDevISM330Base::read_stream_gyro_z> streamGyroZ;
+    flxParameterOutUInt32<flxDevISM330Base, &flxDevISM330Base::read_stream_dropped> streamDropped;
+    flxParameterOutUInt32<flxDevISM330Base, &flxDevISM330Base::read_fifo_overruns> fifoOverruns;
+
     // Define our read-write properties
     flxPropertyRWUInt8<flxDevISM330Base, &flxDevISM330Base::get_accel_data_rate, &flxDevISM330Base::set_accel_data_rate>
         accelDataRate = {ISM_XL_ODR_104Hz,
@@ -172,6 +278,13 @@ class flxDevISM330Base : public flxDevice, public QwDevISM330DHCX
                              {"Aggressive", ISM_AGGRESSIVE},
                              {"Extreme", ISM_XTREME}}};
 
+    // FIFO streaming - when enabled, the samples batched in the device FIFO are output as arrays
+    flxPropertyRWBool<flxDevISM330Base, &flxDevISM330Base::get_fifo_streaming, &flxDevISM330Base::set_fifo_streaming>
+        fifoStreaming = {false};
+
+    flxPropertyRWUInt16<flxDevISM330Base, &flxDevISM330Base::get_fifo_watermark, &flxDevISM330Base::set_fifo_watermark>
+        fifoWatermark = {kISM330FIFOWatermarkDefault, 1, kISM330FIFOWatermarkMax};
+
   protected:
     bool onInitialize(void);
 };
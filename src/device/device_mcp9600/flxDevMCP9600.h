@@ -43,6 +43,12 @@ class flxDevMCP9600 : public flxDeviceI2CType<flxDevMCP9600>, public MCP9600
         return flxDevConfidenceExact;
     }
 
+    // The MCP9600 only ACKs the first transaction after power up - no ping
+    static bool pingable(void)
+    {
+        return false;
+    }
+
     static const char *getDeviceName()
     {
         return kMCP9600DeviceName;
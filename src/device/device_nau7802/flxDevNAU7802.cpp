@@ -67,6 +67,9 @@ flxDevNAU7802::flxDevNAU7802()
     // Register Property
     flxRegister(zeroOffset, "Zero Offset", "The scale zero offset");
     flxRegister(calibrationFactor, "Calibration Factor", "Used to convert the scale ADU into units");
+    flxRegister(backgroundAveraging, "Background Averaging",
+                "Collect samples in the background - weight is the average of the latest samples");
+    flxRegister(averageWindow, "Average Window", "The number of samples averaged for the weight");
 
     // hidden
     flxRegister(_externalCalOffset, "ExternalOffset");
@@ -74,10 +77,15 @@ flxDevNAU7802::flxDevNAU7802()
 
     // Register parameters
     flxRegister(weight, "Weight", "Weight in units - as set by the calibrationFactor", kParamValueWeightUserUnits);
+    flxRegister(rawSamples, "Raw Samples", "The latest raw ADC samples, oldest first");
     flxRegister(calculateZeroOffset, "Calculate Zero Offset",
                 "Perform a zero offset calibration. Sets the scale weight to zero");
     flxRegister(calculateCalibrationFactor, "Calculate Calibration Factor",
                 "Perform a scale calibration. Sets the scale weight to this many units");
+
+    resetSamples();
+
+    _sampleJob.setup(kNAU7802DeviceName, kNAU7802SamplePeriod, this, &flxDevNAU7802::sampleJobCB);
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -137,6 +145,9 @@ bool flxDevNAU7802::onInitialize(TwoWire &wirePort)
         delay(getLDORampDelay()); // Wait for LDO to ramp
     }
 
+    if (status && _backgroundAveraging)
+        flxAddJobToQueue(_sampleJob);
+
     return status;
 }
 
@@ -144,7 +155,111 @@ bool flxDevNAU7802::onInitialize(TwoWire &wirePort)
 // GETTER methods for output params
 float flxDevNAU7802::read_weight()
 {
-    return NAU7802::getWeight(true, 16); // Allow negative weights
+    // No background samples yet? Do a blocking read
+    if (!_backgroundAveraging || _sampleCount == 0)
+        return NAU7802::getWeight(true, _averageWindow); // Allow negative weights
+
+    // Same as getWeight() - with negative weights allowed - on the window average
+    int32_t average = (int32_t)(_sampleSum / _sampleCount);
+
+    return (float)(average - NAU7802::getZeroOffset()) / NAU7802::getCalibrationFactor();
+}
+
+//----------------------------------------------------------------------------------------------------------
+bool flxDevNAU7802::read_raw_samples(flxDataArrayInt32 *theArray)
+{
+    // Unroll the ring buffer - oldest sample first
+    uint16_t iStart = (_sampleHead + kNAU7802WindowMax - _sampleCount) % kNAU7802WindowMax;
+
+    for (uint16_t i = 0; i < _sampleCount; i++)
+        _samplesOut[i] = _samples[(iStart + i) % kNAU7802WindowMax];
+
+    theArray->set(_samplesOut, _sampleCount);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Background sample collection
+//----------------------------------------------------------------------------------------------------------
+
+void flxDevNAU7802::resetSamples(void)
+{
+    _sampleHead = 0;
+    _sampleCount = 0;
+    _sampleSum = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Job callback - add the latest conversion, if one is ready, to the sample window
+void flxDevNAU7802::sampleJobCB(void)
+{
+    if (!NAU7802::available())
+        return;
+
+    int32_t sample = NAU7802::getReading();
+
+    // Window full? Drop the oldest sample
+    if (_sampleCount >= _averageWindow)
+    {
+        uint16_t iOldest = (_sampleHead + kNAU7802WindowMax - _sampleCount) % kNAU7802WindowMax;
+        _sampleSum -= _samples[iOldest];
+        _sampleCount--;
+    }
+
+    _samples[_sampleHead] = sample;
+    _sampleHead = (_sampleHead + 1) % kNAU7802WindowMax;
+    _sampleSum += sample;
+    _sampleCount++;
+}
+
+//----------------------------------------------------------------------------------------------------------
+bool flxDevNAU7802::get_background_averaging(void)
+{
+    return _backgroundAveraging;
+}
+
+//----------------------------------------------------------------------------------------------------------
+void flxDevNAU7802::set_background_averaging(bool enable)
+{
+    _backgroundAveraging = enable;
+
+    rawSamples.setEnabled(enable);
+
+    if (!isInitialized())
+        return;
+
+    resetSamples();
+
+    if (enable)
+        flxAddJobToQueue(_sampleJob);
+    else
+        flxRemoveJobFromQueue(_sampleJob);
+}
+
+//----------------------------------------------------------------------------------------------------------
+uint16_t flxDevNAU7802::get_average_window(void)
+{
+    return _averageWindow;
+}
+
+//----------------------------------------------------------------------------------------------------------
+void flxDevNAU7802::set_average_window(uint16_t window)
+{
+    if (window < 1)
+        window = 1;
+    else if (window > kNAU7802WindowMax)
+        window = kNAU7802WindowMax;
+
+    // Shrinking the window? Drop the oldest samples
+    while (_sampleCount > window)
+    {
+        uint16_t iOldest = (_sampleHead + kNAU7802WindowMax - _sampleCount) % kNAU7802WindowMax;
+        _sampleSum -= _samples[iOldest];
+        _sampleCount--;
+    }
+
+    _averageWindow = window;
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -183,6 +298,7 @@ void flxDevNAU7802::set_ext_offset(int32_t offset)
 {
     NAU7802::set24BitRegister(NAU7802_OCAL1_B2, offset);
     NAU7802::getWeight(true, 10); // flush
+    resetSamples();
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -196,6 +312,7 @@ void flxDevNAU7802::set_ext_gain(uint32_t gain)
 {
     set32BitRegister(NAU7802_GCAL1_B3, gain);
     NAU7802::getWeight(true, 10); // flush
+    resetSamples();
 }
 
 //----------------------------------------------------------------------------------------------------------
@@ -214,8 +331,12 @@ void flxDevNAU7802::calculate_zero_offset()
     NAU7802::calculateZeroOffset(64); // Zero the scale - calculateZeroOffset(uint8_t averageAmount = 8)
 
     NAU7802::getWeight(true, 10); // flush the device
+    resetSamples();                // samples from before the offset calibration are stale
+
     // This has changed the value of the zero offset property in the underlying driver.
-    // Set the dirty flag so that system knows the property changed.
+    // Set the dirty flags so that system knows the property changed - an incremental save only writes
+    // dirty properties.
+    zeroOffset.setIsDirty();
     this->setIsDirty();
 }
 
@@ -228,6 +349,7 @@ void flxDevNAU7802::calculate_calibration_factor(const float &weight_in_units)
 
     NAU7802::getWeight(true, 10); // flush the device
     // This has changed the value of the cal factor property in the underlying driver.
-    // Set the dirty flag so that system knows the property changed.
+    // Set the dirty flags so that system knows the property changed.
+    calibrationFactor.setIsDirty();
     this->setIsDirty();
 }
@@ -23,10 +23,22 @@
 #include "Arduino.h"
 
 #include "SparkFun_Qwiic_Scale_NAU7802_Arduino_Library.h"
+#include "flxCoreJobs.h"
 #include "flxDevice.h"
 
 // What is the name used to ID this device?
 #define kNAU7802DeviceName "NAU7802"
+
+// Background averaging
+//
+// Conversions are collected by a job into a window of the latest samples, and the weight output
+// is the average of the window. The max window size, in samples
+#define kNAU7802WindowMax 64
+#define kNAU7802WindowDefault 16
+
+// Period of the sample collection job in ms. The device converts at 320 SPS, with no FIFO, so
+// the job collects the latest conversion - up to 200 samples per second.
+#define kNAU7802SamplePeriod 5
 //----------------------------------------------------------------------------------------------------------
 // Define our class - note we are sub-classing from the Qwiic Library
 class flxDevNAU7802 : public flxDeviceI2CType<flxDevNAU7802>, public NAU7802
@@ -65,6 +77,7 @@ class flxDevNAU7802 : public flxDeviceI2CType<flxDevNAU7802>, public NAU7802
   private:
     // methods used to get values for our output parameters
     float read_weight();
+    bool read_raw_samples(flxDataArrayInt32 *);
 
     // methods used to get values for our RW properties
     int32_t get_zero_offset();
@@ -80,6 +93,27 @@ class flxDevNAU7802 : public flxDeviceI2CType<flxDevNAU7802>, public NAU7802
     uint32_t get_ext_gain(void);
     void set_ext_gain(uint32_t);
 
+    bool get_background_averaging(void);
+    void set_background_averaging(bool);
+    uint16_t get_average_window(void);
+    void set_average_window(uint16_t);
+
+    // background sample collection
+    void sampleJobCB(void);
+    void resetSamples(void);
+
+    bool _backgroundAveraging = true;
+    uint16_t _averageWindow = kNAU7802WindowDefault;
+
+    // Window of the latest raw samples - a ring buffer, with a running sum
+    int32_t _samples[kNAU7802WindowMax];
+    int32_t _samplesOut[kNAU7802WindowMax];
+    uint16_t _sampleHead = 0;
+    uint16_t _sampleCount = 0;
+    int64_t _sampleSum = 0;
+
+    flxJob _sampleJob;
+
     // methods used to set our input parameters
     void calculate_zero_offset();
     void calculate_calibration_factor(const float &weight_in_units);
@@ -89,6 +123,14 @@ class flxDevNAU7802 : public flxDeviceI2CType<flxDevNAU7802>, public NAU7802
     flxPropertyRWFloat<flxDevNAU7802, &flxDevNAU7802::get_calibration_factor, &flxDevNAU7802::set_calibration_factor>
         calibrationFactor;
 
+    // Background averaging - when enabled, weight is the average of the latest window of samples
+    flxPropertyRWBool<flxDevNAU7802, &flxDevNAU7802::get_background_averaging,
+                      &flxDevNAU7802::set_background_averaging>
+        backgroundAveraging = {true};
+
+    flxPropertyRWUInt16<flxDevNAU7802, &flxDevNAU7802::get_average_window, &flxDevNAU7802::set_average_window>
+        averageWindow = {kNAU7802WindowDefault, 1, kNAU7802WindowMax};
+
     // External calibration - hidden properties for cal data.
     flxPropertyRWHiddenInt32<flxDevNAU7802, &flxDevNAU7802::get_ext_offset, &flxDevNAU7802::set_ext_offset>
         _externalCalOffset;
@@ -101,4 +143,5 @@ class flxDevNAU7802 : public flxDeviceI2CType<flxDevNAU7802>, public NAU7802
 
     // Define our output parameters - specify the get functions to call.
     flxParameterOutFloat<flxDevNAU7802, &flxDevNAU7802::read_weight> weight;
+    flxParameterOutArrayInt32<flxDevNAU7802, &flxDevNAU7802::read_raw_samples> rawSamples;
 };
@@ -94,6 +94,8 @@ bool flxDevPASCO2V01::onInitialize(TwoWire &wirePort)
 {
     uint8_t retries = 3;
 
+    // Note: the retry delay is only taken if the sensor doesn't respond at startup
+
     // Create instance of arduino object
     _theSensor = new PASCO2Ino(&wirePort);
 
@@ -126,40 +128,39 @@ bool flxDevPASCO2V01::onInitialize(TwoWire &wirePort)
 
     _sensorIsMeasuring = true;
 
+    // Read the sensor once per measurement period in the background
+    _theJob.setup(getDeviceName(), _measurementPeriod * 1000, this, &flxDevPASCO2V01::jobHandlerCB);
+    flxAddJobToQueue(_theJob);
+
     return true;
 }
 
-// GETTER methods for output params
-uint32_t flxDevPASCO2V01::read_CO2()
+//-----------------------------------------------------------------------------
+// Background read of the sensor - called once per measurement period
+void flxDevPASCO2V01::jobHandlerCB(void)
 {
     if (_theSensor == nullptr)
-    {
-        flxLog_E("PASCO2V01::read_CO2: Failed! Sensor is nullptr.");
-        return ((uint)_co2InPPM);
-    }
+        return;
 
     if (!_sensorIsMeasuring)
     {
-        flxLog_W("PASCO2V01::read_CO2: Sensor is not measuring, attempting to start.");
+        flxLog_W("PASCO2V01: Sensor is not measuring, attempting to start.");
         if (XENSIV_PASCO2_OK != _theSensor->startMeasure(_measurementPeriod))
         {
-            flxLog_E("PASCO2::read_CO2: Sensor failed to restart. Logging last received value.");
-            return ((uint)_co2InPPM);
+            flxLog_E("PASCO2V01: Sensor failed to restart. Logging last received value.");
+            return;
         }
         _sensorIsMeasuring = true;
     }
 
-    uint32_t currentMillis = millis();
-
-    if (currentMillis - _millisSinceLastMeasure >= (_measurementPeriod * 1000))
-    {
-        _millisSinceLastMeasure = currentMillis;
-        if (XENSIV_PASCO2_OK != _theSensor->getCO2(_co2InPPM))
-        {
-            flxLog_E("PASCO2V01::read_CO2: Failed to read sensor. Logging last received value.");
-        }
-    }
+    if (XENSIV_PASCO2_OK != _theSensor->getCO2(_co2InPPM))
+        flxLog_E("PASCO2V01: Failed to read sensor. Logging last received value.");
+}
 
+// GETTER methods for output params
+uint32_t flxDevPASCO2V01::read_CO2()
+{
+    // The value from the last background read
     return ((uint)_co2InPPM);
 }
 
@@ -276,4 +277,7 @@ void flxDevPASCO2V01::set_measurement_period(uint32_t period)
     }
 
     _sensorIsMeasuring = true;
+
+    _theJob.setPeriod(_measurementPeriod * 1000);
+    flxUpdateJobInQueue(_theJob);
 }
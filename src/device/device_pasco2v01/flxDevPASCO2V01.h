@@ -22,6 +22,7 @@
 
 #include <Arduino.h>
 
+#include "flxCoreJobs.h"
 #include "flxDevice.h"
 #include <pas-co2-ino.hpp>
 
@@ -84,9 +85,12 @@ class flxDevPASCO2V01 : public flxDeviceI2CType<flxDevPASCO2V01>
     uint16_t _pressureReference = 1015;   // Default value on reset
     uint16_t _calibrationReference = 400; // Default value on reset
 
-    uint32_t _millisSinceLastMeasure = 0;
     int16_t _co2InPPM = 0;
 
+    // The CO2 value is read in the background, once per measurement period
+    void jobHandlerCB(void);
+    flxJob _theJob;
+
     bool _sensorIsInitialized = false;
     bool _sensorIsMeasuring = false;
 
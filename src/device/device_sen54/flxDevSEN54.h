@@ -43,6 +43,12 @@ class flxDevSEN54 : public flxDeviceI2CType<flxDevSEN54>, public SensirionI2CSen
         return flxDevConfidenceExact;
     }
 
+    // The SEN54 does not like being pinged
+    static bool pingable(void)
+    {
+        return false;
+    }
+
     static const char *getDeviceName()
     {
         return kSEN54DeviceName;
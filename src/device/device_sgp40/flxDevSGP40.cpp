@@ -63,6 +63,8 @@ bool flxDevSGP40::isConnected(flxBusI2C &i2cDriver, uint8_t address)
 
     if (!i2cDriver.write(address, (uint8_t *)sgp40_measure_test, 2))
         return false;
+
+    // Note: the self test takes up to 320 ms - this wait is only taken during device detection at startup
     delay(320);
 
     uint8_t response[3]; // Two bytes plus CRC
@@ -97,13 +99,30 @@ bool flxDevSGP40::isConnected(flxBusI2C &i2cDriver, uint8_t address)
 bool flxDevSGP40::onInitialize(TwoWire &wirePort)
 {
 
-    return SGP40::begin(wirePort);
+    if (!SGP40::begin(wirePort))
+        return false;
+
+    // The VOC index is computed from samples taken at 1 Hz in the background. Each sample blocks
+    // for the ~30 ms measurement time inside the library, but that no longer lands on the
+    // observation path - and the algorithm is fed at the rate it was designed for.
+    _theJob.setup(getDeviceName(), kSGP40SamplePeriod, this, &flxDevSGP40::jobHandlerCB);
+    flxAddJobToQueue(_theJob);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------
+// Background sample
+void flxDevSGP40::jobHandlerCB(void)
+{
+    _vocIndex = SGP40::getVOCindex(_RH, _temperature);
 }
 
 // GETTER methods for output params
 int32_t flxDevSGP40::read_voc()
 {
-    return SGP40::getVOCindex(_RH, _temperature);
+    // the value from the last background sample
+    return _vocIndex;
 }
 
 // methods for input params
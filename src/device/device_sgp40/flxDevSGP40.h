@@ -23,10 +23,14 @@
 #include "Arduino.h"
 
 #include "SparkFun_SGP40_Arduino_Library.h"
+#include "flxCoreJobs.h"
 #include "flxDevice.h"
 
 // What is the name used to ID this device?
 #define kSGP40DeviceName "SGP40"
+
+// The VOC index algorithm expects a sample every second
+#define kSGP40SamplePeriod 1000
 //----------------------------------------------------------------------------------------------------------
 // Define our class - note we are sub-classing from the Qwiic Library
 class flxDevSGP40 : public flxDeviceI2CType<flxDevSGP40>, public SGP40
@@ -68,6 +72,12 @@ class flxDevSGP40 : public flxDeviceI2CType<flxDevSGP40>, public SGP40
     float _RH = 50.0;
     float _temperature = 25.0;
 
+    // background sampling
+    void jobHandlerCB(void);
+    flxJob _theJob;
+
+    int32_t _vocIndex = 0;
+
   public:
     // Define our input parameters
     flxParameterInFloat<flxDevSGP40, &flxDevSGP40::write_rh> rh;
@@ -232,7 +232,8 @@ void flxDevSoilMoisture::calibrate_low_value(void)
     _lowCalVal = valueSum / kCalibrationIterations;
     flxLog_N(F("Calibration complete. Dry value is: %d"), _lowCalVal);
 
-    // so this value is saved
+    // so this value is saved - an incremental save only writes dirty properties
+    calibrationDry.setIsDirty();
     this->setIsDirty();
 }
 //-----------------------------------------------------------------------
@@ -260,5 +261,6 @@ void flxDevSoilMoisture::calibrate_high_value(void)
     _highCalVal = valueSum / kCalibrationIterations;
     flxLog_N(F("Calibration complete. 100%c Web value is: %d"), '%', _highCalVal);
     // so this value is saved
+    calibrationWet.setIsDirty();
     this->setIsDirty();
 }
\ No newline at end of file
@@ -31,7 +31,8 @@
 // handy helper
 static bool tag_is_valid(const char *tag)
 {
-    if (!tag || strlen(tag) < kESP32MinTagLen)
+    // only the minimum length is checked - not the whole tag
+    if (!tag || strnlen(tag, kESP32MinTagLen) < kESP32MinTagLen)
     {
         flxLog_E("ESP32  Storage - invalid tag length - minimum is %d: %s\n\r", kESP32MinTagLen, !tag ? "NULL" : tag);
         return false;
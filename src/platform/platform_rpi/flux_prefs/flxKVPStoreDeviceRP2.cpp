@@ -18,6 +18,7 @@
 // pattern of that system.
 //----------------------------------------------------------
 #include "flxKVPStoreDeviceRP2.h"
+#include "flxCoreLog.h"
 
 #include <Arduino.h>
 #include <hardware/flash.h>
@@ -38,21 +39,15 @@
 //	also see:
 //	https://petewarden.com/2024/01/16/understanding-the-raspberry-pi-picos-memory-layout/
 //
+// The store has one page per sector of the partition - the _EEPROM partition is one sector, so the
+// partition must be made larger for the store to level wear (see the header).
 
-const uint32_t kRP2040StorageSize = 4096;
 const uint32_t kRP2040SegmentSize = 4096;
-// TODO:
-//    - Make this a per page thing - map 4096 to this
-//    - Add cache and dirty ops
-//    - Add commit method
-//
 const uint32_t kPartitionPageSize = kRP2040SegmentSize;
 
-const uint32_t kPageNumberNull = 0xFFFFFFFF;
-
 extern "C" uint8_t _EEPROM_start;
 
-flxKVPStoreDeviceRP2::flxKVPStoreDeviceRP2() : _pData{nullptr}, _currentPage{kPageNumberNull}, _isDirty{false}
+flxKVPStoreDeviceRP2::flxKVPStoreDeviceRP2() : flxKVPStoreDeviceBuffered()
 {
     _pPartition = nullptr;
     _segmentSize = 0;
@@ -64,47 +59,30 @@ flxKVPStoreDeviceRP2::flxKVPStoreDeviceRP2(uint8_t *partitionStart, uint32_t seg
     initialize(partitionStart, segmentSize, nSegments);
 }
 
-flxKVPStoreDeviceRP2::~flxKVPStoreDeviceRP2()
-{
-    if (!_pData)
-        delete _pData;
-}
-
 void flxKVPStoreDeviceRP2::initialize(uint8_t *partitionStart, uint32_t segmentSize, uint32_t nSegments)
 {
     _pPartition = partitionStart;
-    _segmentSize = segmentSize;
     _nSegments = nSegments;
-}
-bool flxKVPStoreDeviceRP2::setCurrentPage(uint32_t newPage)
-{
-    if (newPage == _currentPage)
-        return true;
-
-    // flush out current
-    commitPage();
-
-    if (_pData == nullptr)
-    {
-        _pData = new uint8_t[kPartitionPageSize];
 
-        if (_pData == nullptr)
-            return false;
-    }
+    // A segment is a flash sector - the unit that's erased
+    if (segmentSize != kPartitionPageSize)
+        flxLog_W(F("KVP Storage - segment size %u not supported, using %u"), segmentSize, kPartitionPageSize);
 
-    // copy the current contents of flash for this page, into our r/w ram buffer
-    memcpy(_pData, _pPartition + (newPage * kPartitionPageSize), kPartitionPageSize);
+    _segmentSize = kPartitionPageSize;
+}
 
-    _currentPage = newPage;
+const uint8_t *flxKVPStoreDeviceRP2::sectorData(uint32_t iSector)
+{
+    if (!_pPartition || iSector >= _nSegments)
+        return nullptr;
 
-    return true;
+    return _pPartition + (iSector * kPartitionPageSize);
 }
 
-void flxKVPStoreDeviceRP2::commitPage(void)
+bool flxKVPStoreDeviceRP2::programSector(uint32_t iSector, const uint8_t *data, uint32_t &usInterruptsOff)
 {
-
-    if (!_isDirty || _currentPage == kPageNumberNull || !_pData)
-        return;
+    if (!sectorData(iSector))
+        return false;
 
     // This is from the rp2040 Arduino core - probably done better
     // TODO - Move this to use the flash api in the pico sdk
@@ -113,77 +91,29 @@ void flxKVPStoreDeviceRP2::commitPage(void)
     noInterrupts(); // from the Arduino core impl
     // rp2040.idleOtherCore(); // 10/2/2024 -- KDB - this hangs the system...
 
-    flash_range_erase((intptr_t)(_pPartition + (_currentPage * kPartitionPageSize)) - (intptr_t)XIP_BASE,
+    // the timer keeps running with interrupts disabled
+    uint32_t ticks = micros();
+
+    flash_range_erase((intptr_t)(_pPartition + (iSector * kPartitionPageSize)) - (intptr_t)XIP_BASE,
                       kPartitionPageSize);
-    flash_range_program((intptr_t)(_pPartition + (_currentPage * kPartitionPageSize)) - (intptr_t)XIP_BASE, _pData,
+    flash_range_program((intptr_t)(_pPartition + (iSector * kPartitionPageSize)) - (intptr_t)XIP_BASE, data,
                         kPartitionPageSize);
+
+    usInterruptsOff = micros() - ticks;
+
     // rp2040.resumeOtherCore();
     interrupts();
 
     // restore_interrupts(intr_stash);
-    _isDirty = false;
-}
-
-bool flxKVPStoreDeviceRP2::erase(uint32_t iPage)
-{
-    if (!setCurrentPage(iPage))
-        return false;
-
-    memset(_pData, 0xFF, kPartitionPageSize);
-    _isDirty = true;
-
     return true;
 }
 
-bool flxKVPStoreDeviceRP2::write(uint32_t iPage, uint32_t address, const void *src, size_t len)
-{
-    if (!src || len == 0 || address + len >= _segmentSize)
-        return false;
-
-    if (!setCurrentPage(iPage))
-        return false;
-
-    memcpy(_pData + address, src, len);
-    _isDirty = true;
-
-    return true;
-}
-
-bool flxKVPStoreDeviceRP2::read(uint32_t iPage, uint32_t address, void *dest, size_t len)
-{
-    if (!dest || len == 0 || address + len >= _segmentSize)
-        return false;
-
-    if (!setCurrentPage(iPage))
-        return false;
-    memcpy(dest, _pData + address, len);
-
-    return true;
-}
-
-void flxKVPStoreDeviceRP2::flush(void)
-{
-    commitPage();
-}
-
-void flxKVPStoreDeviceRP2::close(void)
-{
-    commitPage();
-
-    if (_pData)
-    {
-        delete[] _pData;
-        _pData = nullptr;
-    }
-    _currentPage = kPageNumberNull;
-}
-
 uint32_t flxKVPStoreDeviceRP2::storageSize(void)
 {
-    return kRP2040StorageSize;
+    return _nSegments * _segmentSize;
 }
 
 uint32_t flxKVPStoreDeviceRP2::segmentSize(void)
 {
-    return kRP2040SegmentSize;
-}
\ No newline at end of file
+    return _segmentSize;
+}
@@ -19,40 +19,36 @@
 //----------------------------------------------------------
 #pragma once
 
-#include "flxKVPStoreDevice.h"
+#include "flxKVPStoreDeviceBuffered.h"
 #include <cstddef>
 #include <cstdint>
 
-class flxKVPStoreDeviceRP2 : public flxKVPStoreDevice
+// The sector buffering and transactions are implemented by flxKVPStoreDeviceBuffered - this device reads
+// the flash partition through the XIP mapping, and erases/programs sectors with the pico flash API.
+//
+// The store has a page for each 4K sector of the partition. The Arduino core's _EEPROM partition is a
+// single sector - with one page, the store compacts the page in place and every update erases the same
+// sector, so there's no wear leveling. To level wear, pass a partition of several sectors that's reserved
+// in the flash layout (for example, sectors taken from the end of a smaller filesystem) - each sector
+// added spreads the erases further.
+class flxKVPStoreDeviceRP2 : public flxKVPStoreDeviceBuffered
 {
   public:
     flxKVPStoreDeviceRP2();
     flxKVPStoreDeviceRP2(uint8_t *partitionStart, uint32_t segmentSize, uint32_t nSegments);
-    ~flxKVPStoreDeviceRP2();
 
     void initialize(uint8_t *partitionStart, uint32_t segmentSize, uint32_t nSegments);
-    bool write(uint32_t iPage, uint32_t address, const void *src, size_t len);
-
-    bool read(uint32_t iPage, uint32_t address, void *dest, size_t len);
-
-    bool erase(uint32_t iPage);
-
-    void flush(void);
-    void close(void);
 
     uint32_t storageSize();
     uint32_t segmentSize();
 
+  protected:
+    const uint8_t *sectorData(uint32_t iSector);
+    bool programSector(uint32_t iSector, const uint8_t *data, uint32_t &usInterruptsOff);
+
   private:
-    bool setCurrentPage(uint32_t);
-    void commitPage(void);
     // the pointer to the FLASH partition on the rp2*
-
     uint8_t *_pPartition;
-    uint8_t *_pData;
-
-    uint32_t _currentPage;
-    bool _isDirty;
 
     uint32_t _segmentSize;
     uint32_t _nSegments;
@@ -0,0 +1,289 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxSimDevices.h"
+
+//----------------------------------------------------------------------------------------------------
+// BME280
+//----------------------------------------------------------------------------------------------------
+
+#define kBME280RegCalib00 0x88
+#define kBME280RegCalibH1 0xA1
+#define kBME280RegChipID 0xD0
+#define kBME280RegReset 0xE0
+#define kBME280RegCalib26 0xE1
+#define kBME280RegStatus 0xF3
+#define kBME280RegData 0xF7
+
+#define kBME280ChipID 0x60
+#define kBME280ResetValue 0xB6
+
+// Datasheet example calibration - T1..T3, P1..P9 - little endian
+static const uint8_t kBME280CalibTP[] = {0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC, 0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B,
+                                         0x27, 0x0B, 0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6, 0x70, 0x17};
+
+// Humidity calibration - H1 = 75, H2 = 362, H3 = 0, H4 = 313, H5 = 50, H6 = 30
+static const uint8_t kBME280CalibH1 = 75;
+static const uint8_t kBME280CalibH2H6[] = {0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E};
+
+flxSimBME280::flxSimBME280(uint8_t address) : flxSimI2CDevice(address)
+{
+    reset();
+    setRawData(519888, 415148, 27000);
+}
+
+void flxSimBME280::reset(void)
+{
+    _registers[kBME280RegChipID] = kBME280ChipID;
+    _registers[kBME280RegStatus] = 0;
+
+    setRegisters(kBME280RegCalib00, kBME280CalibTP, sizeof(kBME280CalibTP));
+    _registers[kBME280RegCalibH1] = kBME280CalibH1;
+    setRegisters(kBME280RegCalib26, kBME280CalibH2H6, sizeof(kBME280CalibH2H6));
+
+    // control registers
+    _registers[0xF2] = 0;
+    _registers[0xF4] = 0;
+    _registers[0xF5] = 0;
+}
+
+void flxSimBME280::setRawData(uint32_t adcTemperature, uint32_t adcPressure, uint16_t adcHumidity)
+{
+    // pressure and temperature are 20 bits - msb, lsb, xlsb[7:4]. Humidity is 16 bits - msb, lsb
+    uint8_t data[8] = {(uint8_t)(adcPressure >> 12),    (uint8_t)(adcPressure >> 4),
+                       (uint8_t)(adcPressure << 4),     (uint8_t)(adcTemperature >> 12),
+                       (uint8_t)(adcTemperature >> 4),  (uint8_t)(adcTemperature << 4),
+                       (uint8_t)(adcHumidity >> 8),     (uint8_t)(adcHumidity & 0xFF)};
+
+    setRegisters(kBME280RegData, data, sizeof(data));
+}
+
+void flxSimBME280::writeRegister(uint8_t reg, uint8_t value)
+{
+    // only the control and reset registers are writeable
+    if (reg == kBME280RegReset)
+    {
+        if (value == kBME280ResetValue)
+            reset();
+    }
+    else if (reg == 0xF2 || reg == 0xF4 || reg == 0xF5)
+        _registers[reg] = value;
+}
+
+//----------------------------------------------------------------------------------------------------
+// AMG8833
+//----------------------------------------------------------------------------------------------------
+
+#define kAMG8833RegThermistor 0x0E
+#define kAMG8833RegPixels 0x80
+
+flxSimAMG8833::flxSimAMG8833(uint8_t address) : flxSimI2CDevice(address)
+{
+    setThermistor(25.0);
+
+    // a gradient across the array
+    for (uint8_t i = 0; i < 64; i++)
+        setPixel(i, 20.0 + i * 0.25);
+}
+
+void flxSimAMG8833::setThermistor(float temperature)
+{
+    // 12-bit sign-magnitude, 0.0625 C per LSB
+    int16_t value = (int16_t)(temperature / 0.0625);
+    uint16_t raw = value < 0 ? (uint16_t)(-value) | 0x800 : (uint16_t)value;
+
+    _registers[kAMG8833RegThermistor] = raw & 0xFF;
+    _registers[kAMG8833RegThermistor + 1] = (raw >> 8) & 0x0F;
+}
+
+void flxSimAMG8833::setPixel(uint8_t pixel, float temperature)
+{
+    if (pixel >= 64)
+        return;
+
+    // 12-bit two's complement, 0.25 C per LSB
+    uint16_t raw = (uint16_t)((int16_t)(temperature / 0.25)) & 0x0FFF;
+
+    _registers[kAMG8833RegPixels + pixel * 2] = raw & 0xFF;
+    _registers[kAMG8833RegPixels + pixel * 2 + 1] = raw >> 8;
+}
+
+void flxSimAMG8833::setPixels(float temperature)
+{
+    for (uint8_t i = 0; i < 64; i++)
+        setPixel(i, temperature);
+}
+
+//----------------------------------------------------------------------------------------------------
+// ADS1015
+//----------------------------------------------------------------------------------------------------
+
+#define kADS1015RegConversion 0
+#define kADS1015RegConfig 1
+#define kADS1015RegLoThresh 2
+#define kADS1015RegHiThresh 3
+
+#define kADS1015ConfigOS 0x8000
+
+flxSimADS1015::flxSimADS1015(uint8_t address) : flxSimI2CDevice(address)
+{
+    // power on defaults
+    _registers16[kADS1015RegConversion] = 0;
+    _registers16[kADS1015RegConfig] = 0x8583;
+    _registers16[kADS1015RegLoThresh] = 0x8000;
+    _registers16[kADS1015RegHiThresh] = 0x7FFF;
+
+    for (int i = 0; i < 4; i++)
+        _channels[i] = 0;
+}
+
+void flxSimADS1015::setChannel(uint8_t channel, int16_t value)
+{
+    if (channel < 4)
+        _channels[channel] = value;
+}
+
+// Run a conversion with the mux setting in the config register
+void flxSimADS1015::convert(void)
+{
+    // mux - bits 14:12. 0-3 are differential pairs, 4-7 single ended
+    static const int8_t kMuxPositive[8] = {0, 0, 1, 2, 0, 1, 2, 3};
+    static const int8_t kMuxNegative[8] = {1, 3, 3, 3, -1, -1, -1, -1};
+
+    uint8_t mux = (_registers16[kADS1015RegConfig] >> 12) & 0x07;
+
+    int32_t value = _channels[kMuxPositive[mux]];
+    if (kMuxNegative[mux] >= 0)
+        value -= _channels[kMuxNegative[mux]];
+
+    // 12-bit result, left aligned
+    value = value > 2047 ? 2047 : (value < -2048 ? -2048 : value);
+    _registers16[kADS1015RegConversion] = (uint16_t)(value << 4);
+}
+
+bool flxSimADS1015::onWrite(const uint8_t *data, size_t length)
+{
+    if (length == 0)
+        return true;
+
+    _pointer = data[0] & 0x03;
+
+    if (length < 3)
+        return true;
+
+    uint16_t value = (uint16_t)data[1] << 8 | data[2];
+
+    if (_pointer == kADS1015RegConfig)
+    {
+        // the OS bit starts a conversion - which completes immediately, so it reads back as set
+        _registers16[kADS1015RegConfig] = value | kADS1015ConfigOS;
+        if (value & kADS1015ConfigOS)
+            convert();
+    }
+    else if (_pointer != kADS1015RegConversion)
+        _registers16[_pointer] = value;
+
+    return true;
+}
+
+size_t flxSimADS1015::onRead(uint8_t *data, size_t length)
+{
+    // the register repeats - MSB first
+    uint16_t value = _registers16[_pointer];
+
+    for (size_t i = 0; i < length; i++)
+        data[i] = (i & 0x01) ? value & 0xFF : value >> 8;
+
+    return length;
+}
+
+//----------------------------------------------------------------------------------------------------
+// TMF882X
+//----------------------------------------------------------------------------------------------------
+
+#define kTMF882XRegAppID 0x00
+#define kTMF882XRegEnable 0xE0
+#define kTMF882XRegID 0xE3
+#define kTMF882XRegRevID 0xE4
+
+#define kTMF882XEnablePON 0x01
+#define kTMF882XEnableCPUReady 0x40
+
+flxSimTMF882X::flxSimTMF882X(uint8_t address) : flxSimI2CDevice(address)
+{
+    _registers[kTMF882XRegID] = 0x08;
+    _registers[kTMF882XRegRevID] = 0x01;
+    _registers[kTMF882XRegEnable] = kTMF882XEnablePON | kTMF882XEnableCPUReady;
+
+    // the measurement application is running
+    _registers[kTMF882XRegAppID] = 0x03;
+}
+
+void flxSimTMF882X::writeRegister(uint8_t reg, uint8_t value)
+{
+    // The CPU is always ready when powered on
+    if (reg == kTMF882XRegEnable)
+        value = (value & kTMF882XEnablePON) ? value | kTMF882XEnableCPUReady : value & ~kTMF882XEnableCPUReady;
+
+    // ID registers are read only
+    if (reg != kTMF882XRegID && reg != kTMF882XRegRevID)
+        _registers[reg] = value;
+}
+
+//----------------------------------------------------------------------------------------------------
+// ISM330
+//----------------------------------------------------------------------------------------------------
+
+#define kISM330RegWhoAmI 0x0F
+#define kISM330RegStatus 0x1E
+#define kISM330RegOutTemp 0x20
+#define kISM330RegOutGyro 0x22
+#define kISM330RegOutAccel 0x28
+
+#define kISM330WhoAmI 0x6B
+
+// temperature, gyro and accel data ready
+#define kISM330StatusReady 0x07
+
+flxSimISM330::flxSimISM330(uint8_t cs) : flxSimSPIDevice(cs)
+{
+    _registers[kISM330RegWhoAmI] = kISM330WhoAmI;
+    _registers[kISM330RegStatus] = kISM330StatusReady;
+
+    // At rest - 1 g on Z at the default 4 g full scale
+    setAccel(0, 0, 8197);
+    setGyro(0, 0, 0);
+    setTemperature(0);
+}
+
+// Little endian 16 bit values
+static void setRegisters16(flxSimSPIDevice &theDevice, uint8_t reg, int16_t x, int16_t y, int16_t z)
+{
+    uint8_t data[6] = {(uint8_t)(x & 0xFF), (uint8_t)(x >> 8), (uint8_t)(y & 0xFF),
+                       (uint8_t)(y >> 8),   (uint8_t)(z & 0xFF), (uint8_t)(z >> 8)};
+
+    theDevice.setRegisters(reg, data, sizeof(data));
+}
+
+void flxSimISM330::setAccel(int16_t x, int16_t y, int16_t z)
+{
+    setRegisters16(*this, kISM330RegOutAccel, x, y, z);
+}
+
+void flxSimISM330::setGyro(int16_t x, int16_t y, int16_t z)
+{
+    setRegisters16(*this, kISM330RegOutGyro, x, y, z);
+}
+
+void flxSimISM330::setTemperature(int16_t temperature)
+{
+    _registers[kISM330RegOutTemp] = temperature & 0xFF;
+    _registers[kISM330RegOutTemp + 1] = temperature >> 8;
+}
@@ -0,0 +1,115 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxSimDevices.h
+ *
+ * Register-map models of devices supported by the framework, for use with flxSimWire.
+ *
+ * The models implement the registers used for device detection and by the drivers to read
+ * data. Conversions are immediate - a model is always ready with data.
+ */
+
+#pragma once
+
+#include "flxSimSPI.h"
+#include "flxSimWire.h"
+
+//----------------------------------------------------------------------------------------------------
+// BME280 - temperature, humidity and pressure
+//
+// Uses the datasheet example calibration values. The raw ADC values are set by the user - the
+// defaults give about 25 C, 1006 hPa and 50 %RH.
+//
+class flxSimBME280 : public flxSimI2CDevice
+{
+  public:
+    flxSimBME280(uint8_t address = 0x77);
+
+    void setRawData(uint32_t adcTemperature, uint32_t adcPressure, uint16_t adcHumidity);
+
+    void writeRegister(uint8_t reg, uint8_t value);
+
+  private:
+    void reset(void);
+};
+
+//----------------------------------------------------------------------------------------------------
+// AMG8833 - 8x8 thermal array
+//
+class flxSimAMG8833 : public flxSimI2CDevice
+{
+  public:
+    flxSimAMG8833(uint8_t address = 0x69);
+
+    // temperatures in C
+    void setThermistor(float temperature);
+    void setPixel(uint8_t pixel, float temperature);
+    void setPixels(float temperature);
+};
+
+//----------------------------------------------------------------------------------------------------
+// ADS1015 - 4 channel, 12-bit ADC
+//
+// The device has 16-bit registers addressed through a pointer register. A conversion completes
+// as soon as it is started.
+//
+class flxSimADS1015 : public flxSimI2CDevice
+{
+  public:
+    flxSimADS1015(uint8_t address = 0x48);
+
+    // Set the 12-bit result for a single ended channel (0-3)
+    void setChannel(uint8_t channel, int16_t value);
+
+    bool onWrite(const uint8_t *data, size_t length);
+    size_t onRead(uint8_t *data, size_t length);
+
+  private:
+    void convert(void);
+
+    static constexpr uint8_t kNRegisters = 4;
+
+    uint16_t _registers16[kNRegisters];
+    int16_t _channels[4];
+};
+
+//----------------------------------------------------------------------------------------------------
+// TMF882X - multi-zone time of flight sensor
+//
+// Models the ID registers and the enable/application status registers. The application image
+// download and the measurement protocol are not modeled, so the sensor library can't start a
+// measurement on this model.
+//
+class flxSimTMF882X : public flxSimI2CDevice
+{
+  public:
+    flxSimTMF882X(uint8_t address = 0x41);
+
+    void writeRegister(uint8_t reg, uint8_t value);
+};
+
+//----------------------------------------------------------------------------------------------------
+// ISM330 - 6DoF IMU, SPI model
+//
+// Models the ID register and the output data registers. The status register always reports new
+// data.
+//
+class flxSimISM330 : public flxSimSPIDevice
+{
+  public:
+    flxSimISM330(uint8_t cs);
+
+    // raw output values - LSB
+    void setAccel(int16_t x, int16_t y, int16_t z);
+    void setGyro(int16_t x, int16_t y, int16_t z);
+    void setTemperature(int16_t temperature);
+};
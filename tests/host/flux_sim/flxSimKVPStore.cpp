@@ -0,0 +1,83 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxSimKVPStore.h"
+
+// Typical QSPI flash (W25Q) timing - a 4 KB sector erase, and programming a 256 byte page - microseconds
+#define kSimSectorEraseTime 45000
+#define kSimPageProgramTime 400
+#define kSimProgramPageSize 256
+
+//----------------------------------------------------------------------------------------------------
+flxSimKVPStoreDevice::flxSimKVPStoreDevice(uint32_t nSegments, uint32_t segmentSize)
+    : flxKVPStoreDeviceBuffered(), _nSegments{nSegments}, _segmentSize{segmentSize}
+{
+    // erased flash
+    _flash.assign(nSegments * segmentSize, 0xFF);
+    _eraseCounts.assign(nSegments, 0);
+
+    resetStats();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimKVPStoreDevice::resetStats(void)
+{
+    memset(&_stats, 0, sizeof(_stats));
+
+    for (auto &count : _eraseCounts)
+        count = 0;
+
+    flxKVPStoreDeviceBuffered::resetStats();
+}
+
+//----------------------------------------------------------------------------------------------------
+const uint8_t *flxSimKVPStoreDevice::sectorData(uint32_t iSector)
+{
+    return iSector < _nSegments ? _flash.data() + iSector * _segmentSize : nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxSimKVPStoreDevice::programSector(uint32_t iSector, const uint8_t *data, uint32_t &usInterruptsOff)
+{
+    if (iSector >= _nSegments)
+        return false;
+
+    memcpy(_flash.data() + iSector * _segmentSize, data, _segmentSize);
+
+    usInterruptsOff =
+        kSimSectorEraseTime + (_segmentSize + kSimProgramPageSize - 1) / kSimProgramPageSize * kSimPageProgramTime;
+
+    _eraseCounts[iSector]++;
+    _stats.erases++;
+    _stats.bytesOut += _segmentSize;
+    _stats.interruptsOff += usInterruptsOff;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxSimKVPStoreDevice::write(uint32_t iPage, uint32_t address, const void *src, size_t len)
+{
+    if (!flxKVPStoreDeviceBuffered::write(iPage, address, src, len))
+        return false;
+
+    _stats.writes++;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxSimKVPStoreDevice::read(uint32_t iPage, uint32_t address, void *dest, size_t len)
+{
+    if (!flxKVPStoreDeviceBuffered::read(iPage, address, dest, len))
+        return false;
+
+    _stats.reads++;
+    return true;
+}
@@ -0,0 +1,94 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxSimKVPStore.h
+ *
+ * A simulated flash device for the key-value-pair store - a flxKVPStoreDevice held in RAM.
+ *
+ * The device uses the same sector buffering as the RP2 flash device (flxKVPStoreDeviceBuffered):
+ * a changed sector is buffered in RAM and programmed - an erase and program of the sector - when
+ * the device is flushed, a write moves to another sector or a transaction ends. Each program is
+ * counted as an erase cycle of the sector, and charged the typical erase/program time of a QSPI
+ * flash as time with interrupts disabled, so the statistics show the flash wear and interrupt
+ * latency of a workload.
+ */
+
+#pragma once
+
+#include "flxKVPStoreDeviceBuffered.h"
+
+#include <cstring>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------
+// Device statistics
+typedef struct
+{
+    uint32_t reads;         // read calls
+    uint32_t writes;        // write calls
+    uint32_t erases;        // sector erase/program cycles
+    uint64_t bytesOut;      // bytes written
+    uint64_t interruptsOff; // simulated time with interrupts disabled - microseconds
+} flxSimKVPStats_t;
+
+//----------------------------------------------------------------------------------------------------
+// flxSimKVPStoreDevice
+//
+class flxSimKVPStoreDevice : public flxKVPStoreDeviceBuffered
+{
+  public:
+    flxSimKVPStoreDevice(uint32_t nSegments = 1, uint32_t segmentSize = 4096);
+
+    bool write(uint32_t iPage, uint32_t address, const void *src, size_t len);
+    bool read(uint32_t iPage, uint32_t address, void *dest, size_t len);
+
+    uint32_t storageSize()
+    {
+        return _nSegments * _segmentSize;
+    }
+    uint32_t segmentSize()
+    {
+        return _segmentSize;
+    }
+
+    // erase/program cycles of a sector
+    uint32_t eraseCount(uint32_t iPage)
+    {
+        return iPage < _nSegments ? _eraseCounts[iPage] : 0;
+    }
+
+    using flxKVPStoreDeviceBuffered::getStats;
+    void getStats(flxSimKVPStats_t &stats)
+    {
+        stats = _stats;
+    }
+    void resetStats(void);
+
+    // The contents of flash - the committed data
+    const uint8_t *flash(void)
+    {
+        return _flash.data();
+    }
+
+  protected:
+    const uint8_t *sectorData(uint32_t iSector);
+    bool programSector(uint32_t iSector, const uint8_t *data, uint32_t &usInterruptsOff);
+
+  private:
+    uint32_t _nSegments;
+    uint32_t _segmentSize;
+
+    std::vector<uint8_t> _flash;
+    std::vector<uint32_t> _eraseCounts;
+
+    flxSimKVPStats_t _stats;
+};
@@ -0,0 +1,169 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxSimSPI.h"
+
+#include <algorithm>
+
+// Default software overheads, in nanoseconds. Roughly the cost of the Arduino SPI calls on an ESP32.
+#define kSimSPITransactionOverhead 2000
+#define kSimSPIFrameOverhead 1000
+#define kSimSPITransferOverhead 1500
+
+//----------------------------------------------------------------------------------------------------
+// flxSimSPIDevice
+//----------------------------------------------------------------------------------------------------
+
+flxSimSPIDevice::flxSimSPIDevice(uint8_t cs) : _cs{cs}, _pointer{0}, _command{false}, _read{false}
+{
+    memset(_registers, 0, sizeof(_registers));
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimSPIDevice::setRegisters(uint8_t reg, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+        _registers[(reg + i) & 0x7F] = data[i];
+}
+
+//----------------------------------------------------------------------------------------------------
+// A new frame - the first byte is the register address
+void flxSimSPIDevice::onSelect(void)
+{
+    _command = true;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimSPIDevice::onTransfer(uint8_t *buffer, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (_command)
+        {
+            _read = (buffer[i] & kSPIReadFlag) != 0;
+            _pointer = buffer[i] & 0x7F;
+            _command = false;
+            buffer[i] = 0;
+        }
+        else if (_read)
+            buffer[i] = readRegister(_pointer++);
+        else
+        {
+            writeRegister(_pointer++, buffer[i]);
+            buffer[i] = 0;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+// flxSimBusSPI
+//----------------------------------------------------------------------------------------------------
+
+flxSimBusSPI::flxSimBusSPI()
+    : _selected{nullptr}, _clock{3000000}, _transactionOverhead{kSimSPITransactionOverhead},
+      _frameOverhead{kSimSPIFrameOverhead}, _transferOverhead{kSimSPITransferOverhead}, _realTime{true},
+      _pendingDelay{0}
+{
+    resetStats();
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxSimBusSPI::addDevice(flxSimSPIDevice &theDevice)
+{
+    if (device(theDevice.chipSelect()) != nullptr)
+        return false;
+
+    _devices.push_back(&theDevice);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimBusSPI::removeDevice(flxSimSPIDevice &theDevice)
+{
+    auto it = std::find(_devices.begin(), _devices.end(), &theDevice);
+    if (it != _devices.end())
+        _devices.erase(it);
+
+    if (_selected == &theDevice)
+        _selected = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+flxSimSPIDevice *flxSimBusSPI::device(uint8_t cs)
+{
+    for (auto pDevice : _devices)
+    {
+        if (pDevice->chipSelect() == cs)
+            return pDevice;
+    }
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimBusSPI::charge(uint64_t busTime)
+{
+    _stats.busTime += busTime;
+
+    if (!_realTime)
+        return;
+
+    _pendingDelay += busTime;
+    if (_pendingDelay >= 1000)
+    {
+        delayMicroseconds(_pendingDelay / 1000);
+        _pendingDelay %= 1000;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxSimBusSPI::beginTransfers(void)
+{
+    _stats.transactions++;
+    charge(_transactionOverhead);
+    return true;
+}
+
+void flxSimBusSPI::endTransfers(void)
+{
+    _selected = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimBusSPI::selectDevice(uint8_t cs, bool bSelect)
+{
+    if (!bSelect)
+    {
+        _selected = nullptr;
+        return;
+    }
+
+    _stats.frames++;
+    charge(_frameOverhead);
+
+    _selected = device(cs);
+    if (_selected)
+        _selected->onSelect();
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimBusSPI::transferBytes(uint8_t *buffer, size_t length)
+{
+    _stats.transfers++;
+    _stats.bytes += length;
+    charge(_transferOverhead + ((uint64_t)length * 8 * 1000000000 + _clock - 1) / _clock);
+
+    // Nothing selected - the bus reads as idle high
+    if (!_selected)
+    {
+        memset(buffer, 0xFF, length);
+        return;
+    }
+    _selected->onTransfer(buffer, length);
+}
@@ -0,0 +1,155 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxSimSPI.h
+ *
+ * A simulated SPI bus - a flxBusSPI object that routes chip select frames to register-map device
+ * models instead of hardware.
+ *
+ * Device models are attached to the bus by chip select pin. The first byte of a frame is the
+ * register address, with kSPIReadFlag set for reads, and the register pointer auto-increments.
+ *
+ * Timing:
+ *    Each bus transaction, chip select frame and block transfer is charged a fixed overhead, and
+ *    each byte the time to clock it at the bus clock rate. The overheads model the software cost of
+ *    the SPI driver calls on the target. The time is accumulated in the bus statistics and, unless
+ *    disabled, passed to delayMicroseconds().
+ */
+
+#pragma once
+
+#include "Arduino.h"
+#include "flxBusSPI.h"
+
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------
+// flxSimSPIDevice
+//
+// Base class for a SPI device model - a 128 byte register file.
+//
+class flxSimSPIDevice
+{
+  public:
+    flxSimSPIDevice(uint8_t cs);
+    virtual ~flxSimSPIDevice()
+    {
+    }
+
+    uint8_t chipSelect(void)
+    {
+        return _cs;
+    }
+
+    // Frame handlers - called by the bus when the device is selected, and for each block transferred
+    // in the frame. The block is replaced with the bytes the device sends.
+    virtual void onSelect(void);
+    virtual void onTransfer(uint8_t *buffer, size_t length);
+
+    // Register access - used by the default handlers and to setup a model
+    virtual uint8_t readRegister(uint8_t reg)
+    {
+        return _registers[reg & 0x7F];
+    }
+    virtual void writeRegister(uint8_t reg, uint8_t value)
+    {
+        _registers[reg & 0x7F] = value;
+    }
+    void setRegisters(uint8_t reg, const uint8_t *data, size_t length);
+
+  protected:
+    uint8_t _cs;
+    uint8_t _pointer;
+    bool _command;
+    bool _read;
+    uint8_t _registers[128];
+};
+
+//----------------------------------------------------------------------------------------------------
+// Bus statistics
+typedef struct
+{
+    uint32_t transactions; // beginTransaction/endTransaction pairs
+    uint32_t frames;       // chip select frames
+    uint32_t transfers;    // block transfers
+    uint32_t bytes;        // bytes moved, including the register address
+    uint64_t busTime;      // simulated time spent on the bus, in nanoseconds
+} flxSimSPIStats_t;
+
+//----------------------------------------------------------------------------------------------------
+// flxSimBusSPI
+//
+class flxSimBusSPI : public flxBusSPI
+{
+  public:
+    flxSimBusSPI();
+
+    // Device models - the bus doesn't own the models
+    bool addDevice(flxSimSPIDevice &theDevice);
+    void removeDevice(flxSimSPIDevice &theDevice);
+    flxSimSPIDevice *device(uint8_t cs);
+
+    // simulated clock rate in Hz
+    void setClock(uint32_t clock)
+    {
+        _clock = clock > 0 ? clock : 1000000;
+    }
+    uint32_t clock(void)
+    {
+        return _clock;
+    }
+
+    // Software overheads, in nanoseconds - per bus transaction, chip select frame and block transfer
+    void setOverheads(uint32_t transaction, uint32_t frame, uint32_t transfer)
+    {
+        _transactionOverhead = transaction;
+        _frameOverhead = frame;
+        _transferOverhead = transfer;
+    }
+
+    // Delay for the simulated time? If not, the time is only accumulated in the statistics.
+    void setRealTime(bool bRealTime)
+    {
+        _realTime = bRealTime;
+    }
+
+    void getStats(flxSimSPIStats_t &stats)
+    {
+        stats = _stats;
+    }
+    void resetStats(void)
+    {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+
+  protected:
+    bool beginTransfers(void);
+    void endTransfers(void);
+    void selectDevice(uint8_t cs, bool bSelect);
+    void transferBytes(uint8_t *buffer, size_t length);
+
+  private:
+    void charge(uint64_t busTime);
+
+    std::vector<flxSimSPIDevice *> _devices;
+    flxSimSPIDevice *_selected;
+
+    uint32_t _clock;
+    uint32_t _transactionOverhead;
+    uint32_t _frameOverhead;
+    uint32_t _transferOverhead;
+
+    bool _realTime;
+    uint64_t _pendingDelay; // ns not yet passed to delayMicroseconds()
+
+    flxSimSPIStats_t _stats;
+};
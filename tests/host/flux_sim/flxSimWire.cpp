@@ -0,0 +1,252 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxSimWire.h"
+
+#include <algorithm>
+
+// TwoWire endTransmission() status codes
+#define kSimWireOK 0
+#define kSimWireAddrNACK 2
+#define kSimWireDataNACK 3
+
+//----------------------------------------------------------------------------------------------------
+// flxSimI2CDevice
+//----------------------------------------------------------------------------------------------------
+
+flxSimI2CDevice::flxSimI2CDevice(uint8_t address)
+    : _address{address}, _pointer{0}, _latency{0}, _clockStretch{0}, _offline{false}, _nackCount{0}
+{
+    memset(_registers, 0, sizeof(_registers));
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimI2CDevice::setRegisters(uint8_t reg, const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+        _registers[(uint8_t)(reg + i)] = data[i];
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxSimI2CDevice::acknowledge(void)
+{
+    if (_offline)
+        return false;
+
+    if (_nackCount > 0)
+    {
+        _nackCount--;
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Default write - the first byte sets the register pointer, any following bytes are written to
+// the registers.
+bool flxSimI2CDevice::onWrite(const uint8_t *data, size_t length)
+{
+    if (length == 0)
+        return true;
+
+    _pointer = data[0];
+
+    for (size_t i = 1; i < length; i++)
+        writeRegister(_pointer++, data[i]);
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Default read - read from the register pointer
+size_t flxSimI2CDevice::onRead(uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+        data[i] = readRegister(_pointer++);
+
+    return length;
+}
+
+//----------------------------------------------------------------------------------------------------
+// flxSimWire
+//----------------------------------------------------------------------------------------------------
+
+// The base TwoWire object is never started - the platform constructors need a port
+#if defined(ESP32)
+flxSimWire::flxSimWire() : TwoWire(0)
+#elif defined(ARDUINO_PICO_MAJOR)
+flxSimWire::flxSimWire() : TwoWire(i2c1, PIN_WIRE1_SDA, PIN_WIRE1_SCL)
+#else
+flxSimWire::flxSimWire()
+#endif
+{
+    _txAddress = 0;
+    _txLength = 0;
+    _inTransmission = false;
+    _rxLength = 0;
+    _rxIndex = 0;
+    _clock = 100000;
+    _realTime = true;
+
+    resetStats();
+}
+
+//----------------------------------------------------------------------------------------------------
+bool flxSimWire::addDevice(flxSimI2CDevice &theDevice)
+{
+    if (device(theDevice.address()) != nullptr)
+        return false;
+
+    _devices.push_back(&theDevice);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimWire::removeDevice(flxSimI2CDevice &theDevice)
+{
+    auto it = std::find(_devices.begin(), _devices.end(), &theDevice);
+    if (it != _devices.end())
+        _devices.erase(it);
+}
+
+//----------------------------------------------------------------------------------------------------
+flxSimI2CDevice *flxSimWire::device(uint8_t address)
+{
+    for (auto pDevice : _devices)
+    {
+        if (pDevice->address() == address)
+            return pDevice;
+    }
+    return nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Each byte is 9 clocks (8 data + ACK). The address byte and start/stop conditions add about 11
+// more.
+void flxSimWire::transactionTime(flxSimI2CDevice *pDevice, size_t nBytes)
+{
+    uint32_t busTime = (uint32_t)(((uint64_t)(11 + nBytes * 9) * 1000000 + _clock - 1) / _clock);
+
+    if (pDevice)
+        busTime += pDevice->latency() + nBytes * pDevice->clockStretch();
+
+    _stats.transactions++;
+    _stats.bytes += nBytes;
+    _stats.busTime += busTime;
+
+    if (_realTime)
+        delayMicroseconds(busTime);
+}
+
+//----------------------------------------------------------------------------------------------------
+void flxSimWire::beginTransmission(uint8_t address)
+{
+    _txAddress = address;
+    _txLength = 0;
+    _inTransmission = true;
+}
+
+//----------------------------------------------------------------------------------------------------
+uint8_t flxSimWire::endTransmission(bool stopBit)
+{
+    if (!_inTransmission)
+        return kSimWireDataNACK;
+
+    _inTransmission = false;
+
+    flxSimI2CDevice *pDevice = device(_txAddress);
+
+    if (!pDevice || !pDevice->acknowledge())
+    {
+        transactionTime(nullptr, 0);
+        _stats.nacks++;
+        return kSimWireAddrNACK;
+    }
+
+    transactionTime(pDevice, _txLength);
+
+    if (!pDevice->onWrite(_txBuffer, _txLength))
+    {
+        _stats.nacks++;
+        return kSimWireDataNACK;
+    }
+    return kSimWireOK;
+}
+
+uint8_t flxSimWire::endTransmission(void)
+{
+    return endTransmission(true);
+}
+
+//----------------------------------------------------------------------------------------------------
+size_t flxSimWire::requestFrom(uint8_t address, size_t length, bool stopBit)
+{
+    _rxLength = 0;
+    _rxIndex = 0;
+
+    if (length > kSimWireBufferSize)
+        length = kSimWireBufferSize;
+
+    flxSimI2CDevice *pDevice = device(address);
+
+    if (!pDevice || !pDevice->acknowledge())
+    {
+        transactionTime(nullptr, 0);
+        _stats.nacks++;
+        return 0;
+    }
+
+    _rxLength = pDevice->onRead(_rxBuffer, length);
+
+    transactionTime(pDevice, _rxLength);
+
+    return _rxLength;
+}
+
+size_t flxSimWire::requestFrom(uint8_t address, size_t length)
+{
+    return requestFrom(address, length, true);
+}
+
+//----------------------------------------------------------------------------------------------------
+size_t flxSimWire::write(uint8_t data)
+{
+    if (!_inTransmission || _txLength >= kSimWireBufferSize)
+        return 0;
+
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t flxSimWire::write(const uint8_t *data, size_t length)
+{
+    size_t nWritten = 0;
+
+    while (nWritten < length && write(data[nWritten]) == 1)
+        nWritten++;
+
+    return nWritten;
+}
+
+//----------------------------------------------------------------------------------------------------
+int flxSimWire::available(void)
+{
+    return _rxLength - _rxIndex;
+}
+
+int flxSimWire::read(void)
+{
+    return _rxIndex < _rxLength ? _rxBuffer[_rxIndex++] : -1;
+}
+
+int flxSimWire::peek(void)
+{
+    return _rxIndex < _rxLength ? _rxBuffer[_rxIndex] : -1;
+}
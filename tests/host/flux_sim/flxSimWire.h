@@ -0,0 +1,214 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxSimWire.h
+ *
+ * A simulated I2C bus - a TwoWire object that routes transactions to register-map device models
+ * instead of hardware.
+ *
+ * The simulated bus is passed to flxBusI2C::begin() (or setWirePort()) in place of Wire. Device
+ * models are attached to the bus at an address, and the device auto-detection, driver and logger
+ * code paths then run against the models. This allows these paths to be run and benchmarked on a
+ * host (Linux) build - see tests/host.
+ *
+ * Supported cores:
+ *    The bus overrides the TwoWire transaction methods, so they must be virtual. They are in the host
+ *    shim (tests/host/shim/Wire.h) and in cores built on the ArduinoCore-API HardwareI2C interface,
+ *    such as arduino-pico (RP2040/RP2350). They aren't in the ESP32 core - flxBusI2C would call the
+ *    hardware methods - so the simulated bus doesn't work there, and isn't part of a device build.
+ *
+ * Timing:
+ *    Each transaction is charged the time to clock its bytes at the bus clock rate, plus the
+ *    device model latency and clock stretching. The time is accumulated in the bus statistics and,
+ *    unless disabled, passed to delayMicroseconds() - so micros() based measurements include it.
+ *
+ * Faults:
+ *    A device model can be set to NACK its address or to NACK a number of upcoming transactions.
+ */
+
+#pragma once
+
+#include "Arduino.h"
+#include <Wire.h>
+
+#include <vector>
+
+// Size of the transmit and receive buffers - matches a large Wire buffer
+#define kSimWireBufferSize 256
+
+//----------------------------------------------------------------------------------------------------
+// flxSimI2CDevice
+//
+// Base class for a device model. The default model is a 256 byte register file, with a register
+// pointer that is set by the first byte of a write and auto-increments on reads and writes.
+//
+class flxSimI2CDevice
+{
+  public:
+    flxSimI2CDevice(uint8_t address);
+    virtual ~flxSimI2CDevice()
+    {
+    }
+
+    uint8_t address(void)
+    {
+        return _address;
+    }
+
+    // Transaction handlers. onWrite() returns false to NACK the data. onRead() returns the number
+    // of bytes provided.
+    virtual bool onWrite(const uint8_t *data, size_t length);
+    virtual size_t onRead(uint8_t *data, size_t length);
+
+    // Register access - used by the default handlers and to setup a model
+    virtual uint8_t readRegister(uint8_t reg)
+    {
+        return _registers[reg];
+    }
+    virtual void writeRegister(uint8_t reg, uint8_t value)
+    {
+        _registers[reg] = value;
+    }
+    void setRegisters(uint8_t reg, const uint8_t *data, size_t length);
+
+    // Timing - the time spent in each transaction, and clock stretching per byte - in microseconds
+    void setLatency(uint32_t latency)
+    {
+        _latency = latency;
+    }
+    uint32_t latency(void)
+    {
+        return _latency;
+    }
+    void setClockStretch(uint32_t stretch)
+    {
+        _clockStretch = stretch;
+    }
+    uint32_t clockStretch(void)
+    {
+        return _clockStretch;
+    }
+
+    // Faults - NACK the address always, or for the next n transactions
+    void setOffline(bool bOffline)
+    {
+        _offline = bOffline;
+    }
+    void nackNext(uint16_t count)
+    {
+        _nackCount = count;
+    }
+
+    // Called by the bus at the start of a transaction - returns true if the address is ACKed
+    bool acknowledge(void);
+
+  protected:
+    uint8_t _address;
+    uint8_t _pointer;
+    uint8_t _registers[256];
+
+  private:
+    uint32_t _latency;
+    uint32_t _clockStretch;
+    bool _offline;
+    uint16_t _nackCount;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Bus statistics
+typedef struct
+{
+    uint32_t transactions; // number of write or read transactions
+    uint32_t bytes;        // data bytes moved
+    uint32_t nacks;        // address or data NACKs
+    uint64_t busTime;      // simulated time spent on the bus, in microseconds
+} flxSimWireStats_t;
+
+//----------------------------------------------------------------------------------------------------
+// flxSimWire
+//
+class flxSimWire : public TwoWire
+{
+  public:
+    flxSimWire();
+
+    // Device models - the bus doesn't own the models
+    bool addDevice(flxSimI2CDevice &theDevice);
+    void removeDevice(flxSimI2CDevice &theDevice);
+    flxSimI2CDevice *device(uint8_t address);
+
+    // simulated clock rate in Hz - used for the transfer time of each transaction
+    void setClock(uint32_t clock)
+    {
+        _clock = clock > 0 ? clock : 100000;
+    }
+    uint32_t clock(void)
+    {
+        return _clock;
+    }
+
+    // Delay for the simulated time of each transaction? If not, the time is only accumulated in
+    // the statistics.
+    void setRealTime(bool bRealTime)
+    {
+        _realTime = bRealTime;
+    }
+
+    void getStats(flxSimWireStats_t &stats)
+    {
+        stats = _stats;
+    }
+    void resetStats(void)
+    {
+        memset(&_stats, 0, sizeof(_stats));
+    }
+
+    // TwoWire/HardwareI2C interface
+    using Print::write;
+
+    void beginTransmission(uint8_t address);
+    uint8_t endTransmission(bool stopBit);
+    uint8_t endTransmission(void);
+
+    size_t requestFrom(uint8_t address, size_t length, bool stopBit);
+    size_t requestFrom(uint8_t address, size_t length);
+
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t length);
+
+    int available(void);
+    int read(void);
+    int peek(void);
+    void flush(void)
+    {
+    }
+
+  private:
+    // charge the time of a transaction to the bus
+    void transactionTime(flxSimI2CDevice *pDevice, size_t nBytes);
+
+    std::vector<flxSimI2CDevice *> _devices;
+
+    uint8_t _txAddress;
+    uint8_t _txBuffer[kSimWireBufferSize];
+    size_t _txLength;
+    bool _inTransmission;
+
+    uint8_t _rxBuffer[kSimWireBufferSize];
+    size_t _rxLength;
+    size_t _rxIndex;
+
+    uint32_t _clock;
+    bool _realTime;
+
+    flxSimWireStats_t _stats;
+};
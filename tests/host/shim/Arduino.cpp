@@ -0,0 +1,209 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * Arduino.cpp
+ *
+ * Host shim - implementation of Arduino.h, and the Wire and SPI objects.
+ */
+
+#include "Arduino.h"
+#include "SPI.h"
+#include "Wire.h"
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+
+//----------------------------------------------------------------------------------------------------
+// The simulated clock, in microseconds
+static uint64_t _hostMicros = 0;
+
+unsigned long millis(void)
+{
+    return (unsigned long)(_hostMicros / 1000);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)_hostMicros;
+}
+
+void delay(unsigned long ms)
+{
+    _hostMicros += (uint64_t)ms * 1000;
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    _hostMicros += us;
+}
+
+void yield(void)
+{
+}
+
+//----------------------------------------------------------------------------------------------------
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+}
+
+int digitalRead(uint8_t pin)
+{
+    return LOW;
+}
+
+int analogRead(uint8_t pin)
+{
+    return 0;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+}
+
+void detachInterrupt(uint8_t pin)
+{
+}
+
+int digitalPinToInterrupt(int pin)
+{
+    return pin;
+}
+
+void noInterrupts(void)
+{
+}
+
+void interrupts(void)
+{
+}
+
+//----------------------------------------------------------------------------------------------------
+void randomSeed(unsigned long seed)
+{
+    srandom(seed);
+}
+
+long random(long max)
+{
+    return max > 0 ? ::random() % max : 0;
+}
+
+long random(long min, long max)
+{
+    return max > min ? min + random(max - min) : min;
+}
+
+size_t strlcpy(char *dest, const char *src, size_t size)
+{
+    size_t len = strlen(src);
+    if (size > 0)
+    {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dest, src, n);
+        dest[n] = '\0';
+    }
+    return len;
+}
+
+size_t strlcat(char *dest, const char *src, size_t size)
+{
+    size_t len = strnlen(dest, size);
+    if (len == size)
+        return len + strlen(src);
+
+    return len + strlcpy(dest + len, src, size - len);
+}
+
+//----------------------------------------------------------------------------------------------------
+size_t Print::print(long value, int base)
+{
+    char szBuffer[72];
+    if (base == 10)
+        snprintf(szBuffer, sizeof(szBuffer), "%ld", value);
+    else if (base == 16)
+        snprintf(szBuffer, sizeof(szBuffer), "%lx", value);
+    else
+        return print((unsigned long)value, base);
+
+    return write(szBuffer);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    char szBuffer[72];
+    char *pDigit = szBuffer + sizeof(szBuffer) - 1;
+    *pDigit = '\0';
+
+    if (base < 2 || base > 16)
+        base = 10;
+    do
+    {
+        *--pDigit = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value > 0);
+
+    return write(pDigit);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char szBuffer[64];
+    snprintf(szBuffer, sizeof(szBuffer), "%.*f", digits, value);
+    return write(szBuffer);
+}
+
+int Print::printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    char *szBuffer = nullptr;
+    int len = vasprintf(&szBuffer, format, args);
+    va_end(args);
+
+    if (len < 0)
+        return 0;
+
+    write((const uint8_t *)szBuffer, len);
+    free(szBuffer);
+    return len;
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0)
+        buffer[n++] = (char)c;
+
+    return n;
+}
+
+//----------------------------------------------------------------------------------------------------
+size_t HardwareSerial::write(uint8_t c)
+{
+    return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush(void)
+{
+    fflush(stdout);
+}
@@ -0,0 +1,265 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * Arduino.h
+ *
+ * Host (Linux) shim for the parts of the Arduino API used by the framework code built in the host
+ * tests. It isn't a port - just enough for the stores, buses and simulated devices to run.
+ *
+ * Time is simulated: millis() and micros() return a clock that only moves when delay() or
+ * delayMicroseconds() is called, so tests that use the simulated buses are repeatable.
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+typedef unsigned int uint;
+typedef uint8_t byte;
+
+#define F(x) (x)
+#define PROGMEM
+#define IRAM_ATTR
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define RISING 1
+#define FALLING 2
+#define CHANGE 3
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+#define SPI_MODE3 3
+
+// newlib byte swaps, used by the framework
+#ifndef __bswap16
+#define __bswap16 __builtin_bswap16
+#define __bswap32 __builtin_bswap32
+#endif
+
+class __FlashStringHelper;
+
+//----------------------------------------------------------------------------------------------------
+// Time - a simulated clock
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield(void);
+
+//----------------------------------------------------------------------------------------------------
+// Pins and interrupts - no hardware, these do nothing
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+int digitalPinToInterrupt(int pin);
+void noInterrupts(void);
+void interrupts(void);
+
+//----------------------------------------------------------------------------------------------------
+void randomSeed(unsigned long seed);
+long random(long max);
+long random(long min, long max);
+
+size_t strlcpy(char *dest, const char *src, size_t size);
+size_t strlcat(char *dest, const char *src, size_t size);
+
+//----------------------------------------------------------------------------------------------------
+// String - backed by std::string
+class String
+{
+  public:
+    String()
+    {
+    }
+    String(const char *str) : _str{str ? str : ""}
+    {
+    }
+    String(const std::string &str) : _str{str}
+    {
+    }
+    String(int value) : _str{std::to_string(value)}
+    {
+    }
+    String(unsigned int value) : _str{std::to_string(value)}
+    {
+    }
+    const char *c_str(void) const
+    {
+        return _str.c_str();
+    }
+    size_t length(void) const
+    {
+        return _str.length();
+    }
+    String &operator+=(const String &rhs)
+    {
+        _str += rhs._str;
+        return *this;
+    }
+    String &operator+=(const char *rhs)
+    {
+        _str += rhs;
+        return *this;
+    }
+    String &operator+=(char rhs)
+    {
+        _str += rhs;
+        return *this;
+    }
+    bool operator==(const String &rhs) const
+    {
+        return _str == rhs._str;
+    }
+    bool operator==(const char *rhs) const
+    {
+        return _str == (rhs ? rhs : "");
+    }
+
+  private:
+    std::string _str;
+};
+
+inline String operator+(const String &lhs, const String &rhs)
+{
+    String out = lhs;
+    out += rhs;
+    return out;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Print, Stream and Serial - Serial writes to stdout
+class Print
+{
+  public:
+    virtual ~Print()
+    {
+    }
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+        size_t n = 0;
+        while (n < size && write(buffer[n]))
+            n++;
+        return n;
+    }
+    size_t write(const char *str)
+    {
+        return str ? write((const uint8_t *)str, strlen(str)) : 0;
+    }
+    size_t write(const char *buffer, size_t size)
+    {
+        return write((const uint8_t *)buffer, size);
+    }
+    virtual void flush(void)
+    {
+    }
+
+    size_t print(const char *str)
+    {
+        return write(str);
+    }
+    size_t print(const String &str)
+    {
+        return write(str.c_str());
+    }
+    size_t print(char c)
+    {
+        return write((uint8_t)c);
+    }
+    size_t print(long value, int base = 10);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(int value, int base = 10)
+    {
+        return print((long)value, base);
+    }
+    size_t print(unsigned int value, int base = 10)
+    {
+        return print((unsigned long)value, base);
+    }
+    size_t print(double value, int digits = 2);
+
+    template <typename T> size_t println(T value)
+    {
+        return print(value) + println();
+    }
+    size_t println(void)
+    {
+        return write("\r\n");
+    }
+
+    int printf(const char *format, ...);
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available(void) = 0;
+    virtual int read(void) = 0;
+    virtual int peek(void) = 0;
+
+    size_t readBytes(char *buffer, size_t length);
+};
+
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long)
+    {
+    }
+    operator bool()
+    {
+        return true;
+    }
+    using Print::write;
+    size_t write(uint8_t c);
+    size_t write(const uint8_t *buffer, size_t size);
+
+    int available(void)
+    {
+        return 0;
+    }
+    int read(void)
+    {
+        return -1;
+    }
+    int peek(void)
+    {
+        return -1;
+    }
+    void flush(void);
+};
+
+extern HardwareSerial Serial;
+
+namespace arduino
+{
+using ::__FlashStringHelper;
+using ::Print;
+using ::Stream;
+using ::String;
+} // namespace arduino
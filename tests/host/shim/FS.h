@@ -0,0 +1,40 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * FS.h
+ *
+ * Host shim - the Arduino file system types used by the flxIFile and flxIFileSystem interfaces. There is
+ * no file system; tests implement flxIFile and flxIFileSystem in RAM.
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+namespace fs
+{
+class File
+{
+  public:
+    operator bool() const
+    {
+        return false;
+    }
+};
+
+class FS
+{
+};
+} // namespace fs
+
+using fs::File;
+using fs::FS;
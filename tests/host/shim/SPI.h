@@ -0,0 +1,58 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * SPI.h
+ *
+ * Host shim - SPIClass transfers do nothing. Tests use flxSimBusSPI in place of the SPI bus.
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+class SPISettings
+{
+  public:
+    SPISettings()
+    {
+    }
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+    {
+    }
+};
+
+class SPIClass
+{
+  public:
+    void begin(void)
+    {
+    }
+    void end(void)
+    {
+    }
+    void beginTransaction(SPISettings settings)
+    {
+    }
+    void endTransaction(void)
+    {
+    }
+    uint8_t transfer(uint8_t data)
+    {
+        return 0xFF;
+    }
+    void transfer(void *buffer, size_t length)
+    {
+        memset(buffer, 0xFF, length);
+    }
+};
+
+extern SPIClass SPI;
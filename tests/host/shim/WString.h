@@ -0,0 +1,20 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * WString.h
+ *
+ * Host shim - String is defined in Arduino.h
+ */
+
+#pragma once
+
+#include "Arduino.h"
@@ -0,0 +1,86 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * Wire.h
+ *
+ * Host shim - a TwoWire modeled on the ArduinoCore-API HardwareI2C interface, where the bus methods are
+ * virtual. The default object has no devices - every address NACKs. Tests pass a flxSimWire to the bus
+ * instead.
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+class TwoWire : public Stream
+{
+  public:
+    virtual bool begin(void)
+    {
+        return true;
+    }
+    virtual void end(void)
+    {
+    }
+    virtual void setClock(uint32_t clock)
+    {
+    }
+
+    virtual void beginTransmission(uint8_t address)
+    {
+    }
+    virtual uint8_t endTransmission(bool stopBit)
+    {
+        return 2; // address NACK
+    }
+    virtual uint8_t endTransmission(void)
+    {
+        return endTransmission(true);
+    }
+
+    virtual size_t requestFrom(uint8_t address, size_t length, bool stopBit)
+    {
+        return 0;
+    }
+    virtual size_t requestFrom(uint8_t address, size_t length)
+    {
+        return requestFrom(address, length, true);
+    }
+
+    using Print::write;
+    virtual size_t write(uint8_t data)
+    {
+        return 0;
+    }
+    virtual size_t write(const uint8_t *data, size_t length)
+    {
+        return 0;
+    }
+
+    virtual int available(void)
+    {
+        return 0;
+    }
+    virtual int read(void)
+    {
+        return -1;
+    }
+    virtual int peek(void)
+    {
+        return -1;
+    }
+    virtual void flush(void)
+    {
+    }
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,44 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+#include "flxPlatform.h"
+
+#include <stdlib.h>
+
+// host version of our platform class - a fixed device ID, and no restart or heap limits
+
+//---------------------------------------------------------------------------------
+/// @brief Return a unique identifier for the device - a 12 char hex string
+/// @return const char* - the unique identifier
+///
+const char *flxPlatform::unique_id(void)
+{
+    return "0123456789AB";
+}
+
+//---------------------------------------------------------------------------------
+/// @brief Restart the device - a host test can't restart, so it exits
+///
+void flxPlatform::restart_device(void)
+{
+    exit(1);
+}
+
+// memory things
+uint32_t flxPlatform::heap_size(void)
+{
+    return 0;
+}
+
+// free heap
+uint32_t flxPlatform::heap_free(void)
+{
+    return 0;
+}
@@ -0,0 +1,51 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * mbedtls/aes.h
+ *
+ * Host shim - there's no AES on the host build. The calls fail, so encrypted values can't be used in tests.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#define MBEDTLS_AES_ENCRYPT 1
+#define MBEDTLS_AES_DECRYPT 0
+
+// returned by the shim for every call
+#define MBEDTLS_ERR_AES_HOST_UNSUPPORTED -0x0070
+
+typedef struct
+{
+    int unused;
+} mbedtls_aes_context;
+
+inline void mbedtls_aes_init(mbedtls_aes_context *ctx)
+{
+}
+inline void mbedtls_aes_free(mbedtls_aes_context *ctx)
+{
+}
+inline int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+{
+    return MBEDTLS_ERR_AES_HOST_UNSUPPORTED;
+}
+inline int mbedtls_aes_setkey_dec(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits)
+{
+    return MBEDTLS_ERR_AES_HOST_UNSUPPORTED;
+}
+inline int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx, int mode, size_t length, unsigned char *iv,
+                                 const unsigned char *input, unsigned char *output)
+{
+    return MBEDTLS_ERR_AES_HOST_UNSUPPORTED;
+}
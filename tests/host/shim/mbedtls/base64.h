@@ -0,0 +1,33 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * mbedtls/base64.h
+ *
+ * Host shim - there's no base64 on the host build. The calls fail.
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+#define MBEDTLS_ERR_BASE64_INVALID_CHARACTER -0x002C
+
+inline int mbedtls_base64_encode(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen)
+{
+    *olen = 0;
+    return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+}
+inline int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen, const unsigned char *src, size_t slen)
+{
+    *olen = 0;
+    return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+}
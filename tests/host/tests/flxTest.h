@@ -0,0 +1,38 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxTest.h
+ *
+ * Checks for the host tests. A failed check prints the expression and location, and the test exits with an
+ * error when done - see flxTestResult().
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+extern int flxTestFailures;
+
+#define flxTestCheck(__expr__)                                                                                         \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(__expr__))                                                                                               \
+        {                                                                                                              \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #__expr__);                                                 \
+            flxTestFailures++;                                                                                         \
+        }                                                                                                              \
+    } while (0)
+
+// The exit code of a test - the number of failed checks
+#define flxTestResult() (flxTestFailures > 0 ? 1 : 0)
+
+#define flxTestDefine() int flxTestFailures = 0
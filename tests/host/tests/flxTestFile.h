@@ -0,0 +1,203 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * flxTestFile.h
+ *
+ * A file held in RAM, for the host tests - a flxIFile on a std::string. Reads can be limited to a number of
+ * bytes per call, and the file to a size, so short reads and a full disk can be tested.
+ *
+ * flxTestFileSystem is a flat file system of these files - a flxIFileSystem for code that opens files by name.
+ */
+
+#pragma once
+
+#include "flxFS.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+
+class flxTestFile : public flxIFile
+{
+  public:
+    flxTestFile(const std::string &data = "") : data{data}, readLimit{0}, sizeLimit{SIZE_MAX}, _position{0}
+    {
+    }
+
+    // an open framework file for this file object
+    static flxFSFile open(std::shared_ptr<flxTestFile> theFile)
+    {
+        flxFSFile fsFile;
+        fsFile.setIFile(theFile);
+        return fsFile;
+    }
+
+    size_t write(const uint8_t *buf, size_t size)
+    {
+        if (data.size() + size > sizeLimit)
+            return 0;
+
+        data.append((const char *)buf, size);
+        return size;
+    }
+
+    size_t read(uint8_t *buf, size_t size)
+    {
+        size_t nRead = std::min(size, data.size() - _position);
+        if (readLimit > 0)
+            nRead = std::min(nRead, readLimit);
+
+        memcpy(buf, data.data() + _position, nRead);
+        _position += nRead;
+
+        return nRead;
+    }
+
+    void close(void)
+    {
+    }
+    bool isValid(void)
+    {
+        return true;
+    }
+    void flush(void)
+    {
+    }
+    size_t size(void)
+    {
+        return data.size();
+    }
+    const char *name(void)
+    {
+        return "test";
+    }
+    bool isDirectory(void)
+    {
+        return false;
+    }
+    std::string getNextFilename(void)
+    {
+        return "";
+    }
+    int available(void)
+    {
+        return data.size() - _position;
+    }
+    Stream *stream(void)
+    {
+        return nullptr;
+    }
+    flxFSFile openNextFile(void)
+    {
+        return flxFSFile();
+    }
+    time_t getLastWrite(void)
+    {
+        return 0;
+    }
+    File filePointer(void)
+    {
+        return File();
+    }
+
+    std::string data;
+
+    // bytes returned per read - 0 for no limit
+    size_t readLimit;
+
+    // the size writes can grow the file to
+    size_t sizeLimit;
+
+  private:
+    size_t _position;
+};
+
+//----------------------------------------------------------------------------------------------------
+class flxTestFileSystem : public flxIFileSystem
+{
+  public:
+    flxTestFileSystem() : writeOpens{0}
+    {
+    }
+
+    // A file opened for reading is a copy, with its own position. Opened for writing, a new empty file replaces
+    // the old one.
+    flxFSFile open(const char *name, flxFileOpenMode_t mode, bool create = false)
+    {
+        auto it = files.find(name);
+
+        if (mode == kFileRead)
+            return it == files.end() ? flxFSFile() : flxTestFile::open(std::make_shared<flxTestFile>(it->second->data));
+
+        if (it == files.end() && !create)
+            return flxFSFile();
+
+        writeOpens++;
+
+        if (mode == kFileWrite || it == files.end())
+            files[name] = std::make_shared<flxTestFile>();
+
+        return flxTestFile::open(files[name]);
+    }
+
+    bool exists(const char *name)
+    {
+        return files.find(name) != files.end();
+    }
+
+    bool remove(const char *name)
+    {
+        return files.erase(name) > 0;
+    }
+
+    bool rename(const char *nameFrom, const char *nameTo)
+    {
+        auto it = files.find(nameFrom);
+        if (it == files.end())
+            return false;
+
+        files[nameTo] = it->second;
+        files.erase(nameFrom);
+        return true;
+    }
+
+    bool mkdir(const char *path)
+    {
+        return true;
+    }
+    bool rmdir(const char *path)
+    {
+        return true;
+    }
+    uint64_t size(void)
+    {
+        return 0;
+    }
+    const char *type(void)
+    {
+        return "test";
+    }
+    bool enabled(void)
+    {
+        return true;
+    }
+    FS fileSystem(void)
+    {
+        return FS();
+    }
+
+    std::map<std::string, std::shared_ptr<flxTestFile>> files;
+
+    // the number of opens for writing or appending
+    uint32_t writeOpens;
+};
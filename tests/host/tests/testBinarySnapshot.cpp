@@ -0,0 +1,242 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testBinarySnapshot.cpp
+ *
+ * Tests of the binary snapshot settings storage, on a RAM file system - values of each type saved and
+ * restored, a save of some values merged with the values already in the snapshot, a save of unchanged values
+ * that doesn't write the file, and snapshot files that are corrupt or truncated, which must not load.
+ */
+
+#include "flxStorageBinaryPref.h"
+#include "flxTest.h"
+#include "flxTestFile.h"
+
+#include <string>
+
+flxTestDefine();
+
+#define kTestFilename "/settings.bin"
+
+static const uint8_t testBytes[] = {0, 1, 2, 0xFE, 0xFF, 0};
+
+// as in an application, the storage is a global - its name isn't freed
+static flxTestFileSystem fileSystem;
+static flxStorageBinaryPref snapshot;
+
+//----------------------------------------------------------------------------------------------------
+static void writeSettings(int32_t interval, const char *szName)
+{
+    flxTestCheck(snapshot.begin());
+
+    flxStorageBlock *pBlock = snapshot.beginBlock("device");
+    flxTestCheck(pBlock != nullptr);
+    flxTestCheck(pBlock->writeBool("enabled", true));
+    flxTestCheck(pBlock->writeInt8("trim", -3));
+    flxTestCheck(pBlock->writeInt16("offset", -300));
+    flxTestCheck(pBlock->writeInt32("interval", interval));
+    flxTestCheck(pBlock->writeUInt8("mode", 200));
+    flxTestCheck(pBlock->writeUInt16("rate", 60000));
+    flxTestCheck(pBlock->writeUInt32("serial", 4000000000u));
+    flxTestCheck(pBlock->writeFloat("scale", 1.25));
+    flxTestCheck(pBlock->writeDouble("gain", -0.001));
+    snapshot.endBlock(pBlock);
+
+    pBlock = snapshot.beginBlock("network");
+    flxTestCheck(pBlock != nullptr);
+    flxTestCheck(pBlock->writeString("name", szName));
+    flxTestCheck(pBlock->writeBytes("key", testBytes, sizeof(testBytes)));
+    snapshot.endBlock(pBlock);
+
+    snapshot.end();
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool checkSettings(int32_t interval, const char *szName)
+{
+    if (!snapshot.begin(true))
+        return false;
+
+    bool status = true;
+
+    flxStorageBlock *pBlock = snapshot.beginBlock("device");
+    if (pBlock)
+    {
+        bool vBool = false;
+        int8_t vInt8 = 0;
+        int16_t vInt16 = 0;
+        int32_t vInt32 = 0;
+        uint8_t vUInt8 = 0;
+        uint16_t vUInt16 = 0;
+        uint32_t vUInt32 = 0;
+        float vFloat = 0;
+        double vDouble = 0;
+
+        status = pBlock->readBool("enabled", vBool) && vBool;
+        status = status && pBlock->readInt8("trim", vInt8) && vInt8 == -3;
+        status = status && pBlock->readInt16("offset", vInt16) && vInt16 == -300;
+        status = status && pBlock->readInt32("interval", vInt32) && vInt32 == interval;
+        status = status && pBlock->readUInt8("mode", vUInt8) && vUInt8 == 200;
+        status = status && pBlock->readUInt16("rate", vUInt16) && vUInt16 == 60000;
+        status = status && pBlock->readUInt32("serial", vUInt32) && vUInt32 == 4000000000u;
+        status = status && pBlock->readFloat("scale", vFloat) && vFloat == 1.25;
+        status = status && pBlock->readDouble("gain", vDouble) && vDouble == -0.001;
+        snapshot.endBlock(pBlock);
+    }
+    else
+        status = false;
+
+    pBlock = snapshot.beginBlock("network");
+    if (pBlock)
+    {
+        char szBuffer[64] = {0};
+        uint8_t bytes[sizeof(testBytes)] = {0};
+
+        status = status && pBlock->readString("name", szBuffer, sizeof(szBuffer)) == strlen(szName) &&
+                 strcmp(szBuffer, szName) == 0;
+        status = status && pBlock->readBytes("key", bytes, sizeof(bytes)) == sizeof(testBytes) &&
+                 memcmp(bytes, testBytes, sizeof(testBytes)) == 0;
+        snapshot.endBlock(pBlock);
+    }
+    else
+        status = false;
+
+    snapshot.end();
+    return status;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The number of values loaded from the snapshot
+static int loadedValues(void)
+{
+    if (!snapshot.begin(true))
+        return -1;
+
+    flxStorageBinaryPref::binaryEntry_t theEntry;
+    uint16_t iBlock = 0;
+    uint16_t iValue = 0;
+    int nValues = 0;
+
+    for (; snapshot.nextValue(iBlock, iValue, theEntry); iValue++)
+        nValues++;
+
+    snapshot.end();
+    return nValues;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void testRoundTrip(void)
+{
+    writeSettings(15000, "thing one");
+
+    flxTestCheck(fileSystem.exists(kTestFilename));
+    flxTestCheck(!fileSystem.exists(kTestFilename ".tmp"));
+    flxTestCheck(checkSettings(15000, "thing one"));
+    flxTestCheck(loadedValues() == 11);
+}
+
+//----------------------------------------------------------------------------------------------------
+// A save of one block keeps the values of the other blocks, and a changed string is resized
+static void testMerge(void)
+{
+    flxTestCheck(snapshot.begin());
+
+    flxStorageBlock *pBlock = snapshot.beginBlock("network");
+    flxTestCheck(pBlock != nullptr);
+    flxTestCheck(pBlock->writeString("name", "a longer name than before"));
+    flxTestCheck(pBlock->writeUInt16("port", 8080));
+    snapshot.endBlock(pBlock);
+
+    snapshot.end();
+
+    flxTestCheck(checkSettings(15000, "a longer name than before"));
+    flxTestCheck(loadedValues() == 12);
+
+    // and a value update in the other block
+    writeSettings(-1, "a longer name than before");
+    flxTestCheck(checkSettings(-1, "a longer name than before"));
+    flxTestCheck(loadedValues() == 12);
+}
+
+//----------------------------------------------------------------------------------------------------
+// A save that doesn't change a value doesn't write the file
+static void testUnchanged(void)
+{
+    std::string before = fileSystem.files[kTestFilename]->data;
+    uint32_t writeOpens = fileSystem.writeOpens;
+
+    writeSettings(-1, "a longer name than before");
+
+    flxTestCheck(fileSystem.writeOpens == writeOpens);
+    flxTestCheck(fileSystem.files[kTestFilename]->data == before);
+
+    // a change does
+    writeSettings(2, "a longer name than before");
+    flxTestCheck(fileSystem.writeOpens == writeOpens + 1);
+}
+
+//----------------------------------------------------------------------------------------------------
+// A bit flipped in any byte of the file - nothing is loaded
+static void testCorrupt(void)
+{
+    std::string good = fileSystem.files[kTestFilename]->data;
+    int nLoaded = 0;
+
+    for (size_t i = 0; i < good.size(); i++)
+    {
+        fileSystem.files[kTestFilename]->data = good;
+        fileSystem.files[kTestFilename]->data[i] ^= 1 << (i % 8);
+
+        if (loadedValues() != 0)
+            nLoaded++;
+    }
+    flxTestCheck(nLoaded == 0);
+
+    fileSystem.files[kTestFilename]->data = good;
+    flxTestCheck(loadedValues() == 12);
+}
+
+//----------------------------------------------------------------------------------------------------
+// The file cut short at any length - nothing is loaded
+static void testTruncated(void)
+{
+    std::string good = fileSystem.files[kTestFilename]->data;
+    int nLoaded = 0;
+
+    for (size_t length = 0; length < good.size(); length++)
+    {
+        fileSystem.files[kTestFilename]->data = good.substr(0, length);
+
+        if (loadedValues() != 0)
+            nLoaded++;
+    }
+    flxTestCheck(nLoaded == 0);
+
+    // the next save replaces the bad file
+    writeSettings(3, "thing two");
+    flxTestCheck(checkSettings(3, "thing two"));
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    snapshot.setFileSystem(&fileSystem);
+    snapshot.setFilename(kTestFilename);
+
+    testRoundTrip();
+    testMerge();
+    testUnchanged();
+    testCorrupt();
+    testTruncated();
+
+    return flxTestResult();
+}
@@ -0,0 +1,209 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testBusDetect.cpp
+ *
+ * Device auto-detection on two I2C buses. Each bus is a simulated bus with its own device models - the same
+ * address is used on both. The devices must be found on each bus and tagged with the ID of their bus.
+ *
+ * The devices on the second bus are then run by a bus worker - their execute() methods read the bus they are
+ * on, and the other bus isn't touched.
+ */
+
+#include "flxBusWorker.h"
+#include "flxDevice.h"
+#include "flxFlux.h"
+#include "flxSimDevices.h"
+#include "flxTest.h"
+
+flxTestDefine();
+
+//----------------------------------------------------------------------------------------------------
+// Minimal drivers for the simulated devices - detection by chip ID, and an execute() that reads the data
+// registers
+class testDevBME280 : public flxDeviceI2CType<testDevBME280>
+{
+  public:
+    testDevBME280() : executed{0}
+    {
+        spSetupDeviceIdent(getDeviceName());
+    }
+
+    static bool isConnected(flxBusI2C &i2cDriver, uint8_t address)
+    {
+        return i2cDriver.ping(address) && i2cDriver.readRegister(address, 0xD0) == 0x60;
+    }
+    static flxDeviceConfidence_t connectedConfidence(void)
+    {
+        return flxDevConfidenceExact;
+    }
+    static const char *getDeviceName()
+    {
+        return "BME280";
+    };
+    static const uint8_t *getDefaultAddresses()
+    {
+        return defaultDeviceAddress;
+    }
+    static uint8_t defaultDeviceAddress[];
+
+    bool onInitialize(TwoWire &wirePort)
+    {
+        _i2cBus.setWirePort(wirePort);
+        return true;
+    }
+
+    bool execute(void)
+    {
+        executed++;
+        return _i2cBus.readRegisterRegion(address(), 0xF7, _data, sizeof(_data));
+    }
+
+    int executed;
+
+  private:
+    flxBusI2C _i2cBus;
+    uint8_t _data[8];
+};
+uint8_t testDevBME280::defaultDeviceAddress[] = {0x77, 0x76, kSparkDeviceAddressNull};
+flxRegisterDevice(testDevBME280);
+
+class testDevAMG8833 : public flxDeviceI2CType<testDevAMG8833>
+{
+  public:
+    testDevAMG8833() : executed{0}
+    {
+        spSetupDeviceIdent(getDeviceName());
+    }
+
+    static bool isConnected(flxBusI2C &i2cDriver, uint8_t address)
+    {
+        // the thermistor - 25 C
+        uint16_t value = 0;
+        return i2cDriver.ping(address) && i2cDriver.readRegister16(address, 0x0E, &value, true) && value == 400;
+    }
+    static flxDeviceConfidence_t connectedConfidence(void)
+    {
+        return flxDevConfidenceFuzzy;
+    }
+    static const char *getDeviceName()
+    {
+        return "AMG8833";
+    };
+    static const uint8_t *getDefaultAddresses()
+    {
+        return defaultDeviceAddress;
+    }
+    static uint8_t defaultDeviceAddress[];
+
+    bool onInitialize(TwoWire &wirePort)
+    {
+        _i2cBus.setWirePort(wirePort);
+        return true;
+    }
+
+    bool execute(void)
+    {
+        executed++;
+        return _i2cBus.readRegisterBurst(address(), 0x80, _pixels, sizeof(_pixels));
+    }
+
+    int executed;
+
+  private:
+    flxBusI2C _i2cBus;
+    uint8_t _pixels[128];
+};
+uint8_t testDevAMG8833::defaultDeviceAddress[] = {0x69, 0x68, kSparkDeviceAddressNull};
+flxRegisterDevice(testDevAMG8833);
+
+// as in an application, the built devices live for the life of the program - they're kept here once the
+// framework object is gone at exit
+flxDevice *theDevices[8];
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    flxSimWire sim0, sim1;
+    flxSimBME280 bme0, bme1;
+    flxSimAMG8833 amg1;
+
+    flxTestCheck(sim0.addDevice(bme0));
+    flxTestCheck(sim1.addDevice(bme1));
+    flxTestCheck(sim1.addDevice(amg1));
+
+    flxBusI2C bus0, bus1;
+    bus0.begin(sim0);
+    bus1.begin(sim1);
+
+    flxTestCheck(flux.addI2CBus(bus1));
+    flxTestCheck(!flux.addI2CBus(bus1));
+    flxTestCheck(bus1.busID() == 1);
+    flxTestCheck(flux.i2cBusCount() == 2 && flux.i2cBus(1) == &bus1);
+
+    std::vector<flxBusI2C *> theBuses = {&bus0, &bus1};
+    flxTestCheck(flxDeviceFactory::get().buildDevices(theBuses) == 3);
+
+    // the same address on both buses, and a device only on the second bus
+    testDevBME280 *pBME[2] = {nullptr, nullptr};
+    testDevAMG8833 *pAMG = nullptr;
+    int nDevices = 0;
+
+    for (auto device : flux.connectedDevices())
+    {
+        if (nDevices < sizeof(theDevices) / sizeof(theDevices[0]))
+            theDevices[nDevices] = device;
+        nDevices++;
+        // the address is added to the device name
+        if (strncmp(device->name(), "BME280", 6) == 0 && device->address() == 0x77 && device->busID() < 2)
+            pBME[device->busID()] = (testDevBME280 *)device;
+        else if (strncmp(device->name(), "AMG8833", 7) == 0 && device->address() == 0x69)
+            pAMG = (testDevAMG8833 *)device;
+    }
+    flxTestCheck(nDevices == 3);
+    flxTestCheck(pBME[0] != nullptr && pBME[1] != nullptr && pBME[0] != pBME[1]);
+    flxTestCheck(pAMG != nullptr && pAMG->busID() == 1);
+
+    if (!pBME[0] || !pBME[1] || !pAMG)
+        return flxTestResult();
+
+    // a worker for the second bus - its devices run on it, and only that bus is read
+    flxBusWorker worker;
+    flxTestCheck(worker.begin(1));
+
+    for (auto device : flux.connectedDevices())
+    {
+        if (device->busID() == worker.busID())
+            worker.add(device);
+    }
+    flxTestCheck(worker.contains(pBME[1]) && worker.contains(pAMG) && !worker.contains(pBME[0]));
+
+    flxSimWireStats_t stats0, stats1;
+    sim0.resetStats();
+    sim1.resetStats();
+
+    worker.dispatch();
+    worker.wait();
+
+    sim0.getStats(stats0);
+    sim1.getStats(stats1);
+
+    flxTestCheck(pBME[1]->executed == 1 && pAMG->executed == 1 && pBME[0]->executed == 0);
+    flxTestCheck(stats0.transactions == 0 && stats1.transactions > 0);
+    flxTestCheck(worker.lastRunTime() > 0);
+
+    // the list is cleared once the worker is done
+    flxTestCheck(!worker.contains(pAMG));
+    worker.end();
+
+    return flxTestResult();
+}
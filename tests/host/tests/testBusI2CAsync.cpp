@@ -0,0 +1,257 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testBusI2CAsync.cpp
+ *
+ * The queued I2C transactions on the simulated bus - submit, poll, completion callbacks, cancel, a full
+ * queue, failed transactions and end().
+ *
+ * Then a loop availability benchmark - 10 devices, some slow or clock stretching, read each loop pass. Read
+ * with blocking calls, a loop pass is held for all 10 reads. Queued, the job queue runs one transaction per
+ * dispatch, so the longest loop pass is the slowest single transaction. The longest pass of each is printed.
+ */
+
+#include "flxBusI2C.h"
+#include "flxBusI2CAsync.h"
+#include "flxSimDevices.h"
+#include "flxTest.h"
+
+#include <algorithm>
+#include <vector>
+
+flxTestDefine();
+
+#define kTestDevices 10
+#define kTestPasses 20
+
+//----------------------------------------------------------------------------------------------------
+// Run the job queue until the queue has no pending transactions - returns the number of loop passes
+static int runQueue(flxBusI2CAsync &async, int maxPasses = 1000)
+{
+    int nPasses = 0;
+
+    for (; async.pending() > 0 && nPasses < maxPasses; nPasses++)
+    {
+        delay(1);
+        flxJobQueue.loop();
+    }
+    return nPasses;
+}
+
+//----------------------------------------------------------------------------------------------------
+class testCallback
+{
+  public:
+    testCallback() : count{0}
+    {
+    }
+    void onComplete(flxI2CTransaction &txn)
+    {
+        count++;
+        last = &txn;
+    }
+    int count;
+    flxI2CTransaction *last;
+};
+
+//----------------------------------------------------------------------------------------------------
+static void testQueue(flxBusI2C &bus, flxSimBME280 &bme)
+{
+    flxBusI2CAsync async;
+    flxTestCheck(async.begin(bus, 4));
+
+    testCallback callback;
+
+    // a register read - pending until the job queue runs it
+    uint8_t chipID = 0;
+    flxI2CTransaction txnID;
+    txnID.setReadRegister(0x77, 0xD0, &chipID, 1);
+    txnID.setCallback(&callback, &testCallback::onComplete);
+
+    flxTestCheck(async.submit(txnID));
+    flxTestCheck(async.poll(txnID) == flxI2CTxnPending);
+    flxTestCheck(!async.submit(txnID));
+    flxTestCheck(async.pending() == 1);
+
+    flxTestCheck(runQueue(async) > 0);
+    flxTestCheck(async.poll(txnID) == flxI2CTxnDone);
+    flxTestCheck(chipID == 0x60);
+    flxTestCheck(callback.count == 1 && callback.last == &txnID);
+
+    // a register write, and a raw write then read
+    uint8_t ctrl = 0x27;
+    flxI2CTransaction txnWrite;
+    txnWrite.setWriteRegister(0x77, 0xF4, &ctrl, 1);
+
+    uint8_t reg = 0xF4;
+    uint8_t value = 0;
+    flxI2CTransaction txnRaw;
+    txnRaw.setTransfer(0x77, &reg, 1, &value, 1);
+
+    flxTestCheck(async.submit(txnWrite));
+    flxTestCheck(async.submit(txnRaw));
+    runQueue(async);
+    flxTestCheck(async.poll(txnWrite) == flxI2CTxnDone);
+    flxTestCheck(async.poll(txnRaw) == flxI2CTxnDone);
+    flxTestCheck(value == 0x27);
+
+    // cancel - the canceled transaction is idle and its callback isn't called
+    flxI2CTransaction txns[4];
+    uint8_t data[4][8];
+    for (int i = 0; i < 4; i++)
+    {
+        txns[i].setReadRegister(0x77, 0xF7, data[i], sizeof(data[i]));
+        txns[i].setCallback(&callback, &testCallback::onComplete);
+        flxTestCheck(async.submit(txns[i]));
+    }
+    // full
+    flxTestCheck(!async.submit(txnID));
+
+    flxTestCheck(async.cancel(txns[1]));
+    flxTestCheck(!async.cancel(txns[1]));
+    flxTestCheck(async.poll(txns[1]) == flxI2CTxnIdle);
+    flxTestCheck(async.pending() == 3);
+
+    callback.count = 0;
+    runQueue(async);
+    flxTestCheck(callback.count == 3);
+    flxTestCheck(async.poll(txns[0]) == flxI2CTxnDone && async.poll(txns[2]) == flxI2CTxnDone &&
+                 async.poll(txns[3]) == flxI2CTxnDone);
+    flxTestCheck(async.poll(txns[1]) == flxI2CTxnIdle);
+
+    // a device that doesn't answer, and a register write larger than a transfer
+    bme.setOffline(true);
+    flxTestCheck(async.submit(txnID));
+    runQueue(async);
+    flxTestCheck(async.poll(txnID) == flxI2CTxnError);
+    bme.setOffline(false);
+
+    uint8_t big[kSimWireBufferSize] = {0};
+    txnWrite.setWriteRegister(0x77, 0x00, big, bus.maxTransferSize());
+    flxTestCheck(async.submit(txnWrite));
+    runQueue(async);
+    flxTestCheck(async.poll(txnWrite) == flxI2CTxnError);
+
+    // end - transactions that haven't run fail, without a callback
+    callback.count = 0;
+    flxTestCheck(async.submit(txns[0]));
+    flxTestCheck(async.submit(txns[1]));
+    async.end();
+    flxTestCheck(async.poll(txns[0]) == flxI2CTxnError && async.poll(txns[1]) == flxI2CTxnError);
+    flxTestCheck(callback.count == 0);
+    flxTestCheck(!async.submit(txns[0]));
+}
+
+//----------------------------------------------------------------------------------------------------
+static void testLoopAvailability(void)
+{
+    flxSimWire sim;
+    flxBusI2C bus;
+
+    std::vector<flxSimI2CDevice *> devices;
+    for (int i = 0; i < kTestDevices; i++)
+    {
+        flxSimI2CDevice *pDevice = new flxSimI2CDevice(0x10 + i);
+
+        // every third device is slow - a conversion wait or clock stretching
+        if (i % 3 == 0)
+            pDevice->setLatency(2000);
+        if (i % 3 == 1)
+            pDevice->setClockStretch(50);
+
+        sim.addDevice(*pDevice);
+        devices.push_back(pDevice);
+    }
+    bus.begin(sim);
+
+    uint8_t data[kTestDevices][16];
+
+    // blocking - each loop pass reads every device
+    unsigned long maxBlocking = 0;
+    for (int iPass = 0; iPass < kTestPasses; iPass++)
+    {
+        unsigned long start = micros();
+        for (int i = 0; i < kTestDevices; i++)
+            bus.readRegisterRegion(0x10 + i, 0, data[i], sizeof(data[i]));
+
+        maxBlocking = std::max(maxBlocking, micros() - start);
+        delay(1);
+    }
+
+    // queued - each loop pass runs the job queue
+    flxBusI2CAsync async;
+    flxTestCheck(async.begin(bus, kTestDevices));
+
+    flxI2CTransaction txns[kTestDevices];
+    unsigned long maxQueued = 0;
+    unsigned long maxTransaction = 0;
+    int nLoops = 0;
+    int nDone = 0;
+
+    for (int iPass = 0; iPass < kTestPasses; iPass++)
+    {
+        for (int i = 0; i < kTestDevices; i++)
+        {
+            txns[i].setReadRegister(0x10 + i, 0, data[i], sizeof(data[i]));
+            async.submit(txns[i]);
+        }
+
+        while (async.pending() > 0)
+        {
+            unsigned long start = micros();
+            flxJobQueue.loop();
+            maxQueued = std::max(maxQueued, micros() - start);
+            nLoops++;
+
+            delayMicroseconds(100);
+        }
+        for (int i = 0; i < kTestDevices; i++)
+            nDone += async.poll(txns[i]) == flxI2CTxnDone ? 1 : 0;
+    }
+    async.end();
+
+    // the slowest single transaction
+    for (int i = 0; i < kTestDevices; i++)
+    {
+        unsigned long start = micros();
+        bus.readRegisterRegion(0x10 + i, 0, data[i], sizeof(data[i]));
+        maxTransaction = std::max(maxTransaction, micros() - start);
+    }
+
+    printf("%d devices - longest loop pass: blocking %lu us, queued %lu us (%d passes)\n", kTestDevices,
+           maxBlocking, maxQueued, nLoops);
+
+    flxTestCheck(nDone == kTestDevices * kTestPasses);
+    flxTestCheck(maxQueued <= maxTransaction);
+    flxTestCheck(maxQueued < maxBlocking);
+
+    for (auto pDevice : devices)
+        delete pDevice;
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    flxSimWire sim;
+    flxSimBME280 bme;
+    flxTestCheck(sim.addDevice(bme));
+
+    flxBusI2C bus;
+    bus.begin(sim);
+
+    flxTestCheck(flxJobQueue.start());
+
+    testQueue(bus, bme);
+    testLoopAvailability();
+
+    return flxTestResult();
+}
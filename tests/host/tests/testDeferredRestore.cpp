@@ -0,0 +1,119 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testDeferredRestore.cpp
+ *
+ * Deferred restore of object settings. The settings of three objects are saved to a binary snapshot, then set
+ * back to their defaults - as after a restart. Two of the objects are deferred:
+ *
+ *    - a restore of the system skips the deferred objects, and marks them restore pending
+ *    - restoreDeferred() restores a pending object on demand
+ *    - a save restores the pending objects first, so their defaults aren't saved over their settings
+ *    - the background job restores the pending objects once the job queue runs
+ */
+
+#include "flxFlux.h"
+#include "flxSettings.h"
+#include "flxStorageBinaryPref.h"
+#include "flxTest.h"
+#include "flxTestFile.h"
+
+flxTestDefine();
+
+#define kTestDefault 1
+
+//----------------------------------------------------------------------------------------------------
+class testSettings : public flxActionType<testSettings>
+{
+  public:
+    testSettings(const char *szName)
+    {
+        setName(szName);
+        flxRegister(interval, "Interval");
+    }
+
+    flxPropertyInt32<testSettings> interval = {kTestDefault};
+};
+
+// as in an application, the storage and settings objects are globals - their names aren't freed
+static flxTestFileSystem fileSystem;
+static flxStorageBinaryPref snapshot;
+
+static testSettings settings("Settings");
+static testSettings deferred1("Deferred 1");
+static testSettings deferred2("Deferred 2");
+
+//----------------------------------------------------------------------------------------------------
+// back to the defaults - as after a restart
+static void setDefaults(void)
+{
+    settings.interval = kTestDefault;
+    deferred1.interval = kTestDefault;
+    deferred2.interval = kTestDefault;
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    snapshot.setFileSystem(&fileSystem);
+    snapshot.setFilename("/settings.bin");
+
+    flux.add(settings);
+    flux.add(deferred1);
+    flux.add(deferred2);
+
+    flxSettings.setStorage(&snapshot);
+
+    settings.interval = 100;
+    deferred1.interval = 200;
+    deferred2.interval = 300;
+    flxTestCheck(flxSettings.save(&flux));
+
+    setDefaults();
+    flxSettings.setDeferredRestore(deferred1);
+    flxSettings.setDeferredRestore(deferred2);
+
+    // the system restore skips the deferred objects
+    flxTestCheck(flxSettings.restore(&flux));
+    flxTestCheck(settings.interval() == 100 && !settings.restorePending());
+    flxTestCheck(deferred1.interval() == kTestDefault && deferred1.restorePending());
+    flxTestCheck(deferred2.interval() == kTestDefault && deferred2.restorePending());
+
+    // restored on demand - once, a later call leaves the object's values as they are
+    flxTestCheck(flxSettings.restoreDeferred(deferred1));
+    flxTestCheck(deferred1.interval() == 200 && !deferred1.restorePending());
+    deferred1.interval = 201;
+    flxTestCheck(flxSettings.restoreDeferred(deferred1));
+    flxTestCheck(deferred1.interval() == 201);
+    flxTestCheck(deferred2.interval() == kTestDefault && deferred2.restorePending());
+
+    // a save restores the pending object before it saves
+    settings.interval = 101;
+    flxTestCheck(flxSettings.save(&flux));
+    flxTestCheck(deferred2.interval() == 300 && !deferred2.restorePending());
+
+    setDefaults();
+    flxTestCheck(flxSettings.restore(&flux));
+    flxTestCheck(settings.interval() == 101);
+
+    // the background job restores the rest
+    flxTestCheck(flxJobQueue.start());
+    for (int i = 0; i < 20 && (deferred1.restorePending() || deferred2.restorePending()); i++)
+    {
+        delay(50);
+        flxJobQueue.loop();
+    }
+    flxTestCheck(!deferred1.restorePending() && !deferred2.restorePending());
+    flxTestCheck(deferred1.interval() == 201 && deferred2.interval() == 300);
+
+    return flxTestResult();
+}
@@ -0,0 +1,169 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testDeviceCache.cpp
+ *
+ * Validation of the cached auto-detected device set. The buses in this test all have bus ID 0, so they share
+ * one cache record - each bus is detected against the record the bus before it saved, as a board with a
+ * changed set of devices is on the next startup.
+ *
+ *    bus 1 - no devices. No cache yet - a full scan, which caches an empty device set.
+ *
+ *    bus 2 - a device that can't be pinged at 0x60. The address isn't in the presence scan, so the presence
+ *            scan matches the empty cache - the cache is only found to be invalid by probing that driver.
+ *
+ *    bus 3 - a BME280 at 0x77. The presence scan doesn't match - a full scan, which caches the BME280.
+ *
+ *    bus 4 - a different device at 0x77. The address answers a ping, so the presence scan matches the cache,
+ *            but the cached BME280 isn't connected - the cache is invalid and nothing is built.
+ */
+
+#include "flxDevice.h"
+#include "flxFlux.h"
+#include "flxSimDevices.h"
+#include "flxStorageBinaryPref.h"
+#include "flxTest.h"
+#include "flxTestFile.h"
+
+flxTestDefine();
+
+//----------------------------------------------------------------------------------------------------
+// Minimal drivers - a BME280 found by chip ID, and a device found by its ID register that can't be pinged
+class testDevBME280 : public flxDeviceI2CType<testDevBME280>
+{
+  public:
+    testDevBME280()
+    {
+        spSetupDeviceIdent(getDeviceName());
+    }
+
+    static bool isConnected(flxBusI2C &i2cDriver, uint8_t address)
+    {
+        return i2cDriver.ping(address) && i2cDriver.readRegister(address, 0xD0) == 0x60;
+    }
+    static flxDeviceConfidence_t connectedConfidence(void)
+    {
+        return flxDevConfidenceExact;
+    }
+    static const char *getDeviceName()
+    {
+        return "BME280";
+    };
+    static const uint8_t *getDefaultAddresses()
+    {
+        return defaultDeviceAddress;
+    }
+    static uint8_t defaultDeviceAddress[];
+
+    bool onInitialize(TwoWire &)
+    {
+        return true;
+    }
+};
+uint8_t testDevBME280::defaultDeviceAddress[] = {0x77, kSparkDeviceAddressNull};
+flxRegisterDevice(testDevBME280);
+
+class testDevNoPing : public flxDeviceI2CType<testDevNoPing>
+{
+  public:
+    testDevNoPing()
+    {
+        spSetupDeviceIdent(getDeviceName());
+    }
+
+    static bool isConnected(flxBusI2C &i2cDriver, uint8_t address)
+    {
+        return i2cDriver.readRegister(address, 0x20) == 0x40;
+    }
+    static flxDeviceConfidence_t connectedConfidence(void)
+    {
+        return flxDevConfidenceExact;
+    }
+    static bool pingable(void)
+    {
+        return false;
+    }
+    static const char *getDeviceName()
+    {
+        return "NoPing";
+    };
+    static const uint8_t *getDefaultAddresses()
+    {
+        return defaultDeviceAddress;
+    }
+    static uint8_t defaultDeviceAddress[];
+
+    bool onInitialize(TwoWire &)
+    {
+        return true;
+    }
+};
+uint8_t testDevNoPing::defaultDeviceAddress[] = {0x60, kSparkDeviceAddressNull};
+flxRegisterDevice(testDevNoPing);
+
+// as in an application, the cache storage and the built devices are globals - their names aren't freed
+static flxTestFileSystem fileSystem;
+static flxStorageBinaryPref cache;
+flxDevice *theDevices[8];
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    cache.setFileSystem(&fileSystem);
+    cache.setFilename("/cache.bin");
+
+    flxSimWire sim[4];
+
+    flxSimI2CDevice noPing(0x60);
+    noPing.writeRegister(0x20, 0x40);
+    flxTestCheck(sim[1].addDevice(noPing));
+
+    flxSimBME280 bme;
+    flxTestCheck(sim[2].addDevice(bme));
+
+    flxSimI2CDevice other(0x77);
+    other.writeRegister(0xD0, 0x58);
+    flxTestCheck(sim[3].addDevice(other));
+
+    flxBusI2C bus[4];
+    std::vector<flxBusI2C *> theBuses;
+    for (int i = 0; i < 4; i++)
+    {
+        bus[i].begin(sim[i]);
+        theBuses.push_back(&bus[i]);
+    }
+
+    flxTestCheck(flxDeviceFactory::get().buildDevices(theBuses, &cache) == 2);
+    flxTestCheck(!flxDeviceFactory::get().builtFromCache());
+
+    int nDevices = 0;
+    int nBME = 0;
+    int nNoPing = 0;
+
+    for (auto device : flux.connectedDevices())
+    {
+        if (nDevices < sizeof(theDevices) / sizeof(theDevices[0]))
+            theDevices[nDevices] = device;
+        nDevices++;
+
+        // the address is added to the device name
+        if (strncmp(device->name(), "BME280", 6) == 0 && device->address() == 0x77)
+            nBME++;
+        else if (strncmp(device->name(), "NoPing", 6) == 0 && device->address() == 0x60)
+            nNoPing++;
+    }
+    flxTestCheck(nDevices == 2);
+    flxTestCheck(nBME == 1);
+    flxTestCheck(nNoPing == 1);
+
+    return flxTestResult();
+}
@@ -0,0 +1,98 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testIdHash.cpp
+ *
+ * The hex encoder of the settings keys. flx_utils::id_hash_to_string() must give the output of snprintf("%X") -
+ * truncation to a small buffer included - since the keys of stored settings were made with snprintf. Edge
+ * values and random values are encoded into each buffer size from 1 to 12 bytes, and the bytes past the
+ * buffer must not be written.
+ */
+
+#include "flxUtils.h"
+#include "flxTest.h"
+
+#include <random>
+
+flxTestDefine();
+
+#define kTestBufferMax 12
+#define kTestRandomValues 200000
+
+//----------------------------------------------------------------------------------------------------
+// Encode a value into each buffer size - returns false on any mismatch with snprintf
+static bool checkValue(uint32_t value)
+{
+    for (size_t len = 1; len <= kTestBufferMax; len++)
+    {
+        char szExpected[kTestBufferMax + 4];
+        char szEncoded[kTestBufferMax + 4];
+
+        memset(szExpected, 0x7E, sizeof(szExpected));
+        memset(szEncoded, 0x7E, sizeof(szEncoded));
+
+        snprintf(szExpected, len, "%X", value);
+
+        if (!flx_utils::id_hash_to_string(value, szEncoded, len))
+            return false;
+
+        // the whole buffer - the bytes past the string size must be untouched in both
+        if (memcmp(szExpected, szEncoded, sizeof(szEncoded)) != 0)
+        {
+            printf("mismatch: 0x%X, buffer size %zu - \"%s\"\n", value, len, szEncoded);
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    const uint32_t edgeValues[] = {0,          1,          9,          0xA,        0xF,        0x10,
+                                   0xFF,       0x100,      0xFFF,      0xABCDEF,   0x1000000,  0x7FFFFFFF,
+                                   0x80000000, 0xDEADBEEF, 0xFFFFFFF0, 0xFFFFFFFF};
+
+    for (auto value : edgeValues)
+        flxTestCheck(checkValue(value));
+
+    std::mt19937 rng(46);
+    int nBad = 0;
+    for (int i = 0; i < kTestRandomValues; i++)
+    {
+        // random values of each length - a random number of significant bits
+        uint32_t value = rng() >> (rng() % 32);
+        if (!checkValue(value))
+            nBad++;
+    }
+    flxTestCheck(nBad == 0);
+
+    // no buffer
+    char szBuffer[4] = {'x', 'x', 'x', 'x'};
+    flxTestCheck(!flx_utils::id_hash_to_string(0x1234, szBuffer, 0));
+    flxTestCheck(szBuffer[0] == 'x');
+    flxTestCheck(!flx_utils::id_hash_to_string(0x1234, nullptr, 4));
+
+    // the key of a tag is the hex string of its hash
+    const char *tags[] = {"a", "sampleInterval", "Sample Interval (ms)", "x/y/z"};
+    for (auto szTag : tags)
+    {
+        char szKey[16];
+        char szExpected[16];
+        snprintf(szExpected, sizeof(szExpected), "%X", flx_utils::id_hash_string(szTag));
+
+        flxTestCheck(flx_utils::id_hash_string_to_string(szTag, szKey, sizeof(szKey)));
+        flxTestCheck(strcmp(szKey, szExpected) == 0);
+    }
+
+    return flxTestResult();
+}
@@ -0,0 +1,381 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testIncrementalSave.cpp
+ *
+ * Incremental saves of the system settings. The settings storage is a binary snapshot, wrapped so the blocks
+ * opened and the values written by a save are counted.
+ *
+ * After a full save, a save with one changed property writes just that value, and the clean objects aren't
+ * opened. A counter changed outside of its property - as the ACS37800 energy counters are - is written once
+ * it's marked dirty. The saved values are then restored from a reopened storage.
+ */
+
+#include "flxFlux.h"
+#include "flxSettings.h"
+#include "flxStorageBinaryPref.h"
+#include "flxTest.h"
+#include "flxTestFile.h"
+
+flxTestDefine();
+
+#define kTestFilename "/settings.bin"
+
+//----------------------------------------------------------------------------------------------------
+// A storage block that counts the values written to the block it wraps
+class testCountingBlock : public flxStorageBlock
+{
+  public:
+    testCountingBlock() : writes{0}, _block{nullptr}
+    {
+    }
+
+    void wrap(flxStorageBlock *pBlock)
+    {
+        _block = pBlock;
+        setIncremental(false);
+    }
+    flxStorageBlock *wrapped(void)
+    {
+        return _block;
+    }
+
+    bool writeBool(const char *tag, bool data)
+    {
+        writes++;
+        return _block->writeBool(tag, data);
+    }
+    bool writeInt8(const char *tag, int8_t data)
+    {
+        writes++;
+        return _block->writeInt8(tag, data);
+    }
+    bool writeInt16(const char *tag, int16_t data)
+    {
+        writes++;
+        return _block->writeInt16(tag, data);
+    }
+    bool writeInt32(const char *tag, int32_t data)
+    {
+        writes++;
+        return _block->writeInt32(tag, data);
+    }
+    bool writeUInt8(const char *tag, uint8_t data)
+    {
+        writes++;
+        return _block->writeUInt8(tag, data);
+    }
+    bool writeUInt16(const char *tag, uint16_t data)
+    {
+        writes++;
+        return _block->writeUInt16(tag, data);
+    }
+    bool writeUInt32(const char *tag, uint32_t data)
+    {
+        writes++;
+        return _block->writeUInt32(tag, data);
+    }
+    bool writeFloat(const char *tag, float data)
+    {
+        writes++;
+        return _block->writeFloat(tag, data);
+    }
+    bool writeDouble(const char *tag, double data)
+    {
+        writes++;
+        return _block->writeDouble(tag, data);
+    }
+    bool writeString(const char *tag, const char *data)
+    {
+        writes++;
+        return _block->writeString(tag, data);
+    }
+    bool writeBytes(const char *tag, const uint8_t *data, size_t len)
+    {
+        writes++;
+        return _block->writeBytes(tag, data, len);
+    }
+
+    bool readBool(const char *tag, bool &value)
+    {
+        return _block->readBool(tag, value);
+    }
+    bool readInt8(const char *tag, int8_t &value)
+    {
+        return _block->readInt8(tag, value);
+    }
+    bool readInt16(const char *tag, int16_t &value)
+    {
+        return _block->readInt16(tag, value);
+    }
+    bool readInt32(const char *tag, int32_t &value)
+    {
+        return _block->readInt32(tag, value);
+    }
+    bool readUInt8(const char *tag, uint8_t &value)
+    {
+        return _block->readUInt8(tag, value);
+    }
+    bool readUInt16(const char *tag, uint16_t &value)
+    {
+        return _block->readUInt16(tag, value);
+    }
+    bool readUInt32(const char *tag, uint32_t &value)
+    {
+        return _block->readUInt32(tag, value);
+    }
+    bool readFloat(const char *tag, float &value)
+    {
+        return _block->readFloat(tag, value);
+    }
+    bool readDouble(const char *tag, double &value)
+    {
+        return _block->readDouble(tag, value);
+    }
+    size_t getStringLength(const char *tag)
+    {
+        return _block->getStringLength(tag);
+    }
+    size_t readString(const char *tag, char *data, size_t len)
+    {
+        return _block->readString(tag, data, len);
+    }
+    size_t readBytes(const char *tag, uint8_t *data, size_t len)
+    {
+        return _block->readBytes(tag, data, len);
+    }
+    size_t getBytesLength(const char *tag)
+    {
+        return _block->getBytesLength(tag);
+    }
+    bool valueExists(const char *tag)
+    {
+        return _block->valueExists(tag);
+    }
+
+    flxStorage::flxStorageKind_t kind(void)
+    {
+        return _block->kind();
+    }
+    void setReadOnly(bool readonly)
+    {
+        _block->setReadOnly(readonly);
+    }
+
+    uint32_t writes;
+
+  private:
+    flxStorageBlock *_block;
+};
+
+//----------------------------------------------------------------------------------------------------
+// A storage that counts the blocks opened for writing, and the values written, in the storage it wraps
+class testCountingStorage : public flxStorage
+{
+  public:
+    testCountingStorage(flxStorage &theStorage) : blocks{0}, _storage{theStorage}
+    {
+        setName("Counting");
+    }
+
+    flxStorageKind_t kind(void)
+    {
+        return _storage.kind();
+    }
+    bool begin(bool readonly = false)
+    {
+        return _storage.begin(readonly);
+    }
+    void end(void)
+    {
+        _storage.end();
+    }
+
+    flxStorageBlock *beginBlock(const char *tag)
+    {
+        flxStorageBlock *pBlock = _storage.beginBlock(tag);
+        if (!pBlock)
+            return nullptr;
+        blocks++;
+        _theBlock.wrap(pBlock);
+        return &_theBlock;
+    }
+    flxStorageBlock *getBlock(const char *tag)
+    {
+        flxStorageBlock *pBlock = _storage.getBlock(tag);
+        if (!pBlock)
+            return nullptr;
+        _theBlock.wrap(pBlock);
+        return &_theBlock;
+    }
+    void endBlock(flxStorageBlock *pBlock)
+    {
+        _storage.endBlock(pBlock == &_theBlock ? _theBlock.wrapped() : pBlock);
+    }
+    void resetStorage()
+    {
+        _storage.resetStorage();
+    }
+
+    void resetCounts(void)
+    {
+        blocks = 0;
+        _theBlock.writes = 0;
+    }
+    uint32_t writes(void)
+    {
+        return _theBlock.writes;
+    }
+
+    uint32_t blocks;
+
+  private:
+    flxStorage &_storage;
+    testCountingBlock _theBlock;
+};
+
+//----------------------------------------------------------------------------------------------------
+// Settings objects - one with regular properties, and one with a counter that changes outside of its
+// property, as a meter's energy counter does
+class testSettings : public flxActionType<testSettings>
+{
+  public:
+    testSettings(const char *szName)
+    {
+        setName(szName);
+        flxRegister(interval, "Interval");
+        flxRegister(offset, "Offset");
+        flxRegister(label, "Label");
+    }
+
+    flxPropertyInt32<testSettings> interval = {1000};
+    flxPropertyFloat<testSettings> offset = {0.5};
+    flxPropertyString<testSettings> label = {"none"};
+};
+
+class testMeter : public flxActionType<testMeter>
+{
+  public:
+    testMeter() : _energy{0}
+    {
+        setName("Meter");
+        flxRegister(energyCount, "Energy");
+    }
+
+    void accumulate(double energy)
+    {
+        _energy += energy;
+
+        // changed outside of the property set() - mark it dirty, so an incremental save writes it
+        energyCount.setIsDirty();
+        this->setIsDirty();
+    }
+    double energy(void)
+    {
+        return _energy;
+    }
+
+  private:
+    double get_energy(void)
+    {
+        return _energy;
+    }
+    void set_energy(double energy)
+    {
+        _energy = energy;
+    }
+    double _energy;
+
+  public:
+    flxPropertyRWHiddenDouble<testMeter, &testMeter::get_energy, &testMeter::set_energy> energyCount;
+};
+
+// as in an application, the storage and settings objects are globals - their names aren't freed
+static flxTestFileSystem fileSystem;
+static flxStorageBinaryPref snapshot;
+static flxStorageBinaryPref reopened;
+static testCountingStorage storage(snapshot);
+
+static testSettings settingsA("Settings A");
+static testSettings settingsB("Settings B");
+static testMeter meter;
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    snapshot.setFileSystem(&fileSystem);
+    snapshot.setFilename(kTestFilename);
+    reopened.setFileSystem(&fileSystem);
+    reopened.setFilename(kTestFilename);
+
+    flux.add(settingsA);
+    flux.add(settingsB);
+    flux.add(meter);
+
+    flxSettings.setStorage(&storage);
+    flxSettings.incrementalSave = true;
+
+    // the first save is a full save
+    flxTestCheck(flxSettings.save(&flux));
+    uint32_t fullBlocks = storage.blocks;
+    uint32_t fullWrites = storage.writes();
+    flxTestCheck(fullBlocks >= 3 && fullWrites >= 7);
+
+    // nothing changed - nothing written
+    storage.resetCounts();
+    flxTestCheck(flxSettings.save(&flux));
+    flxTestCheck(storage.writes() == 0 && storage.blocks == 0);
+
+    // one property changed - one value written. Only the blocks of the object and its containers - the
+    // system and the settings container - are opened
+    settingsA.interval = 2500;
+
+    storage.resetCounts();
+    flxTestCheck(flxSettings.save(&flux));
+    flxTestCheck(storage.writes() == 1);
+    flxTestCheck(storage.blocks == 3);
+
+    // a counter changed outside of its property
+    meter.accumulate(1.25);
+
+    storage.resetCounts();
+    flxTestCheck(flxSettings.save(&flux));
+    flxTestCheck(storage.writes() == 1);
+
+    // changes in each object
+    settingsA.interval = 3000;
+    settingsB.label = "thing two";
+    meter.accumulate(0.5);
+
+    storage.resetCounts();
+    flxTestCheck(flxSettings.save(&flux));
+    flxTestCheck(storage.writes() == 3);
+
+    printf("full save: %u blocks, %u values - incremental save of 3 changes: %u blocks, %u values\n", fullBlocks,
+           fullWrites, storage.blocks, storage.writes());
+
+    // change the values in memory, then restore from the storage reopened
+    settingsA.interval = 0;
+    settingsA.offset = 0;
+    settingsB.label = "";
+    meter.accumulate(-meter.energy());
+
+    flxSettings.setStorage(&reopened);
+    flxTestCheck(flxSettings.restore(&flux));
+
+    flxTestCheck(settingsA.interval() == 3000);
+    flxTestCheck(settingsA.offset() == 0.5);
+    flxTestCheck(strcmp(settingsB.label().c_str(), "thing two") == 0);
+    flxTestCheck(meter.energy() == 1.75);
+
+    return flxTestResult();
+}
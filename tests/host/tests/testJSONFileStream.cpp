@@ -0,0 +1,144 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testJSONFileStream.cpp
+ *
+ * The JSON settings file reader and writer. Random data is read back through the reader with a mix of
+ * single byte and block reads, with the file returning short reads, and written through the writer with
+ * a mix of single byte and block writes. Built with the address sanitizer, this checks the chunk buffer
+ * handling at every boundary.
+ */
+
+#include "flxJSONFileStream.h"
+#include "flxTest.h"
+#include "flxTestFile.h"
+
+#include <random>
+
+flxTestDefine();
+
+#define kTestRuns 2000
+#define kTestMaxFileSize 2000
+#define kTestMaxBlock 300
+
+static std::mt19937 rng(3);
+
+//----------------------------------------------------------------------------------------------------
+static std::string randomData(void)
+{
+    std::string data;
+    size_t length = rng() % kTestMaxFileSize;
+
+    for (size_t i = 0; i < length; i++)
+        data += (char)(rng() % 256);
+
+    return data;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void testReader(const std::string &data)
+{
+    auto spFile = std::make_shared<flxTestFile>(data);
+
+    // a third of the files return short reads
+    spFile->readLimit = rng() % 3 ? 0 : 1 + rng() % 50;
+
+    flxFSFile theFile = flxTestFile::open(spFile);
+    flxJSONFileReader theReader(theFile);
+    std::string result;
+    char buffer[kTestMaxBlock];
+
+    while (result.size() < data.size())
+    {
+        if (rng() % 2)
+        {
+            int c = theReader.read();
+            if (c < 0)
+                break;
+            result += (char)c;
+        }
+        else
+        {
+            size_t length = rng() % sizeof(buffer);
+            size_t nRead = theReader.readBytes(buffer, length);
+
+            // a short read is the end of the file
+            if (nRead < length && result.size() + nRead < data.size())
+            {
+                flxTestCheck(false);
+                break;
+            }
+            result.append(buffer, nRead);
+        }
+    }
+    flxTestCheck(result == data);
+
+    // at the end
+    flxTestCheck(theReader.read() == -1);
+    flxTestCheck(theReader.readBytes(buffer, sizeof(buffer)) == 0);
+}
+
+//----------------------------------------------------------------------------------------------------
+static void testWriter(const std::string &data)
+{
+    auto spFile = std::make_shared<flxTestFile>();
+    flxFSFile theFile = flxTestFile::open(spFile);
+    flxJSONFileWriter theWriter(theFile);
+
+    size_t position = 0;
+    while (position < data.size())
+    {
+        if (rng() % 2)
+        {
+            flxTestCheck(theWriter.write((uint8_t)data[position]) == 1);
+            position++;
+        }
+        else
+        {
+            size_t length = std::min((size_t)(rng() % kTestMaxBlock), data.size() - position);
+            flxTestCheck(theWriter.write((const uint8_t *)data.data() + position, length) == length);
+            position += length;
+        }
+    }
+    flxTestCheck(theWriter.flush());
+    flxTestCheck(spFile->data == data);
+}
+
+//----------------------------------------------------------------------------------------------------
+// A file that can't hold the data - the failed write is reported by flush()
+static void testWriterFull(const std::string &data)
+{
+    auto spFile = std::make_shared<flxTestFile>();
+    spFile->sizeLimit = 200;
+
+    flxFSFile theFile = flxTestFile::open(spFile);
+    flxJSONFileWriter theWriter(theFile);
+
+    theWriter.write((const uint8_t *)data.data(), data.size());
+
+    flxTestCheck(theWriter.flush() == (data.size() <= spFile->sizeLimit));
+    flxTestCheck(spFile->data.size() <= spFile->sizeLimit);
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    for (int i = 0; i < kTestRuns; i++)
+    {
+        std::string data = randomData();
+
+        testReader(data);
+        testWriter(data);
+        testWriterFull(data);
+    }
+    return flxTestResult();
+}
@@ -0,0 +1,181 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testKVPExportImport.cpp
+ *
+ * Backup and restore of the key-value-pair settings storage. Settings in two blocks are written to the
+ * simulated flash, exported to a binary snapshot in a RAM file system, the storage is reset and the snapshot
+ * imported back. The store is then reopened from flash - the values and the namespaces must match the
+ * originals, and the store must export again.
+ */
+
+#include "flxKVPStore.h"
+#include "flxSimKVPStore.h"
+#include "flxStorageBinaryPref.h"
+#include "flxStorageKVPPref.h"
+#include "flxTest.h"
+#include "flxTestFile.h"
+
+#include <set>
+#include <string>
+
+flxTestDefine();
+
+#define kTestPages 4
+
+static const uint8_t testBytes[] = {1, 2, 3, 250, 0, 7};
+
+// as in an application, the snapshot storage is a global - its name isn't freed
+static flxTestFileSystem fileSystem;
+static flxStorageBinaryPref snapshot;
+
+//----------------------------------------------------------------------------------------------------
+// The namespace names on flash
+static std::set<std::string> nameSpaces(flxSimKVPStoreDevice &device)
+{
+    flxKVPStore store;
+    store.setStorageDevice(device);
+    flxTestCheck(store.initialize() == kKVPErrorOK);
+
+    std::set<std::string> names;
+    size_t iterator = 0;
+    uint8_t iNS;
+    const char *szName;
+
+    while (store.nextNameSpace(iterator, iNS, szName))
+        names.insert(szName);
+
+    return names;
+}
+
+//----------------------------------------------------------------------------------------------------
+// The number of values in a snapshot file
+static int snapshotValues(flxStorageBinaryPref &snapshot)
+{
+    if (!snapshot.begin(true))
+        return -1;
+
+    flxStorageBinaryPref::binaryEntry_t theEntry;
+    uint16_t iBlock = 0;
+    uint16_t iValue = 0;
+    int nValues = 0;
+
+    for (; snapshot.nextValue(iBlock, iValue, theEntry); iValue++)
+        nValues++;
+
+    snapshot.end();
+    return nValues;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void writeSettings(flxStorageKVPPref &storage)
+{
+    flxTestCheck(storage.begin());
+
+    flxStorageBlock *pBlock = storage.beginBlock("device");
+    flxTestCheck(pBlock != nullptr);
+    flxTestCheck(pBlock->writeInt32("interval", -15000));
+    flxTestCheck(pBlock->writeString("name", "thing one"));
+    flxTestCheck(pBlock->writeFloat("offset", 2.5));
+    storage.endBlock(pBlock);
+
+    pBlock = storage.beginBlock("logger");
+    flxTestCheck(pBlock != nullptr);
+    flxTestCheck(pBlock->writeBool("enabled", true));
+    flxTestCheck(pBlock->writeUInt16("rate", 4321));
+    flxTestCheck(pBlock->writeBytes("key", testBytes, sizeof(testBytes)));
+    storage.endBlock(pBlock);
+
+    storage.end();
+}
+
+//----------------------------------------------------------------------------------------------------
+static bool checkSettings(flxStorageKVPPref &storage)
+{
+    storage.begin(true);
+
+    bool status = true;
+
+    flxStorageBlock *pBlock = storage.beginBlock("device");
+    int32_t interval = 0;
+    char szName[32] = {0};
+    float offset = 0;
+
+    status = status && pBlock != nullptr && pBlock->readInt32("interval", interval) && interval == -15000;
+    status = status && pBlock->readString("name", szName, sizeof(szName)) > 0 && strcmp(szName, "thing one") == 0;
+    status = status && pBlock->readFloat("offset", offset) && offset == 2.5;
+    if (pBlock)
+        storage.endBlock(pBlock);
+
+    pBlock = storage.beginBlock("logger");
+    bool enabled = false;
+    uint16_t rate = 0;
+    uint8_t bytes[16] = {0};
+
+    status = status && pBlock != nullptr && pBlock->readBool("enabled", enabled) && enabled;
+    status = status && pBlock->readUInt16("rate", rate) && rate == 4321;
+    status = status && pBlock->readBytes("key", bytes, sizeof(bytes)) > 0 &&
+             memcmp(bytes, testBytes, sizeof(testBytes)) == 0;
+    if (pBlock)
+        storage.endBlock(pBlock);
+
+    storage.end();
+    return status;
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    flxSimKVPStoreDevice device(kTestPages);
+
+    snapshot.setFileSystem(&fileSystem);
+    snapshot.setFilename("/backup.bin");
+
+    {
+        flxStorageKVPPref storage;
+        storage.setStorageDevice(&device);
+        writeSettings(storage);
+    }
+    device.close();
+
+    std::set<std::string> namesBefore = nameSpaces(device);
+    flxTestCheck(namesBefore.size() == 2);
+
+    // export, reset and import - in one session, so the reset store is used without a reopen
+    {
+        flxStorageKVPPref storage;
+        storage.setStorageDevice(&device);
+
+        flxTestCheck(storage.exportTo(&snapshot));
+        flxTestCheck(snapshotValues(snapshot) == 6);
+
+        storage.resetStorage();
+        flxTestCheck(!checkSettings(storage));
+
+        flxTestCheck(storage.importFrom(&snapshot));
+        flxTestCheck(checkSettings(storage));
+    }
+    device.close();
+
+    // reopen
+    flxTestCheck(nameSpaces(device) == namesBefore);
+
+    flxStorageKVPPref storage;
+    storage.setStorageDevice(&device);
+    flxTestCheck(checkSettings(storage));
+
+    fileSystem.files.clear();
+    flxTestCheck(storage.exportTo(&snapshot));
+    flxTestCheck(snapshotValues(snapshot) == 6);
+
+    return flxTestResult();
+}
@@ -0,0 +1,113 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testKVPStoreIndex.cpp
+ *
+ * Benchmark of the key-value-pair store page index - the settings restore path. A store of 500 keys is
+ * reopened from the simulated flash, every key is read back, then 500 keys that aren't in the store.
+ *
+ * With the index, a found key is one device read (the entry) and a missing key is none. The read counts
+ * are checked; the times are printed.
+ */
+
+#include "flxKVPStore.h"
+#include "flxSimKVPStore.h"
+#include "flxTest.h"
+
+#include <chrono>
+
+flxTestDefine();
+
+#define kTestPages 8
+#define kTestKeys 500
+
+static double elapsed(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    flxSimKVPStoreDevice device(kTestPages);
+    char szKey[16];
+
+    // fill the store - keys named like the settings properties
+    {
+        flxKVPStore store;
+        store.setStorageDevice(device);
+        flxTestCheck(store.initialize() == kKVPErrorOK);
+
+        uint8_t iNS = store.getNameSpace("settings");
+        for (int32_t i = 0; i < kTestKeys; i++)
+        {
+            snprintf(szKey, sizeof(szKey), "dev%d.prop", i);
+            flxTestCheck(store.setValue(iNS, szKey, i) == kKVPErrorOK);
+        }
+        store.commit();
+        device.close();
+    }
+
+    flxSimKVPStats_t statsOpen, statsFound, statsMissing;
+    device.resetStats();
+
+    // open - the pages are loaded and indexed
+    auto start = std::chrono::steady_clock::now();
+    flxKVPStore store;
+    store.setStorageDevice(device);
+    flxTestCheck(store.initialize() == kKVPErrorOK);
+    uint8_t iNS = store.getNameSpace("settings");
+    double usOpen = elapsed(start);
+    device.getStats(statsOpen);
+
+    // restore - every key
+    start = std::chrono::steady_clock::now();
+    int nBad = 0;
+    for (int i = 0; i < kTestKeys; i++)
+    {
+        snprintf(szKey, sizeof(szKey), "dev%d.prop", i);
+        int32_t value;
+        if (store.getValue(iNS, szKey, value) != kKVPErrorOK || value != i)
+            nBad++;
+    }
+    double usFound = elapsed(start);
+    device.getStats(statsFound);
+
+    // keys that aren't in the store
+    start = std::chrono::steady_clock::now();
+    int nFalse = 0;
+    for (int i = 0; i < kTestKeys; i++)
+    {
+        snprintf(szKey, sizeof(szKey), "nokey%d", i);
+        int32_t value;
+        if (store.getValue(iNS, szKey, value) == kKVPErrorOK)
+            nFalse++;
+    }
+    double usMissing = elapsed(start);
+    device.getStats(statsMissing);
+
+    uint32_t nReadsFound = statsFound.reads - statsOpen.reads;
+    uint32_t nReadsMissing = statsMissing.reads - statsFound.reads;
+
+    printf("open: %u reads, %.0f us\n", statsOpen.reads, usOpen);
+    printf("%d keys: %u reads (%.1f per key), %.0f us\n", kTestKeys, nReadsFound, (double)nReadsFound / kTestKeys,
+           usFound);
+    printf("%d missing keys: %u reads, %.0f us\n", kTestKeys, nReadsMissing, usMissing);
+    printf("heap: %zu bytes\n", store.heapSize());
+
+    flxTestCheck(nBad == 0);
+    flxTestCheck(nFalse == 0);
+    flxTestCheck(nReadsFound == kTestKeys);
+    flxTestCheck(nReadsMissing == 0);
+
+    return flxTestResult();
+}
@@ -0,0 +1,132 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testKVPStorePowerLoss.cpp
+ *
+ * Power loss during updates of the key-value-pair store. The contents of flash are saved after every
+ * sector program - each is a point where power could be lost. Each saved image is loaded into a new store,
+ * and the key being updated must have its previous value, or once the new value is on flash, the new value.
+ *
+ * String values of random length move between entries and pages, so the moves and compactions are covered.
+ */
+
+#include "flxKVPStore.h"
+#include "flxSimKVPStore.h"
+#include "flxTest.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+flxTestDefine();
+
+#define kTestPages 3
+#define kTestKeys 40
+#define kTestUpdates 20000
+
+//----------------------------------------------------------------------------------------------------
+// A simulated flash that saves an image of flash after each sector program
+class testSnapshotDevice : public flxSimKVPStoreDevice
+{
+  public:
+    testSnapshotDevice(uint32_t nSegments) : flxSimKVPStoreDevice(nSegments)
+    {
+    }
+
+    std::vector<std::vector<uint8_t>> snapshots;
+
+  protected:
+    bool programSector(uint32_t iSector, const uint8_t *data, uint32_t &usInterruptsOff)
+    {
+        bool status = flxSimKVPStoreDevice::programSector(iSector, data, usInterruptsOff);
+        snapshots.emplace_back(flash(), flash() + storageSize());
+        return status;
+    }
+};
+
+//----------------------------------------------------------------------------------------------------
+// The value of a key in a flash image - empty if not found
+static std::string readSnapshot(const std::vector<uint8_t> &image, const char *szKey)
+{
+    flxSimKVPStoreDevice device(kTestPages);
+    for (uint32_t iPage = 0; iPage < kTestPages; iPage++)
+        device.write(iPage, 0, image.data() + iPage * device.segmentSize(), device.segmentSize());
+    device.flush();
+
+    flxKVPStore store;
+    store.setStorageDevice(device);
+    if (store.initialize() != kKVPErrorOK)
+        return "";
+
+    char szBuffer[256] = {0};
+    if (store.getValue(store.getNameSpace("settings"), szKey, szBuffer, sizeof(szBuffer)) != kKVPErrorOK)
+        return "";
+
+    return szBuffer;
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    testSnapshotDevice device(kTestPages);
+    flxKVPStore store;
+    store.setStorageDevice(device);
+    flxTestCheck(store.initialize() == kKVPErrorOK);
+
+    uint8_t iNS = store.getNameSpace("settings");
+
+    std::mt19937 rng(5);
+    std::vector<std::string> values(kTestKeys);
+    char szKey[16];
+    int nChecked = 0;
+    int nBad = 0;
+
+    for (int i = 0; i < kTestUpdates; i++)
+    {
+        int iKey = rng() % kTestKeys;
+        snprintf(szKey, sizeof(szKey), "s%d", iKey);
+
+        std::string value(1 + rng() % 200, 'a' + rng() % 26);
+        value += std::to_string(i);
+
+        // each update is committed - the snapshots are the programs it took
+        size_t iFirst = device.snapshots.size();
+        if (store.setValue(iNS, szKey, value.c_str()) != kKVPErrorOK)
+        {
+            flxTestCheck(false);
+            break;
+        }
+        store.commit();
+
+        bool bNewSeen = false;
+        for (size_t iSnap = iFirst; iSnap < device.snapshots.size(); iSnap++)
+        {
+            std::string result = readSnapshot(device.snapshots[iSnap], szKey);
+            nChecked++;
+
+            if (result == value)
+                bNewSeen = true;
+            else if (bNewSeen || result != values[iKey])
+            {
+                if (nBad++ < 5)
+                    printf("update %d, program %zu: %s has '%s'\n", i, iSnap - iFirst, szKey, result.c_str());
+            }
+        }
+        device.snapshots.clear();
+
+        values[iKey] = value;
+    }
+    printf("%d power loss points checked, %d bad\n", nChecked, nBad);
+    flxTestCheck(nBad == 0);
+
+    return flxTestResult();
+}
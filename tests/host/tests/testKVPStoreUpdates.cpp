@@ -0,0 +1,173 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testKVPStoreUpdates.cpp
+ *
+ * Long runs of random updates to the key-value-pair store on the simulated flash - integers, and
+ * strings that span entries - so pages fill, compact and level wear many times. The store is checked
+ * against a model of the values after it's reopened from flash, and after an on-demand compaction.
+ *
+ * The number of updates per run is the first argument - the default is one million.
+ */
+
+#include "flxKVPStore.h"
+#include "flxSimKVPStore.h"
+#include "flxTest.h"
+
+#include <map>
+#include <random>
+#include <string>
+
+flxTestDefine();
+
+// A commit every n updates, and a reopen from flash every n updates
+#define kTestCommitInterval 1000
+#define kTestReopenInterval 100000
+
+// Keys below this are integers, the others strings
+#define kTestIntKeys 40
+
+typedef struct
+{
+    std::map<std::string, int32_t> ints;
+    std::map<std::string, std::string> strings;
+} testModel_t;
+
+//----------------------------------------------------------------------------------------------------
+static bool checkStore(flxKVPStore &store, uint8_t iNS, testModel_t &model)
+{
+    for (auto &item : model.ints)
+    {
+        int32_t value;
+        if (store.getValue(iNS, item.first.c_str(), value) != kKVPErrorOK || value != item.second)
+        {
+            printf("integer %s doesn't match\n", item.first.c_str());
+            return false;
+        }
+    }
+
+    char szBuffer[256];
+    for (auto &item : model.strings)
+    {
+        if (store.getValue(iNS, item.first.c_str(), szBuffer, sizeof(szBuffer)) != kKVPErrorOK ||
+            item.second != szBuffer)
+        {
+            printf("string %s doesn't match\n", item.first.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------
+static flxKVPStore *openStore(flxSimKVPStoreDevice &device, uint8_t &iNS)
+{
+    flxKVPStore *pStore = new flxKVPStore;
+    pStore->setStorageDevice(device);
+    flxTestCheck(pStore->initialize() == kKVPErrorOK);
+
+    iNS = pStore->getNameSpace("settings");
+    flxTestCheck(iNS != 0);
+
+    return pStore;
+}
+
+//----------------------------------------------------------------------------------------------------
+// Returns the number of failed updates - a single page store can run out of room for a string
+static long runUpdates(uint32_t nPages, long nUpdates, int nKeys)
+{
+    flxSimKVPStoreDevice device(nPages);
+    uint8_t iNS;
+    flxKVPStore *pStore = openStore(device, iNS);
+
+    testModel_t model;
+    std::mt19937 rng(1234);
+    long nErrors = 0;
+    uint32_t nCompactions = 0;
+    char szKey[16];
+
+    for (long i = 0; i < nUpdates; i++)
+    {
+        int iKey = rng() % nKeys;
+        flxKVPError_t status;
+
+        if (iKey < kTestIntKeys)
+        {
+            snprintf(szKey, sizeof(szKey), "int%d", iKey);
+            int32_t value = rng();
+            status = pStore->setValue(iNS, szKey, value);
+            if (status == kKVPErrorOK)
+                model.ints[szKey] = value;
+        }
+        else
+        {
+            snprintf(szKey, sizeof(szKey), "str%d", iKey);
+            std::string value(1 + rng() % 128, 'a' + rng() % 26);
+            status = pStore->setValue(iNS, szKey, value.c_str());
+            if (status == kKVPErrorOK)
+                model.strings[szKey] = value;
+        }
+        // a failed update keeps the old value
+        if (status != kKVPErrorOK)
+            nErrors++;
+
+        if (i % kTestCommitInterval == kTestCommitInterval - 1)
+            pStore->commit();
+
+        if (i % kTestReopenInterval == kTestReopenInterval - 1)
+        {
+            pStore->commit();
+            nCompactions += pStore->compactions();
+            delete pStore;
+
+            device.close();
+            pStore = openStore(device, iNS);
+
+            if (!checkStore(*pStore, iNS, model))
+            {
+                printf("pages %u: the store doesn't match after %ld updates\n", nPages, i + 1);
+                flxTestCheck(false);
+                break;
+            }
+        }
+    }
+    pStore->commit();
+    flxTestCheck(checkStore(*pStore, iNS, model));
+
+    nCompactions += pStore->compactions();
+    flxTestCheck(pStore->compact() == kKVPErrorOK);
+    flxTestCheck(checkStore(*pStore, iNS, model));
+
+    flxSimKVPStats_t stats;
+    device.getStats(stats);
+    printf("pages %u, keys %d: %ld updates, %ld refused, %u compactions, %u erases\n", nPages, nKeys, nUpdates,
+           nErrors, nCompactions, stats.erases);
+
+    delete pStore;
+    return nErrors;
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    long nUpdates = argc > 1 ? atol(argv[1]) : 1000000;
+
+    // A single page has no spare page to compact into - updates that don't fit are refused
+    runUpdates(1, nUpdates, 60);
+
+    // with a spare page, every update fits
+    flxTestCheck(runUpdates(4, nUpdates, 60) == 0);
+    flxTestCheck(runUpdates(3, nUpdates, 100) == 0);
+    flxTestCheck(runUpdates(4, nUpdates, 100) == 0);
+
+    return flxTestResult();
+}
@@ -0,0 +1,124 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testKVPStoreWear.cpp
+ *
+ * Wear simulation of the key-value-pair store. A settings save workload - a batch of 8 hot string values
+ * written and committed - runs on the simulated flash, with a set of cold values written once at the start.
+ * The erase cycles of each sector are printed, and the most worn sector must be close to the mean.
+ *
+ * The number of saves per run is the first argument - the default is 200000.
+ */
+
+#include "flxKVPStore.h"
+#include "flxSimKVPStore.h"
+#include "flxTest.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+
+flxTestDefine();
+
+#define kTestHotKeys 20
+#define kTestValuesPerSave 8
+
+// The most worn sector, relative to the mean
+#define kTestMaxWear 1.10
+
+//----------------------------------------------------------------------------------------------------
+static void runSaves(uint32_t nPages, long nSaves, int nColdKeys)
+{
+    flxSimKVPStoreDevice device(nPages);
+    flxKVPStore store;
+    store.setStorageDevice(device);
+    flxTestCheck(store.initialize() == kKVPErrorOK);
+
+    uint8_t iNS = store.getNameSpace("settings");
+
+    std::mt19937 rng(99);
+    std::map<std::string, std::string> model;
+    char szKey[16];
+    long nErrors = 0;
+
+    for (int i = 0; i < nColdKeys; i++)
+    {
+        snprintf(szKey, sizeof(szKey), "cold%d", i);
+        std::string value(40, 'a' + i % 26);
+        flxTestCheck(store.setValue(iNS, szKey, value.c_str()) == kKVPErrorOK);
+        model[szKey] = value;
+    }
+    store.commit();
+
+    for (long i = 0; i < nSaves; i++)
+    {
+        for (int j = 0; j < kTestValuesPerSave; j++)
+        {
+            snprintf(szKey, sizeof(szKey), "hot%d", (int)(rng() % kTestHotKeys));
+            std::string value(1 + rng() % 40, 'a' + rng() % 26);
+
+            if (store.setValue(iNS, szKey, value.c_str()) != kKVPErrorOK)
+                nErrors++;
+            else
+                model[szKey] = value;
+        }
+        store.commit();
+    }
+
+    char szBuffer[256];
+    int nBad = 0;
+    for (auto &item : model)
+    {
+        if (store.getValue(iNS, item.first.c_str(), szBuffer, sizeof(szBuffer)) != kKVPErrorOK ||
+            item.second != szBuffer)
+            nBad++;
+    }
+
+    uint32_t minErase = UINT32_MAX;
+    uint32_t maxErase = 0;
+    uint64_t totalErase = 0;
+
+    printf("pages %u, cold keys %d: %ld saves\n  sector erases:", nPages, nColdKeys, nSaves);
+    for (uint32_t iPage = 0; iPage < nPages; iPage++)
+    {
+        uint32_t nErase = device.eraseCount(iPage);
+        printf(" %u", nErase);
+
+        minErase = std::min(minErase, nErase);
+        maxErase = std::max(maxErase, nErase);
+        totalErase += nErase;
+    }
+    double meanErase = (double)totalErase / nPages;
+
+    flxKVPWearStats_t wear;
+    store.getWearStats(wear);
+
+    printf("\n  min %u, max %u, mean %.0f - max/mean %.2f\n", minErase, maxErase, meanErase, maxErase / meanErase);
+    printf("  migrations %u, compactions %u\n", wear.migrations, store.compactions());
+
+    flxTestCheck(nErrors == 0);
+    flxTestCheck(nBad == 0);
+    flxTestCheck(maxErase <= meanErase * kTestMaxWear);
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    long nSaves = argc > 1 ? atol(argv[1]) : 200000;
+
+    runSaves(4, nSaves, 40);
+    runSaves(8, nSaves, 40);
+    runSaves(8, nSaves, 150);
+
+    return flxTestResult();
+}
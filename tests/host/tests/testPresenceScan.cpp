@@ -0,0 +1,212 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testPresenceScan.cpp
+ *
+ * The presence scan of I2C device auto-detection. Each address with a registered driver is pinged once, and
+ * the drivers' isConnected() probes only run at the addresses that answered - except for drivers that can't
+ * be pinged, which are always probed.
+ *
+ * The drivers here count their probes. A driver with a multi-step probe that doesn't ping first covers 16
+ * addresses, a driver that pings first covers 2 and a driver that can't be pinged covers 2. One device of each
+ * is on the bus. The bus transactions of the detection are printed.
+ */
+
+#include "flxDevice.h"
+#include "flxFlux.h"
+#include "flxSimDevices.h"
+#include "flxTest.h"
+
+flxTestDefine();
+
+// probes made by each driver, by address
+static int nProbes[128];
+
+//----------------------------------------------------------------------------------------------------
+// A driver with a multi-step probe that doesn't ping first
+class testDevMultiStep : public flxDeviceI2CType<testDevMultiStep>
+{
+  public:
+    testDevMultiStep()
+    {
+        spSetupDeviceIdent(getDeviceName());
+    }
+
+    static bool isConnected(flxBusI2C &i2cDriver, uint8_t address)
+    {
+        nProbes[address]++;
+
+        uint8_t id = 0;
+        if (!i2cDriver.readRegister(address, 0x0F, &id) || id != 0xA5)
+            return false;
+
+        delay(1);
+        return i2cDriver.readRegister(address, 0x10) == 0x5A;
+    }
+    static flxDeviceConfidence_t connectedConfidence(void)
+    {
+        return flxDevConfidenceExact;
+    }
+    static const char *getDeviceName()
+    {
+        return "MultiStep";
+    };
+    static const uint8_t *getDefaultAddresses()
+    {
+        return defaultDeviceAddress;
+    }
+    static uint8_t defaultDeviceAddress[];
+
+    bool onInitialize(TwoWire &)
+    {
+        return true;
+    }
+};
+uint8_t testDevMultiStep::defaultDeviceAddress[] = {0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+                                                    0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, kSparkDeviceAddressNull};
+flxRegisterDevice(testDevMultiStep);
+
+//----------------------------------------------------------------------------------------------------
+// A driver that pings first - a BME280
+class testDevBME280 : public flxDeviceI2CType<testDevBME280>
+{
+  public:
+    testDevBME280()
+    {
+        spSetupDeviceIdent(getDeviceName());
+    }
+
+    static bool isConnected(flxBusI2C &i2cDriver, uint8_t address)
+    {
+        nProbes[address]++;
+        return i2cDriver.ping(address) && i2cDriver.readRegister(address, 0xD0) == 0x60;
+    }
+    static flxDeviceConfidence_t connectedConfidence(void)
+    {
+        return flxDevConfidenceExact;
+    }
+    static const char *getDeviceName()
+    {
+        return "BME280";
+    };
+    static const uint8_t *getDefaultAddresses()
+    {
+        return defaultDeviceAddress;
+    }
+    static uint8_t defaultDeviceAddress[];
+
+    bool onInitialize(TwoWire &)
+    {
+        return true;
+    }
+};
+uint8_t testDevBME280::defaultDeviceAddress[] = {0x76, 0x77, kSparkDeviceAddressNull};
+flxRegisterDevice(testDevBME280);
+
+//----------------------------------------------------------------------------------------------------
+// A driver that can't be pinged
+class testDevNoPing : public flxDeviceI2CType<testDevNoPing>
+{
+  public:
+    testDevNoPing()
+    {
+        spSetupDeviceIdent(getDeviceName());
+    }
+
+    static bool isConnected(flxBusI2C &i2cDriver, uint8_t address)
+    {
+        nProbes[address]++;
+        return i2cDriver.readRegister(address, 0x20) == 0x40;
+    }
+    static flxDeviceConfidence_t connectedConfidence(void)
+    {
+        return flxDevConfidenceExact;
+    }
+    static bool pingable(void)
+    {
+        return false;
+    }
+    static const char *getDeviceName()
+    {
+        return "NoPing";
+    };
+    static const uint8_t *getDefaultAddresses()
+    {
+        return defaultDeviceAddress;
+    }
+    static uint8_t defaultDeviceAddress[];
+
+    bool onInitialize(TwoWire &)
+    {
+        return true;
+    }
+};
+uint8_t testDevNoPing::defaultDeviceAddress[] = {0x60, 0x61, kSparkDeviceAddressNull};
+flxRegisterDevice(testDevNoPing);
+
+// as in an application, the built devices live for the life of the program
+flxDevice *theDevices[8];
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    flxSimWire sim;
+
+    flxSimI2CDevice multiStep(0x12);
+    multiStep.writeRegister(0x0F, 0xA5);
+    multiStep.writeRegister(0x10, 0x5A);
+    flxTestCheck(sim.addDevice(multiStep));
+
+    flxSimBME280 bme;
+    flxTestCheck(sim.addDevice(bme));
+
+    flxSimI2CDevice noPing(0x60);
+    noPing.writeRegister(0x20, 0x40);
+    flxTestCheck(sim.addDevice(noPing));
+
+    flxBusI2C bus;
+    bus.begin(sim);
+
+    unsigned long start = millis();
+    flxTestCheck(flxDeviceFactory::get().buildDevices(bus) == 3);
+
+    flxSimWireStats_t stats;
+    sim.getStats(stats);
+    printf("detection of 3 devices, 20 driver addresses: %u bus transactions, %lu ms\n", stats.transactions,
+           millis() - start);
+
+    // the probes - only at the addresses that answered the ping, and at the addresses that can't be pinged
+    int nAbsent = 0;
+    for (int i = 0; i < 128; i++)
+    {
+        if (i != 0x12 && i != 0x77 && i != 0x60 && i != 0x61)
+            nAbsent += nProbes[i];
+    }
+    flxTestCheck(nAbsent == 0);
+    flxTestCheck(nProbes[0x12] == 1 && nProbes[0x77] == 1);
+    flxTestCheck(nProbes[0x60] == 1 && nProbes[0x61] == 1);
+
+    // a ping of the 18 pingable addresses, then the probes - two register reads at 0x12, a ping and a read at
+    // 0x77 and a read at each address that can't be pinged. A register read is a write and a read transaction.
+    flxTestCheck(stats.transactions == 18 + 4 + 3 + 4);
+
+    int nDevices = 0;
+    for (auto device : flux.connectedDevices())
+    {
+        if (nDevices < sizeof(theDevices) / sizeof(theDevices[0]))
+            theDevices[nDevices] = device;
+        nDevices++;
+    }
+    flxTestCheck(nDevices == 3);
+
+    return flxTestResult();
+}
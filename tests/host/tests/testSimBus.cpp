@@ -0,0 +1,377 @@
+/*
+ *---------------------------------------------------------------------------------
+ *
+ * Copyright (c) 2022-2024, SparkFun Electronics Inc.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ *---------------------------------------------------------------------------------
+ */
+
+/*
+ *
+ * testSimBus.cpp
+ *
+ * The framework I2C and SPI buses against the simulated buses and device models - detection reads,
+ * register and burst reads, batched register reads and writes, faults and the bus time accounting.
+ *
+ * The AMG8833 frame read time is printed - a transaction per pixel (as the GridEYE library reads a
+ * pixel), and the burst read the driver uses.
+ */
+
+#include "flxBusI2C.h"
+#include "flxSimDevices.h"
+#include "flxTest.h"
+
+flxTestDefine();
+
+//----------------------------------------------------------------------------------------------------
+// BME280 compensated temperature, in C/100 - from the datasheet
+static int32_t bme280Temperature(const uint8_t *calib, const uint8_t *data)
+{
+    uint16_t T1 = calib[0] | calib[1] << 8;
+    int16_t T2 = calib[2] | calib[3] << 8;
+    int16_t T3 = calib[4] | calib[5] << 8;
+
+    int32_t adcT = (data[3] << 12) | (data[4] << 4) | (data[5] >> 4);
+    int32_t var1 = ((((adcT >> 3) - ((int32_t)T1 << 1))) * T2) >> 11;
+    int32_t var2 = (((((adcT >> 4) - T1) * ((adcT >> 4) - T1)) >> 12) * T3) >> 14;
+
+    return ((var1 + var2) * 5 + 128) >> 8;
+}
+
+//----------------------------------------------------------------------------------------------------
+static void testI2CDevices(flxBusI2C &bus, flxSimADS1015 &ads)
+{
+    flxTestCheck(bus.ping(0x77));
+    flxTestCheck(!bus.ping(0x10));
+
+    // BME280 - chip ID and the datasheet example temperature
+    flxTestCheck(bus.readRegister(0x77, 0xD0) == 0x60);
+
+    uint8_t calib[24];
+    uint8_t data[8];
+    flxTestCheck(bus.readRegisterRegion(0x77, 0x88, calib, sizeof(calib)));
+    flxTestCheck(bus.readRegisterRegion(0x77, 0xF7, data, sizeof(data)));
+    flxTestCheck(bme280Temperature(calib, data) == 2508);
+
+    // AMG8833 - thermistor and the first and last pixels
+    uint16_t thermistor = 0;
+    flxTestCheck(bus.readRegister16(0x69, 0x0E, &thermistor, true));
+    flxTestCheck(thermistor == 400);
+
+    uint8_t pixels[128];
+    flxTestCheck(bus.readRegisterBurst(0x69, 0x80, pixels, sizeof(pixels)));
+    flxTestCheck((pixels[0] | pixels[1] << 8) == 80);
+    flxTestCheck((pixels[126] | pixels[127] << 8) == 143);
+
+    // ADS1015 - the pointer register, a threshold register write and read back, and a conversion
+    uint8_t pointer = 3;
+    uint8_t value[2];
+    flxTestCheck(bus.write(0x48, &pointer, 1));
+    flxTestCheck(bus.receiveResponse(0x48, value, 2) == 2);
+    flxTestCheck(value[0] == 0x7F && value[1] == 0xFF);
+
+    uint8_t threshold[3] = {3, 0xAA, 0xAF};
+    flxTestCheck(bus.write(0x48, threshold, sizeof(threshold)));
+    flxTestCheck(bus.write(0x48, &pointer, 1));
+    flxTestCheck(bus.receiveResponse(0x48, value, 2) == 2);
+    flxTestCheck(value[0] == 0xAA && value[1] == 0xAF);
+
+    ads.setChannel(2, 1000);
+    uint8_t config[3] = {1, 0x80 | 0x60 | 0x03, 0x83}; // single shot, AIN2
+    uint8_t conversion = 0;
+    flxTestCheck(bus.write(0x48, config, sizeof(config)));
+    flxTestCheck(bus.write(0x48, &conversion, 1));
+    flxTestCheck(bus.receiveResponse(0x48, value, 2) == 2);
+    flxTestCheck(((int16_t)(value[0] << 8 | value[1]) >> 4) == 1000);
+
+    // TMF882X - ID
+    uint8_t id = 0;
+    flxTestCheck(bus.readRegister(0x41, 0xE3, &id));
+    flxTestCheck(id == 0x08);
+}
+
+//----------------------------------------------------------------------------------------------------
+static void testI2CFaultsAndTime(flxBusI2C &bus, flxSimWire &sim, flxSimBME280 &bme)
+{
+    flxSimWireStats_t stats;
+
+    // NACK the next two transactions
+    sim.resetStats();
+    bme.nackNext(2);
+    flxTestCheck(!bus.ping(0x77));
+    flxTestCheck(!bus.ping(0x77));
+    flxTestCheck(bus.ping(0x77));
+    sim.getStats(stats);
+    flxTestCheck(stats.nacks == 2);
+
+    // The bus time is passed to the clock - micros() includes it
+    uint8_t data[8];
+    sim.resetStats();
+    unsigned long start = micros();
+    flxTestCheck(bus.readRegisterRegion(0x77, 0xF7, data, sizeof(data)));
+    sim.getStats(stats);
+    flxTestCheck(stats.busTime > 0);
+    flxTestCheck(micros() - start == stats.busTime);
+
+    // A faster clock - less time. Device latency and clock stretching add to it.
+    uint64_t time100k = stats.busTime;
+    sim.setClock(400000);
+    sim.resetStats();
+    bus.readRegisterRegion(0x77, 0xF7, data, sizeof(data));
+    sim.getStats(stats);
+    flxTestCheck(stats.busTime < time100k);
+
+    uint64_t time400k = stats.busTime;
+    bme.setLatency(500);
+    bme.setClockStretch(10);
+    sim.resetStats();
+    bus.readRegisterRegion(0x77, 0xF7, data, sizeof(data));
+    sim.getStats(stats);
+    flxTestCheck(stats.busTime > time400k + 500);
+
+    // Not real time - the clock doesn't move
+    sim.setRealTime(false);
+    start = micros();
+    bus.readRegisterRegion(0x77, 0xF7, data, sizeof(data));
+    flxTestCheck(micros() == start);
+
+    bme.setLatency(0);
+    bme.setClockStretch(0);
+    sim.setRealTime(true);
+    sim.setClock(100000);
+
+    // Offline - not found
+    bme.setOffline(true);
+    flxTestCheck(!bus.ping(0x77));
+    bme.setOffline(false);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Batched writes - adjacent ops in one transfer, and an op larger than a transfer split into several
+static void testI2CWrites(flxBusI2C &bus, flxSimWire &sim, flxSimI2CDevice &regs)
+{
+    uint8_t data[40];
+    for (uint8_t i = 0; i < sizeof(data); i++)
+        data[i] = 0xA0 + i;
+
+    flxSimWireStats_t stats;
+    bus.setMaxTransferSize(16);
+
+    // three adjacent ops - one transaction
+    flxI2CRegisterOp_t adjacent[] = {{0x10, data, 2}, {0x12, data + 2, 4}, {0x16, data + 6, 3}};
+    sim.resetStats();
+    flxTestCheck(bus.writeRegisters(regs.address(), adjacent, 3));
+    sim.getStats(stats);
+    flxTestCheck(stats.transactions == 1);
+    for (uint8_t i = 0; i < 9; i++)
+        flxTestCheck(regs.readRegister(0x10 + i) == data[i]);
+
+    // a single 40 byte op - 15 data bytes per transfer, after the register
+    flxI2CRegisterOp_t large[] = {{0x40, data, sizeof(data)}};
+    sim.resetStats();
+    flxTestCheck(bus.writeRegisters(regs.address(), large, 1));
+    sim.getStats(stats);
+    flxTestCheck(stats.transactions == 3);
+    for (uint8_t i = 0; i < sizeof(data); i++)
+        flxTestCheck(regs.readRegister(0x40 + i) == data[i]);
+
+    // and read back in a batch - the second op is larger than a transfer
+    uint8_t head[4] = {0};
+    uint8_t body[36] = {0};
+    flxI2CRegisterOp_t reads[] = {{0x40, head, sizeof(head)}, {0x44, body, sizeof(body)}};
+    flxTestCheck(bus.readRegisters(regs.address(), reads, 2));
+    flxTestCheck(memcmp(head, data, 4) == 0 && memcmp(body, data + 4, sizeof(body)) == 0);
+
+    // a transfer with no room for data
+    bus.setMaxTransferSize(1);
+    flxTestCheck(!bus.writeRegisterBurst(regs.address(), 0x40, data, 2));
+
+    bus.setMaxTransferSize(kI2CMaxTransferSize);
+}
+
+//----------------------------------------------------------------------------------------------------
+// An AMG8833 frame - read and decoded as the driver does, and the time to read it a pixel at a time
+static void testAMG8833Frame(flxBusI2C &bus, flxSimWire &sim, flxSimAMG8833 &amg)
+{
+    // a frame with negative, zero and positive temperatures
+    for (uint8_t i = 0; i < 64; i++)
+        amg.setPixel(i, -10.0 + i * 0.75);
+
+    flxSimWireStats_t stats;
+
+    // a transaction per pixel
+    sim.resetStats();
+    int nBad = 0;
+    for (uint8_t i = 0; i < 64; i++)
+    {
+        uint16_t raw = 0;
+        bus.readRegister16(0x69, 0x80 + i * 2, &raw, true);
+        if ((int16_t)(raw << 4) >> 4 != (int16_t)((-10.0 + i * 0.75) / 0.25))
+            nBad++;
+    }
+    sim.getStats(stats);
+    uint64_t timePixels = stats.busTime;
+    uint32_t nPixelTransactions = stats.transactions;
+    flxTestCheck(nBad == 0);
+
+    // the burst read
+    uint8_t frame[128];
+    sim.resetStats();
+    flxTestCheck(bus.readRegisterBurst(0x69, 0x80, frame, sizeof(frame)));
+    sim.getStats(stats);
+
+    for (uint8_t i = 0; i < 64; i++)
+    {
+        int16_t value = (int16_t)((uint16_t)frame[i * 2] | (uint16_t)frame[i * 2 + 1] << 8);
+        value = (int16_t)(value << 4) >> 4;
+        if (value * 0.25 != -10.0 + i * 0.75)
+            nBad++;
+    }
+    flxTestCheck(nBad == 0);
+
+    printf("AMG8833 frame: per pixel %u transactions, %llu us - burst %u transactions, %llu us\n",
+           nPixelTransactions, (unsigned long long)timePixels, stats.transactions,
+           (unsigned long long)stats.busTime);
+
+    flxTestCheck(stats.transactions < nPixelTransactions);
+    flxTestCheck(stats.busTime < timePixels);
+
+    // back to the default gradient
+    for (uint8_t i = 0; i < 64; i++)
+        amg.setPixel(i, 20.0 + i * 0.25);
+}
+
+//----------------------------------------------------------------------------------------------------
+static void testSPIDevice(void)
+{
+    flxSimBusSPI bus;
+    flxSimISM330 imu(5);
+    SPISettings settings;
+
+    flxTestCheck(bus.addDevice(imu));
+    flxTestCheck(bus.begin(SPI, settings));
+
+    uint8_t whoAmI = 0;
+    flxTestCheck(bus.readRegisterRegion(5, 0x0F, &whoAmI, 1) == 1);
+    flxTestCheck(whoAmI == 0x6B);
+
+    // at rest - 1 g on Z
+    imu.setGyro(10, -20, 30);
+    uint8_t out[12];
+    flxTestCheck(bus.readRegisterRegion(5, 0x22, out, sizeof(out)) == sizeof(out));
+    flxTestCheck((int16_t)(out[0] | out[1] << 8) == 10);
+    flxTestCheck((int16_t)(out[2] | out[3] << 8) == -20);
+    flxTestCheck((int16_t)(out[4] | out[5] << 8) == 30);
+    flxTestCheck((int16_t)(out[10] | out[11] << 8) == 8197);
+
+    // a register write
+    flxTestCheck(bus.writeRegisterByte(5, 0x10, 0xA0));
+    flxTestCheck(imu.readRegister(0x10) == 0xA0);
+
+    flxSimSPIStats_t stats;
+    bus.getStats(stats);
+    flxTestCheck(stats.transactions == 3);
+}
+
+//----------------------------------------------------------------------------------------------------
+// Batched SPI transfers - one bus transaction per batch, and a chip select frame per run of consecutive
+// registers in the same direction
+static void testSPIBatch(void)
+{
+    flxSimBusSPI bus;
+    flxSimSPIDevice regs(7);
+    SPISettings settings;
+
+    flxTestCheck(bus.addDevice(regs));
+    flxTestCheck(bus.begin(SPI, settings));
+
+    uint8_t data[64];
+    for (uint8_t i = 0; i < sizeof(data); i++)
+        data[i] = 0x40 + i;
+
+    flxSimSPIStats_t stats;
+
+    // a write run - one frame
+    flxSPIRegisterOp_t writes[] = {{0x20, data, 4, true}, {0x24, data + 4, 4, true}};
+    bus.resetStats();
+    flxTestCheck(bus.transferRegisters(7, writes, 2));
+    bus.getStats(stats);
+    flxTestCheck(stats.transactions == 1 && stats.frames == 1);
+    for (uint8_t i = 0; i < 8; i++)
+        flxTestCheck(regs.readRegister(0x20 + i) == data[i]);
+
+    // consecutive reads merged - one frame
+    uint8_t in[64] = {0};
+    flxSPIRegisterOp_t reads[] = {{0x20, in, 3, false}, {0x23, in + 3, 5, false}};
+    bus.resetStats();
+    flxTestCheck(bus.transferRegisters(7, reads, 2));
+    bus.getStats(stats);
+    flxTestCheck(stats.transactions == 1 && stats.frames == 1);
+    flxTestCheck(memcmp(in, data, 8) == 0);
+
+    // runs of 32 bytes or more - sent without the gather buffer, still one frame each
+    flxSPIRegisterOp_t longWrites[] = {{0x30, data, 24, true}, {0x48, data + 24, 24, true}};
+    bus.resetStats();
+    flxTestCheck(bus.transferRegisters(7, longWrites, 2));
+    bus.getStats(stats);
+    flxTestCheck(stats.frames == 1);
+    for (uint8_t i = 0; i < 48; i++)
+        flxTestCheck(regs.readRegister(0x30 + i) == data[i]);
+
+    memset(in, 0, sizeof(in));
+    flxSPIRegisterOp_t longReads[] = {{0x30, in, 20, false}, {0x44, in + 20, 28, false}};
+    bus.resetStats();
+    flxTestCheck(bus.transferRegisters(7, longReads, 2));
+    bus.getStats(stats);
+    flxTestCheck(stats.frames == 1);
+    flxTestCheck(memcmp(in, data, 48) == 0);
+
+    // direction changes mid-batch - a new frame each, and the read sees the write before it
+    uint8_t update[4] = {1, 2, 3, 4};
+    uint8_t back[4] = {0};
+    flxSPIRegisterOp_t mixed[] = {{0x10, update, 4, true},
+                                  {0x10, back, 2, false},
+                                  {0x12, back + 2, 2, false},
+                                  {0x14, update, 2, true}};
+    bus.resetStats();
+    flxTestCheck(bus.transferRegisters(7, mixed, 4));
+    bus.getStats(stats);
+    flxTestCheck(stats.transactions == 1 && stats.frames == 3);
+    flxTestCheck(memcmp(back, update, 4) == 0);
+    flxTestCheck(regs.readRegister(0x14) == 1 && regs.readRegister(0x15) == 2);
+}
+
+//----------------------------------------------------------------------------------------------------
+int main(void)
+{
+    flxSimWire sim;
+    flxSimBME280 bme;
+    flxSimAMG8833 amg;
+    flxSimADS1015 ads;
+    flxSimTMF882X tmf;
+    flxSimI2CDevice regs(0x30);
+
+    flxTestCheck(sim.addDevice(bme));
+    flxTestCheck(sim.addDevice(amg));
+    flxTestCheck(sim.addDevice(ads));
+    flxTestCheck(sim.addDevice(tmf));
+    flxTestCheck(sim.addDevice(regs));
+
+    // one model per address
+    flxSimBME280 other;
+    flxTestCheck(!sim.addDevice(other));
+
+    flxBusI2C bus;
+    bus.begin(sim);
+
+    testI2CDevices(bus, ads);
+    testI2CFaultsAndTime(bus, sim, bme);
+    testI2CWrites(bus, sim, regs);
+    testAMG8833Frame(bus, sim, amg);
+    testSPIDevice();
+    testSPIBatch();
+
+    return flxTestResult();
+}